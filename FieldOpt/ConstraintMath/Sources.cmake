@@ -1,13 +1,22 @@
 SET(CONSTRAINTMATH_HEADERS
 	well_constraint_projections/well_constraint_projections.h
+	well_constraint_projections/batch_well_projections.h
+	well_constraint_projections/well_segment_index.h
+	well_constraint_projections/cell_domain.h
 )
 
 SET(CONSTRAINTMATH_SOURCES
 	well_constraint_projections/well_constraint_projections.cpp
+	well_constraint_projections/batch_well_projections.cpp
+	well_constraint_projections/well_segment_index.cpp
+	well_constraint_projections/cell_domain.cpp
 )
 
 SET(CONSTRAINTMATH_TESTS
 	tests/test_domain_boundary.cpp
 	tests/well_constraint_projections_tests.cpp
+	tests/test_batch_well_projections.cpp
+	tests/test_well_segment_index.cpp
+	tests/test_cell_domain.cpp
 )
 
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <QList>
+#include <random>
+#include "ConstraintMath/well_constraint_projections/well_constraint_projections.h"
+#include "ConstraintMath/well_constraint_projections/batch_well_projections.h"
+
+using namespace WellConstraintProjections;
+
+namespace {
+
+    class BatchWellProjectionsTests : public ::testing::Test {
+    protected:
+        BatchWellProjectionsTests() {
+        }
+
+        virtual ~BatchWellProjectionsTests() {
+        }
+
+        virtual void SetUp() {
+            gen_ = std::mt19937(0);
+        }
+
+        virtual void TearDown() { }
+
+        Vector3d random_point() {
+            std::uniform_real_distribution<double> xy(0, 1000);
+            std::uniform_real_distribution<double> z(1700, 1750);
+            return Vector3d(xy(gen_), xy(gen_), z(gen_));
+        }
+
+        std::mt19937 gen_;
+    };
+
+    TEST_F(BatchWellProjectionsTests, KktSolutions) {
+        QList<Vector3d> coords({Vector3d(3,2,0), Vector3d(-2,2,0), Vector3d(2,-2,0), Vector3d(-3,-2,0)});
+        Matrix3d A = build_A_4p(coords);
+        Vector3d b = build_b_4p(coords, 2);
+
+        QList<Vector3d> expected = kkt_eq_solutions(A, b);
+        Vector3d solutions[Batch::kMaxKktSolutions];
+        int n_solutions = Batch::kkt_eq_solutions(A, b, solutions);
+
+        ASSERT_EQ(expected.length(), n_solutions);
+        for (int i = 0; i < n_solutions; ++i) {
+            EXPECT_TRUE(expected[i].isApprox(solutions[i]));
+        }
+    }
+
+    TEST_F(BatchWellProjectionsTests, InterwellProjectionThreePoint) {
+        double d = 300;
+        QList<Vector3d> coords({Vector3d(162.002, 706.854, 1712), Vector3d(525.081, 874.706, 1712),
+                                Vector3d(668.55, 580.227, 1712), Vector3d(916.367, 894.213, 1712)});
+        QList<Vector3d> expected = interwell_constraint_projection(coords, d);
+
+        Batch::WellSegment w1(coords[0], coords[1]);
+        Batch::WellSegment w2(coords[2], coords[3]);
+        EXPECT_TRUE(Batch::interwell_constraint_projection(w1, w2, d));
+        EXPECT_TRUE(expected[0].isApprox(w1.heel));
+        EXPECT_TRUE(expected[1].isApprox(w1.toe));
+        EXPECT_TRUE(expected[2].isApprox(w2.heel));
+        EXPECT_TRUE(expected[3].isApprox(w2.toe));
+        EXPECT_GE(Batch::shortest_distance(w1, w2), d - 0.001);
+    }
+
+    TEST_F(BatchWellProjectionsTests, InterwellProjectionRandom) {
+        double d = 300;
+        for (int k = 0; k < 200; ++k) {
+            QList<Vector3d> coords({random_point(), random_point(), random_point(), random_point()});
+            QList<Vector3d> expected = interwell_constraint_projection(coords, d);
+
+            Batch::WellSegment w1(coords[0], coords[1]);
+            Batch::WellSegment w2(coords[2], coords[3]);
+            EXPECT_EQ(expected.length() > 0, Batch::interwell_constraint_projection(w1, w2, d));
+            if (expected.length() == 0) continue;
+            EXPECT_TRUE(expected[0].isApprox(w1.heel));
+            EXPECT_TRUE(expected[1].isApprox(w1.toe));
+            EXPECT_TRUE(expected[2].isApprox(w2.heel));
+            EXPECT_TRUE(expected[3].isApprox(w2.toe));
+        }
+    }
+
+    TEST_F(BatchWellProjectionsTests, WellLengthProjection) {
+        Vector3d heel(0, 0, 0);
+        Vector3d toe(0, 0, 0);
+        Batch::well_length_projection(heel, toe, 600, 300, 0.001);
+        EXPECT_DOUBLE_EQ(300, (heel - toe).norm());
+
+        heel = Vector3d(0, 0, 0);
+        toe = Vector3d(1000, 0, 0);
+        QList<Vector3d> expected = well_length_projection(heel, toe, 600, 300, 0.001);
+        Batch::well_length_projection(heel, toe, 600, 300, 0.001);
+        EXPECT_TRUE(expected[0].isApprox(heel));
+        EXPECT_TRUE(expected[1].isApprox(toe));
+        EXPECT_LE((heel - toe).norm(), 600);
+    }
+
+    TEST_F(BatchWellProjectionsTests, BothConstraintsPopulation) {
+        double d = 150, tol = 10e-4, max = 600, min = 300, eps = 0.001;
+        std::vector<Batch::WellSet> population(50);
+        QList<QList<QList<Vector3d>>> expected;
+        for (auto &well_set : population) {
+            QList<QList<Vector3d>> wells;
+            for (int w = 0; w < 3; ++w) {
+                Batch::WellSegment well(random_point(), random_point());
+                well_set.push_back(well);
+                wells.append(QList<Vector3d>({well.heel, well.toe}));
+            }
+            expected.append(both_constraints_multiple_wells(wells, d, tol, max, min, eps));
+        }
+
+        Batch::both_constraints_population(population, d, tol, max, min, eps, 4);
+
+        for (int k = 0; k < population.size(); ++k) {
+            for (int w = 0; w < 3; ++w) {
+                EXPECT_TRUE(expected[k][w][0].isApprox(population[k][w].heel));
+                EXPECT_TRUE(expected[k][w][1].isApprox(population[k][w].toe));
+            }
+            EXPECT_TRUE(Batch::feasible_well_length(population[k], max, min, tol));
+        }
+    }
+
+    TEST_F(BatchWellProjectionsTests, ParallelFor) {
+        std::vector<int> values(1000, 0);
+        Batch::parallel_for(values.size(), [&](int i) { values[i] = i; }, 8);
+        for (int i = 0; i < values.size(); ++i) {
+            EXPECT_EQ(i, values[i]);
+        }
+    }
+
+}
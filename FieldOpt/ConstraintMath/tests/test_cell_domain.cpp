@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <QList>
+#include <random>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "ConstraintMath/well_constraint_projections/well_constraint_projections.h"
+#include "ConstraintMath/well_constraint_projections/cell_domain.h"
+#include "Settings/tests/test_resource_example_file_paths.hpp"
+
+using namespace Reservoir::Grid;
+
+namespace {
+
+class CellDomainTest : public ::testing::Test {
+protected:
+    CellDomainTest() {
+        grid_ = new ECLGrid(file_path_);
+        for (int i = 3; i <= 12; ++i) {
+            for (int j = 5; j <= 9; ++j) {
+                Cell cell = grid_->GetCell(i, j, 0);
+                index_list_.append(cell.global_index());
+                cells_.append(cell);
+            }
+        }
+        gen_ = std::mt19937(0);
+    }
+
+    virtual ~CellDomainTest() {
+        delete grid_;
+    }
+
+    virtual void SetUp() {
+    }
+
+    virtual void TearDown() { }
+
+    Eigen::Vector3d random_point() {
+        std::uniform_real_distribution<double> xy(0, 400);
+        std::uniform_real_distribution<double> z(1690, 1740);
+        return Eigen::Vector3d(xy(gen_), xy(gen_), z(gen_));
+    }
+
+    Grid *grid_;
+    QList<int> index_list_;
+    QList<Cell> cells_;
+    std::mt19937 gen_;
+    string file_path_ = TestResources::ExampleFilePaths::grid_5spot_;
+};
+
+TEST_F(CellDomainTest, Contains) {
+    WellConstraintProjections::CellDomain domain(grid_, index_list_);
+    EXPECT_EQ(index_list_.size(), domain.size());
+    EXPECT_TRUE(domain.Contains(cells_[7].center()));
+
+    for (int k = 0; k < 1000; ++k) {
+        Eigen::Vector3d point = random_point();
+        bool enveloped = false;
+        for (auto cell : cells_) {
+            if (cell.EnvelopsPoint(point)) enveloped = true;
+        }
+        EXPECT_EQ(enveloped, domain.Contains(point));
+    }
+}
+
+TEST_F(CellDomainTest, Project) {
+    WellConstraintProjections::CellDomain domain(cells_);
+    Eigen::Vector3d inside = cells_[3].center();
+    EXPECT_TRUE(inside == domain.Project(inside));
+
+    for (int k = 0; k < 100; ++k) {
+        Eigen::Vector3d point = random_point();
+        Eigen::Vector3d expected = WellConstraintProjections::well_domain_constraint(point, cells_);
+        EXPECT_TRUE(expected == domain.Project(point));
+    }
+}
+
+TEST_F(CellDomainTest, ProjectNearBoundary) {
+    // Points just outside the corners of the cells, where the closest cell is decided by
+    // the padding of the boxes
+    WellConstraintProjections::CellDomain domain(cells_);
+    std::uniform_real_distribution<double> offset(-2.0, 2.0);
+    for (auto cell : cells_) {
+        for (auto corner : cell.corners()) {
+            Eigen::Vector3d point = corner + Eigen::Vector3d(offset(gen_), offset(gen_), offset(gen_));
+            Eigen::Vector3d expected = WellConstraintProjections::well_domain_constraint(point, cells_);
+            EXPECT_TRUE(expected == domain.Project(point));
+        }
+    }
+}
+
+TEST_F(CellDomainTest, ProjectPoints) {
+    WellConstraintProjections::CellDomain domain(cells_);
+    std::vector<Eigen::Vector3d> points;
+    for (int k = 0; k < 50; ++k) {
+        points.push_back(random_point());
+    }
+    std::vector<Eigen::Vector3d> expected = points;
+    for (auto &point : expected) {
+        point = domain.Project(point);
+    }
+
+    domain.ProjectPoints(points, 4);
+    for (int k = 0; k < points.size(); ++k) {
+        EXPECT_TRUE(expected[k] == points[k]);
+    }
+}
+
+}
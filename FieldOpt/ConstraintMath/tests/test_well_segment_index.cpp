@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <QList>
+#include <random>
+#include "ConstraintMath/well_constraint_projections/well_constraint_projections.h"
+#include "ConstraintMath/well_constraint_projections/well_segment_index.h"
+
+using namespace WellConstraintProjections;
+
+namespace {
+
+    class WellSegmentIndexTests : public ::testing::Test {
+    protected:
+        WellSegmentIndexTests() {
+        }
+
+        virtual ~WellSegmentIndexTests() {
+        }
+
+        virtual void SetUp() {
+            gen_ = std::mt19937(0);
+        }
+
+        virtual void TearDown() { }
+
+        //! Create n wells with lengths up to max_length in a field of size field_size x field_size.
+        Batch::WellSet random_wells(int n, double field_size, double max_length) {
+            std::uniform_real_distribution<double> xy(0, field_size);
+            std::uniform_real_distribution<double> offset(-max_length / 2, max_length / 2);
+            std::uniform_real_distribution<double> z(1700, 1750);
+            Batch::WellSet wells;
+            for (int i = 0; i < n; ++i) {
+                Vector3d heel(xy(gen_), xy(gen_), z(gen_));
+                Vector3d toe = heel + Vector3d(offset(gen_), offset(gen_), 0);
+                wells.push_back(Batch::WellSegment(heel, toe));
+            }
+            return wells;
+        }
+
+        QList<Vector3d> pair(const Batch::WellSet &wells, int i, int j) {
+            return QList<Vector3d>({wells[i].heel, wells[i].toe, wells[j].heel, wells[j].toe});
+        }
+
+        //! Brute force version of Batch::interwell_constraint_satisfied
+        bool brute_force_satisfied(const Batch::WellSet &wells, double d) {
+            for (int i = 0; i < wells.size(); ++i) {
+                for (int j = i + 1; j < wells.size(); ++j) {
+                    QList<Vector3d> points = pair(wells, i, j);
+                    QList<Vector3d> projection = interwell_constraint_projection(points, d);
+                    if (projection.length() == 0) return false;
+                    for (int k = 0; k < 4; ++k) {
+                        if (!points[k].isApprox(projection[k], 0.01))
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        std::mt19937 gen_;
+    };
+
+    TEST_F(WellSegmentIndexTests, CandidatePairs) {
+        double d = 150;
+        Batch::WellSet wells = random_wells(60, 5000, 600);
+        Batch::WellSegmentIndex index(wells);
+        auto pairs = index.CandidatePairs(d);
+        EXPECT_LT(pairs.size(), 60 * 59 / 2);
+        EXPECT_TRUE(std::is_sorted(pairs.begin(), pairs.end()));
+
+        for (int i = 0; i < wells.size(); ++i) {
+            for (int j = i + 1; j < wells.size(); ++j) {
+                bool is_candidate = std::find(pairs.begin(), pairs.end(), std::make_pair(i, j)) != pairs.end();
+                if (!is_candidate) {
+                    EXPECT_GE(shortest_distance(pair(wells, i, j)), d);
+                }
+                EXPECT_EQ(is_candidate, index.MayBeCloserThan(i, j, d));
+            }
+        }
+    }
+
+    TEST_F(WellSegmentIndexTests, CandidatePairsMoved) {
+        double d = 300;
+        Batch::WellSet wells = random_wells(40, 3000, 600);
+        Batch::WellSegmentIndex index(wells);
+        std::vector<bool> moved(wells.size(), false);
+        moved[3] = moved[17] = moved[31] = true;
+
+        std::vector<std::pair<int, int>> expected;
+        for (auto p : index.CandidatePairs(d)) {
+            if (moved[p.first] || moved[p.second])
+                expected.push_back(p);
+        }
+        EXPECT_EQ(expected, index.CandidatePairs(d, moved));
+    }
+
+    TEST_F(WellSegmentIndexTests, SatisfiedMatchesBruteForce) {
+        for (double d : {50.0, 150.0, 400.0}) {
+            for (int k = 0; k < 10; ++k) {
+                Batch::WellSet wells = random_wells(20, 4000, 600);
+                EXPECT_EQ(brute_force_satisfied(wells, d), Batch::interwell_constraint_satisfied(wells, d, 0.01));
+            }
+        }
+    }
+
+    TEST_F(WellSegmentIndexTests, SweepMatchesBruteForce) {
+        double d = 200;
+        Batch::WellSet wells = random_wells(30, 3000, 600);
+        Batch::WellSet expected = wells;
+        for (int i = 0; i < expected.size(); ++i) {
+            for (int j = i + 1; j < expected.size(); ++j) {
+                QList<Vector3d> projection = interwell_constraint_projection(pair(expected, i, j), d);
+                if (projection.length() == 0) continue;
+                expected[i] = Batch::WellSegment(projection[0], projection[1]);
+                expected[j] = Batch::WellSegment(projection[2], projection[3]);
+            }
+        }
+
+        Batch::interwell_constraint_sweep(wells, d);
+        for (int i = 0; i < wells.size(); ++i) {
+            EXPECT_TRUE(expected[i].heel == wells[i].heel);
+            EXPECT_TRUE(expected[i].toe == wells[i].toe);
+        }
+    }
+
+    TEST_F(WellSegmentIndexTests, EndpointDistances) {
+        double d = 150;
+        Batch::WellSet wells = random_wells(50, 4000, 600);
+        std::vector<double> all = Batch::endpoint_distances(wells);
+        std::vector<double> pruned = Batch::endpoint_distances(wells, d);
+        EXPECT_EQ(50 * 49 / 2 * 4, all.size());
+        EXPECT_LT(pruned.size(), all.size());
+
+        double violation_all = 0.0, violation_pruned = 0.0;
+        for (double dist : all) if (dist < d) violation_all += d - dist;
+        for (double dist : pruned) if (dist < d) violation_pruned += d - dist;
+        EXPECT_DOUBLE_EQ(violation_all, violation_pruned);
+
+        EXPECT_DOUBLE_EQ(*std::min_element(all.begin(), all.end()), Batch::minimum_endpoint_distance(wells));
+    }
+
+}
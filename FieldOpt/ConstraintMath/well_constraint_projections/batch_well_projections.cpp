@@ -0,0 +1,430 @@
+#include "batch_well_projections.h"
+#include "well_constraint_projections.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "Utilities/printer.hpp"
+#include "Utilities/verbosity.h"
+
+namespace WellConstraintProjections {
+namespace Batch {
+
+namespace {
+
+typedef Matrix<double, 7, 1> SexticCoeffs;
+
+Matrix3d build_A_4p(const Vector3d (&c)[4]) {
+    Vector3d avg_vec = 0.25 * (c[0] + c[1] + c[2] + c[3]);
+    Matrix3d A = Matrix3d::Zero();
+    for (int i = 0; i < 4; ++i) {
+        Vector3d vec = c[i] - avg_vec;
+        A += vec * vec.transpose();
+    }
+    return A;
+}
+
+Vector3d build_b_4p(const Vector3d (&c)[4], double d) {
+    Vector3d avg_vec = 0.25 * (c[0] + c[1] + c[2] + c[3]);
+    return 0.5 * d * ((c[0] - avg_vec) + (c[1] - avg_vec) - (c[2] - avg_vec) - (c[3] - avg_vec));
+}
+
+Matrix3d build_A_3p(const Vector3d (&c)[3]) {
+    Vector3d avg_vec = (1.0 / 3) * (c[0] + c[1] + c[2]);
+    Matrix3d A = Matrix3d::Zero();
+    for (int i = 0; i < 3; ++i) {
+        Vector3d vec = c[i] - avg_vec;
+        A += vec * vec.transpose();
+    }
+    return A;
+}
+
+Vector3d build_b_3p(const Vector3d (&c)[3], double d) {
+    Vector3d avg_vec = (1.0 / 3) * (c[0] + c[1] + c[2]);
+    return (2.0 / 3) * d * (c[0] - avg_vec) - (1.0 / 3) * d * ((c[1] - avg_vec) + (c[2] - avg_vec));
+}
+
+/*!
+ * \brief Fixed-size version of WellConstraintProjections::coeff_vector.
+ */
+SexticCoeffs coeff_vector(const Vector3d &D, const Matrix3d &Qinv, const Vector3d &b) {
+    double D1 = D(0);
+    double D2 = D(1);
+    double D3 = D(2);
+    double sum_i = D1 + D2 + D3;
+    double sum_ij = D1*D2 + D2*D3 + D3*D1;
+    double prod_i = D1*D2*D3;
+    double Qtb_1 = Qinv.row(0) * ( b * (Qinv.row(0) * b) );
+    double Qtb_2 = Qinv.row(1) * ( b * (Qinv.row(1) * b) );
+    double Qtb_3 = Qinv.row(2) * ( b * (Qinv.row(2) * b) );
+
+    SexticCoeffs lambda;
+    lambda(0) = 1;
+    lambda(1) = -2 * sum_i;
+    lambda(2) = 2 * sum_ij + sum_i * sum_i - (Qtb_1 + Qtb_2 + Qtb_3);
+    lambda(3) = -2 * prod_i - 2 * sum_i * sum_ij - Qtb_1 * (-2 * D2 - 2 * D3)
+        - Qtb_2 * (-2 * D3 - 2 * D1)
+        - Qtb_3 * (-2 * D1 - 2 * D2);
+    lambda(4) = 2 * sum_i * prod_i + sum_ij * sum_ij - Qtb_1 * (D2 * D2 + D3 * D3 + 4 * D2 * D3)
+        - Qtb_2 * (D3 * D3 + D1 * D1 + 4 * D3 * D1)
+        - Qtb_3 * (D1 * D1 + D2 * D2 + 4 * D1 * D2);
+    lambda(5) = -2 * sum_ij * prod_i - Qtb_1 * (-2 * D2 * D3 * D3 - 2 * D3 * D2 * D2)
+        - Qtb_2 * (-2 * D3 * D1 * D1 - 2 * D1 * D3 * D3)
+        - Qtb_3 * (-2 * D1 * D2 * D2 - 2 * D2 * D1 * D1);
+    lambda(6) = prod_i * prod_i - Qtb_1 * (D2 * D2 * D3 * D3)
+        - Qtb_2 * (D3 * D3 * D1 * D1)
+        - Qtb_3 * (D1 * D1 * D2 * D2);
+
+    for (int ii = 0; ii < 7; ii++) {
+        if (fabs(lambda(ii)) < 10e-12) {
+            lambda(ii) = 0;
+        }
+    }
+    return lambda;
+}
+
+/*!
+ * \brief Find the roots of the polynomial with the (fixed-size) coefficient vector coeffs.
+ *
+ * This uses the same Jenkins-Traub solver as the QList-based functions, so that the two
+ * yield the same set of KKT candidates.
+ */
+template<int N>
+void find_roots(const Matrix<double, N, 1> &coeffs,
+                Matrix<double, N-1, 1> &real_roots,
+                Matrix<double, N-1, 1> &complex_roots) {
+    real_roots.setZero();
+    complex_roots.setConstant(1.0);
+    VectorXd real_buffer(N-1), complex_buffer(N-1);
+    rpoly_plus_plus::FindPolynomialRootsJenkinsTraub(coeffs, &real_buffer, &complex_buffer);
+    for (int ii = 0; ii < real_buffer.size() && ii < N-1; ++ii) {
+        real_roots(ii) = real_buffer(ii);
+        complex_roots(ii) = complex_buffer(ii);
+    }
+}
+
+/*!
+ * \brief Fixed-size version of WellConstraintProjections::non_inv_solution.
+ * \return The number of solutions written to solutions.
+ */
+int non_inv_solution(const Matrix3d &A, const Vector3d &b, Vector3d *solutions) {
+    FullPivLU<Matrix3d> lu(A);
+    Vector3d x = lu.solve(b);
+    Matrix<double, 3, Dynamic, 0, 3, 3> nu = lu.kernel();
+    Vector3d null_space = nu.col(0);
+
+    Vector3d coeffs = non_inv_quad_coeffs(x, null_space);
+    if (coeffs[0] == 0.0 && coeffs[1] == 0.0) {
+        return 0;
+    }
+
+    Vector2d real_roots, complex_roots;
+    find_roots(coeffs, real_roots, complex_roots);
+    int n_solutions = 0;
+    for (int ii = 0; ii < 2; ii++) {
+        if (complex_roots(ii) == 0) {
+            solutions[n_solutions++] = x + real_roots(ii) * null_space;
+        }
+    }
+    return n_solutions;
+}
+
+template<int N>
+double movement_cost(const Vector3d (&old_coords)[N], const Vector3d (&new_coords)[N]) {
+    double cost_squares = 0;
+    for (int ii = 0; ii < N; ii++) {
+        cost_squares += (old_coords[ii] - new_coords[ii]).squaredNorm();
+    }
+    return cost_squares;
+}
+
+double shortest_distance(const Vector3d (&c)[4]) {
+    auto closest_p_q = closest_points_on_lines(c[0], c[1], c[2], c[3]);
+    return (closest_p_q.second - closest_p_q.first).norm();
+}
+
+void move_points_4p(const Vector3d (&c)[4], double d, Vector3d s, Vector3d (&moved)[4]) {
+    s.normalize();
+    Vector3d avg_point = 0.25 * (c[0] + c[1] + c[2] + c[3]);
+    Vector3d top_plane_point = avg_point + (d / 2) * s;
+    Vector3d bot_plane_point = avg_point - (d / 2) * s;
+    moved[0] = project_point_to_plane(c[0], s, top_plane_point);
+    moved[1] = project_point_to_plane(c[1], s, top_plane_point);
+    moved[2] = project_point_to_plane(c[2], s, bot_plane_point);
+    moved[3] = project_point_to_plane(c[3], s, bot_plane_point);
+}
+
+void move_points_3p(const Vector3d (&c)[3], double d, Vector3d s, Vector3d (&moved)[3]) {
+    s.normalize();
+    Vector3d avg_point = (1.0 / 3) * (c[0] + c[1] + c[2]);
+    Vector3d top_plane_point = avg_point + (2.0 * d / 3) * s;
+    Vector3d bot_plane_point = avg_point - (1.0 * d / 3) * s;
+    moved[0] = project_point_to_plane(c[0], s, top_plane_point);
+    moved[1] = project_point_to_plane(c[1], s, bot_plane_point);
+    moved[2] = project_point_to_plane(c[2], s, bot_plane_point);
+}
+
+}
+
+int kkt_eq_solutions(const Matrix3d &A_in, const Vector3d &b, Vector3d (&solutions)[kMaxKktSolutions]) {
+    int n_solutions = 0;
+
+    // Assume that A-\mu I has an inverse - find it and solve a sixth degree eq. for \mu
+    Matrix3d A = rm_entries_eps_matrix(A_in, 10e-12);
+    SelfAdjointEigenSolver<Matrix3d> A_es(A);
+    Vector3d eigenvalues = rm_entries_eps(A_es.eigenvalues(), 10e-12);
+    Matrix3d V = A_es.eigenvectors();
+    Matrix3d V_inv = V.inverse();
+
+    Matrix<double, 6, 1> real_roots, complex_roots;
+    find_roots(coeff_vector(eigenvalues, V_inv, b), real_roots, complex_roots);
+    for (int ii = 0; ii < 6; ii++) {
+        // Root may not be complex or an eigenvalue of A
+        if (complex_roots[ii] == 0 && eigenvalues[0] != real_roots[ii] &&
+            eigenvalues[1] != real_roots[ii] && eigenvalues[2] != real_roots[ii]) {
+            Matrix3d invmatr = (eigenvalues - Vector3d::Constant(real_roots[ii])).asDiagonal();
+            solutions[n_solutions++] = V * invmatr.inverse() * V_inv * b;
+        }
+    }
+
+    // Assume that A-\mu I is not invertible, i.e. \mu is an eigenvalue of A.
+    for (int i = 0; i < 3; i++) {
+        Matrix3d A_eig = A - eigenvalues[i] * Matrix3d::Identity();
+        if (solution_existence(A_eig, b)) {
+            n_solutions += non_inv_solution(A_eig, b, solutions + n_solutions);
+        }
+    }
+    return n_solutions;
+}
+
+double shortest_distance(const WellSegment &w1, const WellSegment &w2) {
+    auto closest_p_q = closest_points_on_lines(w1.heel, w1.toe, w2.heel, w2.toe);
+    return (closest_p_q.second - closest_p_q.first).norm();
+}
+
+double shortest_distance(const WellSet &wells) {
+    double distance = INFINITY;
+    for (int i = 0; i < wells.size(); i++) {
+        for (int j = i + 1; j < wells.size(); j++) {
+            distance = std::min(distance, shortest_distance(wells[i], wells[j]));
+        }
+    }
+    return distance;
+}
+
+void well_length_projection(Vector3d &heel, Vector3d &toe, double max, double min, double epsilon) {
+    Vector3d heel_to_toe_vec = toe - heel;
+    double d = heel_to_toe_vec.norm();
+
+    // If heel and toe same point, all directions are equally good.
+    if (d == 0) {
+        Vector3d unit_vector = Vector3d(1, 0, 0);
+        toe = heel - (min / 2) * unit_vector;
+        heel = heel + (min / 2) * unit_vector;
+        return;
+    }
+    heel_to_toe_vec.normalize();
+
+    double move_distance;
+    if (d <= max && d >= min) { // Trivial case
+        return;
+    }
+    else if (d > max) { // Distance too long
+        move_distance = 0.5 * (d - max + (epsilon / 2));
+    }
+    else { // Distance too short
+        move_distance = 0.5 * (d - min - (epsilon / 2));
+    }
+    heel += move_distance * heel_to_toe_vec;
+    toe -= move_distance * heel_to_toe_vec;
+}
+
+bool interwell_constraint_projection(WellSegment &w1, WellSegment &w2, double d) {
+    if (shortest_distance(w1, w2) >= d) {
+        return true;
+    }
+    const Vector3d coords[4] = {w1.heel, w1.toe, w2.heel, w2.toe};
+    Vector3d moved_coords[4];
+    Vector3d solution_coords[4];
+    double cost = INFINITY;
+
+    // ################## 2 POINT PART ############################
+    const int two_point_index[4][2] = {{0, 2}, {0, 3}, {1, 2}, {1, 3}};
+    for (int ii = 0; ii < 4; ii++) {
+        std::copy(coords, coords + 4, moved_coords);
+        well_length_projection(moved_coords[two_point_index[ii][0]],
+                               moved_coords[two_point_index[ii][1]],
+                               INFINITY, d, 10e-5);
+        if (shortest_distance(moved_coords) >= d) {
+            double move_cost = movement_cost(coords, moved_coords);
+            if (move_cost < cost) {
+                cost = move_cost;
+                std::copy(moved_coords, moved_coords + 4, solution_coords);
+            }
+        }
+    }
+
+    // ################## 3 POINT PART ############################
+    Vector3d candidates[kMaxKktSolutions];
+    if (cost == INFINITY) {
+        const int three_point_index[4][3] = {{2, 0, 1}, {3, 0, 1}, {0, 2, 3}, {1, 2, 3}};
+        for (int ii = 0; ii < 4; ii++) {
+            std::copy(coords, coords + 4, moved_coords);
+            Vector3d input_coords_3p[3];
+            for (int jj = 0; jj < 3; jj++) {
+                input_coords_3p[jj] = coords[three_point_index[ii][jj]];
+            }
+            int n_candidates = kkt_eq_solutions(build_A_3p(input_coords_3p),
+                                                build_b_3p(input_coords_3p, d),
+                                                candidates);
+            for (int sol_num = 0; sol_num < n_candidates; sol_num++) {
+                Vector3d temp_coords[3];
+                move_points_3p(input_coords_3p, d, candidates[sol_num], temp_coords);
+                for (int jj = 0; jj < 3; jj++) {
+                    moved_coords[three_point_index[ii][jj]] = temp_coords[jj];
+                }
+                if (shortest_distance(moved_coords) >= d - 0.001) {
+                    double move_cost = movement_cost(coords, moved_coords);
+                    if (move_cost < cost) {
+                        cost = move_cost;
+                        std::copy(moved_coords, moved_coords + 4, solution_coords);
+                    }
+                }
+            }
+        }
+    }
+
+    // ################## 4 POINT PART ############################
+    if (cost == INFINITY) {
+        if (VERB_OPT >= 3) {
+            Printer::ext_warn("Found no 3-point solution. Trying 4 points.", "ConstraintMath", "BatchWellProjections");
+        }
+        int n_candidates = kkt_eq_solutions(build_A_4p(coords), build_b_4p(coords, d), candidates);
+        for (int sol_num = 0; sol_num < n_candidates; sol_num++) {
+            move_points_4p(coords, d, candidates[sol_num], moved_coords);
+            if (shortest_distance(moved_coords) >= d - 0.001) {
+                double move_cost = movement_cost(coords, moved_coords);
+                if (move_cost < cost) {
+                    cost = move_cost;
+                    std::copy(moved_coords, moved_coords + 4, solution_coords);
+                }
+            }
+        }
+    }
+
+    if (cost == INFINITY) {
+        if (VERB_OPT >= 2) {
+            Printer::ext_warn("Found no solution to interwell projection problem.", "ConstraintMath", "BatchWellProjections");
+        }
+        return false;
+    }
+    w1.heel = solution_coords[0];
+    w1.toe = solution_coords[1];
+    w2.heel = solution_coords[2];
+    w2.toe = solution_coords[3];
+    return true;
+}
+
+void interwell_constraint_multiple_wells(WellSet &wells, double d, double tol) {
+    double distance = 0;
+    int max_iter = 10000;
+    int iter = 0;
+    while (distance < d - tol && iter < max_iter) {
+        for (int i = 0; i < wells.size(); i++) {
+            for (int j = i + 1; j < wells.size(); j++) {
+                interwell_constraint_projection(wells[i], wells[j], d);
+            }
+        }
+        distance = shortest_distance(wells);
+        iter += 1;
+    }
+    if (iter == max_iter && VERB_OPT >= 1) {
+        Printer::ext_warn("No convergence in interwell distance constraints after "
+                              + Printer::num2str(iter) + " iterations.", "ConstraintMath", "BatchWellProjections");
+    }
+}
+
+void well_length_constraint_multiple_wells(WellSet &wells, double max, double min, double epsilon) {
+    for (WellSegment &well : wells) {
+        well_length_projection(well.heel, well.toe, max, min, epsilon);
+    }
+}
+
+bool feasible_well_length(const WellSet &wells, double max, double min, double tol) {
+    for (const WellSegment &well : wells) {
+        double well_length = (well.heel - well.toe).norm();
+        if (well_length < min - tol || well_length > max + tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool feasible_interwell_distance(const WellSet &wells, double d, double tol) {
+    return shortest_distance(wells) >= d - tol;
+}
+
+void both_constraints_multiple_wells(WellSet &wells, double d, double tol,
+                                     double max, double min, double epsilon) {
+    int iter = 0;
+    while (!feasible_interwell_distance(wells, d, 3 * tol) ||
+        !feasible_well_length(wells, max, min, tol)) {
+        well_length_constraint_multiple_wells(wells, max, min, epsilon);
+        interwell_constraint_multiple_wells(wells, d, tol);
+
+        iter += 1;
+        if (iter > 100) {
+            if (VERB_OPT >= 1) {
+                Printer::ext_warn("Above max number of iterations.", "ConstraintMath", "BatchWellProjections");
+            }
+            return;
+        }
+    }
+}
+
+void parallel_for(int n, const std::function<void(int)> &func, int n_threads) {
+    if (n_threads < 1) {
+        n_threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    n_threads = std::min(n_threads, n);
+    if (n_threads <= 1) {
+        for (int i = 0; i < n; ++i) {
+            func(i);
+        }
+        return;
+    }
+
+    // Elements are handed out one at a time, as the cost of a projection varies a lot
+    // depending on whether the 3- or 4-point problems have to be solved.
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (int i = next++; i < n; i = next++) {
+            func(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(n_threads - 1);
+    for (int t = 0; t < n_threads - 1; ++t) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void interwell_constraint_population(std::vector<WellSet> &population, double d, double tol, int n_threads) {
+    parallel_for(population.size(), [&](int i) {
+        interwell_constraint_multiple_wells(population[i], d, tol);
+    }, n_threads);
+}
+
+void both_constraints_population(std::vector<WellSet> &population, double d, double tol,
+                                 double max, double min, double epsilon, int n_threads) {
+    parallel_for(population.size(), [&](int i) {
+        both_constraints_multiple_wells(population[i], d, tol, max, min, epsilon);
+    }, n_threads);
+}
+
+}
+}
@@ -0,0 +1,124 @@
+#ifndef BATCH_WELL_PROJECTIONS_H
+#define BATCH_WELL_PROJECTIONS_H
+
+#include <Eigen/Dense>
+#include <functional>
+#include <vector>
+
+/*!
+ * \brief Fixed-size, in-place counterparts of the interwell distance and well length
+ * projections in WellConstraintProjections.
+ *
+ * The functions in the parent namespace operate on QList objects, and solve the KKT systems
+ * for one pair of wells at a time, allocating new lists (and dynamically sized Eigen objects)
+ * for every intermediate result. The functions in this namespace operate in-place on
+ * WellSegment objects and stack buffers of fixed-size Eigen types (the only remaining
+ * allocations are the ones made by the polynomial root finder), and the population functions
+ * project all the well sets in a generation (e.g. all the cases created by a GA or PSO iteration)
+ * in one call, distributing the sets over a number of threads.
+ *
+ * The algorithms, tolerances and the order in which point moves are tried are the same as
+ * in the QList-based functions, so both should yield the same projections.
+ */
+namespace WellConstraintProjections {
+namespace Batch {
+
+using namespace Eigen;
+
+/*!
+ * \brief A straight well segment defined by its heel and toe.
+ */
+struct WellSegment {
+  WellSegment() : heel(Vector3d::Zero()), toe(Vector3d::Zero()) {}
+  WellSegment(const Vector3d &h, const Vector3d &t) : heel(h), toe(t) {}
+  Vector3d heel;
+  Vector3d toe;
+};
+
+//! All the wells of a single case.
+typedef std::vector<WellSegment> WellSet;
+
+//! Maximum number of KKT candidates: six sextic roots plus two per eigenvalue of A.
+const int kMaxKktSolutions = 12;
+
+/*!
+ * \brief Find all potential KKT points (s) for the equation \f$(A - \mu I)s = b, \; length(s) = 1\f$.
+ * \param A The matrix A in the equation.
+ * \param b The vector b in the equation.
+ * \param solutions Buffer the candidates are written to.
+ * \return The number of candidates written to the buffer.
+ */
+int kkt_eq_solutions(const Matrix3d &A, const Vector3d &b, Vector3d (&solutions)[kMaxKktSolutions]);
+
+/*!
+ * \brief Shortest distance between two well segments.
+ */
+double shortest_distance(const WellSegment &w1, const WellSegment &w2);
+
+/*!
+ * \brief Shortest distance between any pair of wells in the set.
+ */
+double shortest_distance(const WellSet &wells);
+
+/*!
+ * \brief In-place version of WellConstraintProjections::well_length_projection.
+ */
+void well_length_projection(Vector3d &heel, Vector3d &toe, double max, double min, double epsilon);
+
+/*!
+ * \brief In-place version of WellConstraintProjections::interwell_constraint_projection.
+ *
+ * \param w1 First well segment.
+ * \param w2 Second well segment.
+ * \param d Minimum distance allowed between the two wells.
+ * \return True if a projection was found (or none was needed); if false, the wells are left unchanged.
+ */
+bool interwell_constraint_projection(WellSegment &w1, WellSegment &w2, double d);
+
+/*!
+ * \brief In-place version of WellConstraintProjections::interwell_constraint_multiple_wells.
+ */
+void interwell_constraint_multiple_wells(WellSet &wells, double d, double tol);
+
+/*!
+ * \brief In-place version of WellConstraintProjections::well_length_constraint_multiple_wells.
+ */
+void well_length_constraint_multiple_wells(WellSet &wells, double max, double min, double epsilon);
+
+bool feasible_well_length(const WellSet &wells, double max, double min, double tol);
+bool feasible_interwell_distance(const WellSet &wells, double d, double tol);
+
+/*!
+ * \brief In-place version of WellConstraintProjections::both_constraints_multiple_wells.
+ */
+void both_constraints_multiple_wells(WellSet &wells, double d, double tol,
+                                     double max, double min, double epsilon);
+
+/*!
+ * \brief Call func(i) for i in [0, n), distributing the calls over a number of threads.
+ *
+ * func must not touch shared state other than the i'th element of whatever it operates on.
+ * \param n Number of elements.
+ * \param func Function to be called for each element.
+ * \param n_threads Number of threads to use. If this is less than 1, the hardware concurrency is used.
+ */
+void parallel_for(int n, const std::function<void(int)> &func, int n_threads = 0);
+
+/*!
+ * \brief Project the wells in each of the sets (i.e. in each case of a population) so that
+ * they satisfy the interwell distance constraint.
+ */
+void interwell_constraint_population(std::vector<WellSet> &population, double d, double tol,
+                                     int n_threads = 0);
+
+/*!
+ * \brief Project the wells in each of the sets (i.e. in each case of a population) so that
+ * they satisfy both the interwell distance and the well length constraints.
+ */
+void both_constraints_population(std::vector<WellSet> &population, double d, double tol,
+                                 double max, double min, double epsilon, int n_threads = 0);
+
+}
+}
+
+#endif // BATCH_WELL_PROJECTIONS_H
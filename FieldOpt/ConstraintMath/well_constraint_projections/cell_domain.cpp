@@ -0,0 +1,177 @@
+#include "cell_domain.h"
+#include "well_constraint_projections.h"
+#include "batch_well_projections.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace WellConstraintProjections {
+
+namespace {
+
+/*!
+ * \brief Padding added to the bounding box of each cell, relative to the size of the box.
+ *
+ * The faces of corner point cells need not be planar, so the region bounded by the face
+ * planes may extend slightly beyond the corners of the cell. This is a heuristic bound:
+ * Project falls back to the full search if a cell's closest point is found outside it.
+ */
+const double kRelativePadding = 0.25;
+
+double box_distance(const AlignedBox3d &box, const Vector3d &point) {
+    return (box.min() - point).cwiseMax(point - box.max()).cwiseMax(0.0).norm();
+}
+
+}
+
+CellDomain::CellDomain(const QList<Reservoir::Grid::Cell> &cells) {
+    cells_.reserve(cells.size());
+    for (auto cell : cells) {
+        cells_.push_back(cell);
+    }
+    compile();
+}
+
+CellDomain::CellDomain(Reservoir::Grid::Grid *grid, const QList<int> &index_list) {
+    cells_.reserve(index_list.size());
+    for (int index : index_list) {
+        cells_.push_back(grid->GetCell(index));
+    }
+    compile();
+}
+
+void CellDomain::compile() {
+    half_spaces_.clear();
+    face_offsets_.assign(1, 0);
+    boxes_.clear();
+    bounding_box_.setEmpty();
+    for (auto &cell : cells_) {
+        for (auto face : cell.faces()) {
+            half_spaces_.push_back(HalfSpace{face.corners[0], face.normal_vector});
+        }
+        face_offsets_.push_back(half_spaces_.size());
+
+        AlignedBox3d box;
+        box.setEmpty();
+        for (auto corner : cell.corners()) {
+            box.extend(corner);
+        }
+        Vector3d padding = kRelativePadding * box.sizes()
+            + Vector3d::Constant(1e-9 * (1.0 + box.max().cwiseAbs().maxCoeff()));
+        box = AlignedBox3d(box.min() - padding, box.max() + padding);
+        boxes_.push_back(box);
+        bounding_box_.extend(box);
+    }
+
+    buckets_.clear();
+    if (cells_.empty()) {
+        nx_ = ny_ = 0;
+        return;
+    }
+
+    // Roughly one bucket per cell in a single layer of the domain
+    Vector3d sizes = bounding_box_.sizes();
+    int n_buckets = std::max(1, (int)cells_.size());
+    double aspect = sizes.y() > 0 ? sizes.x() / sizes.y() : 1.0;
+    nx_ = std::max(1, std::min(n_buckets, (int)std::lround(std::sqrt(n_buckets * aspect))));
+    ny_ = std::max(1, n_buckets / nx_);
+    dx_ = sizes.x() > 0 ? sizes.x() / nx_ : 1.0;
+    dy_ = sizes.y() > 0 ? sizes.y() / ny_ : 1.0;
+    buckets_.resize(nx_ * ny_);
+    for (int c = 0; c < boxes_.size(); ++c) {
+        int lower = bucketIndex(boxes_[c].min().x(), boxes_[c].min().y());
+        int upper = bucketIndex(boxes_[c].max().x(), boxes_[c].max().y());
+        for (int ix = lower % nx_; ix <= upper % nx_; ++ix) {
+            for (int iy = lower / nx_; iy <= upper / nx_; ++iy) {
+                buckets_[iy * nx_ + ix].push_back(c);
+            }
+        }
+    }
+}
+
+int CellDomain::bucketIndex(double x, double y) const {
+    int ix = (int)std::floor((x - bounding_box_.min().x()) / dx_);
+    int iy = (int)std::floor((y - bounding_box_.min().y()) / dy_);
+    ix = std::max(0, std::min(nx_ - 1, ix));
+    iy = std::max(0, std::min(ny_ - 1, iy));
+    return iy * nx_ + ix;
+}
+
+bool CellDomain::cellContains(int i, const Vector3d &point) const {
+    // Same test as Cell::EnvelopsPoint
+    for (int f = face_offsets_[i]; f < face_offsets_[i + 1]; ++f) {
+        if ((point - half_spaces_[f].point).dot(half_spaces_[f].normal) < 0)
+            return false;
+    }
+    return true;
+}
+
+bool CellDomain::Contains(const Vector3d &point) const {
+    if (cells_.empty() || !bounding_box_.contains(point))
+        return false;
+    for (int c : buckets_[bucketIndex(point.x(), point.y())]) {
+        if (boxes_[c].contains(point) && cellContains(c, point))
+            return true;
+    }
+    return false;
+}
+
+Vector3d CellDomain::Project(const Vector3d &point) const {
+    if (cells_.empty() || Contains(point))
+        return point;
+
+    // Visit the cells in order of increasing distance to their boxes, which is a lower bound
+    // for the distance to the cells, until no remaining cell can be closer than the best one.
+    // The cells are taken off a heap, so only the visited ones are ordered.
+    std::vector<std::pair<double, int>> order(cells_.size());
+    for (int c = 0; c < cells_.size(); ++c) {
+        order[c] = std::make_pair(box_distance(boxes_[c], point), c);
+    }
+    std::greater<std::pair<double, int>> closer;
+    std::make_heap(order.begin(), order.end(), closer);
+
+    double minimum = INFINITY;
+    int best_cell = cells_.size();
+    Vector3d best_point = point;
+    for (auto end = order.end(); end != order.begin(); --end) {
+        std::pop_heap(order.begin(), end, closer);
+        auto entry = *(end - 1);
+        if (entry.first > minimum)
+            break;
+        Vector3d temp_point = point_to_cell_shortest(cells_[entry.second], point);
+        if (!boxes_[entry.second].contains(temp_point)) {
+            // The padding does not cover this cell, so the box distances are not a safe bound
+            return projectFullSearch(point);
+        }
+        double distance = (point - temp_point).norm();
+        // Ties go to the first cell in the list, like in well_domain_constraint
+        if (distance < minimum || (distance == minimum && entry.second < best_cell)) {
+            best_point = temp_point;
+            best_cell = entry.second;
+            minimum = distance;
+        }
+    }
+    return best_point;
+}
+
+Vector3d CellDomain::projectFullSearch(const Vector3d &point) const {
+    double minimum = INFINITY;
+    Vector3d best_point = point;
+    for (auto &cell : cells_) {
+        Vector3d temp_point = point_to_cell_shortest(cell, point);
+        double distance = (point - temp_point).norm();
+        if (distance < minimum) {
+            best_point = temp_point;
+            minimum = distance;
+        }
+    }
+    return best_point;
+}
+
+void CellDomain::ProjectPoints(std::vector<Vector3d> &points, int n_threads) const {
+    Batch::parallel_for(points.size(), [&](int i) {
+        points[i] = Project(points[i]);
+    }, n_threads);
+}
+
+}
@@ -0,0 +1,92 @@
+#ifndef CELL_DOMAIN_H
+#define CELL_DOMAIN_H
+
+#include "Reservoir/grid/cell.h"
+#include "Reservoir/grid/grid.h"
+#include <Eigen/Geometry>
+#include <QList>
+#include <vector>
+
+namespace WellConstraintProjections {
+
+using namespace Eigen;
+
+/*!
+ * \brief The CellDomain class is a compiled representation of a domain made up of a set of
+ * grid cells, e.g. the box of a ReservoirBoundary constraint.
+ *
+ * The cells are fetched from the grid once. Each cell is then stored as the half-spaces
+ * bounding it (one point and the normal vector for each face) along with its bounding box,
+ * and the bounding boxes are bucketed in a regular raster over the x-y extent of the domain.
+ * A point is thus only tested against the faces of the few cells whose boxes contain it,
+ * rather than against every cell in the domain through Grid::GetCell.
+ *
+ * The domain is not assumed to be convex. The padding of the boxes is a heuristic for how
+ * far the region bounded by the face planes of a cell extends beyond its corners. Within
+ * that bound, Contains gives the same result as checking Cell::EnvelopsPoint for every cell,
+ * and Project gives the same result as well_domain_constraint. Project checks the bound for
+ * every cell it visits, and falls back to checking all the cells when it does not hold.
+ */
+class CellDomain {
+ public:
+  CellDomain() {}
+
+  /*!
+   * \brief Compile the domain made up of the cells in the list.
+   */
+  explicit CellDomain(const QList<Reservoir::Grid::Cell> &cells);
+
+  /*!
+   * \brief Compile the domain made up of the cells with the global indices in index_list.
+   */
+  CellDomain(Reservoir::Grid::Grid *grid, const QList<int> &index_list);
+
+  //! Check whether the point is inside, or on the boundary of, any of the cells.
+  bool Contains(const Vector3d &point) const;
+
+  /*!
+   * \brief Find the point in the domain closest to the given point.
+   * \return The projected point. If the point is already inside the domain, the same point.
+   */
+  Vector3d Project(const Vector3d &point) const;
+
+  /*!
+   * \brief Project all the points onto the domain, distributing them over a number of threads.
+   * \param points The points to be projected. Modified in-place.
+   * \param n_threads Number of threads to use. If this is less than 1, the hardware concurrency is used.
+   */
+  void ProjectPoints(std::vector<Vector3d> &points, int n_threads = 0) const;
+
+  //! The cells in the domain, in the order they were given.
+  const Reservoir::Grid::Cell &cell(int i) const { return cells_[i]; }
+
+  //! Bounding box of the entire domain.
+  const AlignedBox3d &bounding_box() const { return bounding_box_; }
+
+  int size() const { return cells_.size(); }
+
+ private:
+  struct HalfSpace {
+    Vector3d point;
+    Vector3d normal;
+  };
+
+  std::vector<Reservoir::Grid::Cell> cells_;
+  std::vector<HalfSpace> half_spaces_; //!< The half-spaces of cell i are [face_offsets_[i], face_offsets_[i+1]).
+  std::vector<int> face_offsets_;
+  std::vector<AlignedBox3d> boxes_; //!< Padded bounding box for each cell.
+  AlignedBox3d bounding_box_;
+
+  int nx_ = 0, ny_ = 0;
+  double dx_ = 1.0, dy_ = 1.0;
+  std::vector<std::vector<int>> buckets_; //!< Cells whose boxes overlap each bucket in the x-y raster.
+
+  void compile();
+  bool cellContains(int i, const Vector3d &point) const;
+  Vector3d projectFullSearch(const Vector3d &point) const; //!< Project by checking every cell.
+  int bucketIndex(double x, double y) const;
+};
+
+}
+
+#endif // CELL_DOMAIN_H
@@ -0,0 +1,166 @@
+#include "well_segment_index.h"
+#include <algorithm>
+
+namespace WellConstraintProjections {
+namespace Batch {
+
+namespace {
+
+/*!
+ * \brief Margin added to the pruning distance, so that rounding errors in the segment
+ * distance computations can never cause a pruned pair to be found closer than d.
+ */
+double pruning_distance(double d) {
+    return d + 1e-9 * (1.0 + fabs(d));
+}
+
+void append_endpoint_distances(const WellSegment &w1, const WellSegment &w2, std::vector<double> &distances) {
+    distances.push_back((w1.heel - w2.heel).norm()); // heel_i -> heel_j
+    distances.push_back((w1.toe - w2.toe).norm());   //  toe_i ->  toe_j
+    distances.push_back((w1.heel - w2.toe).norm());  // heel_i ->  toe_j
+    distances.push_back((w1.toe - w2.heel).norm());  //  toe_i -> heel_j
+}
+
+}
+
+WellSegmentIndex::WellSegmentIndex(const WellSet &wells) {
+    boxes_.resize(wells.size());
+    for (int i = 0; i < wells.size(); ++i) {
+        Update(i, wells[i]);
+    }
+}
+
+void WellSegmentIndex::Update(int i, const WellSegment &well) {
+    boxes_[i] = AlignedBox3d(well.heel.cwiseMin(well.toe), well.heel.cwiseMax(well.toe));
+}
+
+double WellSegmentIndex::BoxDistance(int i, int j) const {
+    Vector3d gaps = (boxes_[i].min() - boxes_[j].max()).cwiseMax(boxes_[j].min() - boxes_[i].max());
+    return gaps.cwiseMax(0.0).norm();
+}
+
+bool WellSegmentIndex::MayBeCloserThan(int i, int j, double d) const {
+    return BoxDistance(i, j) < pruning_distance(d);
+}
+
+std::vector<int> WellSegmentIndex::sweepOrder() const {
+    std::vector<int> order(boxes_.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return boxes_[a].min().x() < boxes_[b].min().x();
+    });
+    return order;
+}
+
+std::vector<std::pair<int, int>> WellSegmentIndex::CandidatePairs(double d) const {
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<int> order = sweepOrder();
+    for (int a = 0; a < order.size(); ++a) {
+        int i = order[a];
+        for (int b = a + 1; b < order.size(); ++b) {
+            int j = order[b];
+            if (boxes_[j].min().x() - boxes_[i].max().x() >= pruning_distance(d))
+                break; // All remaining boxes start even further along the x-axis
+            if (MayBeCloserThan(i, j, d))
+                pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+std::vector<std::pair<int, int>> WellSegmentIndex::CandidatePairs(double d, const std::vector<bool> &moved) const {
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < boxes_.size(); ++i) {
+        if (!moved[i]) continue;
+        for (int j = 0; j < boxes_.size(); ++j) {
+            // Pairs where both wells moved are added when i is the smaller index
+            if (j == i || (moved[j] && j < i)) continue;
+            if (MayBeCloserThan(i, j, d))
+                pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+void interwell_constraint_sweep(WellSet &wells, double d) {
+    WellSegmentIndex index(wells);
+    for (int i = 0; i < wells.size(); ++i) {
+        for (int j = i + 1; j < wells.size(); ++j) {
+            // Checked against the current boxes, as earlier projections may have moved the wells
+            if (!index.MayBeCloserThan(i, j, d))
+                continue;
+            interwell_constraint_projection(wells[i], wells[j], d);
+            index.Update(i, wells[i]);
+            index.Update(j, wells[j]);
+        }
+    }
+}
+
+bool interwell_constraint_satisfied(const WellSet &wells, double d, double precision, const std::vector<bool> &moved) {
+    WellSegmentIndex index(wells);
+    std::vector<std::pair<int, int>> pairs = moved.empty() ? index.CandidatePairs(d) : index.CandidatePairs(d, moved);
+    for (auto pair : pairs) {
+        WellSegment w1 = wells[pair.first];
+        WellSegment w2 = wells[pair.second];
+        if (!interwell_constraint_projection(w1, w2, d))
+            return false; // No solution was found
+        if (!wells[pair.first].heel.isApprox(w1.heel, precision) || !wells[pair.first].toe.isApprox(w1.toe, precision)
+            || !wells[pair.second].heel.isApprox(w2.heel, precision) || !wells[pair.second].toe.isApprox(w2.toe, precision))
+            return false;
+    }
+    return true;
+}
+
+std::vector<double> endpoint_distances(const WellSet &wells, double max_distance) {
+    std::vector<double> distances;
+    if (std::isinf(max_distance)) {
+        for (int i = 0; i < wells.size(); ++i) {
+            for (int j = i + 1; j < wells.size(); ++j) {
+                append_endpoint_distances(wells[i], wells[j], distances);
+            }
+        }
+    }
+    else {
+        for (auto pair : WellSegmentIndex(wells).CandidatePairs(max_distance)) {
+            append_endpoint_distances(wells[pair.first], wells[pair.second], distances);
+        }
+    }
+    return distances;
+}
+
+double minimum_endpoint_distance(const WellSet &wells) {
+    WellSegmentIndex index(wells);
+    std::vector<int> order(wells.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&wells](int a, int b) {
+        return std::min(wells[a].heel.x(), wells[a].toe.x()) < std::min(wells[b].heel.x(), wells[b].toe.x());
+    });
+
+    // Sweep along the x-axis, pruning pairs whose boxes are further apart than the best distance found so far
+    double minimum = INFINITY;
+    std::vector<double> distances;
+    for (int a = 0; a < order.size(); ++a) {
+        int i = order[a];
+        double max_x = std::max(wells[i].heel.x(), wells[i].toe.x());
+        for (int b = a + 1; b < order.size(); ++b) {
+            int j = order[b];
+            if (std::min(wells[j].heel.x(), wells[j].toe.x()) - max_x >= minimum)
+                break;
+            if (index.BoxDistance(i, j) >= minimum)
+                continue;
+            distances.clear();
+            append_endpoint_distances(wells[i], wells[j], distances);
+            minimum = std::min(minimum, *std::min_element(distances.begin(), distances.end()));
+        }
+    }
+    return minimum;
+}
+
+}
+}
@@ -0,0 +1,103 @@
+#ifndef WELL_SEGMENT_INDEX_H
+#define WELL_SEGMENT_INDEX_H
+
+#include "batch_well_projections.h"
+#include <Eigen/Geometry>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace WellConstraintProjections {
+namespace Batch {
+
+/*!
+ * \brief The WellSegmentIndex class is a broad phase for distance queries between the
+ * wells in a set.
+ *
+ * It keeps the axis-aligned bounding box for each well segment. The distance between the
+ * boxes of two wells is a lower bound for the distance between the wells, so pairs of
+ * wells whose boxes are at least d apart can never violate a minimum distance d, and need
+ * not be passed to the (expensive) projections. Pairs are found using sweep-and-prune
+ * along the x-axis, so a query is O(n log n + k) rather than O(n^2) for n wells and k
+ * nearby pairs.
+ */
+class WellSegmentIndex {
+ public:
+  explicit WellSegmentIndex(const WellSet &wells);
+
+  //! Update the bounding box for well i after it has been moved.
+  void Update(int i, const WellSegment &well);
+
+  //! Distance between the bounding boxes of wells i and j.
+  double BoxDistance(int i, int j) const;
+
+  /*!
+   * \brief Check whether wells i and j may be closer than d. If this returns false, the
+   * wells are guaranteed to be at least d apart.
+   */
+  bool MayBeCloserThan(int i, int j, double d) const;
+
+  /*!
+   * \brief Get all pairs of wells (i, j), i < j, that may be closer than d.
+   * \return The pairs, sorted in the order they would be visited by a double loop over the wells.
+   */
+  std::vector<std::pair<int, int>> CandidatePairs(double d) const;
+
+  /*!
+   * \brief Get all pairs of wells (i, j), i < j, that may be closer than d and where at least
+   * one of the wells is flagged in moved.
+   * \return The pairs, sorted in the order they would be visited by a double loop over the wells.
+   */
+  std::vector<std::pair<int, int>> CandidatePairs(double d, const std::vector<bool> &moved) const;
+
+  int size() const { return boxes_.size(); }
+
+ private:
+  std::vector<AlignedBox3d> boxes_;
+
+  //! Well indices sorted by the lower x-coordinate of their bounding boxes.
+  std::vector<int> sweepOrder() const;
+};
+
+/*!
+ * \brief Project every pair of wells in the set onto the interwell distance constraint, in
+ * the order of a double loop over the wells (i.e. (0,1), (0,2), ..., (1,2), ...).
+ *
+ * Pairs that are already far enough apart are skipped, as the projection would leave them
+ * unchanged. The result is the same as that of calling interwell_constraint_projection for
+ * every pair.
+ * \param wells The wells to be projected. Modified in-place.
+ * \param d Minimum distance allowed between any pair of wells.
+ */
+void interwell_constraint_sweep(WellSet &wells, double d);
+
+/*!
+ * \brief Check whether all pairs of wells satisfy the interwell distance constraint, i.e.
+ * whether projecting each pair leaves it (approximately) unchanged.
+ * \param wells The wells to check.
+ * \param d Minimum distance allowed between any pair of wells.
+ * \param precision The precision used when comparing the projected points to the original ones.
+ * \param moved Optional flags for the wells that have moved relative to a set of wells that is
+ * known to satisfy the constraint. If given, only pairs involving moved wells are checked.
+ * \return True if all (checked) pairs satisfy the constraint.
+ */
+bool interwell_constraint_satisfied(const WellSet &wells, double d, double precision,
+                                    const std::vector<bool> &moved = std::vector<bool>());
+
+/*!
+ * \brief Get the distances between the endpoints (heel-heel, toe-toe, heel-toe, toe-heel) of
+ * the pairs of wells that may be closer than max_distance, in the order of a double loop
+ * over the wells. The endpoint distances for pairs that are skipped are all at least max_distance.
+ */
+std::vector<double> endpoint_distances(const WellSet &wells, double max_distance = INFINITY);
+
+/*!
+ * \brief Get the smallest distance between the endpoints of any two wells in the set.
+ * \return The smallest distance, or infinity if there are fewer than two wells.
+ */
+double minimum_endpoint_distance(const WellSet &wells);
+
+}
+}
+
+#endif // WELL_SEGMENT_INDEX_H
@@ -21,6 +21,7 @@
 #include <boost/lexical_cast.hpp>
 #include "Utilities/verbosity.h"
 #include "Utilities/printer.hpp"
+#include "Utilities/tracing.hpp"
 
 namespace Model {
 
@@ -29,6 +30,9 @@ Model::Model(Settings::Settings settings, Logger *logger)
     if (settings.paths().IsSet(Paths::GRID_FILE)) {
         grid_ = new Reservoir::Grid::ECLGrid(settings.paths().GetPath(Paths::GRID_FILE));
         wic_ = new Reservoir::WellIndexCalculation::wicalc_rixx(grid_);
+        if (settings.simulator()->is_ensemble()) {
+            wic_->SetMaxCachedGrids(settings.simulator()->get_ensemble().MaxCachedGrids());
+        }
     }
     else {
         grid_ = 0;
@@ -60,6 +64,7 @@ void Model::Finalize() {
 
 void Model::ApplyCase(Optimization::Case *c)
 {
+    TRACE_SCOPE("ApplyCase", "Model");
 
     // Notify the logger to log previous case.
     if (current_case_ != nullptr && current_case_->state.eval != Optimization::Case::CaseState::EvalStatus::E_PENDING) {
@@ -70,6 +75,9 @@ void Model::ApplyCase(Optimization::Case *c)
         }
         logger_->AddEntry(this);
     }
+    // Set before applying, so that a case that fails to apply is the one logged next
+    current_case_id_ = c->id();
+    current_case_ = c;
 
     for (QUuid key : c->binary_variables().keys()) {
         variable_container_->SetBinaryVariableValue(key, c->binary_variables()[key]);
@@ -96,9 +104,6 @@ void Model::ApplyCase(Optimization::Case *c)
         c->SetWICTime(0);
     }
     verify();
-
-    current_case_id_ = c->id();
-    current_case_ = c;
 //    results_.clear();
 }
 
@@ -105,7 +105,7 @@ class Model : public Loggable
 
   Logger *logger_;
   QUuid current_case_id_;
-  Optimization::Case *current_case_; //!< Pointer to current case. Kept for logging purposes.
+  Optimization::Case *current_case_; //!< Pointer to current case. Kept for logging purposes; not owned, but must outlive the next ApplyCase call.
   QString compdat_; //!< The compdat generated from the list of well blocks corresponding to the current case. This is set by the simulator library.
   std::map<std::string, std::vector<double>> results_; //!< The results of the last simulation (i.e. the one performed with the current case).
 
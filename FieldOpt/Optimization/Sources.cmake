@@ -1,6 +1,7 @@
 SET(OPTIMIZATION_HEADERS
 	case.h
 	case_handler.h
+	case_pool.h
 	case_transfer_object.h
 	constraints/bhp_constraint.h
 	constraints/combined_spline_length_interwell_distance.h
@@ -38,18 +39,24 @@ SET(OPTIMIZATION_HEADERS
 	optimizers/RGARDD.h
 	optimizers/VFSA.h
     optimizers/SPSA.h
+	optimizers/LBFGSB.h
 	optimizers/bayesian_optimization/AcquisitionFunction.h
 	optimizers/bayesian_optimization/EGO.h
 	optimizers/bayesian_optimization/af_optimizers/AFCompassSearch.h
 	optimizers/bayesian_optimization/af_optimizers/AFOptimizer.h
 	optimizers/bayesian_optimization/af_optimizers/AFPSO.h
 	optimizers/compass_search.h
+	optimizers/finite_difference_gradient.h
 	optimizers/gss_patterns.hpp
+	portfolio_optimizer.h
+	screening/case_screener.h
+	screening/rbf_surrogate.h
 )
 
 SET(OPTIMIZATION_SOURCES
 	case.cpp
 	case_handler.cpp
+	case_pool.cpp
 	case_transfer_object.cpp
 	constraints/bhp_constraint.cpp
 	constraints/combined_spline_length_interwell_distance.cpp
@@ -86,12 +93,17 @@ SET(OPTIMIZATION_SOURCES
 	optimizers/RGARDD.cpp
 	optimizers/VFSA.cpp
     optimizers/SPSA.cpp
+	optimizers/LBFGSB.cpp
 	optimizers/bayesian_optimization/AcquisitionFunction.cpp
 	optimizers/bayesian_optimization/EGO.cpp
 	optimizers/bayesian_optimization/af_optimizers/AFCompassSearch.cpp
 	optimizers/bayesian_optimization/af_optimizers/AFOptimizer.cpp
 	optimizers/bayesian_optimization/af_optimizers/AFPSO.cpp
 	optimizers/compass_search.cpp
+	optimizers/finite_difference_gradient.cpp
+	portfolio_optimizer.cpp
+	screening/case_screener.cpp
+	screening/rbf_surrogate.cpp
 )
 
 SET(OPTIMIZATION_TESTS
@@ -114,8 +126,13 @@ SET(OPTIMIZATION_TESTS
 	tests/optimizers/test_vfsa.cpp
 	tests/optimizers/test_spsa.cpp
 	tests/optimizers/test_cma_es.cpp
+	tests/optimizers/test_portfolio.cpp
+	tests/optimizers/test_exhaustive_search_2d_vert.cpp
+	tests/optimizers/test_lbfgsb.cpp
+	tests/screening/test_case_screener.cpp
 	tests/test_case.cpp
 	tests/test_case_handler.cpp
+	tests/test_case_pool.cpp
 	tests/test_case_transfer_object.cpp
 	tests/test_normalizer.cpp
 )
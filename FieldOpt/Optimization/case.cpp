@@ -28,6 +28,11 @@
 
 namespace Optimization {
 
+CasePool &Case::Pool() {
+    static CasePool pool(sizeof(Case));
+    return pool;
+}
+
 Case::Case() {
     id_ = QUuid::createUuid();
     binary_variables_ = QHash<QUuid, bool>();
@@ -35,9 +40,15 @@ Case::Case() {
     real_variables_ = QHash<QUuid, double>();
     objective_function_value_ = std::numeric_limits<double>::max();
     sim_time_sec_ = 0;
+    sim_timeout_sec_ = 0;
+    sim_threads_ = 0;
     wic_time_sec_ = 0;
+    parent_ = nullptr;
     ensemble_realization_ = "";
     ensemble_ofvs_ = QHash<QString, double>();
+    fidelity_ = FINE;
+    coarse_ofv_ = std::numeric_limits<double>::max();
+    fine_ofv_ = std::numeric_limits<double>::max();
 }
 
 Case::Case(const QHash<QUuid, bool> &binary_variables, const QHash<QUuid, int> &integer_variables, const QHash<QUuid, double> &real_variables)
@@ -51,9 +62,15 @@ Case::Case(const QHash<QUuid, bool> &binary_variables, const QHash<QUuid, int> &
     real_id_index_map_ = real_variables_.keys();
     integer_id_index_map_ = integer_variables_.keys();
     sim_time_sec_ = 0;
+    sim_timeout_sec_ = 0;
+    sim_threads_ = 0;
     wic_time_sec_ = 0;
+    parent_ = nullptr;
     ensemble_realization_ = "";
     ensemble_ofvs_ = QHash<QString, double>();
+    fidelity_ = FINE;
+    coarse_ofv_ = std::numeric_limits<double>::max();
+    fine_ofv_ = std::numeric_limits<double>::max();
 }
 
 Case::Case(const Case *c)
@@ -67,13 +84,32 @@ Case::Case(const Case *c)
     real_id_index_map_ = c->real_id_index_map_;
     integer_id_index_map_ = c->integer_variables_.keys();
     sim_time_sec_ = 0;
+    sim_timeout_sec_ = 0;
+    sim_threads_ = 0;
     wic_time_sec_ = 0;
+    parent_ = nullptr;
     ensemble_realization_ = "";
     ensemble_ofvs_ = c->ensemble_ofvs_;
+    fidelity_ = FINE;
+    coarse_ofv_ = std::numeric_limits<double>::max();
+    fine_ofv_ = std::numeric_limits<double>::max();
+}
+
+void Case::Compact()
+{
+    binary_variables_ = QHash<QUuid, bool>();
+    integer_variables_ = QHash<QUuid, int>();
+    real_variables_ = QHash<QUuid, double>();
+    real_id_index_map_ = QList<QUuid>();
+    integer_id_index_map_ = QList<QUuid>();
+    compacted_ = true;
 }
 
 bool Case::Equals(const Case *other, double tolerance) const
 {
+    // Compacted cases have no variable values to compare
+    if (this->compacted_ || other->compacted_)
+        return false;
     // Check if number of variables are equal
     if (this->binary_variables().size() != other->binary_variables().size()
         || this->integer_variables().size() != other->integer_variables().size()
@@ -183,6 +219,7 @@ void Case::SetIntegerVarValues(Eigen::VectorXi vec) {
 
 void Case::set_origin_data(Case *parent, int direction_index, double step_length) {
     parent_ = parent;
+    parent_id_ = parent == nullptr ? QUuid() : parent->id();
     direction_index_ = direction_index;
     step_length_ = step_length;
 }
@@ -192,6 +229,7 @@ Loggable::LogTarget Case::GetLogTarget() {
 map <string, string> Case::GetState() {
     map<string, string> statemap;
     switch (state.eval) {
+        case CaseState::EvalStatus::E_CANCELLED: statemap["EvalSt"] = "CNCL"; break;
         case CaseState::EvalStatus::E_FAILED: statemap["EvalSt"] = "FAIL"; break;
         case CaseState::EvalStatus::E_TIMEOUT: statemap["EvalSt"] = "TMOT"; break;
         case CaseState::EvalStatus::E_PENDING: statemap["EvalSt"] = "PEND"; break;
@@ -227,6 +265,9 @@ map <string, vector<double>> Case::GetValues() {
     if (ensemble_ofvs_.size() > 1) {
         valmap["OFvSTD"] = vector<double>{GetEnsembleExpectedOfv().second};
     }
+    if (HasFidelityOfv(COARSE)) {
+        valmap["OFvCrs"] = vector<double>{coarse_ofv_};
+    }
     return valmap;
 }
 string Case::StringRepresentation(Model::Properties::VariablePropertyContainer *varcont) {
@@ -323,6 +364,24 @@ QPair<double, double> Case::GetEnsembleExpectedOfv() const {
     return pair;
 }
 
+void Case::SetFidelityOfv(const Fidelity fidelity, const double ofv) {
+    if (fidelity == COARSE)
+        coarse_ofv_ = ofv;
+    else
+        fine_ofv_ = ofv;
+}
+
+bool Case::HasFidelityOfv(const Fidelity fidelity) const {
+    double ofv = fidelity == COARSE ? coarse_ofv_ : fine_ofv_;
+    return ofv != std::numeric_limits<double>::max();
+}
+
+double Case::GetFidelityOfv(const Fidelity fidelity) const {
+    if (!HasFidelityOfv(fidelity))
+        throw ObjectiveFunctionException("The objective function value for this fidelity has not been set.");
+    return fidelity == COARSE ? coarse_ofv_ : fine_ofv_;
+}
+
 void Case::set_objective_function_value(double objective_function_value) {
     objective_function_value_ = objective_function_value;
 }
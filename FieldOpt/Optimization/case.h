@@ -27,6 +27,7 @@
 #include <Model/properties/variable_property_container.h>
 #include "Runner/loggable.hpp"
 #include "optimization_exceptions.h"
+#include "case_pool.h"
 
 namespace Optimization {
 
@@ -50,6 +51,17 @@ class Case : public Loggable
   Case(const Case &c) = delete;
   Case(const Case *c);
 
+  /*!
+   * @brief Cases are allocated from a CasePool, which reuses the memory of deleted cases.
+   *
+   * A Case is owned by whoever created it, unless it is handed over. Cases added to a
+   * CaseHandler are owned by the handler's optimizer. Functions returning copies (e.g.
+   * Perturb(), CaseTransferObject::CreateCase()) hand ownership of the copy to the caller.
+   */
+  static void *operator new(std::size_t size) { return Pool().Allocate(size); }
+  static void operator delete(void *p, std::size_t size) { Pool().Free(p, size); }
+  static CasePool &Pool(); //!< The pool cases are allocated from.
+
   /*!
    * @brief The CaseState struct holds information about the current
    * status of the Case object, such as whether or not it has been
@@ -57,6 +69,7 @@ class Case : public Loggable
    */
   struct CaseState {
     enum EvalStatus : int {
+      E_CANCELLED=-3, //!< The evaluation was cancelled because the case became obsolete.
       E_FAILED=-2, E_TIMEOUT=-1,
       E_PENDING=0,
       E_CURRENT=1, E_DONE=2,
@@ -68,6 +81,7 @@ class Case : public Loggable
       C_FEASIBLE=1, C_PROJECTED=2, C_PENALIZED=3,
     };
     enum QueueStatus : int {
+      Q_SCREENED=-2, //!< Removed from the queue by surrogate pre-screening.
       Q_DISCARDED=-1,
       Q_QUEUED=0,
       Q_DEQUEUED=1
@@ -126,6 +140,7 @@ class Case : public Loggable
 
   /*!
    * \brief Perturb Creates variations of this Case where the value of one variable has been changed.
+   * The caller takes ownership of the returned cases.
    *
    * If PLUS or MINUS is selected as the sign, _one_ case is returned. If PLUSMINUS is selected, _two_
    * cases are returned.
@@ -205,12 +220,39 @@ class Case : public Loggable
   void set_origin_data(Case* parent, int direction_index, double step_length);
 
   Case* origin_case() const { return parent_; }
+  QUuid origin_case_id() const { return parent_id_; } //!< Id of the origin case. Safe to use after it is deleted.
   int origin_direction_index() const { return direction_index_; }
   double origin_step_length() const { return step_length_; }
 
+  /*!
+   * @brief Drop the variable values of the case to save memory, keeping the id, the objective
+   * function value and the state. Used by the CaseHandler to compact long-superseded cases.
+   *
+   * A compacted case has no variables: it is never equal to another case, and it can not
+   * be used as a template for new cases.
+   */
+  void Compact();
+  bool IsCompacted() const { return compacted_; }
+
   void SetSimTime(const int sec) { sim_time_sec_ = sec; }
   int GetSimTime() const { return sim_time_sec_; }
 
+  /*!
+   * @brief Set the timeout for the simulation of this case. Set by the overseer when the
+   * runtime of the case has been predicted; 0 (the default) means that the worker should
+   * use its own timeout.
+   */
+  void SetSimTimeout(const int sec) { sim_timeout_sec_ = sec; }
+  int GetSimTimeout() const { return sim_timeout_sec_; }
+
+  /*!
+   * @brief Set the number of threads the simulation of this case may use. Set by the overseer
+   * when dynamic threads are enabled; 0 (the default) means that the worker should use the
+   * threads-per-simulation setting.
+   */
+  void SetSimThreads(const int threads) { sim_threads_ = threads; }
+  int GetSimThreads() const { return sim_threads_; }
+
   // Logger interface
   LogTarget GetLogTarget() override;
   map<string, string> GetState() override;
@@ -244,9 +286,19 @@ class Case : public Loggable
   QPair<double, double> GetEnsembleExpectedOfv() const;
   QHash<QString, double> GetRealizationOFVMap() const { return ensemble_ofvs_; }
 
+  // Multi-fidelity support
+  enum Fidelity : int { FINE=0, COARSE=1 };
+  void SetFidelity(const Fidelity fidelity) { fidelity_ = fidelity; } //!< Set the model to evaluate the case on next.
+  Fidelity GetFidelity() const { return fidelity_; }
+  void SetFidelityOfv(const Fidelity fidelity, const double ofv);
+  bool HasFidelityOfv(const Fidelity fidelity) const;
+  double GetFidelityOfv(const Fidelity fidelity) const; //!< Get the value from one model. Throws if it has not been set.
+
  private:
   QUuid id_; //!< Unique ID for the case.
   int sim_time_sec_;
+  int sim_timeout_sec_; //!< Timeout for the simulation of this case. 0 if not set.
+  int sim_threads_; //!< Number of threads for the simulation of this case. 0 if not set.
   int wic_time_sec_; //!< The number of seconds spent computing the well index for this case.
 
   double objective_function_value_;
@@ -256,14 +308,21 @@ class Case : public Loggable
 
   QList<QUuid> real_id_index_map_;
   QList<QUuid> integer_id_index_map_;
+  bool compacted_ = false; //!< Whether the variable values have been dropped.
 
   Case* parent_; //!< The parent of this trial point. Needed by the APPS algorithm.
+  QUuid parent_id_; //!< The id of the parent of this trial point.
   int direction_index_; //!< The direction index used to generate this trial point.
   double step_length_; //!< The step length used to generate this trial point.
 
   // Multiple realizations-support
   QString ensemble_realization_; //!< The realization to evaluate next. Used by workers when in parallel mode.
   QHash<QString, double> ensemble_ofvs_; //!< Map of objective function values from realization alias - value.
+
+  // Multi-fidelity support
+  Fidelity fidelity_; //!< The model to evaluate the case on next. Used by workers when in parallel mode.
+  double coarse_ofv_; //!< Objective function value from the coarse model.
+  double fine_ofv_; //!< Objective function value from the fine model.
 };
 
 }
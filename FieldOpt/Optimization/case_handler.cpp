@@ -26,9 +26,11 @@ CaseHandler::CaseHandler()
 {
     cases_ = QHash<QUuid, Case *>();
     evaluation_queue_ = QQueue<QUuid>();
-    evaluating_ = QList<QUuid>();
+    queued_ = QSet<QUuid>();
+    evaluating_ = QSet<QUuid>();
     evaluated_ = QList<QUuid>();
     evaluated_recently_ = QList<QUuid>();
+    compact_cursor_ = 0;
 
     nr_totl_ = 0;
     nr_eval_ = 0;
@@ -36,6 +38,7 @@ CaseHandler::CaseHandler()
     nr_timo_ = 0;
     nr_invl_ = 0;
     nr_fail_ = 0;
+    nr_cmpt_ = 0;
 }
 
 CaseHandler::CaseHandler(Case *base_case)
@@ -49,6 +52,7 @@ void CaseHandler::AddNewCase(Case *c)
 {
     c->state.queue = Case::CaseState::QueueStatus::Q_QUEUED;
     evaluation_queue_.enqueue(c->id());
+    queued_.insert(c->id());
     cases_[c->id()] = c;
     nr_totl_++;
 }
@@ -61,22 +65,30 @@ void CaseHandler::AddNewCases(QList<Case *> cases)
     }
 }
 
+void CaseHandler::AddEvaluatedCase(Case *c)
+{
+    c->state.queue = Case::CaseState::QueueStatus::Q_DEQUEUED;
+    cases_[c->id()] = c;
+    evaluated_.append(c->id());
+}
+
 Case *CaseHandler::GetNextCaseForEvaluation()
 {
     if (evaluation_queue_.size() == 0)
         throw CaseHandlerException(
             "The evaluation queue contains no cases.");
-    evaluating_.append(evaluation_queue_.head());
-    cases_[evaluation_queue_.head()]->state.queue = Case::CaseState::QueueStatus::Q_DEQUEUED;
-    return cases_[evaluation_queue_.dequeue()];
+    QUuid id = evaluation_queue_.dequeue();
+    queued_.remove(id);
+    evaluating_.insert(id);
+    cases_[id]->state.queue = Case::CaseState::QueueStatus::Q_DEQUEUED;
+    return cases_[id];
 }
 
 void CaseHandler::SetCaseEvaluated(const QUuid id)
 {
-    if (!evaluating_.contains(id))
+    if (!evaluating_.remove(id))
         throw CaseHandlerException(
             "The case id is not found in the list of cases being evaluated.");
-    evaluating_.removeAll(id);
     evaluated_.append(id);
     evaluated_recently_.append(id);
 
@@ -101,6 +113,13 @@ void CaseHandler::SetCaseState(QUuid id, Case::CaseState state, int wic_time, in
     cases_[id]->SetSimTime(sim_time);
 }
 
+void CaseHandler::SetCaseFidelityOfvs(QUuid id, const Case *evaluated) {
+    for (Case::Fidelity fidelity : {Case::FINE, Case::COARSE}) {
+        if (evaluated->HasFidelityOfv(fidelity))
+            cases_[id]->SetFidelityOfv(fidelity, evaluated->GetFidelityOfv(fidelity));
+    }
+}
+
 QList<Case *> CaseHandler::RecentlyEvaluatedCases() const
 {
     QList<Case *> recently_evaluated_cases = QList<Case *>();
@@ -144,9 +163,80 @@ QList<Case *> CaseHandler::EvaluatedCases() const
     }
     return evaluated_cases;
 }
+int CaseHandler::CompactEvaluatedCases(int keep_recent, const QSet<QUuid> &retain) {
+    int n_compacted = 0;
+    auto compact = [&](const QUuid &id, QList<QUuid> &still_retained) {
+        Case *c = cases_[id];
+        if (c->IsCompacted())
+            return;
+        if (retain.contains(id)) {
+            still_retained.append(id);
+            return;
+        }
+        c->Compact();
+        n_compacted++;
+    };
+
+    QList<QUuid> still_retained;
+    for (const QUuid &id : compact_pending_) {
+        compact(id, still_retained);
+    }
+    int end = evaluated_.size() - keep_recent;
+    for (; compact_cursor_ < end; ++compact_cursor_) {
+        compact(evaluated_[compact_cursor_], still_retained);
+    }
+    compact_pending_ = still_retained;
+    nr_cmpt_ += n_compacted;
+    return n_compacted;
+}
 void CaseHandler::DequeueCase(QUuid id) {
     cases_[id]->state.queue = Case::CaseState::QueueStatus::Q_DISCARDED;
-    evaluation_queue_.removeOne(id);
+    if (queued_.remove(id))
+        evaluation_queue_.removeOne(id);
+}
+void CaseHandler::ScreenOutCase(QUuid id) {
+    if (queued_.remove(id)) {
+        evaluation_queue_.removeOne(id);
+    }
+    else if (!evaluating_.remove(id)) {
+        throw CaseHandlerException(
+            "The case id is not found in the evaluation queue or in the list of cases being evaluated.");
+    }
+    cases_[id]->state.queue = Case::CaseState::QueueStatus::Q_SCREENED;
+    screened_out_.append(id);
+}
+void CaseHandler::CancelCase(QUuid id) {
+    if (queued_.remove(id)) {
+        cases_[id]->state.queue = Case::CaseState::QueueStatus::Q_DISCARDED;
+        evaluation_queue_.removeOne(id);
+    }
+    else if (!evaluating_.remove(id)) {
+        throw CaseHandlerException(
+            "The case id is not found in the evaluation queue or in the list of cases being evaluated.");
+    }
+    cases_[id]->state.eval = Case::CaseState::EvalStatus::E_CANCELLED;
+    cancelled_.append(id);
+}
+void CaseHandler::ReorderQueue(const QList<QUuid> &order) {
+    if (order.size() != evaluation_queue_.size())
+        throw CaseHandlerException(
+            "The new queue order must contain exactly the queued cases.");
+    for (QUuid id : order) {
+        if (!queued_.contains(id))
+            throw CaseHandlerException(
+                "The new queue order must contain exactly the queued cases.");
+    }
+    evaluation_queue_.clear();
+    for (QUuid id : order) {
+        evaluation_queue_.enqueue(id);
+    }
+}
+QList<Case *> CaseHandler::ScreenedOutCases() const {
+    QList<Case *> screened_out_cases = QList<Case *>();
+    for (QUuid id : screened_out_) {
+        screened_out_cases.append(cases_[id]);
+    }
+    return screened_out_cases;
 }
 Case *CaseHandler::GetCase(const QUuid id) const {
     return cases_[id];
@@ -22,9 +22,45 @@
 
 #include "case.h"
 #include <QQueue>
+#include <QSet>
 
 namespace Optimization {
 
+/*!
+ * @brief A read-only view of a list of case ids held by the CaseHandler, resolving each
+ * id to its case on access. Iterating a view does not copy the list.
+ *
+ * A view is invalidated when the underlying list is modified.
+ */
+class CaseView
+{
+ public:
+  class const_iterator
+  {
+   public:
+    const_iterator(QList<QUuid>::const_iterator it, const QHash<QUuid, Case *> *cases)
+        : it_(it), cases_(cases) {}
+    Case *operator*() const { return cases_->value(*it_); }
+    const_iterator &operator++() { ++it_; return *this; }
+    const_iterator &operator--() { --it_; return *this; }
+    bool operator==(const const_iterator &other) const { return it_ == other.it_; }
+    bool operator!=(const const_iterator &other) const { return it_ != other.it_; }
+   private:
+    QList<QUuid>::const_iterator it_;
+    const QHash<QUuid, Case *> *cases_;
+  };
+
+  CaseView(const QList<QUuid> *ids, const QHash<QUuid, Case *> *cases) : ids_(ids), cases_(cases) {}
+  const_iterator begin() const { return const_iterator(ids_->constBegin(), cases_); }
+  const_iterator end() const { return const_iterator(ids_->constEnd(), cases_); }
+  int size() const { return ids_->size(); }
+  Case *operator[](int i) const { return cases_->value(ids_->at(i)); }
+
+ private:
+  const QList<QUuid> *ids_;
+  const QHash<QUuid, Case *> *cases_;
+};
+
 /*!
  * \brief The CaseHandler class acts as a handler for cases for the optimizer. It keeps track of the cases
  * that have been evaluated and the ones that have not.
@@ -45,6 +81,12 @@ class CaseHandler
    */
   void AddNewCases(QList<Case *> cases);
 
+  /*!
+   * \brief AddEvaluatedCase Add a case that was evaluated elsewhere, e.g. in a previous run,
+   * directly to the list of evaluated cases. It is not counted as simulated.
+   */
+  void AddEvaluatedCase(Case *c);
+
   /*!
    * \brief GetNextCaseForEvaluation Get the next case to be evaluated.
    *
@@ -83,6 +125,14 @@ class CaseHandler
    */
   void SetCaseState(QUuid id, Case::CaseState state, int wic_time, int sim_time);
 
+  /*!
+   * @brief Copy the coarse and fine model objective function values that have been set
+   * for an evaluated case to the stored case (see UpdateCaseObjectiveFunctionValue).
+   * @param id The id of the case to update.
+   * @param evaluated The evaluated copy of the case.
+   */
+  void SetCaseFidelityOfvs(QUuid id, const Case *evaluated);
+
   /*!
    * \brief RecentlyEvaluatedCases Get the list of cases that has been marked as evaluated since the last
    * time ClearRecentlyEvaluatedCases() was called.
@@ -111,6 +161,31 @@ class CaseHandler
    */
   QList<Case *> EvaluatedCases() const;
 
+  /*!
+   * @brief Get a view of the evaluated cases, in the order they were evaluated.
+   * Unlike EvaluatedCases(), this does not build a new list.
+   */
+  CaseView EvaluatedCasesView() const { return CaseView(&evaluated_, &cases_); }
+
+  /*!
+   * @brief Get a view of the recently evaluated cases (see RecentlyEvaluatedCases()).
+   */
+  CaseView RecentlyEvaluatedCasesView() const { return CaseView(&evaluated_recently_, &cases_); }
+
+  /*!
+   * @brief Drop the variable values of evaluated cases that have been superseded,
+   * keeping their id, objective function value and state (see Case::Compact()).
+   *
+   * All evaluated cases except the most recent keep_recent ones, and except the ones
+   * in retain, are compacted. Retained cases are compacted by a later call, once they
+   * are no longer retained. Each case is visited a bounded number of times, so the
+   * cost is proportional to the number of cases evaluated since the last call.
+   * @param keep_recent Number of most recently evaluated cases to leave untouched.
+   * @param retain Ids of cases that are still in use by the optimizer.
+   * @return The number of cases compacted by this call.
+   */
+  int CompactEvaluatedCases(int keep_recent, const QSet<QUuid> &retain);
+
   /*!
    * @brief Get _all_ cases.
    */
@@ -122,19 +197,59 @@ class CaseHandler
    */
   void DequeueCase(QUuid id);
 
+  /*!
+   * @brief Remove a case from the queue, or from the cases being evaluated, because it was
+   * screened out by a surrogate model. The case is marked with the Q_SCREENED queue status
+   * and kept in the list of screened out cases; it is not considered evaluated.
+   * @param id UUID of the case to be screened out.
+   */
+  void ScreenOutCase(QUuid id);
+
+  /*!
+   * @brief Cancel a queued case, or a case that is being evaluated, because it has become
+   * obsolete. The case is marked with the E_CANCELLED evaluation status and kept in the
+   * list of cancelled cases; it is not considered evaluated.
+   * @param id UUID of the case to be cancelled.
+   */
+  void CancelCase(QUuid id);
+
+  /*!
+   * @brief Replace the order of the evaluation queue.
+   * @param order UUIDs of the cases in the queue, in the order they should be evaluated.
+   * Must contain exactly the cases that are currently queued.
+   */
+  void ReorderQueue(const QList<QUuid> &order);
+
+  /*!
+   * @brief Get the cases that have been screened out.
+   */
+  QList<Case *> ScreenedOutCases() const;
+
   int NumberTotal() const { return nr_totl_; }
   int NumberSimulated() const { return nr_eval_; }
   int NumberBookkeeped() const { return nr_bkpd_; }
   int NumberTimeout() const { return  nr_timo_; }
   int NumberInvalid() const { return nr_invl_; }
   int NumberFailed() const { return nr_fail_; }
+  int NumberScreenedOut() const { return screened_out_.size(); }
+  int NumberCancelled() const { return cancelled_.size(); }
+  int NumberQueued() const { return evaluation_queue_.size(); }
+  int NumberBeingEvaluated() const { return evaluating_.size(); }
+  int NumberEvaluated() const { return evaluated_.size(); }
+  int NumberRecentlyEvaluated() const { return evaluated_recently_.size(); }
+  int NumberCompacted() const { return nr_cmpt_; }
 
  private:
   QQueue<QUuid> evaluation_queue_; //!< Queue of the next keys to be evaluated.
-  QList<QUuid> evaluating_; //!< List of keys for Cases currently being evaluated.
+  QSet<QUuid> queued_; //!< Set of the keys in the evaluation queue.
+  QSet<QUuid> evaluating_; //!< Set of keys for Cases currently being evaluated.
   QList<QUuid> evaluated_; //!< List of keys for Cases that have already been evaluated.
   QList<QUuid> evaluated_recently_; //!< List of keys that have recently been evaluated.
+  QList<QUuid> screened_out_; //!< List of keys for Cases that were screened out of the queue.
+  QList<QUuid> cancelled_; //!< List of keys for Cases that were cancelled because they became obsolete.
   QHash<QUuid, Case *> cases_;
+  int compact_cursor_; //!< Index in evaluated_ up to which cases have been considered for compaction.
+  QList<QUuid> compact_pending_; //!< Cases that were retained at the last compaction.
 
   int nr_totl_; //!< Total number of cases added to handler.
   int nr_eval_; //!< Number of cases that have been simulated.
@@ -142,6 +257,7 @@ class CaseHandler
   int nr_timo_; //!< Number of cases interrupted because of timeout.
   int nr_invl_; //!< Number of invalid cases (failed while being applied to model).
   int nr_fail_; //!< Number of cases that have failed for some reason.
+  int nr_cmpt_; //!< Number of cases that have been compacted.
 };
 
 }
@@ -0,0 +1,84 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "case_pool.h"
+#include <algorithm>
+#include <new>
+
+namespace Optimization {
+
+CasePool::CasePool(std::size_t object_size, int slots_per_chunk) {
+    const std::size_t alignment = alignof(std::max_align_t);
+    object_size_ = object_size;
+    slot_size_ = std::max(object_size, sizeof(Slot));
+    slot_size_ = (slot_size_ + alignment - 1) / alignment * alignment;
+    slots_per_chunk_ = slots_per_chunk;
+    free_list_ = nullptr;
+    n_live_ = 0;
+}
+
+void *CasePool::Allocate(std::size_t size) {
+    if (size != object_size_) {
+        return ::operator new(size);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_list_ == nullptr) {
+        // new[] of char returns memory aligned for any fundamental type
+        chunks_.emplace_back(new char[slot_size_ * slots_per_chunk_]);
+        char *chunk = chunks_.back().get();
+        for (int i = slots_per_chunk_ - 1; i >= 0; --i) {
+            Slot *slot = reinterpret_cast<Slot *>(chunk + i * slot_size_);
+            slot->next = free_list_;
+            free_list_ = slot;
+        }
+    }
+    Slot *slot = free_list_;
+    free_list_ = slot->next;
+    n_live_++;
+    return slot;
+}
+
+void CasePool::Free(void *p, std::size_t size) {
+    if (p == nullptr) {
+        return;
+    }
+    if (size != object_size_) {
+        ::operator delete(p);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = static_cast<Slot *>(p);
+    slot->next = free_list_;
+    free_list_ = slot;
+    n_live_--;
+}
+
+int CasePool::NumberLive() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return n_live_;
+}
+
+int CasePool::NumberSlots() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size() * slots_per_chunk_;
+}
+
+std::size_t CasePool::ReservedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size() * slots_per_chunk_ * slot_size_;
+}
+
+}
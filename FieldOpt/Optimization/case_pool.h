@@ -0,0 +1,74 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_CASE_POOL_H
+#define FIELDOPT_CASE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Optimization {
+
+/*!
+ * @brief The CasePool class is a fixed-size object pool that Case objects are allocated
+ * from (see Case::operator new).
+ *
+ * Memory is reserved in chunks of slots. Slots freed by deleting a Case are put on a free
+ * list and reused by the next allocation, so a run that keeps creating and deleting copies
+ * of cases (e.g. the copies received from MPI workers) does not fragment the heap. Chunks
+ * are never returned to the system; the number of live objects and the reserved memory are
+ * reported so that leaks show up in the optimizer log.
+ *
+ * Requests for any other size than the object size (i.e. for classes derived from Case)
+ * are passed on to the global operator new.
+ */
+class CasePool {
+ public:
+  /*!
+   * @param object_size Size of the objects allocated from the pool.
+   * @param slots_per_chunk Number of objects to reserve memory for at a time.
+   */
+  CasePool(std::size_t object_size, int slots_per_chunk=256);
+
+  CasePool(const CasePool &) = delete;
+  CasePool &operator=(const CasePool &) = delete;
+
+  void *Allocate(std::size_t size); //!< Get a slot for an object of the given size.
+  void Free(void *p, std::size_t size); //!< Return a slot to the pool.
+
+  int NumberLive() const; //!< Number of objects currently allocated from the pool.
+  int NumberSlots() const; //!< Number of slots reserved, free or not.
+  std::size_t ReservedBytes() const; //!< Memory reserved by the pool, in bytes.
+
+ private:
+  struct Slot {
+    Slot *next;
+  };
+
+  std::size_t slot_size_; //!< Object size, rounded up to keep the slots aligned.
+  std::size_t object_size_;
+  int slots_per_chunk_;
+  mutable std::mutex mutex_;
+  Slot *free_list_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  int n_live_;
+};
+
+}
+
+#endif //FIELDOPT_CASE_POOL_H
@@ -34,12 +34,18 @@ CaseTransferObject::CaseTransferObject(Optimization::Case *c) {
     real_variables_ = qHashToStdMap(c->real_variables_);
     wic_time_secs_ = c->GetWICTime();
     sim_time_secs_ = c->GetSimTime();
+    sim_timeout_secs_ = c->GetSimTimeout();
+    sim_threads_ = c->GetSimThreads();
     ensemble_realization_ = c->GetEnsembleRealization().toStdString();
 
     status_eval_ = c->state.eval;
     status_cons_ = c->state.cons;
     status_queue_ = c->state.queue;
     status_err_msg_ = c->state.err_msg;
+
+    fidelity_ = c->fidelity_;
+    coarse_ofv_ = c->coarse_ofv_;
+    fine_ofv_ = c->fine_ofv_;
 }
 
 Case *CaseTransferObject::CreateCase() {
@@ -51,11 +57,16 @@ Case *CaseTransferObject::CreateCase() {
     c->objective_function_value_ = objective_function_value_;
     c->SetWICTime(wic_time_secs_);
     c->SetSimTime(sim_time_secs_);
+    c->SetSimTimeout(sim_timeout_secs_);
+    c->SetSimThreads(sim_threads_);
     c->SetEnsembleRealization(QString::fromStdString(ensemble_realization_));
     c->state.eval = static_cast<Case::CaseState::EvalStatus>(status_eval_);
     c->state.cons = static_cast<Case::CaseState::ConsStatus>(status_cons_);
     c->state.queue = static_cast<Case::CaseState::QueueStatus>(status_queue_);
     c->state.err_msg = static_cast<Case::CaseState::ErrorMessage >(status_err_msg_);
+    c->fidelity_ = static_cast<Case::Fidelity>(fidelity_);
+    c->coarse_ofv_ = coarse_ofv_;
+    c->fine_ofv_ = fine_ofv_;
     return c;
 }
 
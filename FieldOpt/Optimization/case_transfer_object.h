@@ -52,10 +52,15 @@ class CaseTransferObject {
       ar & ensemble_realization_;
       ar & wic_time_secs_;
       ar & sim_time_secs_;
+      ar & sim_timeout_secs_;
+      ar & sim_threads_;
       ar & status_eval_;
       ar & status_cons_;
       ar & status_queue_;
       ar & status_err_msg_;
+      ar & fidelity_;
+      ar & coarse_ofv_;
+      ar & fine_ofv_;
   }
 
  public:
@@ -70,7 +75,7 @@ class CaseTransferObject {
 
   /*!
    * @brief Create a Case object corresponding to this CaseTransferObject.
-   * @return
+   * @return A new Case, owned by the caller.
    */
   Case *CreateCase();
 
@@ -93,6 +98,8 @@ class CaseTransferObject {
   double objective_function_value_;
   int wic_time_secs_;
   int sim_time_secs_;
+  int sim_timeout_secs_;
+  int sim_threads_;
   map<uuid, bool> binary_variables_;
   map<uuid, int> integer_variables_;
   map<uuid, double> real_variables_;
@@ -104,6 +111,10 @@ class CaseTransferObject {
   int status_queue_;
   int status_err_msg_;
 
+  int fidelity_;
+  double coarse_ofv_;
+  double fine_ofv_;
+
   QUuid boostUuidToQuuid(const uuid buuid) const; //!< Create a QUuid from a boost::uuid.
   uuid qUuidToBoostUuid(const QUuid quuid) const; //!< Create a boost::uuid from a Quuid.
   QString boostUuidToQstring(const uuid buuid) const; //!< Get the string representing a boost::uuid.
@@ -11,6 +11,9 @@ namespace Optimization {
                 Reservoir::Grid::Grid *grid)
         {
             max_iterations_ = settings.max_iterations;
+            min_length_ = settings.min_length;
+            max_length_ = settings.max_length;
+            min_distance_ = settings.min_distance;
             Settings::Optimizer::Constraint dist_constr_settings;
             dist_constr_settings.wells = settings.wells;
             dist_constr_settings.min = settings.min_distance;
@@ -34,6 +37,7 @@ namespace Optimization {
                 boundary_constraint_settings.box_kmax = settings.box_kmax;
                 boundary_constraint_settings.well = wname;
                 boundary_constraints_.append(new ReservoirBoundary(boundary_constraint_settings, variables, grid));
+                affected_wells_.append(initializeWell(variables->GetWellSplineVariables(wname)));
             }
         }
 
@@ -71,6 +75,88 @@ namespace Optimization {
                 }
             }
         }
+
+        void CombinedSplineLengthInterwellDistanceReservoirBoundary
+        ::SnapCasesToConstraints(QList<Case *> cases)
+        {
+            using WellConstraintProjections::Batch::WellSet;
+            QList<Case *> pending = cases;
+            for (int i = 0; i < max_iterations_ && pending.size() > 0; ++i) {
+                std::vector<WellSet> well_sets = getWellSets(pending);
+                std::vector<char> satisfied(well_sets.size());
+                WellConstraintProjections::Batch::parallel_for(well_sets.size(), [&](int k) {
+                    satisfied[k] = projectDistanceAndLength(well_sets[k]);
+                });
+
+                QList<Case *> unsatisfied;
+                for (int k = 0; k < pending.size(); ++k) {
+                    bool case_satisfied = satisfied[k];
+                    for (ReservoirBoundary *rb : boundary_constraints_) {
+                        if (!case_satisfied) break;
+                        case_satisfied = rb->CaseSatisfiesConstraint(pending[k]);
+                    }
+                    if (case_satisfied)
+                        continue;
+
+                    setWellSet(pending[k], well_sets[k]);
+                    for (ReservoirBoundary *rb : boundary_constraints_) {
+                        rb->SnapCaseToConstraints(pending[k]);
+                    }
+                    unsatisfied.append(pending[k]);
+                }
+                pending = unsatisfied;
+            }
+        }
+
+        std::vector<WellConstraintProjections::Batch::WellSet> CombinedSplineLengthInterwellDistanceReservoirBoundary
+        ::getWellSets(QList<Case *> cases)
+        {
+            std::vector<WellConstraintProjections::Batch::WellSet> well_sets(cases.size());
+            for (int k = 0; k < cases.size(); ++k) {
+                for (Well well : affected_wells_) {
+                    auto endpoints = GetEndpointValueVectors(cases[k], well);
+                    well_sets[k].push_back(WellConstraintProjections::Batch::WellSegment(endpoints.first, endpoints.second));
+                }
+            }
+            return well_sets;
+        }
+
+        void CombinedSplineLengthInterwellDistanceReservoirBoundary
+        ::setWellSet(Case *c, const WellConstraintProjections::Batch::WellSet &wells)
+        {
+            for (int i = 0; i < affected_wells_.size(); ++i) {
+                c->set_real_variable_value(affected_wells_[i].heel.x, wells[i].heel(0));
+                c->set_real_variable_value(affected_wells_[i].heel.y, wells[i].heel(1));
+                c->set_real_variable_value(affected_wells_[i].heel.z, wells[i].heel(2));
+
+                c->set_real_variable_value(affected_wells_[i].toe.x, wells[i].toe(0));
+                c->set_real_variable_value(affected_wells_[i].toe.y, wells[i].toe(1));
+                c->set_real_variable_value(affected_wells_[i].toe.z, wells[i].toe(2));
+            }
+        }
+
+        bool CombinedSplineLengthInterwellDistanceReservoirBoundary
+        ::projectDistanceAndLength(WellConstraintProjections::Batch::WellSet &wells) const
+        {
+            using namespace WellConstraintProjections;
+            const Batch::WellSet original = wells;
+
+            // Same tolerances as in InterwellDistance and WellSplineLength
+            bool satisfied = Batch::interwell_constraint_satisfied(original, min_distance_, 0.01);
+            Batch::interwell_constraint_sweep(wells, min_distance_);
+            for (int i = 0; i < original.size() && satisfied; ++i) {
+                Eigen::Vector3d heel = original[i].heel;
+                Eigen::Vector3d toe = original[i].toe;
+                Batch::well_length_projection(heel, toe, max_length_, min_length_, 0.001);
+                satisfied = original[i].heel.isApprox(heel, 0.01) && original[i].toe.isApprox(toe, 0.01);
+            }
+
+            for (Batch::WellSegment &well : wells) {
+                Batch::well_length_projection(well.heel, well.toe, max_length_, min_length_, 0.001);
+            }
+            return satisfied;
+        }
+
     bool CombinedSplineLengthInterwellDistanceReservoirBoundary::IsBoundConstraint() const {
         return true;
     }
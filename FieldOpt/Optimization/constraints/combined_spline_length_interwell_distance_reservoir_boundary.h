@@ -5,6 +5,8 @@
 #include "well_spline_length.h"
 #include "interwell_distance.h"
 #include "reservoir_boundary.h"
+#include "well_spline_constraint.h"
+#include "ConstraintMath/well_constraint_projections/well_segment_index.h"
 
 namespace Optimization { namespace Constraints {
 /*!
@@ -15,9 +17,13 @@ namespace Optimization { namespace Constraints {
  * number of iterations is reached.
  * The class instantiates one well length constraint per well, _one_ distance constraint
  * and _one_ reservoir boundary constraint.
+ *
+ * When a batch of cases is snapped, the distance and length projections for all cases
+ * are computed in parallel using the fixed-size WellConstraintProjections::Batch functions,
+ * while the reservoir boundary projections are applied sequentially.
  */
 
-class CombinedSplineLengthInterwellDistanceReservoirBoundary : public Constraint
+class CombinedSplineLengthInterwellDistanceReservoirBoundary : public Constraint, WellSplineConstraint
 {
  public:
   CombinedSplineLengthInterwellDistanceReservoirBoundary(
@@ -34,12 +40,33 @@ class CombinedSplineLengthInterwellDistanceReservoirBoundary : public Constraint
  public:
   bool CaseSatisfiesConstraint(Case *c);
   void SnapCaseToConstraints(Case *c);
+  void SnapCasesToConstraints(QList<Case *> cases) override;
 
  private:
   int max_iterations_;
+  double min_length_;
+  double max_length_;
+  double min_distance_;
+  QList<Well> affected_wells_;
   QList<WellSplineLength *> length_constraints_;
   QList<ReservoirBoundary *> boundary_constraints_;
   InterwellDistance *distance_constraint_;
+
+  //! Get the heel and toe of each of the affected wells in the cases.
+  std::vector<WellConstraintProjections::Batch::WellSet> getWellSets(QList<Case *> cases);
+
+  //! Set the heel and toe variable values for the affected wells in the case.
+  void setWellSet(Case *c, const WellConstraintProjections::Batch::WellSet &wells);
+
+  /*!
+   * @brief Apply the interwell distance and well length projections to a set of wells.
+   *
+   * Corresponds to the distance and length parts of CaseSatisfiesConstraint and
+   * SnapCaseToConstraints.
+   * @param wells The wells to be projected. Modified in-place.
+   * @return True if the wells satisfied the distance and length constraints before projection.
+   */
+  bool projectDistanceAndLength(WellConstraintProjections::Batch::WellSet &wells) const;
 };
 
 }}
@@ -32,6 +32,12 @@ void Constraint::EnableLogging(QString output_directory_path) {
     constraint_log_path_ = output_directory_path + "/log_constraints.txt";
 }
 
+void Constraint::SnapCasesToConstraints(QList<Case *> cases) {
+    for (Case *c : cases) {
+        SnapCaseToConstraints(c);
+    }
+}
+
 void Constraint::SetVerbosityLevel(int level) {
     verbosity_level_ = level;
 }
@@ -51,6 +51,16 @@ class Constraint
    */
   virtual void SnapCaseToConstraints(Case *c) = 0;
 
+  /*!
+   * \brief SnapCasesToConstraints Snaps all variable values in each of the cases to the
+   * closest value that satisfies the constraint.
+   *
+   * This default implementation calls SnapCaseToConstraints for each case. Constraints
+   * with expensive projections should override this to process the cases as a batch.
+   * \param cases The cases that should have their variable values snapped.
+   */
+  virtual void SnapCasesToConstraints(QList<Case *> cases);
+
   virtual void EnableLogging(QString output_directory_path);
   virtual void SetVerbosityLevel(int level);
 
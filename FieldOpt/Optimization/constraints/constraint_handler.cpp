@@ -181,6 +181,24 @@ void ConstraintHandler::SnapCaseToConstraints(Case *c)
     }
 
 }
+void ConstraintHandler::SnapCasesToConstraints(QList<Case *> cases)
+{
+    QList<Eigen::VectorXd> vecs_before;
+    for (Case *c : cases) {
+        vecs_before.append(c->GetRealVarVector());
+    }
+    for (Constraint *constraint : constraints_) {
+        constraint->SnapCasesToConstraints(cases);
+    }
+    for (int i = 0; i < cases.size(); ++i) {
+        if (vecs_before[i] != cases[i]->GetRealVarVector()) {
+            cases[i]->state.cons = Case::CaseState::ConsStatus::C_PROJECTED;
+        }
+        else {
+            cases[i]->state.cons = Case::CaseState::ConsStatus::C_FEASIBLE;
+        }
+    }
+}
 bool ConstraintHandler::HasBoundaryConstraints() const {
     for (int i = 0; i < constraints_.size(); ++i) {
         if (constraints_[i]->IsBoundConstraint()) {
@@ -59,6 +59,7 @@ class ConstraintHandler
                     Reservoir::Grid::Grid *grid);
   bool CaseSatisfiesConstraints(Case *c); //!< Check if a Case satisfies _all_ constraints.
   void SnapCaseToConstraints(Case *c); //!< Snap all variables to _all_ constraints.
+  void SnapCasesToConstraints(QList<Case *> cases); //!< Snap all variables in all cases to _all_ constraints.
 
   QList<Constraint *> constraints() const { return constraints_; }
 
@@ -18,7 +18,6 @@
 ******************************************************************************/
 
 #include "interwell_distance.h"
-#include "ConstraintMath/well_constraint_projections/well_constraint_projections.h"
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include "Utilities/verbosity.h"
@@ -36,94 +35,92 @@ InterwellDistance::InterwellDistance(Settings::Optimizer::Constraint settings,
     for (QString name : settings.wells) {
         affected_wells_.append(initializeWell(variables->GetWellSplineVariables(name)));
     }
-    if (affected_wells_.length() != 2) {
-        throw std::runtime_error("Currently, the Interwell Distance constraint must be applied to exactly two wells. Found " + boost::lexical_cast<std::string>(affected_wells_.length()));
+    if (affected_wells_.length() < 2) {
+        throw std::runtime_error("The Interwell Distance constraint must be applied to at least two wells. Found " + boost::lexical_cast<std::string>(affected_wells_.length()));
     }
 }
 
 bool InterwellDistance::CaseSatisfiesConstraint(Case *c)
 {
-    QList<Eigen::Vector3d> points;
-    for (Well well : affected_wells_) {
-        double heel_x_val = c->real_variables()[well.heel.x];
-        double heel_y_val = c->real_variables()[well.heel.y];
-        double heel_z_val = c->real_variables()[well.heel.z];
-
-        double toe_x_val = c->real_variables()[well.toe.x];
-        double toe_y_val = c->real_variables()[well.toe.y];
-        double toe_z_val = c->real_variables()[well.toe.z];
-
-        Eigen::Vector3d heel_vals;
-        Eigen::Vector3d toe_vals;
-        heel_vals << heel_x_val, heel_y_val, heel_z_val;
-        toe_vals << toe_x_val, toe_y_val, toe_z_val;
-        points.append(heel_vals);
-        points.append(toe_vals);
-    }
-    // Get the projection
-    QList<Eigen::Vector3d> projection = WellConstraintProjections::interwell_constraint_projection(
-        points, distance_);
-
-    if (projection.length() == 0) return false; // No solution was found
+    WellConstraintProjections::Batch::WellSet wells = getWellSet(c);
+    std::vector<bool> moved = movedWells(c, wells);
+    bool satisfied = WellConstraintProjections::Batch::interwell_constraint_satisfied(wells, distance_, 0.01, moved);
 
-    // Check if the projection is (approximately) equal to the input case
-    for (int i = 0; i < projection.length(); ++i) {
-        if (!points[i].isApprox(projection[i], 0.01))
-            return false;
+    if (satisfied) {
+        rememberFeasible(c->id(), wells);
     }
-    return true;
+    return satisfied;
 }
 
-void InterwellDistance::SnapCaseToConstraints(Case *c)
+void InterwellDistance::rememberFeasible(const QUuid &id, const WellConstraintProjections::Batch::WellSet &wells)
 {
-    QList<Eigen::Vector3d> points;
-    for (Well well : affected_wells_) {
-        double heel_x_val = c->real_variables()[well.heel.x];
-        double heel_y_val = c->real_variables()[well.heel.y];
-        double heel_z_val = c->real_variables()[well.heel.z];
-
-        double toe_x_val = c->real_variables()[well.toe.x];
-        double toe_y_val = c->real_variables()[well.toe.y];
-        double toe_z_val = c->real_variables()[well.toe.z];
-
-        Eigen::Vector3d heel_vals;
-        Eigen::Vector3d toe_vals;
-        heel_vals << heel_x_val, heel_y_val, heel_z_val;
-        toe_vals << toe_x_val, toe_y_val, toe_z_val;
-        points.append(heel_vals);
-        points.append(toe_vals);
+    if (feasible_well_sets_.contains(id)) {
+        feasible_lru_.remove(id);
     }
-    // Get the projection
-    QList<Eigen::Vector3d> projection = WellConstraintProjections::interwell_constraint_projection(
-        points, distance_);
+    feasible_lru_.push_front(id);
+    feasible_well_sets_[id] = wells;
+    while ((int)feasible_lru_.size() > kMaxFeasibleWellSets) {
+        feasible_well_sets_.remove(feasible_lru_.back());
+        feasible_lru_.pop_back();
+    }
+}
 
-    if (projection.length() == 0) return; // No solution was found
+void InterwellDistance::SnapCaseToConstraints(Case *c)
+{
+    WellConstraintProjections::Batch::WellSet wells = getWellSet(c);
+    WellConstraintProjections::Batch::interwell_constraint_sweep(wells, distance_);
 
     for (int i = 0; i < affected_wells_.length(); ++i) {
-        c->set_real_variable_value(affected_wells_[i].heel.x, projection[i*2](0));
-        c->set_real_variable_value(affected_wells_[i].heel.y, projection[i*2](1));
-        c->set_real_variable_value(affected_wells_[i].heel.z, projection[i*2](2));
+        c->set_real_variable_value(affected_wells_[i].heel.x, wells[i].heel(0));
+        c->set_real_variable_value(affected_wells_[i].heel.y, wells[i].heel(1));
+        c->set_real_variable_value(affected_wells_[i].heel.z, wells[i].heel(2));
+
+        c->set_real_variable_value(affected_wells_[i].toe.x, wells[i].toe(0));
+        c->set_real_variable_value(affected_wells_[i].toe.y, wells[i].toe(1));
+        c->set_real_variable_value(affected_wells_[i].toe.z, wells[i].toe(2));
+    }
+}
+
+WellConstraintProjections::Batch::WellSet InterwellDistance::getWellSet(Case *c) {
+    WellConstraintProjections::Batch::WellSet wells;
+    for (Well well : affected_wells_) {
+        auto endpoints = GetEndpointValueVectors(c, well);
+        wells.push_back(WellConstraintProjections::Batch::WellSegment(endpoints.first, endpoints.second));
+    }
+    return wells;
+}
 
-        c->set_real_variable_value(affected_wells_[i].toe.x, projection[i*2+1](0));
-        c->set_real_variable_value(affected_wells_[i].toe.y, projection[i*2+1](1));
-        c->set_real_variable_value(affected_wells_[i].toe.z, projection[i*2+1](2));
+std::vector<bool> InterwellDistance::movedWells(Case *c, const WellConstraintProjections::Batch::WellSet &wells) {
+    // Keyed by id, as the origin case may have been deleted and its memory reused by another case
+    QUuid origin = c->origin_case_id();
+    if (origin.isNull() || !feasible_well_sets_.contains(origin))
+        return std::vector<bool>();
+
+    // Keep the well sets of cases that are still used as origins
+    feasible_lru_.remove(origin);
+    feasible_lru_.push_front(origin);
+    const WellConstraintProjections::Batch::WellSet &reference = feasible_well_sets_[origin];
+    std::vector<bool> moved(wells.size());
+    for (int i = 0; i < wells.size(); ++i) {
+        moved[i] = wells[i].heel != reference[i].heel || wells[i].toe != reference[i].toe;
     }
+    return moved;
 }
+
 void InterwellDistance::InitializeNormalizer(QList<Case *> cases) {
     long double minimum_distance = 1e20;
     for (auto c : cases) {
-        vector<double> endp_dist = endpointDistances(c);
-        for (double dist : endp_dist) {
-            if (abs(dist) < minimum_distance)
-                minimum_distance = abs(dist);
-        }
+        double dist = WellConstraintProjections::Batch::minimum_endpoint_distance(getWellSet(c));
+        if (abs(dist) < minimum_distance)
+            minimum_distance = abs(dist);
     }
     normalizer_.set_max(1.0L);
     normalizer_.set_steepness(1.0L/minimum_distance);
     normalizer_.set_midpoint(minimum_distance/2.0L);
 }
 double InterwellDistance::Penalty(Case *c) {
-    vector<double> endpoint_distances = endpointDistances(c);
+    // Pairs of wells further apart than the minimum distance cannot contribute to the violation
+    vector<double> endpoint_distances = endpointDistances(c, distance_);
     double violation = 0.0;
     for (auto distance : endpoint_distances) {
         if (distance < distance_) {
@@ -137,21 +134,8 @@ double InterwellDistance::Penalty(Case *c) {
     return violation;
 }
 
-vector<double> InterwellDistance::endpointDistances(Case *c) {
-    vector<double> endpoint_distances;
-    for (int i = 0; i < affected_wells_.size(); i += 2) { // Even numbers
-        if (i >= affected_wells_.size()) break;
-        for (int j = 1; j < affected_wells_.size(); j += 2) { // Odd numbers
-            if (j >= affected_wells_.size()) break;
-            QPair<Eigen::Vector3d, Eigen::Vector3d> well_i = GetEndpointValueVectors(c, affected_wells_[i]);
-            QPair<Eigen::Vector3d, Eigen::Vector3d> well_j = GetEndpointValueVectors(c, affected_wells_[j]);
-            endpoint_distances.push_back( (well_i.first  - well_j.first).norm()  ); // heel_i -> heel_j
-            endpoint_distances.push_back( (well_i.second - well_j.second).norm() ); //  toe_i ->  toe_j
-            endpoint_distances.push_back( (well_i.first  - well_j.second).norm() ); // heel_i ->  toe_j
-            endpoint_distances.push_back( (well_i.second - well_j.first).norm()  ); //  toe_i -> heel_j
-        }
-    }
-    return endpoint_distances;
+vector<double> InterwellDistance::endpointDistances(Case *c, double max_distance) {
+    return WellConstraintProjections::Batch::endpoint_distances(getWellSet(c), max_distance);
 }
 long double InterwellDistance::PenaltyNormalized(Case *c) {
     double penalty = Penalty(c);
@@ -22,11 +22,23 @@
 
 #include "constraint.h"
 #include "well_spline_constraint.h"
+#include "ConstraintMath/well_constraint_projections/well_segment_index.h"
 #include <Eigen/Core>
+#include <list>
 
 namespace Optimization {
 namespace Constraints {
 
+/*!
+ * \brief The InterwellDistance constraint requires all pairs of the affected wells to
+ * be at least a distance Min apart.
+ *
+ * Only pairs of wells whose bounding boxes are closer than Min are checked and projected
+ * (see WellConstraintProjections::Batch::WellSegmentIndex), so the cost scales with the
+ * number of nearby pairs rather than with the square of the number of wells. When a case
+ * has an origin case that was found to satisfy the constraint, only the pairs involving
+ * wells that moved relative to the origin are checked.
+ */
 class InterwellDistance : public Constraint, WellSplineConstraint
 {
  public:
@@ -56,8 +68,28 @@ class InterwellDistance : public Constraint, WellSplineConstraint
   double distance_;
   QList<Well> affected_wells_;
 
-  //! Calculate the distances between the endpoints for two wells
-  vector<double> endpointDistances(Case *c);
+  //! Maximum number of feasible well sets kept. The least recently used ones are dropped first.
+  static const int kMaxFeasibleWellSets = 1000;
+
+  //! Well sets of recently checked cases found to satisfy the constraint, keyed by case id.
+  QHash<QUuid, WellConstraintProjections::Batch::WellSet> feasible_well_sets_;
+  std::list<QUuid> feasible_lru_; //!< Ids of the cases in feasible_well_sets_, most recently used first.
+
+  //! Store the well set of a case found to satisfy the constraint.
+  void rememberFeasible(const QUuid &id, const WellConstraintProjections::Batch::WellSet &wells);
+
+  //! Get the heel and toe of each of the affected wells in the case.
+  WellConstraintProjections::Batch::WellSet getWellSet(Case *c);
+
+  /*!
+   * @brief Get the wells that moved relative to the origin case, if the origin case
+   * was recently found to satisfy the constraint.
+   * @return Flags for the moved wells, or an empty vector if all pairs have to be checked.
+   */
+  std::vector<bool> movedWells(Case *c, const WellConstraintProjections::Batch::WellSet &wells);
+
+  //! Calculate the distances between the endpoints for the pairs of wells that may be closer than max_distance
+  vector<double> endpointDistances(Case *c, double max_distance = INFINITY);
 
 };
 
@@ -26,43 +26,9 @@ PolarSplineBoundary::PolarSplineBoundary(const Settings::Optimizer::Constraint &
                                          Model::Properties::VariablePropertyContainer *variables,
                                          Reservoir::Grid::Grid *grid)
                                          : ReservoirBoundary(settings, variables, grid){}
-bool PolarSplineBoundary::CaseSatisfiesConstraint(Case *c) {
-  double midpoint_x_val = c->real_variables()[affected_well_.midpoint.x];
-  double midpoint_y_val = c->real_variables()[affected_well_.midpoint.y];
-  double midpoint_z_val = c->real_variables()[affected_well_.midpoint.z];
-  
-  bool midpoint_feasible = false;
-
-  for (int ii=0; ii<index_list_.length(); ii++){
-    if (grid_->GetCell(index_list_[ii]).EnvelopsPoint(
-        Eigen::Vector3d(midpoint_x_val, midpoint_y_val, midpoint_z_val))) {
-      midpoint_feasible = true;
-    }
-  }
-
-  return midpoint_feasible;
-}
-void PolarSplineBoundary::SnapCaseToConstraints(Case *c) {
-
-  double midpoint_x_val = c->real_variables()[affected_well_.midpoint.x];
-  double midpoint_y_val = c->real_variables()[affected_well_.midpoint.y];
-  double midpoint_z_val = c->real_variables()[affected_well_.midpoint.z];
-  
-  Eigen::Vector3d projected_midpoint =
-      WellConstraintProjections::well_domain_constraint_indices(
-          Eigen::Vector3d(midpoint_x_val, midpoint_y_val, midpoint_z_val),
-          grid_,
-          index_list_
-      );
-
-  c->set_real_variable_value(affected_well_.midpoint.x, projected_midpoint(0));
-  c->set_real_variable_value(affected_well_.midpoint.y, projected_midpoint(1));
-  c->set_real_variable_value(affected_well_.midpoint.z, projected_midpoint(2));
-  
-}
 Eigen::VectorXd PolarSplineBoundary::GetLowerBounds(QList<QUuid> id_vector) const {
-  auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-  auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+  auto cell_min = boxCell(imin_, jmin_, kmin_);
+  auto cell_max = boxCell(imax_, jmax_, kmax_);
   double xmin, ymin, zmin;
   xmin = std::min(cell_max.center().x(), cell_min.center().x());
   ymin = std::min(cell_max.center().y(), cell_min.center().y());
@@ -84,8 +50,8 @@ Eigen::VectorXd PolarSplineBoundary::GetLowerBounds(QList<QUuid> id_vector) cons
 }
 
 Eigen::VectorXd PolarSplineBoundary::GetUpperBounds(QList<QUuid> id_vector) const {
-  auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-  auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+  auto cell_min = boxCell(imin_, jmin_, kmin_);
+  auto cell_max = boxCell(imax_, jmax_, kmax_);
   double xmax, ymax, zmax;
   xmax = std::max(cell_max.center().x(), cell_min.center().x());
   ymax = std::max(cell_max.center().y(), cell_min.center().y());
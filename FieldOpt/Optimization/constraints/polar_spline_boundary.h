@@ -32,11 +32,12 @@ class PolarSplineBoundary  : public ReservoirBoundary{
                       Model::Properties::VariablePropertyContainer *variables,
                       Reservoir::Grid::Grid *grid);
   string name() override { return "PolarSplineBoundary"; }
-  bool CaseSatisfiesConstraint(Case *c) override;
-  void SnapCaseToConstraints(Case *c) override;
   Eigen::VectorXd GetLowerBounds(QList<QUuid> id_vector) const override;
   Eigen::VectorXd GetUpperBounds(QList<QUuid> id_vector) const override;
 
+ protected:
+  QList<Coord> constrainedPoints() const override { return QList<Coord>({affected_well_.midpoint}); }
+
 };
 }
 }
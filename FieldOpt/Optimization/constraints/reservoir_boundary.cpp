@@ -40,6 +40,8 @@ ReservoirBoundary::ReservoirBoundary(
     grid_ = grid;
     penalty_weight_ = settings.penalty_weight;
 
+    // Fetch the box cells from the grid once; all later checks use the compiled domain
+    domain_ = WellConstraintProjections::CellDomain(getListOfBoxCells());
     index_list_ = getListOfCellIndices();
     if (variables->GetWellSplineVariables(settings.well).size() > 0)
         affected_well_ = initializeWell(variables->GetWellSplineVariables(settings.well));
@@ -85,8 +87,8 @@ void ReservoirBoundary::findCornerCells() {
     //        0   1
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> upper_plane_left_bottom_cell_xyz = grid_->GetCell(imin_, jmin_, kmax_).corners();
-    std::vector<Eigen::Vector3d> upper_plane_left_top_cell_xyz = grid_->GetCell(imin_, jmax_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_left_bottom_cell_xyz = boxCell(imin_, jmin_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_left_top_cell_xyz = boxCell(imin_, jmax_, kmax_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d upper_plane_left_bottom_corner_xyz = upper_plane_left_bottom_cell_xyz[0];
     Eigen::Vector3d upper_plane_left_top_corner_xyz = upper_plane_left_top_cell_xyz[2];
@@ -102,8 +104,8 @@ void ReservoirBoundary::findCornerCells() {
     //        0   1
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> upper_plane_right_bottom_cell_xyz = grid_->GetCell(imax_, jmin_, kmax_).corners();
-    std::vector<Eigen::Vector3d> upper_plane_right_top_cell_xyz = grid_->GetCell(imax_, jmax_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_right_bottom_cell_xyz = boxCell(imax_, jmin_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_right_top_cell_xyz = boxCell(imax_, jmax_, kmax_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d upper_plane_right_bottom_corner_xyz = upper_plane_right_bottom_cell_xyz[1];
     Eigen::Vector3d upper_plane_right_top_corner_xyz = upper_plane_right_top_cell_xyz[3];
@@ -122,8 +124,8 @@ void ReservoirBoundary::findCornerCells() {
     //         | |
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> upper_plane_bottom_left_cell_xyz = grid_->GetCell(imin_, jmin_, kmax_).corners();
-    std::vector<Eigen::Vector3d> upper_plane_bottom_right_cell_xyz = grid_->GetCell(imax_, jmin_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_bottom_left_cell_xyz = boxCell(imin_, jmin_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_bottom_right_cell_xyz = boxCell(imax_, jmin_, kmax_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d upper_plane_bottom_left_corner_xyz = upper_plane_bottom_left_cell_xyz[0];
     Eigen::Vector3d upper_plane_bottom_right_corner_xyz = upper_plane_bottom_right_cell_xyz[1];
@@ -142,8 +144,8 @@ void ReservoirBoundary::findCornerCells() {
     //        0   1
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> upper_plane_top_left_cell_xyz = grid_->GetCell(imin_, jmax_, kmax_).corners();
-    std::vector<Eigen::Vector3d> upper_plane_top_right_cell_xyz = grid_->GetCell(imax_, jmax_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_top_left_cell_xyz = boxCell(imin_, jmax_, kmax_).corners();
+    std::vector<Eigen::Vector3d> upper_plane_top_right_cell_xyz = boxCell(imax_, jmax_, kmax_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d upper_plane_top_left_corner_xyz = upper_plane_top_left_cell_xyz[2];
     Eigen::Vector3d upper_plane_top_right_corner_xyz = upper_plane_top_right_cell_xyz[3];
@@ -163,8 +165,8 @@ void ReservoirBoundary::findCornerCells() {
     //        4   5
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> lower_plane_left_bottom_cell_xyz = grid_->GetCell(imin_, jmin_, kmin_).corners();
-    std::vector<Eigen::Vector3d> lower_plane_left_top_cell_xyz = grid_->GetCell(imin_, jmax_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_left_bottom_cell_xyz = boxCell(imin_, jmin_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_left_top_cell_xyz = boxCell(imin_, jmax_, kmin_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d lower_plane_left_bottom_corner_xyz = lower_plane_left_bottom_cell_xyz[4];
     Eigen::Vector3d lower_plane_left_top_corner_xyz = lower_plane_left_top_cell_xyz[6];
@@ -180,8 +182,8 @@ void ReservoirBoundary::findCornerCells() {
     //        4   5
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> lower_plane_right_bottom_cell_xyz = grid_->GetCell(imax_, jmin_, kmin_).corners();
-    std::vector<Eigen::Vector3d> lower_plane_right_top_cell_xyz = grid_->GetCell(imax_, jmax_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_right_bottom_cell_xyz = boxCell(imax_, jmin_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_right_top_cell_xyz = boxCell(imax_, jmax_, kmin_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d lower_plane_right_bottom_corner_xyz = lower_plane_right_bottom_cell_xyz[5];
     Eigen::Vector3d lower_plane_right_top_corner_xyz = lower_plane_right_top_cell_xyz[7];
@@ -200,8 +202,8 @@ void ReservoirBoundary::findCornerCells() {
     //         | |
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> lower_plane_bottom_left_cell_xyz = grid_->GetCell(imin_, jmin_, kmin_).corners();
-    std::vector<Eigen::Vector3d> lower_plane_bottom_right_cell_xyz = grid_->GetCell(imax_, jmin_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_bottom_left_cell_xyz = boxCell(imin_, jmin_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_bottom_right_cell_xyz = boxCell(imax_, jmin_, kmin_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d lower_plane_bottom_left_corner_xyz = lower_plane_bottom_left_cell_xyz[4];
     Eigen::Vector3d lower_plane_bottom_right_corner_xyz = lower_plane_bottom_right_cell_xyz[5];
@@ -220,8 +222,8 @@ void ReservoirBoundary::findCornerCells() {
     //        4   5
 
     // Get corner cells of box
-    std::vector<Eigen::Vector3d> lower_plane_top_left_cell_xyz = grid_->GetCell(imin_, jmax_, kmin_).corners();
-    std::vector<Eigen::Vector3d> lower_plane_top_right_cell_xyz = grid_->GetCell(imax_, jmax_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_top_left_cell_xyz = boxCell(imin_, jmax_, kmin_).corners();
+    std::vector<Eigen::Vector3d> lower_plane_top_right_cell_xyz = boxCell(imax_, jmax_, kmin_).corners();
     // Get cell vertex amounting to true box corner
     Eigen::Vector3d lower_plane_top_left_corner_xyz = lower_plane_top_left_cell_xyz[6];
     Eigen::Vector3d lower_plane_top_right_corner_xyz = lower_plane_top_right_cell_xyz[7];
@@ -262,7 +264,7 @@ QList<int> ReservoirBoundary::getIndicesOfEdgeCells() {
 
     // UPPER CELL FACE: LEFT EDGE
     for (int j = jmin_; j <= jmax_; j++) {
-        upper_face_left_edge_.append(grid_->GetCell(imin_, j, kmax_).global_index());
+        upper_face_left_edge_.append(boxCell(imin_, j, kmax_).global_index());
 //        upper_face_left_edge_xyz.append(grid_->GetCell(imin_, j, kmax_).corners());
         // Testing
         // upper_face_left_edge_xyz.push_back(grid_->GetCell(imin_, j, kmax_).corners());
@@ -270,17 +272,17 @@ QList<int> ReservoirBoundary::getIndicesOfEdgeCells() {
 
     // UPPER CELL FACE: BOTTOM EDGE
     for (int i = imin_; i <= imax_; i++) {
-        upper_face_bottom_edge_.append(grid_->GetCell(i, jmin_, kmax_).global_index());
+        upper_face_bottom_edge_.append(boxCell(i, jmin_, kmax_).global_index());
     }
 
     // UPPER CELL FACE: RIGHT EDGE
     for (int j = jmin_; j <= jmax_; j++) {
-        upper_face_right_edge_.append(grid_->GetCell(imax_, j, kmax_).global_index());
+        upper_face_right_edge_.append(boxCell(imax_, j, kmax_).global_index());
     }
 
     // UPPER CELL FACE: TOP EDGE
     for (int i = imin_; i <= imax_; i++) {
-        upper_face_top_edge_.append(grid_->GetCell(i, jmax_, kmax_).global_index());
+        upper_face_top_edge_.append(boxCell(i, jmax_, kmax_).global_index());
     }
 
     // APPEND UPPER EDGE CELLS TO box_edge_cells_ LIST
@@ -296,22 +298,22 @@ QList<int> ReservoirBoundary::getIndicesOfEdgeCells() {
 
     // LOWER CELL FACE: LEFT EDGE
     for (int j = jmin_; j <= jmax_; j++) {
-        lower_face_left_edge_.append(grid_->GetCell(imin_, j, kmin_).global_index());
+        lower_face_left_edge_.append(boxCell(imin_, j, kmin_).global_index());
     }
 
     // LOWER CELL FACE: BOTTOM EDGE
     for (int i = imin_; i <= imax_; i++) {
-        lower_face_bottom_edge_.append(grid_->GetCell(i, jmin_, kmin_).global_index());
+        lower_face_bottom_edge_.append(boxCell(i, jmin_, kmin_).global_index());
     }
 
     // LOWER CELL FACE: RIGHT EDGE
     for (int j = jmin_; j <= jmax_; j++) {
-        lower_face_right_edge_.append(grid_->GetCell(imax_, j, kmin_).global_index());
+        lower_face_right_edge_.append(boxCell(imax_, j, kmin_).global_index());
     }
 
     // LOWER CELL FACE: TOP EDGE
     for (int i = imin_; i <= imax_; i++) {
-        lower_face_top_edge_.append(grid_->GetCell(i, jmax_, kmin_).global_index());
+        lower_face_top_edge_.append(boxCell(i, jmax_, kmin_).global_index());
     }
 
     // APPEND LOWER EDGE CELLS TO box_edge_cells_ LIST
@@ -324,79 +326,86 @@ QList<int> ReservoirBoundary::getIndicesOfEdgeCells() {
 }
 
 bool ReservoirBoundary::CaseSatisfiesConstraint(Case *c) {
+    for (auto coord : constrainedPoints()) {
+        if (!domain_.Contains(pointValue(c, coord)))
+            return false;
+    }
+    return true;
+}
 
-    double heel_x_val = c->real_variables()[affected_well_.heel.x];
-    double heel_y_val = c->real_variables()[affected_well_.heel.y];
-    double heel_z_val = c->real_variables()[affected_well_.heel.z];
+void ReservoirBoundary::SnapCaseToConstraints(Case *c) {
+    for (auto coord : constrainedPoints()) {
+        setPointValue(c, coord, domain_.Project(pointValue(c, coord)));
+    }
+}
 
-    double toe_x_val = c->real_variables()[affected_well_.toe.x];
-    double toe_y_val = c->real_variables()[affected_well_.toe.y];
-    double toe_z_val = c->real_variables()[affected_well_.toe.z];
+void ReservoirBoundary::SnapCasesToConstraints(QList<Case *> cases) {
+    QList<Coord> coords = constrainedPoints();
+    std::vector<Eigen::Vector3d> points;
+    points.reserve(cases.size() * coords.size());
+    for (Case *c : cases) {
+        for (auto coord : coords) {
+            points.push_back(pointValue(c, coord));
+        }
+    }
 
-    bool heel_feasible = false;
-    bool toe_feasible = false;
+    // The domain is read-only, so the points can be projected concurrently
+    domain_.ProjectPoints(points);
 
-    for (int ii=0; ii<index_list_.length(); ii++){
-        if (grid_->GetCell(index_list_[ii]).EnvelopsPoint(
-            Eigen::Vector3d(heel_x_val, heel_y_val, heel_z_val))) {
-            heel_feasible = true;
-        }
-        if (grid_->GetCell(index_list_[ii]).EnvelopsPoint(
-            Eigen::Vector3d(toe_x_val, toe_y_val, toe_z_val))) {
-            toe_feasible = true;
+    int n = 0;
+    for (Case *c : cases) {
+        for (auto coord : coords) {
+            setPointValue(c, coord, points[n++]);
         }
     }
+}
 
-    return heel_feasible && toe_feasible;
+QList<ReservoirBoundary::Coord> ReservoirBoundary::constrainedPoints() const {
+    return QList<Coord>({affected_well_.heel, affected_well_.toe});
 }
 
-void ReservoirBoundary::SnapCaseToConstraints(Case *c) {
+Eigen::Vector3d ReservoirBoundary::pointValue(Case *c, const Coord &coord) const {
+    return Eigen::Vector3d(c->real_variables()[coord.x],
+                           c->real_variables()[coord.y],
+                           c->real_variables()[coord.z]);
+}
 
-    double heel_x_val = c->real_variables()[affected_well_.heel.x];
-    double heel_y_val = c->real_variables()[affected_well_.heel.y];
-    double heel_z_val = c->real_variables()[affected_well_.heel.z];
-
-    double toe_x_val = c->real_variables()[affected_well_.toe.x];
-    double toe_y_val = c->real_variables()[affected_well_.toe.y];
-    double toe_z_val = c->real_variables()[affected_well_.toe.z];
-
-    Eigen::Vector3d projected_heel =
-        WellConstraintProjections::well_domain_constraint_indices(
-            Eigen::Vector3d(heel_x_val, heel_y_val, heel_z_val),
-            grid_,
-            index_list_
-        );
-    Eigen::Vector3d projected_toe =
-        WellConstraintProjections::well_domain_constraint_indices(
-            Eigen::Vector3d(toe_x_val, toe_y_val, toe_z_val),
-            grid_,
-            index_list_
-        );
-
-    c->set_real_variable_value(affected_well_.heel.x, projected_heel(0));
-    c->set_real_variable_value(affected_well_.heel.y, projected_heel(1));
-    c->set_real_variable_value(affected_well_.heel.z, projected_heel(2));
-
-    c->set_real_variable_value(affected_well_.toe.x, projected_toe(0));
-    c->set_real_variable_value(affected_well_.toe.y, projected_toe(1));
-    c->set_real_variable_value(affected_well_.toe.z, projected_toe(2));
+void ReservoirBoundary::setPointValue(Case *c, const Coord &coord, const Eigen::Vector3d &point) const {
+    c->set_real_variable_value(coord.x, point(0));
+    c->set_real_variable_value(coord.y, point(1));
+    c->set_real_variable_value(coord.z, point(2));
 }
 
-QList<int> ReservoirBoundary::getListOfCellIndices() {
-    QList<int> index_list;
+QList<Reservoir::Grid::Cell> ReservoirBoundary::getListOfBoxCells() {
+    QList<Reservoir::Grid::Cell> cells;
 
     for (int i = imin_; i <= imax_; i++){
         for (int j = jmin_; j <= jmax_; j++){
             for (int k = kmin_; k <= kmax_; k++){
-                index_list.append(grid_->GetCell(i, j, k).global_index());
+                cells.append(grid_->GetCell(i, j, k));
             }
         }
     }
+    return cells;
+}
+
+QList<int> ReservoirBoundary::getListOfCellIndices() {
+    QList<int> index_list;
+    for (int ii = 0; ii < domain_.size(); ii++) {
+        index_list.append(domain_.cell(ii).global_index());
+    }
     return index_list;
 }
+
+const Reservoir::Grid::Cell &ReservoirBoundary::boxCell(int i, int j, int k) const {
+    int nj = jmax_ - jmin_ + 1;
+    int nk = kmax_ - kmin_ + 1;
+    return domain_.cell(((i - imin_) * nj + (j - jmin_)) * nk + (k - kmin_));
+}
+
 Eigen::VectorXd ReservoirBoundary::GetLowerBounds(QList<QUuid> id_vector) const {
-    auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-    auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+    auto cell_min = boxCell(imin_, jmin_, kmin_);
+    auto cell_max = boxCell(imax_, jmax_, kmax_);
     double xmin, ymin, zmin;
     xmin = std::min(cell_max.center().x(), cell_min.center().x());
     ymin = std::min(cell_max.center().y(), cell_min.center().y());
@@ -423,8 +432,8 @@ Eigen::VectorXd ReservoirBoundary::GetLowerBounds(QList<QUuid> id_vector) const
     return lbounds;
 }
 Eigen::VectorXd ReservoirBoundary::GetUpperBounds(QList<QUuid> id_vector) const {
-    auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-    auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+    auto cell_min = boxCell(imin_, jmin_, kmin_);
+    auto cell_max = boxCell(imax_, jmax_, kmax_);
     double xmax, ymax, zmax;
     xmax = std::max(cell_max.center().x(), cell_min.center().x());
     ymax = std::max(cell_max.center().y(), cell_min.center().y());
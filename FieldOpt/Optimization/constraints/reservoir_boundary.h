@@ -23,6 +23,7 @@
 #include "constraint.h"
 #include "well_spline_constraint.h"
 #include "Reservoir/grid/grid.h"
+#include "ConstraintMath/well_constraint_projections/cell_domain.h"
 
 namespace Optimization {
 namespace Constraints {
@@ -37,6 +38,11 @@ namespace Constraints {
  *  well is inside the given box domain and, if needed,
  *  project the well onto the domain.
  *
+ *  The cells in the box are fetched from the grid once, at construction,
+ *  and compiled into a CellDomain (per-cell face half-spaces and a bucketed
+ *  x-y raster of cell bounding boxes). Checking or snapping a point thus only
+ *  involves the faces of the cells near it, also for non-convex boxes.
+ *
  *  \todo Figure out a more effective way to enforce
  *  the box constraints (TASK A), then figure out way
  *  boundary constraints for non-box (parallelogram)
@@ -62,7 +68,7 @@ namespace Constraints {
  *
  *  Steps for (B):
  */
-class ReservoirBoundary : public Constraint, WellSplineConstraint
+class ReservoirBoundary : public Constraint, protected WellSplineConstraint
 {
  public:
   ReservoirBoundary(const Settings::Optimizer::Constraint &settings,
@@ -73,6 +79,12 @@ class ReservoirBoundary : public Constraint, WellSplineConstraint
  public:
   bool CaseSatisfiesConstraint(Case *c);
   void SnapCaseToConstraints(Case *c);
+
+  /*!
+   * @brief Snap the wells in all the cases to the box, projecting the points
+   * of all the cases concurrently.
+   */
+  void SnapCasesToConstraints(QList<Case *> cases) override;
   bool IsBoundConstraint() const override { return true; }
 
   /*!
@@ -132,11 +144,25 @@ class ReservoirBoundary : public Constraint, WellSplineConstraint
   Reservoir::Grid::Grid *grid_;
   Well affected_well_;
   QList<int> getListOfCellIndices();
+  QList<Reservoir::Grid::Cell> getListOfBoxCells();
+
+  //! The cells in the box, compiled for fast point queries.
+  WellConstraintProjections::CellDomain domain_;
+
+  //! Get a cell in the box from its (i,j,k) index without querying the grid.
+  const Reservoir::Grid::Cell &boxCell(int i, int j, int k) const;
+
+  //! The points of the well that are constrained to the box (by default the heel and toe).
+  virtual QList<Coord> constrainedPoints() const;
 
   QList<int> getIndicesOfEdgeCells();
   QList<int> index_list_edge_;
 
   void printCornerXYZ(std::string str_out, Eigen::Vector3d vector_xyz);
+
+ private:
+  Eigen::Vector3d pointValue(Case *c, const Coord &coord) const;
+  void setPointValue(Case *c, const Coord &coord, const Eigen::Vector3d &point) const;
 };
 }
 }
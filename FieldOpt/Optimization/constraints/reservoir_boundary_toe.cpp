@@ -28,43 +28,9 @@ ReservoirBoundaryToe::ReservoirBoundaryToe(const Settings::Optimizer::Constraint
                                            Model::Properties::VariablePropertyContainer *variables,
                                            Reservoir::Grid::Grid *grid)
     : ReservoirBoundary(settings, variables, grid) {}
-bool ReservoirBoundaryToe::CaseSatisfiesConstraint(Case *c) {
-  double toe_x_val = c->real_variables()[affected_well_.toe.x];
-  double toe_y_val = c->real_variables()[affected_well_.toe.y];
-  double toe_z_val = c->real_variables()[affected_well_.toe.z];
-
-  bool midpoint_feasible = false;
-
-  for (int ii = 0; ii < index_list_.length(); ii++) {
-    if (grid_->GetCell(index_list_[ii]).EnvelopsPoint(
-        Eigen::Vector3d(toe_x_val, toe_y_val, toe_z_val))) {
-      midpoint_feasible = true;
-    }
-  }
-
-  return midpoint_feasible;
-}
-void ReservoirBoundaryToe::SnapCaseToConstraints(Case *c) {
-
-  double toe_x_val = c->real_variables()[affected_well_.toe.x];
-  double toe_y_val = c->real_variables()[affected_well_.toe.y];
-  double toe_z_val = c->real_variables()[affected_well_.toe.z];
-
-  Eigen::Vector3d projected_toe =
-      WellConstraintProjections::well_domain_constraint_indices(
-          Eigen::Vector3d(toe_x_val, toe_y_val, toe_z_val),
-          grid_,
-          index_list_
-      );
-
-  c->set_real_variable_value(affected_well_.toe.x, projected_toe(0));
-  c->set_real_variable_value(affected_well_.toe.y, projected_toe(1));
-  c->set_real_variable_value(affected_well_.toe.z, projected_toe(2));
-
-}
 Eigen::VectorXd ReservoirBoundaryToe::GetLowerBounds(QList<QUuid> id_vector) const {
-  auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-  auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+  auto cell_min = boxCell(imin_, jmin_, kmin_);
+  auto cell_max = boxCell(imax_, jmax_, kmax_);
   double xmin, ymin, zmin;
   xmin = std::min(cell_max.center().x(), cell_min.center().x());
   ymin = std::min(cell_max.center().y(), cell_min.center().y());
@@ -85,8 +51,8 @@ Eigen::VectorXd ReservoirBoundaryToe::GetLowerBounds(QList<QUuid> id_vector) con
 }
 
 Eigen::VectorXd ReservoirBoundaryToe::GetUpperBounds(QList<QUuid> id_vector) const {
-  auto cell_min = grid_->GetCell(imin_, jmin_, kmin_);
-  auto cell_max = grid_->GetCell(imax_, jmax_, kmax_);
+  auto cell_min = boxCell(imin_, jmin_, kmin_);
+  auto cell_max = boxCell(imax_, jmax_, kmax_);
   double xmax, ymax, zmax;
   xmax = std::max(cell_max.center().x(), cell_min.center().x());
   ymax = std::max(cell_max.center().y(), cell_min.center().y());
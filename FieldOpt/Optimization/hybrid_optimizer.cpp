@@ -64,7 +64,7 @@ HybridOptimizer::HybridOptimizer(Settings::Optimizer *settings,
 }
 
 Optimizer::TerminationCondition HybridOptimizer::IsFinished() {
-    if (case_handler_->CasesBeingEvaluated().size() > 0) {
+    if (case_handler_->NumberBeingEvaluated() > 0) {
         return TerminationCondition::NOT_FINISHED;
     }
     else if (hybrid_termination_condition_ == HybridTerminationCondition::NO_IMPROVEMENT
@@ -92,6 +92,14 @@ Optimizer::TerminationCondition HybridOptimizer::IsFinished() {
         }
     }
 }
+void HybridOptimizer::handleScreenedOutCase(Case *c) {
+    if (active_component_ == 0) {
+        primary_->handleScreenedOutCase(c);
+    }
+    else {
+        secondary_->handleScreenedOutCase(c);
+    }
+}
 void HybridOptimizer::handleEvaluatedCase(Case *c) {
     if (active_component_ == 0) {
         if (isImprovement(c)) {
@@ -121,6 +129,13 @@ void HybridOptimizer::handleEvaluatedCase(Case *c) {
     }
 
 }
+void HybridOptimizer::retainedCases(QSet<QUuid> &retained) const {
+    // The inactive component is re-initialized from the best case when it is activated
+    Optimizer *active = active_component_ == 0 ? primary_ : secondary_;
+    if (active->tentative_best_case_ != nullptr)
+        retained.insert(active->tentative_best_case_->id());
+    active->retainedCases(retained);
+}
 void HybridOptimizer::iterate() {
     if (enable_logging_) {
         logger_->AddEntry(this);
@@ -136,7 +151,7 @@ void HybridOptimizer::iterate() {
             primary_best_case_ = tentative_best_case_;
             initializeComponent(1);
             active_component_ = 1;
-            if (case_handler_->QueuedCases().size() == 0) { // Iterate if the constructor does not generate cases
+            if (case_handler_->NumberQueued() == 0) { // Iterate if the constructor does not generate cases
                 secondary_->iterate();
             }
 
@@ -157,7 +172,7 @@ void HybridOptimizer::iterate() {
             secondary_best_case_ = tentative_best_case_;
             initializeComponent(0);
             active_component_ = 0;
-            if (case_handler_->QueuedCases().size() == 0) { // Iterate if the constructor does not generate cases
+            if (case_handler_->NumberQueued() == 0) { // Iterate if the constructor does not generate cases
                 primary_->iterate();
             }
 
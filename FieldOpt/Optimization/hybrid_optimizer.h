@@ -53,7 +53,9 @@ class HybridOptimizer : public Optimizer {
 
  protected:
   void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Pass the case on to the active component.
   void iterate() override;
+  void retainedCases(QSet<QUuid> &retained) const override; //!< Cases retained by the active component.
 
  private:
   enum HybridSwitchMode { ON_CONVERGENCE };
@@ -26,6 +26,7 @@ along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 #include "Model/model.h"
 #include "Model/wells/well.h"
 #include <Utilities/printer.hpp>
+#include <Utilities/tracing.hpp>
 
 using std::cout;
 using std::endl;
@@ -72,6 +73,7 @@ NPV::NPV(Settings::Optimizer *settings,
 }
 
 double NPV::value() const {
+  TRACE_SCOPE("ObjectiveValue", "Objective");
   try {
   double value = 0;
 
@@ -25,6 +25,7 @@
 
 #include "weightedsum.h"
 #include "Model/model.h"
+#include "Utilities/tracing.hpp"
 
 namespace Optimization {
 namespace Objective {
@@ -50,6 +51,7 @@ WeightedSum::WeightedSum(Settings::Optimizer *settings, Simulation::Results::Res
 
 double WeightedSum::value() const
 {
+    TRACE_SCOPE("ObjectiveValue", "Objective");
     double value = 0;
     for (int i = 0; i < components_->size(); ++i) {
         value += components_->at(i)->resolveValue(results_);
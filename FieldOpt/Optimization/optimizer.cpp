@@ -17,8 +17,11 @@
    along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include <Utilities/time.hpp>
+#include <Utilities/tracing.hpp>
+#include <Utilities/system.hpp>
 #include "optimizer.h"
 #include <time.h>
+#include <algorithm>
 #include <cmath>
 
 namespace Optimization {
@@ -65,6 +68,11 @@ Optimizer::Optimizer(Settings::Optimizer *settings, Case *base_case,
     enable_logging_ = true;
     verbosity_level_ = 0;
     penalize_ = settings->objective().use_penalty_function;
+    screener_ = nullptr;
+    compact_case_history_ = settings->parameters().compact_case_history;
+    if (settings->parameters().screening != "None") {
+        screener_ = new Screening::CaseScreener(settings, mode_);
+    }
 
     if (penalize_) {
         if (!normalizer_ofv_.is_ready()) {
@@ -88,18 +96,42 @@ Optimizer::Optimizer(Settings::Optimizer *settings, Case *base_case,
 
 Case *Optimizer::GetCaseForEvaluation()
 {
-    if (case_handler_->QueuedCases().size() == 0) {
+    GenerateCases();
+    return case_handler_->GetNextCaseForEvaluation();
+}
+
+int Optimizer::GenerateCases()
+{
+    if (case_handler_->NumberQueued() == 0) {
         time_t start, end;
         time(&start);
-        iterate();
+        {
+            TRACE_SCOPE("Iterate", "Optimization");
+            iterate();
+        }
         time(&end);
         seconds_spent_in_iterate_ = difftime(end, start);
     }
-    return case_handler_->GetNextCaseForEvaluation();
+    // Also screens cases queued from handleEvaluatedCase(), e.g. by APPS
+    if (screener_ != nullptr && case_handler_->NumberQueued() > 0) {
+        TRACE_SCOPE("ScreenQueuedCases", "Optimization");
+        screenQueuedCases();
+    }
+    return case_handler_->NumberQueued();
+}
+
+void Optimizer::screenQueuedCases() {
+    for (Case *c : screener_->Screen(case_handler_)) {
+        handleScreenedOutCase(c);
+    }
 }
 
 void Optimizer::SubmitEvaluatedCase(Case *c)
 {
+    if (c->state.eval == Case::CaseState::EvalStatus::E_CANCELLED) {
+        case_handler_->CancelCase(c->id());
+        return;
+    }
     evaluated_cases_++;
     if (penalize_) {
         double penalized_ofv = PenalizedOFV(c);
@@ -107,11 +139,77 @@ void Optimizer::SubmitEvaluatedCase(Case *c)
     }
     case_handler_->UpdateCaseObjectiveFunctionValue(c->id(), c->objective_function_value());
     case_handler_->SetCaseState(c->id(), c->state, c->GetWICTime(), c->GetSimTime());
+    case_handler_->SetCaseFidelityOfvs(c->id(), c);
     case_handler_->SetCaseEvaluated(c->id());
-    handleEvaluatedCase(case_handler_->GetCase(c->id()));
+    {
+        TRACE_SCOPE("HandleEvaluatedCase", "Optimization");
+        handleEvaluatedCase(case_handler_->GetCase(c->id()));
+    }
     if (enable_logging_) {
         logger_->AddEntry(case_handler_->GetCase(c->id()));
     }
+    if (compact_case_history_ > 0 && evaluated_cases_ % compact_case_history_ == 0) {
+        compactCaseHistory();
+    }
+}
+
+void Optimizer::compactCaseHistory() {
+    QSet<QUuid> retained;
+    if (tentative_best_case_ != nullptr)
+        retained.insert(tentative_best_case_->id());
+    retainedCases(retained);
+    int n_compacted = case_handler_->CompactEvaluatedCases(compact_case_history_, retained);
+    if (VERB_OPT >= 2) {
+        Printer::ext_info("Compacted " + Printer::num2str(n_compacted) + " cases ("
+                              + Printer::num2str(case_handler_->NumberCompacted()) + " of "
+                              + Printer::num2str(case_handler_->NumberEvaluated()) + " evaluated cases in total).",
+                          "Optimization", "Optimizer");
+    }
+}
+
+QList<QUuid> Optimizer::TakeObsoleteCases() {
+    QList<QUuid> obsolete = obsolete_cases_;
+    obsolete_cases_.clear();
+    return obsolete;
+}
+
+void Optimizer::markObsolete(Case *c) {
+    if (c->state.queue == Case::CaseState::QueueStatus::Q_QUEUED) {
+        case_handler_->CancelCase(c->id());
+    }
+    else if (!obsolete_cases_.contains(c->id())) {
+        obsolete_cases_.append(c->id());
+    }
+}
+
+void Optimizer::WarmStart(QList<Case *> cases) {
+    if (cases.empty())
+        return;
+    for (Case *c : cases) {
+        case_handler_->AddEvaluatedCase(c);
+    }
+    if (penalize_ || normalizer_ofv_.is_ready()) {
+        // Re-initialize from the full set of cases instead of just the base case
+        normalizer_ofv_ = Normalizer();
+        initializeNormalizers();
+    }
+    for (Case *c : cases) {
+        if (isImprovement(c))
+            updateTentativeBestCase(c);
+    }
+    warmStart(cases);
+    if (VERB_OPT >= 1) {
+        Printer::ext_info("Warm started with " + Printer::num2str(cases.size()) + " cases. Best OFV: "
+                              + Printer::num2str(tentative_best_case_->objective_function_value()),
+                          "Optimization", "Optimizer");
+    }
+}
+
+QList<Case *> Optimizer::bestCases(QList<Case *> cases, int n) const {
+    std::stable_sort(cases.begin(), cases.end(), [&](const Case *c1, const Case *c2) {
+        return isBetter(c1, c2);
+    });
+    return cases.mid(0, n);
 }
 
 Case *Optimizer::GetTentativeBestCase() const {
@@ -123,6 +221,10 @@ bool Optimizer::isImprovement(const Case *c) {
 }
 
 bool Optimizer::isBetter(const Case *c1, const Case *c2) const {
+    bool screened1 = c1->state.queue == Case::CaseState::QueueStatus::Q_SCREENED;
+    bool screened2 = c2->state.queue == Case::CaseState::QueueStatus::Q_SCREENED;
+    if (screened1 || screened2)
+        return !screened1;
     if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
         if (c1->objective_function_value() > c2->objective_function_value())
             return true;
@@ -193,6 +295,8 @@ map<string, vector<double>> Optimizer::GetValues() {
     valmap["TimONr"] = vector<double>{case_handler_->NumberTimeout()};
     valmap["FailNr"] = vector<double>{case_handler_->NumberFailed()};
     valmap["InvlNr"] = vector<double>{case_handler_->NumberInvalid()};
+    valmap["LiveCs"] = vector<double>{Case::Pool().NumberLive()};
+    valmap["MemoMB"] = vector<double>{std::max(0L, resident_memory_kb()) / 1024.0};
     valmap["CBOFnV"] = vector<double>{tentative_best_case_->objective_function_value()};
     return valmap;
 }
@@ -231,6 +335,13 @@ map<string, vector<double>> Optimizer::Summary::GetValues() {
     valmap["failed"] = vector<double>{opt_->case_handler_->NumberFailed()};
     valmap["timed out"] = vector<double>{opt_->case_handler_->NumberTimeout()};
     valmap["bookkeeped"] = vector<double>{opt_->case_handler_->NumberBookkeeped()};
+    if (opt_->case_handler_->NumberCancelled() > 0) {
+        valmap["cancelled"] = vector<double>{opt_->case_handler_->NumberCancelled()};
+    }
+    if (opt_->screener_ != nullptr) {
+        valmap["screened out"] = vector<double>{opt_->case_handler_->NumberScreenedOut()};
+        valmap["screening acceptance ratio"] = vector<double>{opt_->screener_->acceptance_ratio()};
+    }
     return valmap;
 }
 
@@ -245,11 +356,11 @@ void Optimizer::initializeNormalizers() {
 }
 
 void Optimizer::initializeOfvNormalizer() {
-    if (case_handler_->EvaluatedCases().size() == 0 || normalizer_ofv_.is_ready())
+    if (case_handler_->NumberEvaluated() == 0 || normalizer_ofv_.is_ready())
         throw runtime_error("Unable to initialize normalizer with no evaluated cases available.");
 
     vector<double> abs_ofvs;
-    for (auto c : case_handler_->EvaluatedCases()) {
+    for (auto c : case_handler_->EvaluatedCasesView()) {
         abs_ofvs.push_back(abs(c->objective_function_value()));
     }
     long double max_ofv = *max_element(abs_ofvs.begin(), abs_ofvs.end());
@@ -28,6 +28,7 @@
 #include "Runner/loggable.hpp"
 #include "Runner/logger.h"
 #include "normalizer.h"
+#include "screening/case_screener.h"
 #include "Utilities/verbosity.h"
 #include "Utilities/printer.hpp"
 
@@ -36,6 +37,7 @@ class Logger;
 namespace Optimization {
 
 class HybridOptimizer;
+class PortfolioOptimizer;
 
 /*!
  * \brief The Optimizer class is the abstract parent class for all optimizers. It is primarily
@@ -44,6 +46,7 @@ class HybridOptimizer;
 class Optimizer : public Loggable
 {
   friend class HybridOptimizer;
+  friend class PortfolioOptimizer;
 
  public:
   Optimizer() = delete;
@@ -57,14 +60,48 @@ class Optimizer : public Loggable
    */
   Case *GetCaseForEvaluation();
 
+  /*!
+   * \brief GenerateCases Make sure there are cases available for evaluation, calling the
+   * iterate() method if the queue is empty.
+   *
+   * This is used by the runners to request more cases from asynchronous optimizers while
+   * other cases are still being evaluated.
+   *
+   * If surrogate pre-screening is enabled, the cases queued since the last call are
+   * screened before this returns, whether they were generated by iterate() or queued while
+   * handling an evaluated case; see screenQueuedCases().
+   * \return The number of queued cases. This may be zero for asynchronous optimizers that
+   * need more evaluated cases before generating new ones.
+   */
+  int GenerateCases();
+
   /*!
    * \brief SubmitEvaluatedCase Submit an already evaluated case to the optimizer.
    *
-   * The submitted case is marked as recently evaluated in the CaseHandler.
+   * The submitted case is marked as recently evaluated in the CaseHandler. Cases with the
+   * E_CANCELLED status are only marked as cancelled; they are not passed on to the algorithm.
    * \param c Case to submit.
    */
   void SubmitEvaluatedCase(Case *c);
 
+  /*!
+   * \brief TakeObsoleteCases Get the ids of the cases being evaluated that the optimizer
+   * no longer needs, and clear the list. The runner should cancel their simulations and
+   * submit them with the E_CANCELLED status (or with their results, if they finished first).
+   */
+  QList<QUuid> TakeObsoleteCases();
+
+  /*!
+   * \brief WarmStart Seed the optimizer with cases evaluated in a previous run.
+   *
+   * The cases are added to the evaluated cases, so that the bookkeeper finds them, the
+   * normalizers are re-initialized from them, and the best of them becomes the tentative
+   * best case if it is better. Algorithms that build a model or a population may also use
+   * them for that (see warmStart()). The cases do not count as evaluations.
+   * \param cases Evaluated cases, with objective function values.
+   */
+  void WarmStart(QList<Case *> cases);
+
   /*!
    * \brief GetTentativeBestCase Get the best case found so far.
    * \return
@@ -77,9 +114,9 @@ class Optimizer : public Loggable
   CaseHandler *case_handler() const { return case_handler_; }
 
   // Status related methods
-  int nr_evaluated_cases() const { return case_handler_->EvaluatedCases().size(); }
-  int nr_queued_cases() const { return case_handler_->QueuedCases().size(); }
-  int nr_recently_evaluated_cases() const { return case_handler_->RecentlyEvaluatedCases().size(); }
+  int nr_evaluated_cases() const { return case_handler_->NumberEvaluated(); }
+  int nr_queued_cases() const { return case_handler_->NumberQueued(); }
+  int nr_recently_evaluated_cases() const { return case_handler_->NumberRecentlyEvaluated(); }
 
   /*!
    * The TerminationCondition enum enumerates the reasons why an optimization run is deemed
@@ -104,7 +141,7 @@ class Optimizer : public Loggable
   virtual QString GetStatusString() const; //!< Get a CSV string describing the current state of the optimizer.
   void EnableConstraintLogging(QString output_directory_path); //!< Enable writing a text log for the constraint operations.
   void SetVerbosityLevel(int level);
-  bool IsAsync() const { return is_async_; } //!< Check if the optimizer is asynchronous.
+  bool IsAsync() const { return is_async_; } //!< Check if the optimizer is asynchronous, i.e. if it can generate new cases while others are being evaluated.
 
   /*!
    * @brief Get the simulation duration in seconds for a case.
@@ -148,6 +185,9 @@ class Optimizer : public Loggable
 
   /*!
    * @brief Check if Case c1 is better than Case c2, taking into account if we're maximizing or minimizing.
+   *
+   * A case that has been screened out is never better than another case, and any other
+   * case is better than a screened out case.
    */
   bool isBetter(const Case* c1, const Case *c2) const;
 
@@ -173,16 +213,59 @@ class Optimizer : public Loggable
   bool is_async_; //!< Inidcates whether or not the optimizer is asynchronous. Defaults to false.
   Logger *logger_;
   bool enable_logging_; //!< Whether logging should be performed. This should be set to false when the optimizer is a component in HybridOptimizer.
-  void DisableLogging(); //!< Disable logging for this optimizer. This is called by HybridOptimizer.
+  void DisableLogging(); //!< Disable logging for this optimizer. This is called by HybridOptimizer and PortfolioOptimizer.
   bool penalize_; //!< Switch for whether or not to use penalty function to account for constraints.
   Case *tentative_best_case_; //!< The best case encountered thus far.
   int tentative_best_case_iteration_; //!< The iteration in which the current tentative best case was found.
   bool is_hybrid_component_; //!< Indicates that this object is a hybrid optimization component.
 
   Normalizer normalizer_ofv_; //!< Normalizer for objective function values.
+  Screening::CaseScreener *screener_; //!< Surrogate pre-screening of generated cases. Null if not enabled.
+
+  /*!
+   * @brief Screen the queued cases with the surrogate, reordering the queue and possibly
+   * screening some of them out.
+   *
+   * Screened out cases keep their predicted objective function value, but they are not
+   * evaluated: they are not passed to handleEvaluatedCase(), they are not counted as
+   * evaluations and isBetter() never considers them better than an evaluated case. They
+   * are passed to handleScreenedOutCase() instead.
+   */
+  void screenQueuedCases();
+
+  /*!
+   * @brief Called for each case that is screened out after it has been generated, so that
+   * algorithms waiting for a result for the case can release it. The default does nothing.
+   * @param c The screened out case. It has the Q_SCREENED queue status.
+   */
+  virtual void handleScreenedOutCase(Case *c) {}
+
+  /*!
+   * @brief Mark a case as obsolete. A queued case is cancelled immediately; a case that is
+   * being evaluated is added to the list returned by TakeObsoleteCases().
+   */
+  void markObsolete(Case *c);
 
   void initializeNormalizers(); //!< Initialize all normalization parameters.
 
+  /*!
+   * @brief Add the ids of the evaluated cases the algorithm still needs the variable values
+   * of (e.g. as templates for new cases) to retained. The tentative best case is always
+   * retained. Optimizers that hold on to other evaluated cases must override this.
+   */
+  virtual void retainedCases(QSet<QUuid> &retained) const {}
+
+  /*!
+   * @brief Use the cases passed to WarmStart(), which have already been added to the
+   * evaluated cases, to initialize the algorithm. Does nothing by default.
+   */
+  virtual void warmStart(QList<Case *> cases) {}
+
+  /*!
+   * @brief Get the (at most) n best of a list of cases, best first.
+   */
+  QList<Case *> bestCases(QList<Case *> cases, int n) const;
+
   class Summary : public Loggable {
    public:
     Summary(Optimizer *opt, TerminationCondition cond,
@@ -207,6 +290,14 @@ class Optimizer : public Loggable
  private:
   QDateTime start_time_;
   int seconds_spent_in_iterate_; //!< The number of seconds spent in the iterate() method.
+  QList<QUuid> obsolete_cases_; //!< Cases being evaluated that should be cancelled by the runner.
+  int compact_case_history_; //!< Compact superseded cases every this many evaluations (0: never).
+
+  /*!
+   * @brief Compact the evaluated cases that are no longer needed, except the
+   * compact_case_history_ most recent ones (see CaseHandler::CompactEvaluatedCases).
+   */
+  void compactCaseHistory();
 
   /*!
    * @brief Initialize the OFV normalizer, setting the parameters for it
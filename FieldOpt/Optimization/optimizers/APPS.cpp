@@ -43,6 +43,7 @@ APPS::APPS(Settings::Optimizer *settings,
 
     assert(settings->parameters().max_queue_size >= 1.0);
     max_queue_length_ = directions_.size() * settings->parameters().max_queue_size;
+    cancel_obsolete_ = settings->parameters().cancel_obsolete_cases;
     is_async_ = true;
     if (enable_logging_) {
         logger_->AddEntry(this);
@@ -50,13 +51,16 @@ APPS::APPS(Settings::Optimizer *settings,
 }
 
 void APPS::iterate() {
+    // The runner may call this whenever a worker is free. Without inactive directions there is
+    // nothing to generate, so return without logging or counting an iteration.
+    if (inactive().size() == 0 || evaluated_cases_ >= max_evaluations_) {
+        return;
+    }
     if (enable_logging_) {
         logger_->AddEntry(this);
     }
-    if (inactive().size() > 0 && evaluated_cases_ < max_evaluations_) {
-        case_handler_->AddNewCases(generate_trial_points(inactive()));
-        set_active(inactive());
-    }
+    case_handler_->AddNewCases(generate_trial_points(inactive()));
+    set_active(inactive());
     iteration_++;
     if (is_hybrid_component_) {
         // Increment this here if this object is a hybrid optimization component,
@@ -75,11 +79,17 @@ void APPS::successful_iteration(Case *c) {
     set_step_lengths(c->origin_direction_index(), c->origin_step_length());
     expand();
     reset_active();
-    prune_queue();
+    if (cancel_obsolete_) cancel_obsolete_cases();
+    else prune_queue();
     if (VERB_OPT >= 2) print_state("Successful iteration");
     iterate();
 }
 
+void APPS::handleScreenedOutCase(Case *c) {
+    if (c->origin_case()->id() == GetTentativeBestCase()->id()) {
+        set_inactive(vector<int>{c->origin_direction_index()});
+    }
+}
 void APPS::unsuccessful_iteration(Case *c) {
     vector<int> unsuccessful_direction;
     if (c->origin_case()->id() == GetTentativeBestCase()->id()) {
@@ -116,13 +126,13 @@ vector<int> APPS::inactive() {
 }
 
 void APPS::prune_queue() {
-    if (case_handler_->QueuedCases().size() <= max_queue_length_ - directions_.size()) {
+    if (case_handler_->NumberQueued() <= max_queue_length_ - directions_.size()) {
         return;
     }
     else {
         int queue_size = max_queue_length_ - directions_.size();
         if (evaluated_cases_ >= max_evaluations_) queue_size = 1;
-        while (case_handler_->QueuedCases().size() > queue_size) {
+        while (case_handler_->NumberQueued() > queue_size) {
             auto dequeued_case = dequeue_case_with_worst_origin();
             if (dequeued_case->origin_case()->id() == GetTentativeBestCase()->id())
                 set_inactive(vector<int>{dequeued_case->origin_direction_index()});
@@ -131,12 +141,23 @@ void APPS::prune_queue() {
     }
 }
 
+void APPS::cancel_obsolete_cases() {
+    for (Case *c : case_handler_->QueuedCases())
+        markObsolete(c);
+    for (Case *c : case_handler_->CasesBeingEvaluated())
+        markObsolete(c);
+    if (VERB_OPT >= 2) {
+        Printer::ext_info("Marked queued and running cases obsolete. Cancelled so far: "
+                              + Printer::num2str(case_handler_->NumberCancelled()), "Optimization", "APPS");
+    }
+}
+
 void APPS::print_state(string header) {
     std::stringstream ss;
     ss << header << "|";
     ss << "Iteration:         " << iteration_ << "|";
     ss << "Evaluated cases:   " << evaluated_cases_ << "|";
-    ss << "Queued cases:      " << case_handler_->QueuedCases().size() << "|";
+    ss << "Queued cases:      " << case_handler_->NumberQueued() << "|";
     ss << "Current best case: " << tentative_best_case_->id().toString().toStdString() << "|";
     ss << "OFV:               " << tentative_best_case_->objective_function_value();
     ss << "Step lengths  :    " << vec_to_str(vector<double>(step_lengths_.data(), step_lengths_.data() + step_lengths_.size())) << "|";
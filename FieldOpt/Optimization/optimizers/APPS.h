@@ -41,10 +41,17 @@ namespace Optimization {
         protected:
             void handleEvaluatedCase(Case *c) override;
 
+            /*!
+             * @brief Mark the direction of a screened out case as inactive, so that it is tried again
+             * in the next iteration. The step length is not contracted.
+             */
+            void handleScreenedOutCase(Case *c) override;
+
             void iterate() override;
 
         private:
             int max_queue_length_; //!< Maximum length of queue.
+            bool cancel_obsolete_; //!< Cancel queued and running cases when an improvement is found.
             set<int> active_; //!< Set containing the indices of all active search directions.
             void set_active(vector<int> dirs); //!< Mark the direction indices in the vector as active.
             void set_inactive(vector<int> dirs); //!< Mark the direction indices in the vector as inactive.
@@ -74,6 +81,15 @@ namespace Optimization {
              */
             void prune_queue();
 
+            /*!
+             * @brief Mark all queued cases and all cases being evaluated as obsolete.
+             *
+             * Called on a successful iteration when CancelObsoleteCases is enabled: the
+             * remaining polls around the previous best case can no longer contract the
+             * step lengths, so the simulator time is better spent on the new trial points.
+             */
+            void cancel_obsolete_cases();
+
             /*!
              * @brief Print the state of the optimizer. Detail level depends on the verbosity setting.
              */
@@ -25,9 +25,18 @@
 #include "Settings/optimizer.h"
 #include <math.h>
 #include <random>
+#include <algorithm>
 
 namespace Optimization {
 namespace Optimizers {
+
+namespace {
+const double initial_sigma = 0.3; //!< Initial step size in the normalized search space.
+const double tol_fun = 1e-12; //!< Relative tolerance on the range of recent objective function values.
+const double tol_x = 1e-12; //!< Tolerance on the step size, relative to the initial step size of the run.
+const double max_condition = 1e14; //!< Maximum condition number of the covariance matrix.
+}
+
 CMA_ES::CMA_ES(Settings::Optimizer *settings,
                Case *base_case,
                Model::Properties::VariablePropertyContainer *variables,
@@ -45,9 +54,28 @@ CMA_ES::CMA_ES(Settings::Optimizer *settings,
     gen_ = get_random_generator(settings->parameters().rng_seed);
     max_iterations_ = settings->parameters().max_generations;
     population_size_ = settings->parameters().population_size;
-    sigma_ = 0.3;
+    sigma_ = initial_sigma;
+    sigma0_ = initial_sigma;
     xmean_ = Eigen::VectorXd::Zero(n_vars_);
 
+    if (settings->parameters().cma_es_restart_strategy == "IPOP") {
+        restart_strategy_ = IPOP;
+    } else if (settings->parameters().cma_es_restart_strategy == "BIPOP") {
+        restart_strategy_ = BIPOP;
+    } else {
+        restart_strategy_ = NO_RESTARTS;
+    }
+    if (settings->parameters().cma_es_sampling == "Mirrored") {
+        sampling_ = MIRRORED;
+    } else if (settings->parameters().cma_es_sampling == "Orthogonal") {
+        sampling_ = ORTHOGONAL;
+    } else {
+        sampling_ = RANDOM;
+    }
+    max_restarts_ = settings->parameters().cma_es_max_restarts;
+    inc_pop_size_ = settings->parameters().cma_es_inc_pop_size;
+    parallel_evaluations_ = std::max(1, settings->parameters().parallel_evaluations);
+
     if (constraint_handler_->HasBoundaryConstraints()) {
         lower_bound_ = constraint_handler_->GetLowerBounds(base_case->GetRealVarIdVector());
         upper_bound_ = constraint_handler_->GetUpperBounds(base_case->GetRealVarIdVector());
@@ -73,9 +101,17 @@ CMA_ES::CMA_ES(Settings::Optimizer *settings,
     if (population_size_ != -1){
         lambda_ = population_size_;
     } else {
-        lambda_ = 4 + floor(3 * log(n_vars_));
+        lambda_ = roundToParallelEvaluations(4 + floor(3 * log(n_vars_)));
     }
-    mu_ = lambda_ / 2;
+    default_lambda_ = lambda_;
+
+    initializeStrategyParameters();
+    generatePopulation();
+}
+
+void CMA_ES::initializeStrategyParameters() {
+    mu_ = lambda_ / 2.0;
+    weights_.clear();
     for (int i = 1; i <= mu_; i++) {
         weights_.push_back(log(mu_ + 0.5) - log(i));
     }
@@ -100,39 +136,26 @@ CMA_ES::CMA_ES(Settings::Optimizer *settings,
     cc_ = (4 + mueff_ / n_vars_) / (n_vars_ + 4 + 2 * mueff_ / n_vars_);
     cs_ = (mueff_ + 2) / (n_vars_ + mueff_ + 5);
     c1_ = 2 / (pow(n_vars_ + 1.3, 2) + mueff_);
-
-    if (1 - c1_ < 2 * (mueff_ - 2 + 1 / mueff_) / (pow(n_vars_ + 2, 2) + mueff_)) {
-        cmu_ = 1 - c1_;
-    } else {
-        cmu_ = 2 * (mueff_ - 2 + 1 / mueff_) / (pow(n_vars_ + 2, 2) + mueff_);
-    }
-
-    if (0 > sqrt((mueff_ - 1) / (n_vars_ + 1)) - 1) {
-        damps_ = 1 + 2 * 0 + cs_;
-    } else {
-        damps_ = 1 + 2 * sqrt((mueff_ - 1) / (n_vars_ + 1)) - 1 + cs_;
-    }
+    cmu_ = std::min(1 - c1_, 2 * (mueff_ - 2 + 1 / mueff_) / (pow(n_vars_ + 2, 2) + mueff_));
+    damps_ = 1 + 2 * std::max(0.0, sqrt((mueff_ - 1) / (n_vars_ + 1)) - 1) + cs_;
 
     // Initialize dynamic (internal) strategy parameters and constants
     pc_ = Eigen::VectorXd::Zero(n_vars_);
     ps_ = Eigen::VectorXd::Zero(n_vars_);
     B_ = Eigen::MatrixXd::Identity(n_vars_, n_vars_);
     D_ = Eigen::VectorXd::Ones(n_vars_);
-    Eigen::VectorXd temp_D = Eigen::VectorXd::Zero(n_vars_);
-    for (int i = 0; i < D_.size(); i++) {
-        temp_D[i] = D_(i) * D_(i);
-    }
-    C_ = B_ * (temp_D).asDiagonal() * B_.transpose();
-    for (int i = 0; i < D_.size(); i++) {
-        temp_D[i] = 1.0 / D_(i);
-    }
-    invsqrtC_ = B_ * (temp_D).asDiagonal() * B_.transpose();
+    C_ = B_ * D_.cwiseProduct(D_).asDiagonal() * B_.transpose();
+    invsqrtC_ = B_ * D_.cwiseInverse().asDiagonal() * B_.transpose();
     eigeneval_ = 0;
+    counteval_ = 0;
+    run_generation_ = 0;
+    best_history_.clear();
     chiN_ = pow(n_vars_, 0.5) * (1 - (float(1) / (4 * n_vars_)) + 1 / (21 * pow(n_vars_, 2)));
-    for (int i = 0; i < lambda_; ++i) {
-        auto new_case = generateCase(xmean_, i, 1);
-        case_handler_->AddNewCase(new_case);
-    }
+}
+
+int CMA_ES::roundToParallelEvaluations(double lambda) const {
+    int rounded = std::max(2, (int)ceil(lambda));
+    return (int)ceil(rounded / (double)parallel_evaluations_) * parallel_evaluations_;
 }
 
 CMA_ES::Individual::Individual(Optimization::Case *c, boost::random::mt19937 &gen, int index,
@@ -145,28 +168,36 @@ CMA_ES::Individual::Individual(Optimization::Case *c, boost::random::mt19937 &ge
 }
 
 vector<CMA_ES::Individual> CMA_ES::sortPopulation(vector<CMA_ES::Individual> population) {
-    vector<CMA_ES::Individual> sortedPopulation;
-    int n = population_.size();
-    bool swapped = true;
-    while (swapped) {
-        swapped = false;
-        for (int i = 1; i <= n - 1; i++) {
-            if (population[i - 1].ofv() > population[i].ofv() &&
-                (Settings::Optimizer::Minimize == settings_->mode())) {
-                CMA_ES::Individual temp_individual = population[i];
-                population[i] = population[i - 1];
-                population[i - 1] = temp_individual;
-                swapped = true;
-            } else if (population[i - 1].ofv() < population[i].ofv() &&
-                       (Settings::Optimizer::Maximize == settings_->mode())) {
-                CMA_ES::Individual temp_individual = population[i];
-                population[i] = population[i - 1];
-                population[i - 1] = temp_individual;
-                swapped = true;
-            }
+    bool minimize = Settings::Optimizer::Minimize == settings_->mode();
+    std::stable_sort(population.begin(), population.end(), [minimize](Individual a, Individual b) {
+        // Screened out individuals were not evaluated; rank them last
+        bool screened_a = a.case_pointer_->state.queue == Case::CaseState::QueueStatus::Q_SCREENED;
+        bool screened_b = b.case_pointer_->state.queue == Case::CaseState::QueueStatus::Q_SCREENED;
+        if (screened_a || screened_b)
+            return !screened_a && screened_b;
+        return minimize ? a.ofv() < b.ofv() : a.ofv() > b.ofv();
+    });
+    return population;
+}
+
+vector<CMA_ES::Individual> CMA_ES::selectParents(const vector<CMA_ES::Individual> &sorted_population) const {
+    vector<Individual> parents;
+    if (sampling_ == MIRRORED) {
+        // Pairwise selection: only the better of two mirrored offspring may be selected, to avoid
+        // biasing the step size towards zero.
+        vector<bool> pair_selected(lambda_ / 2 + 1, false);
+        for (auto individual : sorted_population) {
+            if (parents.size() >= mu_) break;
+            if (pair_selected[individual.index_ / 2]) continue;
+            pair_selected[individual.index_ / 2] = true;
+            parents.push_back(individual);
+        }
+    } else {
+        for (int i = 0; i < mu_; i++) {
+            parents.push_back(sorted_population[i]);
         }
     }
-    return population;
+    return parents;
 }
 
 void CMA_ES::iterate() {
@@ -182,26 +213,31 @@ void CMA_ES::iterate() {
                     population_[i].ofv() - (exp(penalty_ * population_[i].penalty_dist_) - 1));
         }
     }
-    population_ = sortPopulation(population_);
+    counteval_ += population_.size();
+    vector<Individual> sorted_population = sortPopulation(population_);
+    parents_ = selectParents(sorted_population);
+
     xold_ = xmean_;
     xmean_ = Eigen::VectorXd::Zero(xmean_.size());
-    for (int i = 0; i < n_vars_; i++) {
-        double temp = 0;
-        for (int j = 0; j < mu_; j++) {
-            temp += population_[j].erands_norm_[i] * weights_[j];
-        }
-        xmean_(i) = temp;
+    for (int j = 0; j < mu_; j++) {
+        xmean_ += weights_[j] * parents_[j].erands_norm_;
     }
     updateEvolutionPath();
     adaptCovarianceMatrix();
     decompositionOfC();
 
-    for (int i = 0; i < lambda_; ++i) {
-        auto new_case = generateCase(xmean_, i, 0);
-        case_handler_->AddNewCase(new_case);
+    run_generation_++;
+    best_history_.push_back(sorted_population.front().ofv());
+    while (best_history_.size() > 10 + ceil(30.0 * n_vars_ / lambda_)) {
+        best_history_.pop_front();
     }
-    population_ = temp_population_;
     iteration_++;
+
+    if (restart_strategy_ != NO_RESTARTS && restarts_ < max_restarts_
+        && iteration_ < max_iterations_ && runHasStagnated()) {
+        restart();
+    }
+    generatePopulation();
 }
 
 void CMA_ES::handleEvaluatedCase(Case *c) {
@@ -219,40 +255,111 @@ void CMA_ES::handleEvaluatedCase(Case *c) {
 }
 
 Optimizer::TerminationCondition CMA_ES::IsFinished() {
-    if (case_handler_->CasesBeingEvaluated().size() > 0) return NOT_FINISHED;
+    if (case_handler_->NumberBeingEvaluated() > 0) return NOT_FINISHED;
     if (iteration_ < max_iterations_) return NOT_FINISHED;
     else return MAX_EVALS_REACHED;
 }
 
+bool CMA_ES::runHasStagnated() {
+    string reason;
+
+    // TolFun: range of the best values in the recent generations, and of all values in the last generation
+    double best = best_history_.back();
+    double scale = 1.0 + fabs(best);
+    if (best_history_.size() >= 10 + ceil(30.0 * n_vars_ / lambda_)) {
+        auto history_range = std::minmax_element(best_history_.begin(), best_history_.end());
+        double range = *history_range.second - *history_range.first;
+        for (auto individual : population_) {
+            range = std::max(range, fabs(individual.ofv() - best));
+        }
+        if (range < tol_fun * scale) reason = "TolFun";
+    }
+
+    // TolX: the step size is negligible in all coordinates
+    double max_std = (sigma_ * C_.diagonal().cwiseSqrt()).maxCoeff();
+    double max_pc = (sigma_ * pc_.cwiseAbs()).maxCoeff();
+    if (std::max(max_std, max_pc) < tol_x * sigma0_) reason = "TolX";
+
+    // ConditionCov: the covariance matrix is (numerically) degenerate
+    double condition = pow(D_.maxCoeff() / D_.minCoeff(), 2);
+    if (!(condition <= max_condition)) reason = "ConditionCov";
+
+    // NoEffectAxis and NoEffectCoord: steps no longer change the mean
+    int axis = run_generation_ % n_vars_;
+    if (xmean_ == xmean_ + 0.1 * sigma_ * D_(axis) * B_.col(axis)) reason = "NoEffectAxis";
+    for (int i = 0; i < n_vars_; ++i) {
+        if (xmean_(i) == xmean_(i) + 0.2 * sigma_ * sqrt(C_(i, i))) reason = "NoEffectCoord";
+    }
+
+    if (!reason.empty() && VERB_OPT > 0) {
+        Printer::ext_info("Run stagnated (" + reason + ") after " + Printer::num2str(run_generation_)
+                              + " generations with population size " + Printer::num2str(lambda_) + ".",
+                          "Optimization", "CMA_ES");
+    }
+    return !reason.empty();
+}
+
+void CMA_ES::restart() {
+    restarts_++;
+    if (large_regime_) evals_large_ += counteval_;
+    else evals_small_ += counteval_;
+
+    if (restart_strategy_ == IPOP) {
+        lambda_ = roundToParallelEvaluations(lambda_ * inc_pop_size_);
+        sigma0_ = initial_sigma;
+    } else {
+        // The first restart uses the large population regime; after that the regime that
+        // has used the fewest evaluations so far is chosen.
+        large_regime_ = large_restarts_ == 0 || evals_small_ >= evals_large_;
+        double lambda_large = default_lambda_ * pow(inc_pop_size_, large_restarts_ + (large_regime_ ? 1 : 0));
+        if (large_regime_) {
+            large_restarts_++;
+            lambda_ = roundToParallelEvaluations(lambda_large);
+            sigma0_ = initial_sigma;
+        } else {
+            double u = random_doubles(gen_, 0, 1, 1)[0];
+            lambda_ = roundToParallelEvaluations(floor(default_lambda_ * pow(0.5 * lambda_large / default_lambda_, u * u)));
+            sigma0_ = initial_sigma * pow(10.0, -2.0 * u);
+        }
+    }
+    sigma_ = sigma0_;
+    for (int i = 0; i < n_vars_; i++) {
+        xmean_(i) = random_doubles(gen_, 0, 1, 1)[0];
+    }
+    initializeStrategyParameters();
+
+    if (VERB_OPT > 0) {
+        Printer::ext_info("Restart " + Printer::num2str(restarts_) + " with population size "
+                              + Printer::num2str(lambda_) + " and step size " + Printer::num2str(sigma_) + ".",
+                          "Optimization", "CMA_ES");
+    }
+}
+
 void CMA_ES::updateEvolutionPath() {
     ps_ = (1.0 - cs_) * ps_ + sqrt(cs_ * (2.0 - cs_) * mueff_) * invsqrtC_ * (xmean_ - xold_) / sigma_;
-    hsig_ = ps_.norm() / sqrt(pow(1.0 - (1.0 - cs_), 2.0 * case_handler_->EvaluatedCases().size() / lambda_)) /
+    hsig_ = ps_.norm() / sqrt(1.0 - pow(1.0 - cs_, 2.0 * counteval_ / lambda_)) /
             chiN_ < 1.4 + 2.0 / (n_vars_ + 1);
     pc_ = (1.0 - cc_) * pc_ + hsig_ * sqrt(cc_ * (2.0 - cc_) * mueff_) * (xmean_ - xold_) / sigma_;
 }
 
 void CMA_ES::adaptCovarianceMatrix() {
-    Eigen::MatrixXd argument_matrix(n_vars_, int(mu_));
-    for (int i = 0; i < n_vars_; i++) {
-        double temp = 0;
-        for (int j = 0; j < mu_; j++) {
-            argument_matrix(i, j) = population_[j].erands_norm_[i];
-        }
+    Eigen::MatrixXd artmp(n_vars_, int(mu_));
+    for (int j = 0; j < mu_; j++) {
+        artmp.col(j) = (parents_[j].erands_norm_ - xold_) / sigma_;
     }
     Eigen::VectorXd temp_weights(weights_.size());
     for (int i = 0; i < weights_.size(); i++) {
         temp_weights(i) = weights_[i];
     }
-    auto artmp = (1 / sigma_) * (argument_matrix) - xold_.replicate(1, int(mu_));
     C_ = (1 - c1_ - cmu_) * C_ + c1_ * (pc_ * pc_.transpose() + (1 - hsig_) * cc_ * (2 - cc_) * C_) +
          cmu_ * artmp * temp_weights.asDiagonal() * artmp.transpose();
     sigma_ = sigma_ * exp((cs_ / damps_) * (ps_.norm() / chiN_ - 1));
 }
 
 void CMA_ES::decompositionOfC() {
-    if (case_handler_->EvaluatedCases().size() - eigeneval_ > lambda_ / (c1_ + cmu_) / n_vars_ / 10.0) {
-        eigeneval_ = case_handler_->EvaluatedCases().size();
-        const IOFormat fmt(10, DontAlignCols, "\t", " ", "\n", "", "", "");
+    // Lazy update: the decomposition is O(n^3), so it is only done every lambda/(c1+cmu)/n/10 evaluations
+    if (counteval_ - eigeneval_ > lambda_ / (c1_ + cmu_) / n_vars_ / 10.0) {
+        eigeneval_ = counteval_;
         Eigen::MatrixXd Cupper = Eigen::MatrixXd::Zero(n_vars_, n_vars_);
         for (int i = 0; i < n_vars_; i++) {
             for (int j = i; j < n_vars_; j++) {
@@ -268,40 +375,70 @@ void CMA_ES::decompositionOfC() {
         C_ = Cupper + Cupperest.transpose();
 
         es_.compute(C_);
-        D_ = es_.eigenvalues().real();
-        B_ = es_.eigenvectors().real();
-
-        VectorXd D_diag_sqrt;
-        D_diag_sqrt.resize(D_.size());
-        for (int i = 0; i < D_.size(); i++) {
-            D_diag_sqrt(i) = sqrt(D_(i));
-        }
+        D_ = es_.eigenvalues().cwiseSqrt();
+        B_ = es_.eigenvectors();
+        invsqrtC_ = B_ * D_.cwiseInverse().asDiagonal() * B_.transpose();
+    }
+}
 
-        VectorXd D_diag_inverse;
-        D_diag_inverse.resize(D_.size());
-        for (int i = 0; i < D_.size(); i++) {
-            D_diag_inverse(i) = 1. / D_(i);
+vector<Eigen::VectorXd> CMA_ES::sampleStandardNormals() {
+    auto standard_normal = [this]() {
+        Eigen::VectorXd z(n_vars_);
+        for (int i = 0; i < n_vars_; ++i) {
+            z(i) = random_normal_distribution(gen_, 0, 1, 1);
         }
+        return z;
+    };
+
+    vector<Eigen::VectorXd> samples;
+    switch (sampling_) {
+        case MIRRORED:
+            while (samples.size() < lambda_) {
+                Eigen::VectorXd z = standard_normal();
+                samples.push_back(z);
+                if (samples.size() < lambda_) samples.push_back(-z);
+            }
+            break;
+        case ORTHOGONAL:
+            // Blocks of (up to) n orthogonal directions, each with a chi-distributed length
+            while (samples.size() < lambda_) {
+                int block_size = std::min(n_vars_, lambda_ - (int)samples.size());
+                Eigen::MatrixXd G(n_vars_, block_size);
+                for (int j = 0; j < block_size; ++j) {
+                    G.col(j) = standard_normal();
+                }
+                Eigen::HouseholderQR<Eigen::MatrixXd> qr(G);
+                Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(n_vars_, block_size);
+                for (int j = 0; j < block_size; ++j) {
+                    samples.push_back(Q.col(j) * standard_normal().norm());
+                }
+            }
+            break;
+        default:
+            for (int i = 0; i < lambda_; ++i) {
+                samples.push_back(standard_normal());
+            }
+    }
+    return samples;
+}
 
-        D_ = D_diag_sqrt;
-        invsqrtC_ = B_ * D_diag_inverse.asDiagonal() * B_.transpose();
+void CMA_ES::generatePopulation() {
+    vector<Eigen::VectorXd> samples = sampleStandardNormals();
+    population_.clear();
+    for (int i = 0; i < lambda_; ++i) {
+        auto new_case = generateCase(samples[i], i);
+        case_handler_->AddNewCase(new_case);
     }
 }
 
-Case *CMA_ES::generateCase(Eigen::VectorXd xmean, int index, bool first_iteration) {
+Case *CMA_ES::generateCase(const Eigen::VectorXd &z, int index) {
     Case *new_case;
     new_case = new Case(GetTentativeBestCase());
 
-    Eigen::VectorXd xmeanNormal(n_vars_);
-    Eigen::VectorXd erands_norm(n_vars_);
+    Eigen::VectorXd erands_norm = xmean_ + sigma_ * (B_ * D_.cwiseProduct(z));
     Eigen::VectorXd erands(n_vars_);
     double penalty_dist = 0;
     for (int i = 0; i < n_vars_; ++i) {
-        xmeanNormal(i) = random_normal_distribution(gen_, 0, 1, 1);
-    }
-    const IOFormat fmt(1, DontAlignCols, "\t", " ", "", "", "", "");
-    for (int i = 0; i < n_vars_; ++i) {
-        erands_norm(i) = xmean(i) + sigma_ * B_(i, i) * (D_(i) * xmeanNormal(i));
         if (erands_norm(i) > 1.0) {
             penalty_dist += abs(erands_norm(i) - 1.0);
         } else if (erands_norm(i) < 0.0) {
@@ -310,22 +447,12 @@ Case *CMA_ES::generateCase(Eigen::VectorXd xmean, int index, bool first_iteratio
             penalty_dist += 0;
         }
         erands(i) = lower_bound_(i) + erands_norm(i) * (upper_bound_(i) - lower_bound_(i));
-        //if (erands(i) < lower_bound_(i)) {
-        //    erands(i) = lower_bound_(i);
-        //} else if (erands(i) > upper_bound_(i)) {
-        //    erands(i) = upper_bound_(i);
-        //}
     }
     new_case->SetRealVarValues(erands);
     constraint_handler_->CaseSatisfiesConstraints(new_case);
 
-    if (first_iteration) {
-        population_.push_back(Individual(new_case, gen_, index, erands_norm, penalty_dist));
-    } else {
-        temp_population_.push_back(Individual(new_case, gen_, index, erands_norm, penalty_dist));
-    }
+    population_.push_back(Individual(new_case, gen_, index, erands_norm, penalty_dist));
     return new_case;
 }
 }
 }
-
@@ -22,6 +22,7 @@
 #define FIELDOPT_CMA_ES_H
 
 #include <boost/random.hpp>
+#include <deque>
 #include "optimizer.h"
 
 namespace Optimization {
@@ -35,12 +36,25 @@ namespace Optimizers {
 * variables in the population is perturbed to achieve a zero mean, based on the covariance matrix. For each step
 * the coverance matrix is based on the new distribution around the new mean.
 *
-* It approximates the
+* The eigendecomposition of the covariance matrix is only updated every lambda/(c1+cmu)/n/10 evaluations, as
+* recommended in the reference below.
+*
+* Offspring may be sampled as independent normal vectors (Random), as mirrored pairs (Mirrored, with pairwise
+* selection) or in orthogonal blocks (Orthogonal). The latter two reduce the number of evaluations needed to
+* reach a given precision.
+*
+* When a run stagnates (TolFun, TolX, condition number or no-effect criteria) the optimizer can be restarted with
+* a larger population (IPOP), or alternately with large and small populations (BIPOP). The population size is
+* rounded up to a multiple of the number of parallel evaluations, so that each generation keeps all workers busy.
+* The MaxGenerations parameter bounds the total number of generations across all restarts.
+*
 * The implementation is based on the description found at:
 * Hansen, N. (2006), "The CMA evolution strategy: a comparing review", Towards a new evolutionary computation.
 * Advances on estimation of distribution algorithms, Springer, pp. 1769–1776
 *
-*
+* The restart strategies are described in:
+* Auger, A. and Hansen, N. (2005), "A restart CMA evolution strategy with increasing population size", CEC 2005.
+* Hansen, N. (2009), "Benchmarking a BI-population CMA-ES on the BBOB-2009 function testbed", GECCO 2009.
 */
 class CMA_ES : public Optimizer {
 public:
@@ -51,6 +65,12 @@ public:
            Logger *logger,
            CaseHandler *case_handler=0,
            Constraints::ConstraintHandler *constraint_handler=0);
+
+    enum RestartStrategy { NO_RESTARTS, IPOP, BIPOP };
+    enum SamplingMethod { RANDOM, MIRRORED, ORTHOGONAL };
+
+    int population_size() const { return lambda_; } //!< Population size in the current run.
+    int restarts() const { return restarts_; } //!< Number of restarts performed so far.
 protected:
     void handleEvaluatedCase(Case *c) override;
     void iterate() override;
@@ -72,24 +92,33 @@ private:
     Settings::Optimizer *settings_;
     /*!
      * @brief
-     * Generates a set of cases within their given upper and lower bounds, based on the mean (or base case, if utilizied).
+     * Generates a case at xmean + sigma * B * D * z, within the normalized bounds.
      * @return
      */
-    Case *generateCase(Eigen::VectorXd xmean, int index, bool first_iteration);
+    Case *generateCase(const Eigen::VectorXd &z, int index);
+
+    void generatePopulation(); //!< Sample lambda new cases and add them to the case handler.
+    vector<Eigen::VectorXd> sampleStandardNormals(); //!< Draw lambda N(0,I) vectors using the selected sampling method.
+    void initializeStrategyParameters(); //!< Set the parameters that depend on lambda, and reset the dynamic parameters.
+    bool runHasStagnated(); //!< Check the termination criteria for the current run.
+    void restart(); //!< Start a new run with a population size determined by the restart strategy.
+    int roundToParallelEvaluations(double lambda) const; //!< Round a population size up to a multiple of the number of parallel evaluations.
 
     void updateEvolutionPath(); //!< Updated the Evolution Path
     void adaptCovarianceMatrix(); //!< The adaption of Covariance Matrix (the CMA of CMA-ES)
     void decompositionOfC(); //!< Utilizing the Covariance matrix to update the next meanx.
     vector<Individual> sortPopulation(vector<Individual> population);
+    vector<Individual> selectParents(const vector<Individual> &sorted_population) const; //!< The mu best (with pairwise selection for mirrored sampling).
     vector<Individual> population_; //!< The storage vector of the population
-    vector<Individual> temp_population_; //!< Temporary storage for the new generation that will be merged.
+    vector<Individual> parents_; //!< The selected parents in the last generation.
     bool improve_base_case_ = false;
     double stagnation_limit_; //!< The stagnation criterion, standard deviation of all particle positions.
     int population_size_ = -1; //!< The number of people in the population
     double penalty_;
     int max_iterations_; //!< Max iterations
     double sigma_; //!< coordinate wise standard deviation (step size)
-    double lambda_; //!< Population size, offspring number
+    double sigma0_; //!< Initial step size for the current run
+    int lambda_; //!< Population size, offspring number
     double mu_; //!< Number of parents/points for recombination
     double mueff_; //!< variance-effectiveness of sum w_i x_i
     double cc_; //!< time constant for cumulation for C
@@ -108,12 +137,26 @@ private:
     Eigen::MatrixXd B_; //!< B defines the coordinate system
     Eigen::MatrixXd C_; //!< Co-variance matrix
     Eigen::MatrixXd invsqrtC_; //!< The inverse of the co-variance matrix
-    double eigeneval_;
-    EigenSolver<MatrixXd> es_; //!< The EigenValueSolver from Eigen, which allows us to calculated the eigenvalues and eigenvector.
+    double eigeneval_; //!< Value of counteval_ at the last eigendecomposition
+    SelfAdjointEigenSolver<MatrixXd> es_; //!< The EigenValueSolver from Eigen, which allows us to calculated the eigenvalues and eigenvector of the (symmetric) covariance matrix.
     Eigen::VectorXd lower_bound_; //!< Lower bounds for the variables (used for generating populations, and maintaining the search space)
     Eigen::VectorXd upper_bound_; //!< Upper bounds for the variables (used for generating populations, and maintaining the search space)
     int n_vars_; //!< Number of variables in the problem.
 
+    RestartStrategy restart_strategy_; //!< Restart strategy (CMA-ES-RestartStrategy).
+    SamplingMethod sampling_; //!< How offspring are sampled (CMA-ES-Sampling).
+    int max_restarts_; //!< Maximum number of restarts.
+    double inc_pop_size_; //!< Factor by which the population grows for each (large) restart.
+    int parallel_evaluations_; //!< Number of cases that can be evaluated concurrently.
+    int default_lambda_; //!< Population size of the first run.
+    int restarts_ = 0; //!< Number of restarts performed.
+    int large_restarts_ = 0; //!< Number of restarts in the large population regime (BIPOP).
+    bool large_regime_ = true; //!< Whether the current run is in the large population regime (BIPOP).
+    long evals_large_ = 0; //!< Evaluations spent in the large population regime (BIPOP).
+    long evals_small_ = 0; //!< Evaluations spent in the small population regime (BIPOP).
+    long counteval_ = 0; //!< Evaluations in the current run.
+    int run_generation_ = 0; //!< Generations in the current run.
+    std::deque<double> best_history_; //!< Best objective function value in the recent generations of the current run.
 };
 }
 }
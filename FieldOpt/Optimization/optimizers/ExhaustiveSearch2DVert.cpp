@@ -17,7 +17,7 @@
    along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
-#include <iostream>
+#include <algorithm>
 #include "ExhaustiveSearch2DVert.h"
 
 namespace Optimization {
@@ -50,29 +50,174 @@ ExhaustiveSearch2DVert::ExhaustiveSearch2DVert(Settings::Optimizer *settings,
         else
             throw std::runtime_error("ExhaustiveSearch2DVert: Error getting variables.");
     }
+
+    nx_ = grid->Dimensions().nx;
+    ny_ = grid->Dimensions().ny;
+    stride_ = settings->parameters().exhaustive_stride;
+    refine_top_ = settings->parameters().exhaustive_refine_top;
+    skip_inactive_ = settings->parameters().exhaustive_skip_inactive;
+    batch_size_ = std::max(1, settings->parameters().parallel_evaluations);
+    is_async_ = true;
+
+    phase_ = COARSE;
+    sweep_i_ = 1;
+    sweep_j_ = 1;
+    refine_center_ = 0;
+    refine_offset_ = 0;
+    n_skipped_ = 0;
+    advance();
 }
 Optimizer::TerminationCondition ExhaustiveSearch2DVert::IsFinished() {
     if (iteration_ == 0) return NOT_FINISHED;
-    else if (case_handler_->QueuedCases().size() > 0) return NOT_FINISHED;
+    else if (has_column_) return NOT_FINISHED;
+    else if (case_handler_->NumberQueued() > 0 || case_handler_->NumberBeingEvaluated() > 0) return NOT_FINISHED;
     else return MAX_EVALS_REACHED;
 }
 void ExhaustiveSearch2DVert::iterate() {
-    int i_max = grid_->Dimensions().nx;
-    int j_max = grid_->Dimensions().ny;
+    if (iteration_ == 0) {
+        iteration_ = 1;
+    }
+    int n_created = 0;
+    while (has_column_ && n_created < batch_size_) {
+        auto new_case = new Case(GetTentativeBestCase());
+        new_case->set_integer_variable_value(i_varid, column_i_);
+        new_case->set_integer_variable_value(j_varid, column_j_);
+        case_handler_->AddNewCase(new_case);
+        n_created++;
+        advance();
+    }
+}
+
+void ExhaustiveSearch2DVert::handleEvaluatedCase(Case *c) {
+    bool evaluated = c->state.eval == Case::CaseState::E_DONE || c->state.eval == Case::CaseState::E_BOOKKEEPED;
+    if (!evaluated) {
+        refineIfSweepDone(); // The last coarse case may have failed
+        return;
+    }
+    if (isImprovement(c)) {
+        updateTentativeBestCase(c);
+    }
+    if (phase_ != COARSE || stride_ == 1 || refine_top_ <= 0) {
+        return;
+    }
+
+    Column column = {c->integer_variables()[i_varid], c->integer_variables()[j_varid], c->objective_function_value()};
+    int position = 0;
+    while (position < best_columns_.size()) {
+        bool better = mode_ == Settings::Optimizer::OptimizerMode::Maximize
+                      ? column.ofv > best_columns_[position].ofv
+                      : column.ofv < best_columns_[position].ofv;
+        if (better) break;
+        position++;
+    }
+    if (position < refine_top_) {
+        best_columns_.insert(position, column);
+        if (best_columns_.size() > refine_top_) {
+            best_columns_.removeLast();
+        }
+    }
+    refineIfSweepDone();
+}
+
+void ExhaustiveSearch2DVert::handleScreenedOutCase(Case *c) {
+    refineIfSweepDone();
+}
 
-    if (iteration_ > 0) {
-        std::cout << "Can't iterate more than once." << std::endl;
+void ExhaustiveSearch2DVert::refineIfSweepDone() {
+    if (phase_ != COARSE || stride_ == 1 || refine_top_ <= 0) {
         return;
     }
+    if (!has_column_ && case_handler_->NumberQueued() == 0 && case_handler_->NumberBeingEvaluated() == 0) {
+        startRefinement();
+    }
+}
+
+void ExhaustiveSearch2DVert::advance() {
+    has_column_ = false;
+    while (true) {
+        int i, j;
+        if (phase_ == COARSE) {
+            if (sweep_j_ > ny_) {
+                sweep_j_ = 1;
+                sweep_i_ += stride_;
+            }
+            if (sweep_i_ > nx_) {
+                if (stride_ == 1 || refine_top_ <= 0) {
+                    phase_ = DONE;
+                    if (VERB_OPT >= 1 && n_skipped_ > 0) {
+                        Printer::ext_info("Skipped " + Printer::num2str(n_skipped_) + " inactive columns.",
+                                          "Optimization", "ExhaustiveSearch2DVert");
+                    }
+                }
+                return; // Otherwise, wait for the coarse sweep to be evaluated
+            }
+            i = sweep_i_;
+            j = sweep_j_;
+            sweep_j_ += stride_;
+        }
+        else if (phase_ == REFINE) {
+            int width = 2 * stride_ - 1;
+            if (refine_offset_ >= width * width) {
+                refine_center_++;
+                refine_offset_ = 0;
+            }
+            if (refine_center_ >= best_columns_.size()) {
+                phase_ = DONE;
+                if (VERB_OPT >= 1 && n_skipped_ > 0) {
+                    Printer::ext_info("Skipped " + Printer::num2str(n_skipped_) + " inactive columns.",
+                                      "Optimization", "ExhaustiveSearch2DVert");
+                }
+                return;
+            }
+            i = best_columns_[refine_center_].i + refine_offset_ / width - (stride_ - 1);
+            j = best_columns_[refine_center_].j + refine_offset_ % width - (stride_ - 1);
+            refine_offset_++;
+            if (i < 1 || i > nx_ || j < 1 || j > ny_) {
+                continue;
+            }
+        }
+        else {
+            return;
+        }
+
+        if (stride_ > 1) {
+            int index = (i - 1) * ny_ + (j - 1);
+            if (visited_.contains(index)) {
+                continue;
+            }
+            visited_.insert(index);
+        }
+        if (skip_inactive_ && !isActiveColumn(i, j)) {
+            n_skipped_++;
+            continue;
+        }
+        column_i_ = i;
+        column_j_ = j;
+        has_column_ = true;
+        return;
+    }
+}
+
+void ExhaustiveSearch2DVert::startRefinement() {
+    if (VERB_OPT >= 1) {
+        Printer::ext_info("Coarse sweep done. Refining the " + Printer::num2str(best_columns_.size()) + " best columns.",
+                          "Optimization", "ExhaustiveSearch2DVert");
+    }
+    phase_ = REFINE;
+    iteration_ = 2;
+    refine_center_ = 0;
+    refine_offset_ = 0;
+    advance();
+}
 
-    for (int i = 1; i < i_max; ++i) {
-        for (int j = 1; j < j_max; ++j) {
-            auto new_case = new Case(GetTentativeBestCase());
-            new_case->set_integer_variable_value(i_varid, i);
-            new_case->set_integer_variable_value(j_varid, j);
-            case_handler_->AddNewCase(new_case);
+bool ExhaustiveSearch2DVert::isActiveColumn(int i, int j) {
+    // Well block indices are 1-based, grid indices are 0-based
+    for (int k = 0; k < grid_->Dimensions().nz; ++k) {
+        if (grid_->GetCell(i - 1, j - 1, k).is_active()) {
+            return true;
         }
     }
+    return false;
 }
 
 }
@@ -21,6 +21,8 @@
 #define FIELDOPT_EXHAUSTIVESEARCH2DVERT_H
 
 #include "Optimization/optimizer.h"
+#include <QList>
+#include <QSet>
 
 namespace Optimization {
 namespace Optimizers {
@@ -30,6 +32,16 @@ namespace Optimizers {
  * (i.e. check all possible permutations) for the placement of _one_ verical well
  * in two dimensions. It works by creating Case objects for all combinations of the
  * i and j variables that are inside the reservoir.
+ *
+ * The cases are generated lazily: each call to iterate() creates at most one case pr.
+ * parallel evaluation, continuing the sweep where the previous call stopped, so only
+ * the cases in flight are held at any time. Columns without active cells are skipped
+ * (Exhaustive-SkipInactive).
+ *
+ * If Exhaustive-Stride is greater than one, the search runs in coarse-to-fine mode: the
+ * first sweep only visits every stride'th column in each direction. When it has been
+ * evaluated, the Exhaustive-RefineTop best columns are refined by visiting all the columns
+ * within stride-1 of them.
  */
 class ExhaustiveSearch2DVert : public Optimizer {
  public:
@@ -44,25 +56,69 @@ class ExhaustiveSearch2DVert : public Optimizer {
                          Logger *logger
   );
  private:
+  enum Phase { COARSE, REFINE, DONE };
+
+  //! A column and the objective function value of the well placed in it.
+  struct Column {
+    int i;
+    int j;
+    double ofv;
+  };
+
   Reservoir::Grid::Grid *grid_;
   QUuid i_varid;
   QUuid j_varid;
 
+  int nx_;               //!< Number of columns in the i direction.
+  int ny_;               //!< Number of columns in the j direction.
+  int stride_;           //!< Stride of the coarse sweep.
+  int refine_top_;       //!< Number of columns from the coarse sweep to refine.
+  bool skip_inactive_;   //!< Skip columns without active cells.
+  int batch_size_;       //!< Maximum number of cases created in each call to iterate().
+
+  Phase phase_;          //!< Current phase of the search.
+  int sweep_i_;          //!< i index of the next column in the coarse sweep.
+  int sweep_j_;          //!< j index of the next column in the coarse sweep.
+  QList<Column> best_columns_; //!< The best columns from the coarse sweep, best first.
+  int refine_center_;    //!< Index in best_columns_ of the column currently being refined.
+  int refine_offset_;    //!< Index of the next offset in the refinement window around the column.
+  QSet<int> visited_;    //!< Columns already visited, only tracked in coarse-to-fine mode.
+  int n_skipped_;        //!< Number of inactive columns skipped.
+
+  bool has_column_;      //!< Whether column_i_ and column_j_ hold the next column to create a case for.
+  int column_i_;
+  int column_j_;
+
   /*!
-   * @brief This will return NOT_FINISHED if either iterate() has not been called yet,
-   * or if all cases have not yet been evaluated.
+   * @brief This will return NOT_FINISHED until all columns have been generated and all
+   * cases have been evaluated.
    * @return
    */
   virtual TerminationCondition IsFinished() override;
 
   /*!
-   * @brief Creates a Case for every permutation of the i and j variables that are inside
-   * the reservoir the first time its called. Calling it more than once has no effect.
+   * @brief Creates cases for the next columns in the sweep, at most one pr. parallel evaluation.
+   *
+   * In coarse-to-fine mode, the refinement starts when the last case from the coarse sweep
+   * has been evaluated; until then, calls made after the coarse sweep is exhausted have no effect.
    */
   virtual void iterate() override;
 
+  /*!
+   * @brief Find the next column to visit and store it in column_i_ and column_j_.
+   *
+   * has_column_ is set to false if there are no columns left to visit at this point,
+   * i.e. if the search is done or if it is waiting for the coarse sweep to be evaluated.
+   */
+  void advance();
+
+  void startRefinement(); //!< Switch to refining the best columns from the coarse sweep.
+  void refineIfSweepDone(); //!< Start the refinement if all the cases from the coarse sweep have been handled.
+  bool isActiveColumn(int i, int j); //!< Check whether any of the cells in the column is active.
+
 protected:
-    void handleEvaluatedCase(Case *c) override {}
+    void handleEvaluatedCase(Case *c) override;
+    void handleScreenedOutCase(Case *c) override; //!< Start the refinement if the case was the last one from the coarse sweep.
 
 };
 
@@ -82,7 +82,7 @@ GSS::GSS(Settings::Optimizer *settings,
 Optimizer::TerminationCondition GSS::IsFinished()
 {
     TerminationCondition tc = NOT_FINISHED;
-    if (case_handler_->CasesBeingEvaluated().size() > 0)
+    if (case_handler_->NumberBeingEvaluated() > 0)
         return tc;
     if (evaluated_cases_ >= max_evaluations_)
         tc = MAX_EVALS_REACHED;
@@ -138,8 +138,7 @@ QList<Case *> GSS::generate_trial_points(vector<int> dirs) {
         trial_points.append(trial_point);
     }
 
-    for (Case *c : trial_points)
-        constraint_handler_->SnapCaseToConstraints(c);
+    constraint_handler_->SnapCasesToConstraints(trial_points);
 
     return trial_points;
 }
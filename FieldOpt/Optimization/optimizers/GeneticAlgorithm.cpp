@@ -77,7 +77,9 @@ GeneticAlgorithm::GeneticAlgorithm(Settings::Optimizer *settings,
 }
 Optimizer::TerminationCondition GeneticAlgorithm::IsFinished() {
     TerminationCondition tc = NOT_FINISHED;
-    if (case_handler_->CasesBeingEvaluated().size() > 0)
+    if (case_handler_->NumberBeingEvaluated() > 0)
+        return tc;
+    if (is_async_ && case_handler_->NumberQueued() > 0)
         return tc;
     if (iteration_ >= max_generations_)
         tc = MAX_ITERATIONS_REACHED;
@@ -90,6 +92,23 @@ Optimizer::TerminationCondition GeneticAlgorithm::IsFinished() {
     }
     return tc;
 }
+void GeneticAlgorithm::retainedCases(QSet<QUuid> &retained) const {
+    // New offspring are created as copies of the chromosomes' cases
+    for (auto &chrom : population_) {
+        retained.insert(chrom.case_pointer->id());
+    }
+}
+void GeneticAlgorithm::warmStart(QList<Case *> cases) {
+    // The initial population is still queued; the bookkeeper finds the replaced cases already evaluated
+    auto best = bestCases(cases, population_size_ / 2);
+    QList<Case *> queued = case_handler_->QueuedCases();
+    for (int i = 0; i < best.size() && i < queued.size(); ++i) {
+        queued[i]->SetRealVarValues(best[i]->GetRealVarVector());
+    }
+    for (auto &chrom : population_) {
+        chrom.rea_vars = chrom.case_pointer->GetRealVarVector();
+    }
+}
 GeneticAlgorithm::Chromosome::Chromosome(Case *c) {
     case_pointer = c;
     rea_vars = c->GetRealVarVector();
@@ -51,6 +51,8 @@ class GeneticAlgorithm : public Optimizer {
  protected:
   virtual void handleEvaluatedCase(Case *c) = 0;
   virtual void iterate() = 0;
+  void retainedCases(QSet<QUuid> &retained) const override; //!< The cases in the population.
+  void warmStart(QList<Case *> cases) override; //!< Replace half of the initial population with the best of the cases.
  protected:
   boost::random::mt19937 gen_; //!< Random number generator with the random functions in math.hpp
 
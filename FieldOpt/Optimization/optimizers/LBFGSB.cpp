@@ -0,0 +1,371 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "Optimization/optimizers/LBFGSB.h"
+#include "Utilities/stringhelpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Optimization {
+namespace Optimizers {
+
+LBFGSB::LBFGSB(Settings::Optimizer *settings,
+               Case *base_case,
+               Model::Properties::VariablePropertyContainer *variables,
+               Reservoir::Grid::Grid *grid,
+               Logger *logger,
+               CaseHandler *case_handler,
+               Constraints::ConstraintHandler *constraint_handler)
+    : Optimizer(settings, base_case, variables, grid, logger, case_handler, constraint_handler)
+{
+    auto params = settings->parameters();
+    max_iterations_ = params.lbfgsb_max_iterations;
+    memory_ = std::max(1, params.lbfgsb_memory);
+    n_step_candidates_ = params.lbfgsb_step_candidates;
+    if (n_step_candidates_ <= 0) {
+        n_step_candidates_ = std::max(1, params.parallel_evaluations);
+    }
+    tolerance_ = params.lbfgsb_proj_grad_tolerance;
+    fd_step_ = params.lbfgsb_fd_step;
+
+    D_ = base_case->GetRealVarVector().size();
+    lb_ = constraint_handler_->GetLowerBounds(base_case->GetRealVarIdVector());
+    ub_ = constraint_handler_->GetUpperBounds(base_case->GetRealVarIdVector());
+    gradient_ = new FiniteDifferenceGradient(lb_, ub_, fd_step_, params.lbfgsb_central_differences);
+
+    center_ = new Case(base_case);
+    center_->set_objective_function_value(base_case->objective_function_value());
+    center_loss_ = loss(center_);
+    phase_ = GRADIENT;
+    termination_ = NOT_FINISHED;
+    max_step_ = 0.0;
+    steepest_descent_ = true;
+}
+
+Optimization::Optimizer::TerminationCondition LBFGSB::IsFinished()
+{
+    if (case_handler_->NumberBeingEvaluated() > 0 || case_handler_->NumberQueued() > 0) {
+        return NOT_FINISHED;
+    }
+    if (termination_ != NOT_FINISHED) {
+        logger_->AddEntry(this);
+        return termination_;
+    }
+    if (phase_ == LINE_SEARCH) {
+        return NOT_FINISHED;
+    }
+    if (iteration_ >= max_iterations_) {
+        Printer::ext_info("Max iterations reached. Terminating", "Optimization", "LBFGSB");
+        logger_->AddEntry(this);
+        return MAX_ITERATIONS_REACHED;
+    }
+    return NOT_FINISHED;
+}
+
+void LBFGSB::handleScreenedOutCase(Case *c)
+{
+    // The case is not evaluated, so it is never an improvement and is skipped like a failed case
+    handleEvaluatedCase(c);
+}
+
+void LBFGSB::handleEvaluatedCase(Case *c)
+{
+    if (isImprovement(c)) {
+        updateTentativeBestCase(c);
+        if (VERB_OPT >= 2) {
+            Printer::ext_info("Found new tentative best case in iteration " + Printer::num2str(iteration_)
+                                  + ": " + Printer::num2str(tentative_best_case_->objective_function_value()),
+                              "Optimization", "LBFGSB");
+        }
+    }
+    if (phase_ == GRADIENT) {
+        gradient_->Submit(c);
+    }
+    if (!pending_.remove(c->id()) || !pending_.isEmpty()) {
+        return;
+    }
+    if (phase_ == GRADIENT) {
+        gradientEvaluated();
+    }
+    else {
+        lineSearchEvaluated();
+    }
+}
+
+void LBFGSB::iterate()
+{
+    if (termination_ != NOT_FINISHED || !pending_.isEmpty()) {
+        return;
+    }
+    if (phase_ == LINE_SEARCH) {
+        createStepCandidates();
+        return;
+    }
+    logger_->AddEntry(this);
+    if (iteration_ >= max_iterations_) {
+        Printer::ext_info("Reached max iterations.", "Optimization", "LBFGSB");
+        return;
+    }
+
+    iteration_++;
+    if (VERB_OPT >= 3) {
+        Printer::ext_info("Starting iteration " + Printer::num2str(iteration_), "Optimization", "LBFGSB");
+    }
+    // All the gradient cases are queued at once, so that they are spread over all workers
+    for (Case *c : gradient_->CreateCases(center_)) {
+        case_handler_->AddNewCase(c);
+        pending_.insert(c->id());
+    }
+}
+
+void LBFGSB::retainedCases(QSet<QUuid> &retained) const
+{
+    for (Case *c : step_candidates_) {
+        retained.insert(c->id());
+    }
+}
+
+void LBFGSB::gradientEvaluated()
+{
+    g_ = gradient_->Gradient(center_->objective_function_value());
+    if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
+        g_ = -1.0 * g_;
+    }
+    if (gradient_->NumberFailed() == D_) {
+        Printer::ext_warn("No finite-difference case was successfully evaluated in iteration "
+                              + Printer::num2str(iteration_) + ". Retrying.", "Optimization", "LBFGSB");
+        return;
+    }
+    if (VERB_OPT >= 4) Printer::ext_info("Updated gradient vector: " + eigenvec_to_str(g_), "Optimization", "LBFGSB");
+
+    // Add the correction pair from the previous step, if it keeps the approximation positive definite
+    if (last_step_.size() > 0) {
+        Eigen::VectorXd y = g_ - last_g_;
+        if (last_step_.dot(y) > 1e-10 * y.squaredNorm()) {
+            s_.push_back(last_step_);
+            y_.push_back(y);
+            if ((int)s_.size() > memory_) {
+                s_.pop_front();
+                y_.pop_front();
+            }
+        }
+        else if (VERB_OPT >= 3) {
+            Printer::ext_info("Skipping correction pair with non-positive curvature.", "Optimization", "LBFGSB");
+        }
+        last_step_.resize(0);
+    }
+
+    double norm = projectedGradientNorm();
+    if (norm <= tolerance_) {
+        Printer::ext_info("Projected gradient norm " + Printer::num2str(norm) + " below tolerance. Terminating.",
+                          "Optimization", "LBFGSB");
+        termination_ = MINIMUM_STEP_LENGTH_REACHED;
+        return;
+    }
+    updateDirection();
+    phase_ = LINE_SEARCH;
+}
+
+void LBFGSB::lineSearchEvaluated()
+{
+    // Armijo condition, with the projected step
+    const double c1 = 1e-4;
+    Case *best = nullptr;
+    for (Case *c : step_candidates_) {
+        if (!isEvaluated(c)) {
+            continue;
+        }
+        double decrease = g_.dot(c->GetRealVarVector() - center_->GetRealVarVector());
+        if (loss(c) <= center_loss_ + c1 * decrease && (best == nullptr || loss(c) < loss(best))) {
+            best = c;
+        }
+    }
+    step_candidates_.clear();
+
+    if (best != nullptr) {
+        if (VERB_OPT >= 3) Printer::ext_info("Selected step candidate: " + Printer::num2str(best->objective_function_value()), "Optimization", "LBFGSB");
+        last_step_ = best->GetRealVarVector() - center_->GetRealVarVector();
+        last_g_ = g_;
+        center_->SetRealVarValues(best->GetRealVarVector());
+        center_->set_objective_function_value(best->objective_function_value());
+        center_loss_ = loss(center_);
+        phase_ = GRADIENT;
+        return;
+    }
+
+    // Continue backtracking after the shortest candidate
+    max_step_ /= std::pow(2.0, n_step_candidates_);
+    if (max_step_ >= relativeStepLength(fd_step_)) {
+        if (VERB_OPT >= 3) Printer::ext_info("Retrying line search with shorter steps.", "Optimization", "LBFGSB");
+        return;
+    }
+    if (!steepest_descent_) {
+        Printer::ext_warn("Line search along the quasi-Newton direction failed. Clearing the memory and retrying "
+                              "along the steepest descent direction.", "Optimization", "LBFGSB");
+        s_.clear();
+        y_.clear();
+        setSteepestDescent();
+        return;
+    }
+    Printer::ext_info("Line search failed with steps shorter than the finite-difference steps. Terminating.",
+                      "Optimization", "LBFGSB");
+    termination_ = MINIMUM_STEP_LENGTH_REACHED;
+}
+
+void LBFGSB::updateDirection()
+{
+    Eigen::VectorXd free = freeVariables();
+    Eigen::VectorXd q = g_.cwiseProduct(free);
+
+    // Two-loop recursion, restricted to the free variables
+    std::vector<double> alpha(s_.size(), 0.0);
+    std::vector<double> rho(s_.size(), 0.0);
+    double gamma = 0.0;
+    for (int i = (int)s_.size() - 1; i >= 0; --i) {
+        Eigen::VectorXd s = s_[i].cwiseProduct(free);
+        Eigen::VectorXd y = y_[i].cwiseProduct(free);
+        double sy = s.dot(y);
+        if (sy <= 0.0) {
+            continue;
+        }
+        rho[i] = 1.0 / sy;
+        alpha[i] = rho[i] * s.dot(q);
+        q -= alpha[i] * y;
+        if (gamma == 0.0) {
+            gamma = sy / y.squaredNorm();
+        }
+    }
+    if (gamma == 0.0) {
+        setSteepestDescent();
+        return;
+    }
+    Eigen::VectorXd r = gamma * q;
+    for (int i = 0; i < (int)s_.size(); ++i) {
+        if (rho[i] == 0.0) {
+            continue;
+        }
+        Eigen::VectorXd s = s_[i].cwiseProduct(free);
+        Eigen::VectorXd y = y_[i].cwiseProduct(free);
+        double beta = rho[i] * y.dot(r);
+        r += (alpha[i] - beta) * s;
+    }
+    direction_ = -1.0 * r.cwiseProduct(free);
+
+    if (g_.dot(direction_) >= 0.0) {
+        Printer::ext_warn("The quasi-Newton direction is not a descent direction. Clearing the memory.",
+                          "Optimization", "LBFGSB");
+        s_.clear();
+        y_.clear();
+        setSteepestDescent();
+        return;
+    }
+    steepest_descent_ = false;
+    // The unit step is the natural step length for the quasi-Newton direction
+    max_step_ = std::pow(2.0, (n_step_candidates_ - 1) / 2);
+    if (VERB_OPT >= 4) Printer::ext_info("Updated step direction: " + eigenvec_to_str(direction_), "Optimization", "LBFGSB");
+}
+
+void LBFGSB::setSteepestDescent()
+{
+    direction_ = -1.0 * g_.cwiseProduct(freeVariables());
+    steepest_descent_ = true;
+    // Without curvature information, the middle candidate moves some variable 10% of its scale
+    max_step_ = relativeStepLength(0.1) * std::pow(2.0, (n_step_candidates_ - 1) / 2);
+    if (VERB_OPT >= 4) Printer::ext_info("Using steepest descent direction: " + eigenvec_to_str(direction_), "Optimization", "LBFGSB");
+}
+
+Eigen::VectorXd LBFGSB::freeVariables() const
+{
+    Eigen::VectorXd x = center_->GetRealVarVector();
+    Eigen::VectorXd free = Eigen::VectorXd::Ones(D_);
+    for (int i = 0; i < D_; ++i) {
+        if (ub_[i] <= lb_[i]) {
+            continue;
+        }
+        double eps = 1e-10 * (ub_[i] - lb_[i]);
+        if ((x[i] <= lb_[i] + eps && g_[i] > 0.0) || (x[i] >= ub_[i] - eps && g_[i] < 0.0)) {
+            free[i] = 0.0;
+        }
+    }
+    return free;
+}
+
+double LBFGSB::projectedGradientNorm() const
+{
+    Eigen::VectorXd x = center_->GetRealVarVector();
+    return (project(x - g_) - x).lpNorm<Eigen::Infinity>();
+}
+
+Eigen::VectorXd LBFGSB::scales() const
+{
+    Eigen::VectorXd x = center_->GetRealVarVector();
+    Eigen::VectorXd scales(D_);
+    for (int i = 0; i < D_; ++i) {
+        scales[i] = ub_[i] > lb_[i] ? ub_[i] - lb_[i] : std::max(1.0, std::abs(x[i]));
+    }
+    return scales;
+}
+
+double LBFGSB::relativeStepLength(double fraction) const
+{
+    double longest = direction_.cwiseQuotient(scales()).lpNorm<Eigen::Infinity>();
+    if (longest <= 0.0) {
+        return 0.0;
+    }
+    return fraction / longest;
+}
+
+Eigen::VectorXd LBFGSB::project(Eigen::VectorXd x) const
+{
+    for (int i = 0; i < D_; ++i) {
+        if (ub_[i] > lb_[i]) {
+            x[i] = std::min(ub_[i], std::max(lb_[i], x[i]));
+        }
+    }
+    return x;
+}
+
+void LBFGSB::createStepCandidates()
+{
+    step_candidates_.clear();
+    Eigen::VectorXd x = center_->GetRealVarVector();
+    for (int j = 0; j < n_step_candidates_; ++j) {
+        double step = max_step_ / std::pow(2.0, j);
+        auto candidate = new Case(center_);
+        candidate->SetRealVarValues(project(x + step * direction_));
+        constraint_handler_->SnapCaseToConstraints(candidate);
+        step_candidates_.append(candidate);
+        case_handler_->AddNewCase(candidate);
+        pending_.insert(candidate->id());
+    }
+}
+
+double LBFGSB::loss(Case *c) const
+{
+    if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
+        return -1 * c->objective_function_value();
+    }
+    return c->objective_function_value();
+}
+
+bool LBFGSB::isEvaluated(Case *c)
+{
+    return c->state.eval == Case::CaseState::E_DONE || c->state.eval == Case::CaseState::E_BOOKKEEPED;
+}
+
+}
+}
@@ -0,0 +1,171 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_LBFGSB_H
+#define FIELDOPT_LBFGSB_H
+
+#include "Optimization/optimizer.h"
+#include "Optimization/optimizers/finite_difference_gradient.h"
+#include <Eigen/Core>
+#include <QSet>
+#include <deque>
+
+namespace Optimization {
+namespace Optimizers {
+
+/*!
+ * @brief This class implements a bound-constrained limited-memory quasi-Newton method in
+ * the style of L-BFGS-B, using finite-difference gradients.
+ *
+ * Each iteration consists of two batches of cases, both of which can be evaluated in parallel:
+ *  1. The finite-difference cases for the gradient at the current point (see
+ *     FiniteDifferenceGradient).
+ *  2. A number of step lengths along the search direction (LBFGSB-StepCandidates). Each
+ *     candidate is projected onto the bounds. The best candidate satisfying the Armijo
+ *     condition becomes the next point.
+ *
+ * Rather than the generalized Cauchy point and subspace minimization of L-BFGS-B, the bounds
+ * are handled with an active set: variables at a bound with the gradient pointing out of the
+ * feasible region are fixed, and the two-loop recursion is applied to the free variables
+ * (projected L-BFGS). If no candidate is accepted, the line search continues with shorter
+ * steps. Once the steps are shorter than the finite-difference steps, the memory is cleared
+ * and the line search is repeated along the steepest descent direction.
+ *
+ * The algorithm terminates when the projected gradient is small enough
+ * (LBFGSB-ProjGradTolerance), when the line search fails, or after LBFGSB-MaxIterations
+ * iterations. Only continuous variables are optimized.
+ */
+class LBFGSB : public Optimizer {
+ public:
+  LBFGSB(Settings::Optimizer *settings,
+         Case *base_case,
+         Model::Properties::VariablePropertyContainer *variables,
+         Reservoir::Grid::Grid *grid,
+         Logger *logger,
+         CaseHandler *case_handler=0,
+         Constraints::ConstraintHandler *constraint_handler=0);
+
+  TerminationCondition IsFinished() override;
+
+ protected:
+  void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Treat the case as a failed evaluation.
+  void iterate() override;
+  void retainedCases(QSet<QUuid> &retained) const override;
+
+ private:
+  enum Phase { GRADIENT, LINE_SEARCH };
+
+  // Parameters
+  int max_iterations_;   //!< Maximum number of iterations.
+  int memory_;           //!< Number of correction pairs kept.
+  int n_step_candidates_; //!< Number of step lengths evaluated in each line search.
+  double tolerance_;     //!< Projected gradient tolerance.
+  double fd_step_;       //!< Relative finite-difference step.
+
+  // Run-time variables
+  Phase phase_;          //!< The batch to be generated, or being evaluated.
+  TerminationCondition termination_; //!< Set when the algorithm has converged or the line search failed.
+  int D_;                //!< Dimensionality of the problem.
+  Eigen::VectorXd lb_;   //!< Lower bounds.
+  Eigen::VectorXd ub_;   //!< Upper bounds.
+  FiniteDifferenceGradient *gradient_;
+
+  Case *center_;         //!< The current point. This is always an evaluated point.
+  double center_loss_;   //!< Loss at the current point.
+  Eigen::VectorXd g_;    //!< Gradient of the loss at the current point.
+  Eigen::VectorXd direction_; //!< Search direction.
+  double max_step_;      //!< Longest step length along direction_ in the next line search.
+  bool steepest_descent_; //!< Whether direction_ is the steepest descent direction.
+
+  std::deque<Eigen::VectorXd> s_; //!< Steps of the correction pairs, oldest first.
+  std::deque<Eigen::VectorXd> y_; //!< Gradient changes of the correction pairs, oldest first.
+  Eigen::VectorXd last_step_; //!< Step taken in the previous iteration. Empty if none.
+  Eigen::VectorXd last_g_;    //!< Gradient at the start of the previous iteration.
+
+  QList<Case *> step_candidates_; //!< Step candidates currently being evaluated.
+  QSet<QUuid> pending_; //!< Cases generated in the current phase that have not been evaluated yet.
+
+  /*!
+   * @brief Compute the gradient when all gradient cases are evaluated, update the memory,
+   * check for convergence and compute the search direction.
+   */
+  void gradientEvaluated();
+
+  /*!
+   * @brief Select the best candidate satisfying the Armijo condition. If there is none,
+   * backtrack, switch to the steepest descent direction, or terminate.
+   */
+  void lineSearchEvaluated();
+
+  /*!
+   * @brief Compute direction_ with the two-loop recursion on the free variables. Falls back
+   * to the steepest descent direction if the result is not a descent direction.
+   */
+  void updateDirection();
+
+  /*!
+   * @brief Set direction_ to the steepest descent direction on the free variables.
+   */
+  void setSteepestDescent();
+
+  /*!
+   * @brief The variables that are not fixed at a bound by the gradient.
+   */
+  Eigen::VectorXd freeVariables() const;
+
+  /*!
+   * @brief Infinity norm of the projected gradient, \$ \| P(x - g) - x \|_\infty \$.
+   */
+  double projectedGradientNorm() const;
+
+  /*!
+   * @brief The scale of each variable: the range between the bounds, or max(1, |x_i|) for
+   * unbounded variables.
+   */
+  Eigen::VectorXd scales() const;
+
+  /*!
+   * @brief Step length along direction_ for which the longest step, relative to the scale of
+   * the variable, is the given fraction.
+   */
+  double relativeStepLength(double fraction) const;
+
+  /*!
+   * @brief Project a point onto the bounds. Unbounded variables are left as they are.
+   */
+  Eigen::VectorXd project(Eigen::VectorXd x) const;
+
+  /*!
+   * @brief Generate step_candidates_ at P(x + alpha*direction_) for alpha = max_step_ / 2^j.
+   */
+  void createStepCandidates();
+
+  /*!
+   * @brief The objective function value of a case as a loss to be minimized.
+   */
+  double loss(Case *c) const;
+
+  /*!
+   * @brief Check whether a case was successfully evaluated.
+   */
+  static bool isEvaluated(Case *c);
+};
+
+}
+}
+
+#endif //FIELDOPT_LBFGSB_H
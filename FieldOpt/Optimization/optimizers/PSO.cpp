@@ -61,9 +61,17 @@ PSO::PSO(Settings::Optimizer *settings,
         ss << vec_to_str(vector<double>(upper_bound_.data(), upper_bound_.data() + upper_bound_.size()));
         Printer::ext_info(ss.str(), "Optimization","PSO");
     }
+    steady_state_ = settings->parameters().steady_state;
+    if (steady_state_) {
+        is_async_ = true;
+        personal_best_.resize(number_of_particles_);
+    }
     for (int i = 0; i < number_of_particles_; ++i) {
         auto new_case = generateRandomCase();
         swarm_.push_back(Particle(new_case ,gen_, v_max_, n_vars_));
+        if (steady_state_) {
+            particle_of_case_[new_case->id()] = i;
+        }
         case_handler_->AddNewCase(new_case);
     }
     if (VERB_OPT > 2) {
@@ -72,6 +80,10 @@ PSO::PSO(Settings::Optimizer *settings,
 }
 
 void PSO::iterate(){
+    if (steady_state_) {
+        iterateSteadyState();
+        return;
+    }
     if(enable_logging_){
         logger_->AddEntry(this);
     }
@@ -92,7 +104,67 @@ void PSO::iterate(){
     iteration_++;
 }
 
+void PSO::warmStart(QList<Case *> cases) {
+    // The other half stays random to keep the swarm from starting out stagnant. The bookkeeper
+    // finds the moved particles already evaluated.
+    auto best = bestCases(cases, number_of_particles_ / 2);
+    for (int i = 0; i < best.size() && i < swarm_.size(); ++i) {
+        swarm_[i].rea_vars = best[i]->GetRealVarVector();
+        swarm_[i].case_pointer->SetRealVarValues(swarm_[i].rea_vars);
+    }
+}
+
+void PSO::iterateSteadyState() {
+    if (iteration_ >= max_iterations_ || idle_particles_.empty() || is_stagnant()) {
+        return;
+    }
+    int i = idle_particles_.front();
+    idle_particles_.pop_front();
+    update_particle_velocity(swarm_[i], personal_best_[i]);
+    update_particle_position(swarm_[i]);
+
+    auto new_case = new Case(GetTentativeBestCase());
+    new_case->SetRealVarValues(swarm_[i].rea_vars);
+    swarm_[i].case_pointer = new_case;
+    particle_of_case_[new_case->id()] = i;
+    case_handler_->AddNewCase(new_case);
+
+    issued_updates_++;
+    if (issued_updates_ % number_of_particles_ == 0) {
+        iteration_++;
+        if (enable_logging_) {
+            logger_->AddEntry(this);
+        }
+    }
+}
+
+void PSO::handleEvaluatedCaseSteadyState(Case *c) {
+    if (!particle_of_case_.contains(c->id())) {
+        Printer::ext_warn("Unable to find the particle for an evaluated case.", "Optimization", "PSO");
+        return;
+    }
+    int i = particle_of_case_.take(c->id());
+    swarm_[i].case_pointer = c;
+    if (personal_best_[i].case_pointer == nullptr || isBetter(c, personal_best_[i].case_pointer)) {
+        personal_best_[i] = swarm_[i];
+    }
+    if (current_best_particle_global_.case_pointer == nullptr
+        || isBetter(c, current_best_particle_global_.case_pointer)) {
+        current_best_particle_global_ = swarm_[i];
+    }
+    idle_particles_.push_back(i);
+}
+
+void PSO::handleScreenedOutCase(Case *c) {
+    // The particle moves on from the screened out position, but its bests are not updated
+    if (steady_state_ && particle_of_case_.contains(c->id())) {
+        idle_particles_.push_back(particle_of_case_.take(c->id()));
+    }
+}
 void PSO::handleEvaluatedCase(Case *c) {
+    if (steady_state_) {
+        handleEvaluatedCaseSteadyState(c);
+    }
     if(isImprovement(c)){
         updateTentativeBestCase(c);
         if (VERB_OPT > 1) {
@@ -106,7 +178,8 @@ void PSO::handleEvaluatedCase(Case *c) {
 }
 
 Optimizer::TerminationCondition PSO::IsFinished() {
-    if (case_handler_->CasesBeingEvaluated().size() > 0) return NOT_FINISHED;
+    if (case_handler_->NumberBeingEvaluated() > 0) return NOT_FINISHED;
+    if (steady_state_ && case_handler_->NumberQueued() > 0) return NOT_FINISHED;
     if (is_stagnant()) return MINIMUM_STEP_LENGTH_REACHED;
     if (iteration_ < max_iterations_) return NOT_FINISHED;
     else return MAX_EVALS_REACHED;
@@ -190,34 +263,40 @@ vector<PSO::Particle> PSO::update_velocity() {
     for(int i = 0; i < swarm_.size(); i++){
         Particle best_in_particle_memory = find_best_in_particle_memory(i);
         new_swarm.push_back(swarm_[i]);
-        for(int j = 0; j < n_vars_; j++){
-            double velocity_1 = learning_factor_1_ * random_double(gen_, 0, 1) * (best_in_particle_memory.rea_vars(j)-swarm_[i].rea_vars(j));
-            double velocity_2 = learning_factor_2_ * random_double(gen_, 0, 1) * (current_best_particle_global_.rea_vars(j)-swarm_[i].rea_vars(j));
-            new_swarm[i].rea_vars_velocity(j) = swarm_[i].rea_vars_velocity(j) + velocity_1 + velocity_2;
-            if (new_swarm[i].rea_vars_velocity(j) < -v_max_(j)){
-                new_swarm[i].rea_vars_velocity(j) = -v_max_(j);
-            }else if(new_swarm[i].rea_vars_velocity(j) > v_max_(j)){
-                new_swarm[i].rea_vars_velocity(j) = v_max_(j);
-            }
-        }
+        update_particle_velocity(new_swarm[i], best_in_particle_memory);
     }
     return new_swarm;
 }
 vector<PSO::Particle> PSO::update_position() {
     for(int i = 0; i < swarm_.size(); i++){
-        for(int j = 0; j < n_vars_; j++){
-            swarm_[i].rea_vars(j)=swarm_[i].rea_vars_velocity(j)+swarm_[i].rea_vars(j);
-            if (swarm_[i].rea_vars(j) > upper_bound_[j]){
-                swarm_[i].rea_vars(j) = upper_bound_[j]-abs(swarm_[i].rea_vars(j)-upper_bound_[j])*0.5;
-                swarm_[i].rea_vars_velocity(j) = swarm_[i].rea_vars_velocity(j)*-0.5;
-            } else if (swarm_[i].rea_vars(j) < lower_bound_[j]){
-                swarm_[i].rea_vars(j) = lower_bound_[j]+abs(swarm_[i].rea_vars(j)-lower_bound_[j])*0.5;
-                swarm_[i].rea_vars_velocity(j) = swarm_[i].rea_vars_velocity(j)*-0.5;
-            }
-        }
+        update_particle_position(swarm_[i]);
     }
     return swarm_;
 }
+void PSO::update_particle_velocity(Particle &particle, const Particle &personal_best) {
+    for(int j = 0; j < n_vars_; j++){
+        double velocity_1 = learning_factor_1_ * random_double(gen_, 0, 1) * (personal_best.rea_vars(j)-particle.rea_vars(j));
+        double velocity_2 = learning_factor_2_ * random_double(gen_, 0, 1) * (current_best_particle_global_.rea_vars(j)-particle.rea_vars(j));
+        particle.rea_vars_velocity(j) = particle.rea_vars_velocity(j) + velocity_1 + velocity_2;
+        if (particle.rea_vars_velocity(j) < -v_max_(j)){
+            particle.rea_vars_velocity(j) = -v_max_(j);
+        }else if(particle.rea_vars_velocity(j) > v_max_(j)){
+            particle.rea_vars_velocity(j) = v_max_(j);
+        }
+    }
+}
+void PSO::update_particle_position(Particle &particle) {
+    for(int j = 0; j < n_vars_; j++){
+        particle.rea_vars(j)=particle.rea_vars_velocity(j)+particle.rea_vars(j);
+        if (particle.rea_vars(j) > upper_bound_[j]){
+            particle.rea_vars(j) = upper_bound_[j]-abs(particle.rea_vars(j)-upper_bound_[j])*0.5;
+            particle.rea_vars_velocity(j) = particle.rea_vars_velocity(j)*-0.5;
+        } else if (particle.rea_vars(j) < lower_bound_[j]){
+            particle.rea_vars(j) = lower_bound_[j]+abs(particle.rea_vars(j)-lower_bound_[j])*0.5;
+            particle.rea_vars_velocity(j) = particle.rea_vars_velocity(j)*-0.5;
+        }
+    }
+}
 
 
 }
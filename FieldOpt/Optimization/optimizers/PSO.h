@@ -19,6 +19,8 @@
 ******************************************************************************/
 
 #include <boost/random.hpp>
+#include <deque>
+#include <QHash>
 #include "optimizer.h"
 
 #ifndef FIELDOPT_PSO_H
@@ -32,6 +34,12 @@ namespace Optimizers {
  *
  * The implementation is based on the description found at:
  * http://www.cleveralgorithms.com/nature-inspired/swarm/pso.html
+ *
+ * By default the swarm is moved one generation at a time. If the SteadyState parameter
+ * is set, the asynchronous variant is used instead: each evaluated case immediately
+ * updates the personal best of its particle and the global best, and the particle is
+ * then moved and a new case issued for it, without waiting for the rest of the swarm.
+ * A generation is then counted for every swarm size of cases issued.
  */
 class PSO : public Optimizer {
  public:
@@ -44,7 +52,9 @@ class PSO : public Optimizer {
       Constraints::ConstraintHandler *constraint_handler=0);
  protected:
   void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Mark the particle of the case as idle (steady-state mode).
   void iterate() override;
+  void warmStart(QList<Case *> cases) override; //!< Move half of the initial swarm to the best of the cases.
   virtual TerminationCondition IsFinished() override;
  protected:
     boost::random::mt19937 gen_; //!< Random number generator with the random functions in math.hpp
@@ -54,7 +64,7 @@ class PSO : public Optimizer {
     Case *case_pointer; //!< Pointer to the case
     Eigen::VectorXd rea_vars_velocity; //!< The velocity of the real variables
     Particle(Optimization::Case *c, boost::random::mt19937 &gen, Eigen::VectorXd v_max, int n_vars);
-    Particle(){}
+    Particle() : case_pointer(nullptr) {}
     void ParticleAdapt(Eigen::VectorXd rea_vars_velocity_swap, Eigen::VectorXd rea_vars);
     double ofv() { return case_pointer->objective_function_value(); }
   };
@@ -86,6 +96,31 @@ class PSO : public Optimizer {
    * @return
    */
   vector<PSO::Particle> update_position();
+
+  /*!
+   * @brief Update the velocity of a single particle. Used by update_velocity.
+   * @param particle The particle to be updated.
+   * @param personal_best The best perturbation found by the particle.
+   */
+  void update_particle_velocity(Particle &particle, const Particle &personal_best);
+
+  /*!
+   * @brief Move a single particle according to its velocity, reflecting it off the bounds.
+   * Used by update_position.
+   */
+  void update_particle_position(Particle &particle);
+
+  /*!
+   * @brief Steady-state version of iterate(): move the first idle particle, i.e. one whose last
+   * case has been evaluated, and issue a new case for it.
+   */
+  void iterateSteadyState();
+
+  /*!
+   * @brief Steady-state version of the bookkeeping in handleEvaluatedCase(): update the
+   * personal and global bests and mark the particle the case belongs to as idle.
+   */
+  void handleEvaluatedCaseSteadyState(Case *c);
   /*!
    * @brief Prints the swarm and its current values in a readable format, calls print particle
    * @param swarm
@@ -123,6 +158,12 @@ class PSO : public Optimizer {
   Eigen::VectorXd upper_bound_; //!< Upper bounds for the variables (used for randomly generating populations and mutation)
   int n_vars_; //!< Number of variables in the problem.
 
+  bool steady_state_; //!< Whether the asynchronous steady-state variant is used.
+  int issued_updates_ = 0; //!< Number of particle updates issued in steady-state mode.
+  vector<Particle> personal_best_; //!< Best perturbation found by each particle (steady-state mode).
+  QHash<QUuid, int> particle_of_case_; //!< Index of the particle each case being evaluated belongs to (steady-state mode).
+  std::deque<int> idle_particles_; //!< Particles whose last case has been evaluated, in the order they returned (steady-state mode).
+
 };
 }
 }
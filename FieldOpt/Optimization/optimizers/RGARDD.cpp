@@ -37,14 +37,30 @@ RGARDD::RGARDD(Settings::Optimizer *settings,
         discard_parameter_ = 1.0/population_size_;
     else discard_parameter_ = settings->parameters().discard_parameter;
     stagnation_limit_ = settings->parameters().stagnation_limit;
+    steady_state_ = settings->parameters().steady_state;
+    if (steady_state_) {
+        // The initial cases are added to the population as they are evaluated
+        is_async_ = true;
+        population_.clear();
+    }
     mating_pool_ = population_;
     if (enable_logging_) {
         logger_->AddEntry(this);
         logger_->AddEntry(new ConfigurationSummary(this));
     }
 }
+void RGARDD::retainedCases(QSet<QUuid> &retained) const {
+    GeneticAlgorithm::retainedCases(retained);
+    for (auto &chrom : mating_pool_) {
+        retained.insert(chrom.case_pointer->id());
+    }
+}
 void RGARDD::iterate() {
-    if (case_handler_->QueuedCases().size() > 0 || case_handler_->CasesBeingEvaluated().size() > 0) {
+    if (steady_state_) {
+        iterateSteadyState();
+        return;
+    }
+    if (case_handler_->NumberQueued() > 0 || case_handler_->NumberBeingEvaluated() > 0) {
         Printer::ext_warn("Iteration requested while evaluation queue is not empty. Skipping call.", "Optimization", "RGARDD");
         return;
     }
@@ -87,7 +103,89 @@ void RGARDD::iterate() {
     }
     iteration_++;
 }
+void RGARDD::iterateSteadyState() {
+    if (iteration_ >= max_generations_) {
+        return;
+    }
+    if (pending_immigrants_ > 0) {
+        case_handler_->AddNewCase(generateRandomCase());
+        pending_immigrants_--;
+        return;
+    }
+    if (population_.size() < 2) {
+        return; // Wait for more evaluated cases
+    }
+    population_ = sortPopulation(population_);
+    if (population_.size() == population_size_ && is_stagnant()) {
+        if (VERB_OPT >= 1) {
+            Printer::ext_info("The population has stagnated in generation" +
+                Printer::num2str(iteration_) + ". Repopulating",
+                "RGARDD", "Optimization");
+        }
+        population_.resize(1);
+        pending_immigrants_ = population_size_ - 1;
+        iterateSteadyState();
+        return;
+    }
+
+    auto parents = selectParents();
+    vector<Chromosome> offspring;
+    if (random_double(gen_) > p_crossover_ && parents[0].rea_vars != parents[1].rea_vars
+        && population_.front().ofv() != population_.back().ofv()) {
+        offspring = crossover(parents);
+    }
+    else {
+        offspring = mutate(parents);
+    }
+    for (auto &child : offspring) {
+        child.createNewCase();
+        case_handler_->AddNewCase(child.case_pointer);
+        issued_offspring_++;
+        if (issued_offspring_ % population_size_ == 0) {
+            iteration_++;
+            if (enable_logging_) {
+                logger_->AddEntry(this);
+            }
+        }
+    }
+}
+void RGARDD::handleEvaluatedCaseSteadyState(Case *c) {
+    if (population_.size() < population_size_) {
+        population_.push_back(Chromosome(c));
+    }
+    else {
+        population_ = sortPopulation(population_);
+        if (isBetter(c, population_.back().case_pointer)) {
+            population_.back() = Chromosome(c);
+        }
+    }
+    if (isImprovement(c)) {
+        updateTentativeBestCase(c);
+        if (enable_logging_) {
+            logger_->AddEntry(this);
+        }
+        if (VERB_OPT >= 1) {
+            Printer::ext_info("New best in generation " + Printer::num2str(iteration_) + ": "
+            + Printer::num2str(GetTentativeBestCase()->objective_function_value()), "RGARDD", "Optimization");
+        }
+    }
+}
+vector<GeneticAlgorithm::Chromosome> RGARDD::selectParents() {
+    int n = population_.size();
+    auto mating_pool = population_;
+    int n_repl = floor(n * discard_parameter_);
+    for (int i = n - n_repl; i < n; ++i) {
+        mating_pool[i] = population_[i - n + n_repl];
+    }
+    mating_pool = sortPopulation(mating_pool);
+    int i = std::min(n / 2 - 1, (int)floor(random_double(gen_) * (n / 2)));
+    return vector<Chromosome>{mating_pool[i], mating_pool[n / 2 + i]};
+}
 void RGARDD::handleEvaluatedCase(Case *c) {
+    if (steady_state_) {
+        handleEvaluatedCaseSteadyState(c);
+        return;
+    }
     int index = -1;
     for (int i = 0; i < mating_pool_.size(); ++i) {
         if (mating_pool_[i].case_pointer == c) {
@@ -144,7 +242,7 @@ vector<GeneticAlgorithm::Chromosome> RGARDD::crossover(vector<Chromosome> mating
     Chromosome o2 = Chromosome(p2.case_pointer);
 
     double s = abs(p1.ofv() - p2.ofv()) /
-        (population_[0].ofv() - population_[population_size_-1].ofv());
+        (population_.front().ofv() - population_.back().ofv());
     o1.rea_vars = p1.rea_vars + s * dirs;
     o2.rea_vars = p2.rea_vars + s * dirs;
     snap_to_bounds(o1);
@@ -210,6 +308,7 @@ map<string, string> RGARDD::ConfigurationSummary::GetState() {
     statemap["Crossover Probability"] = boost::lexical_cast<string>(opt_->p_crossover_);
     statemap["Decay Rate"] = boost::lexical_cast<string>(opt_->decay_rate_);
     statemap["Mutation Strength"] = boost::lexical_cast<string>(opt_->mutation_strength_);
+    statemap["Steady State"] = opt_->steady_state_ ? "Yes" : "No";
 
     string constraints_used = "";
     for (auto cons : opt_->constraint_handler_->constraints()) {
@@ -45,6 +45,15 @@ namespace Optimizers {
  * passes below the stagnation limit. The stagnation indicator used
  * is the standard deviation of the population.
  *
+ * If the SteadyState parameter is set, an asynchronous steady-state
+ * variant is used instead of generational replacement: whenever a case
+ * is evaluated, the offspring replaces the worst individual in the
+ * population if it is better, and a new pair of offspring is bred from
+ * the current population and queued, without waiting for the rest of
+ * the generation. A generation is then counted for every population
+ * size of offspring. On stagnation, all but the best individual are
+ * dropped and the population is refilled with random cases.
+ *
  * \note This algorithm requires either that simple max/min bounds are
  * given (i.e. single numbers applying to all variables) as an optimizer
  * argument or that some form of bound constraints are used (e.g. reservoir
@@ -64,6 +73,9 @@ class RGARDD : public GeneticAlgorithm {
   vector<Chromosome> mating_pool_; //!< Holds the current mating pool.
   double discard_parameter_; //!< Determines the fraction of parents to be discarded in selection.
   double stagnation_limit_; //!< The threshold for when to regenerate the population.
+  bool steady_state_; //!< Whether the asynchronous steady-state variant is used.
+  int issued_offspring_ = 0; //!< Number of offspring issued in steady-state mode.
+  int pending_immigrants_ = 0; //!< Number of random cases still to be issued after stagnation (steady-state mode).
 
   /*!
    * @brief Perform the next iteration by generating a new mating pool
@@ -82,6 +94,31 @@ class RGARDD : public GeneticAlgorithm {
    */
   void handleEvaluatedCase(Optimization::Case *c) override;
 
+  /*!
+   * @brief Retain the cases in the population and in the mating pool.
+   */
+  void retainedCases(QSet<QUuid> &retained) const override;
+
+  /*!
+   * @brief Steady-state version of iterate(): breed and queue a new pair of
+   * offspring from the current population.
+   */
+  void iterateSteadyState();
+
+  /*!
+   * @brief Steady-state version of handleEvaluatedCase(): add the case to the
+   * population if it is not yet full; otherwise replace the worst individual
+   * if the case is better.
+   */
+  void handleEvaluatedCaseSteadyState(Optimization::Case *c);
+
+  /*!
+   * @brief Select a pair of parents from the current (possibly not yet full)
+   * population, in the same way as the generational Ranking Selection pairs them.
+   * Expects a population from best to worst fitness.
+   */
+  vector<Chromosome> selectParents();
+
   /*!
    * @brief Perform Ranking Selection on the population to generate a
    * new mating pool. Expects a population from best to worst fitness.
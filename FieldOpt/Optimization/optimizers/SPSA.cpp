@@ -1,5 +1,7 @@
 #include "Optimization/optimizers/SPSA.h"
 #include "Utilities/stringhelpers.hpp"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
 #include <cmath>
 
 namespace Optimization {
@@ -28,10 +30,21 @@ SPSA::SPSA(Settings::Optimizer *settings,
   a_ = params.spsa_a;
   c_ = params.spsa_c;
   assert(a_ != 0.0 || init_step_magnitude_ != 0.0);
+  batch_size_ = params.spsa_batch_size;
+  hessian_ = params.spsa_hessian;
+  n_step_candidates_ = params.spsa_step_candidates;
+  if (batch_size_ <= 0) {
+    // Each pair takes two evaluations, four with the shifted pair in 2SPSA
+    batch_size_ = std::max(1, params.parallel_evaluations / (hessian_ ? 4 : 2));
+  }
 
   estimate_ = new Case(base_case);
   perturbations_evaluated_ = false;
+  perturbation_evaluation_failed_ = false;
   perturbations_valid_ = false;
+  line_search_pending_ = false;
+  hessian_estimate_ = Eigen::MatrixXd::Zero(D_, D_);
+  n_hessian_estimates_ = 0;
 
   ub_ = constraint_handler_->GetUpperBounds(base_case->GetRealVarIdVector());
   lb_ = constraint_handler_->GetLowerBounds(base_case->GetRealVarIdVector());
@@ -39,7 +52,7 @@ SPSA::SPSA(Settings::Optimizer *settings,
 
 Optimization::Optimizer::TerminationCondition SPSA::IsFinished()
 {
-  if (case_handler_->CasesBeingEvaluated().size() > 0 || case_handler_->QueuedCases().size() > 0) {
+  if (case_handler_->NumberBeingEvaluated() > 0 || case_handler_->NumberQueued() > 0 || line_search_pending_) {
     return NOT_FINISHED;
   }
   if (iteration_ >= max_iterations_) {
@@ -52,6 +65,12 @@ Optimization::Optimizer::TerminationCondition SPSA::IsFinished()
   }
 }
 
+void SPSA::handleScreenedOutCase(Case *c)
+{
+  // The case is not evaluated, so it is never an improvement and is skipped like a failed case
+  handleEvaluatedCase(c);
+}
+
 void SPSA::handleEvaluatedCase(Case *c)
 {
   if (isImprovement(c)) {
@@ -62,36 +81,50 @@ void SPSA::handleEvaluatedCase(Case *c)
             "Optimization", "SPSA");
     }
   }
-  bool first_done = perturbations_.first->state.eval == Case::CaseState::E_DONE || perturbations_.first->state.eval == Case::CaseState::E_BOOKKEEPED;
-  bool second_done = perturbations_.second->state.eval == Case::CaseState::E_DONE || perturbations_.second->state.eval == Case::CaseState::E_BOOKKEEPED;
-  if (first_done && second_done)
+  if (!pending_.remove(c->id()) || !pending_.isEmpty()) {
+    return;
+  }
+
+  if (!step_candidates_.isEmpty()) {
+    selectStepCandidate();
+    return;
+  }
+  perturbations_evaluated_ = true;
+  if (updateGradient())
   {
-    perturbations_evaluated_ = true;
     perturbation_evaluation_failed_ = false;
     if (VERB_OPT >= 3) {
-      Printer::ext_info("Both perturbations evaluated in iteration " + Printer::num2str(iteration_), "Optimization", "SPSA");
+      Printer::ext_info("Perturbations evaluated in iteration " + Printer::num2str(iteration_), "Optimization", "SPSA");
+    }
+    if (hessian_) {
+      updateHessian();
     }
-    updateGradient();
+    updateDirection();
     if (iteration_ == 1 && init_step_magnitude_ != 0.0) {
       if (VERB_OPT >= 3) { Printer::ext_info("First iteration done. Computing a.", "Optimization", "SPSA"); }
       compute_a();
     }
     update_a_k();
-    updateEstimate();
+    if (n_step_candidates_ > 0) {
+      line_search_pending_ = true;
+    }
+    else {
+      updateEstimate();
+    }
   }
-  else if ( ! first_done && ! second_done ) {
-      std::stringstream ss;
-      ss << "Non-successfully evaluated case returned (codes: " 
-          << perturbations_.first->state.eval << ", " << perturbations_.second->state.eval
-          << "). Attempting to recover.";
-      Printer::ext_warn(ss.str(), "Optimization", "SPSA");
-      perturbation_evaluation_failed_ = true;
+  else {
+    Printer::ext_warn("No perturbation pair was successfully evaluated in iteration " + Printer::num2str(iteration_)
+                          + ". Skipping the update.", "Optimization", "SPSA");
+    perturbation_evaluation_failed_ = true;
   }
-
 }
 
 void SPSA::iterate()
 {
+  if (line_search_pending_) {
+    createStepCandidates();
+    return;
+  }
   logger_->AddEntry(this);
 
   if (iteration_ >= max_iterations_) {
@@ -99,7 +132,7 @@ void SPSA::iterate()
     return;
   }
 
-  if ( ! perturbations_evaluated_ && iteration_ != 0) {
+  if (( ! perturbations_evaluated_ && iteration_ != 0) || ! pending_.isEmpty()) {
     Printer::ext_warn("Iterate called before perturbations were evaluated.", "Optimization", "SPSA");
     return;
   }
@@ -110,21 +143,9 @@ void SPSA::iterate()
   }
 
   update_c_k();
+  createPerturbationPairs();
 
-  int max_attempts = 1*D_;
-  int attempt = 1;
-  perturbations_valid_ = false;
-  auto first = new Case(estimate_);
-  auto second = new Case(estimate_);
-  while (perturbations_valid_ == false && attempt <= max_attempts) {
-    updateSPVector();
-    createPerturbations(first, second);
-    attempt++;
-  }
-  perturbations_ = std::pair<Case *, Case *>(first, second);
-
-  if (perturbations_valid_ == false) {
-    Printer::ext_warn("Unable to generate valid pair of perturbations after " + Printer::num2str(max_attempts) + " attempts.", "Optimization", "SPSA");
+  if (perturbations_.empty()) {
     if ((iteration_ - tentative_best_case_iteration_) > 0.1*max_iterations_) {
       Printer::ext_warn("No new best case found in the last (0.1*max_iterations) iterations. Setting estimate to tentative best case.", "Optimization", "SPSA");
       estimate_->SetRealVarValues(tentative_best_case_->GetRealVarVector());
@@ -134,12 +155,73 @@ void SPSA::iterate()
     iterate();
   }
   else {
-    case_handler_->AddNewCase(perturbations_.first);
-    case_handler_->AddNewCase(perturbations_.second);
+    for (auto &pair : perturbations_) {
+      case_handler_->AddNewCase(pair.first);
+      case_handler_->AddNewCase(pair.second);
+      pending_.insert(pair.first->id());
+      pending_.insert(pair.second->id());
+    }
+    for (auto &pair : hessian_perturbations_) {
+      if (pair.first != nullptr) {
+        case_handler_->AddNewCase(pair.first);
+        case_handler_->AddNewCase(pair.second);
+        pending_.insert(pair.first->id());
+        pending_.insert(pair.second->id());
+      }
+    }
     perturbations_evaluated_ = false;
   }
 }
 
+void SPSA::createPerturbationPairs()
+{
+  perturbations_.clear();
+  deltas_.clear();
+  hessian_perturbations_.clear();
+  hessian_deltas_.clear();
+
+  int max_attempts = 1*D_;
+  for (int j = 0; j < batch_size_; ++j) {
+    int attempt = 1;
+    perturbations_valid_ = false;
+    auto first = new Case(estimate_);
+    auto second = new Case(estimate_);
+    while (perturbations_valid_ == false && attempt <= max_attempts) {
+      updateSPVector();
+      createPerturbations(first, second);
+      attempt++;
+    }
+    if (perturbations_valid_ == false) {
+      Printer::ext_warn("Unable to generate valid pair of perturbations after " + Printer::num2str(max_attempts) + " attempts.", "Optimization", "SPSA");
+      delete first;
+      delete second;
+      continue;
+    }
+    perturbations_.push_back(std::pair<Case *, Case *>(first, second));
+    deltas_.push_back(delta_k_);
+
+    if (hessian_) {
+      // The shifted cases share the evaluations of the pair (common random numbers)
+      Eigen::VectorXd shift = random_symmetric_bernoulli_eigen(gen_, D_);
+      auto first_shifted = new Case(first);
+      auto second_shifted = new Case(second);
+      first_shifted->SetRealVarValues(first->GetRealVarVector() + c_k_ * shift);
+      second_shifted->SetRealVarValues(second->GetRealVarVector() + c_k_ * shift);
+      if (constraint_handler_->CaseSatisfiesConstraints(first_shifted)
+          && constraint_handler_->CaseSatisfiesConstraints(second_shifted)) {
+        hessian_perturbations_.push_back(std::pair<Case *, Case *>(first_shifted, second_shifted));
+      }
+      else {
+        if (VERB_OPT >= 1) Printer::ext_info("Shifted perturbations violate constraints. Not used for the Hessian.", "Optimization", "SPSA");
+        delete first_shifted;
+        delete second_shifted;
+        hessian_perturbations_.push_back(std::pair<Case *, Case *>(nullptr, nullptr));
+      }
+      hessian_deltas_.push_back(shift);
+    }
+  }
+}
+
 void SPSA::update_a_k()
 {
   a_k_ = a_ / pow((A_ + iteration_), alpha_);
@@ -228,20 +310,124 @@ void SPSA::createPerturbations(Case *first, Case *second)
   }
 }
 
-void SPSA::updateGradient()
+bool SPSA::updateGradient()
 {
   if (VERB_OPT >= 3) Printer::ext_info("Updating gradient.", "Optimization", "SPSA");
-  double yplus = perturbations_.first->objective_function_value();
-  double yminus = perturbations_.second->objective_function_value();
-  if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
-    yplus = yplus * -1;
-    yminus = yminus * -1;
+  g_k_ = Eigen::VectorXd::Zero(D_);
+  int n_pairs = 0;
+  for (int j = 0; j < perturbations_.size(); ++j) {
+    if (!isEvaluated(perturbations_[j].first) || !isEvaluated(perturbations_[j].second)) {
+      continue;
+    }
+    double yplus = loss(perturbations_[j].first);
+    double yminus = loss(perturbations_[j].second);
+    for (int i = 0; i < D_; ++i) {
+      g_k_[i] += (yplus - yminus) / (2 * c_k_ * deltas_[j][i]);
+    }
+    n_pairs++;
   }
-  g_k_.resize(D_);
-  for (int i = 0; i < D_; ++i) {
-    g_k_[i] = (yplus - yminus) / (2 * c_k_ * delta_k_[i]);
+  if (n_pairs == 0) {
+    return false;
   }
+  g_k_ /= n_pairs;
   if (VERB_OPT >= 4) Printer::ext_info("Updated gradient vector: " + eigenvec_to_str(g_k_), "Optimization", "SPSA");
+  return true;
+}
+
+void SPSA::updateHessian()
+{
+  Eigen::MatrixXd estimate = Eigen::MatrixXd::Zero(D_, D_);
+  int n_pairs = 0;
+  for (int j = 0; j < perturbations_.size(); ++j) {
+    auto pair = perturbations_[j];
+    auto shifted = hessian_perturbations_[j];
+    if (shifted.first == nullptr
+        || !isEvaluated(pair.first) || !isEvaluated(pair.second)
+        || !isEvaluated(shifted.first) || !isEvaluated(shifted.second)) {
+      continue;
+    }
+    double diff = (loss(shifted.first) - loss(pair.first)) - (loss(shifted.second) - loss(pair.second));
+    Eigen::VectorXd delta_g = diff / c_k_ * hessian_deltas_[j].cwiseInverse();
+    Eigen::MatrixXd h = delta_g / (2.0 * c_k_) * deltas_[j].cwiseInverse().transpose();
+    estimate += 0.5 * (h + h.transpose());
+    n_pairs++;
+  }
+  if (n_pairs == 0) {
+    Printer::ext_warn("No shifted pair was successfully evaluated. Keeping the Hessian estimate.", "Optimization", "SPSA");
+    return;
+  }
+  estimate /= n_pairs;
+  hessian_estimate_ = (n_hessian_estimates_ * hessian_estimate_ + estimate) / (n_hessian_estimates_ + 1.0);
+  n_hessian_estimates_++;
+}
+
+void SPSA::updateDirection()
+{
+  direction_ = g_k_;
+  if (!hessian_ || n_hessian_estimates_ == 0) {
+    return;
+  }
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(hessian_estimate_);
+  if (solver.info() != Eigen::Success) {
+    Printer::ext_warn("Unable to decompose the Hessian estimate. Using the gradient as step direction.", "Optimization", "SPSA");
+    return;
+  }
+  Eigen::VectorXd eigenvalues = solver.eigenvalues().cwiseAbs();
+  double max_eigenvalue = eigenvalues.maxCoeff();
+  if (max_eigenvalue <= 0.0) {
+    return;
+  }
+  for (int i = 0; i < D_; ++i) {
+    eigenvalues[i] = std::max(eigenvalues[i], 1e-6 * max_eigenvalue);
+  }
+  direction_ = solver.eigenvectors() * (solver.eigenvectors().transpose() * g_k_).cwiseQuotient(eigenvalues);
+  if (VERB_OPT >= 4) Printer::ext_info("Updated step direction: " + eigenvec_to_str(direction_), "Optimization", "SPSA");
+}
+
+void SPSA::createStepCandidates()
+{
+  line_search_pending_ = false;
+  step_candidates_.clear();
+  for (int j = 0; j < n_step_candidates_; ++j) {
+    double scale = std::pow(2.0, n_step_candidates_ / 2 - j);
+    auto candidate = new Case(estimate_);
+    candidate->SetRealVarValues(estimate_->GetRealVarVector() - scale * a_k_ * direction_);
+    constraint_handler_->SnapCaseToConstraints(candidate);
+    step_candidates_.append(candidate);
+    case_handler_->AddNewCase(candidate);
+    pending_.insert(candidate->id());
+  }
+}
+
+void SPSA::selectStepCandidate()
+{
+  Case *best = nullptr;
+  for (Case *c : step_candidates_) {
+    if (isEvaluated(c) && (best == nullptr || loss(c) < loss(best))) {
+      best = c;
+    }
+  }
+  step_candidates_.clear();
+  if (best == nullptr) {
+    Printer::ext_warn("No step candidate was successfully evaluated. Taking the step without line search.", "Optimization", "SPSA");
+    updateEstimate();
+    return;
+  }
+  if (VERB_OPT >= 3) Printer::ext_info("Selected step candidate: " + Printer::num2str(best->objective_function_value()), "Optimization", "SPSA");
+  estimate_->SetRealVarValues(best->GetRealVarVector());
+}
+
+double SPSA::loss(Case *c) const
+{
+  if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
+    return -1 * c->objective_function_value();
+  }
+  return c->objective_function_value();
+}
+
+bool SPSA::isEvaluated(Case *c)
+{
+  return c->state.eval == Case::CaseState::E_DONE || c->state.eval == Case::CaseState::E_BOOKKEEPED;
 }
 
 void SPSA::updateEstimate() {
@@ -254,8 +440,8 @@ void SPSA::updateEstimate() {
     tentative_best_case_iteration_ = iteration_;
   }
   else {
-    if (VERB_OPT >= 4) Printer::ext_info("Taking step: " + eigenvec_to_str(-1.0 * a_k_ * g_k_), "Optimization", "SPSA");
-    estimate_->SetRealVarValues(estimate_->GetRealVarVector() - a_k_ * g_k_);
+    if (VERB_OPT >= 4) Printer::ext_info("Taking step: " + eigenvec_to_str(-1.0 * a_k_ * direction_), "Optimization", "SPSA");
+    estimate_->SetRealVarValues(estimate_->GetRealVarVector() - a_k_ * direction_);
     constraint_handler_->SnapCaseToConstraints(estimate_);
   }
 
@@ -263,7 +449,7 @@ void SPSA::updateEstimate() {
 
 void SPSA::compute_a()
 {
-  a_ = init_step_magnitude_ / abs(g_k_.mean()) * pow(A_ + 1.0, alpha_);
+  a_ = init_step_magnitude_ / abs(direction_.mean()) * pow(A_ + 1.0, alpha_);
   if (a_ < 0.0) a_ = 0.0;
   if (a_ > 1.0) a_ = 1.0;
   if (VERB_OPT >= 2) {
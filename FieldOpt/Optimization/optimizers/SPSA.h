@@ -25,7 +25,9 @@
 #include "Utilities/math.hpp"
 #include "Utilities/random.hpp"
 #include <Eigen/Core>
+#include <QSet>
 #include <utility>
+#include <vector>
 
 namespace Optimization {
 namespace Optimizers {
@@ -41,6 +43,14 @@ namespace Optimizers {
  * The default parameter values are based on the recommendations described in
  * [2] "Implementation of the simultaneous perturbation algorithm for stochastic optimization",
  *	James C. Spall, IEEE Transactions on Aearospace and Electronic Systems, vol. 34 no. 3 (1998)
+ *
+ * To keep more workers busy, several perturbation pairs can be evaluated in each iteration
+ * (SPSA-BatchSize); the gradient estimates from the pairs are averaged. Optionally, the
+ * Hessian is estimated as well, from two more cases per pair that reuse the evaluations of
+ * the pair (common random numbers), and the steps are preconditioned with the running
+ * average of the estimates (2SPSA, see [1]). Finally, a number of step lengths along each
+ * step direction can be evaluated in parallel (SPSA-StepCandidates), the best of which
+ * becomes the next estimate.
  */
 class SPSA : public Optimizer {
  public:
@@ -56,6 +66,7 @@ class SPSA : public Optimizer {
 
  protected:
   void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Treat the case as a failed evaluation.
   void iterate() override;
 
  private:
@@ -69,17 +80,30 @@ class SPSA : public Optimizer {
   double c_;     //!< Used to compensate for noise.
   double init_step_magnitude_; //!< Used to compute the a_ parameter.
 
+  int batch_size_; //!< Number of perturbation pairs per iteration.
+  bool hessian_; //!< Whether the Hessian is estimated (2SPSA).
+  int n_step_candidates_; //!< Number of step lengths to evaluate along each step direction.
+
   // Run-time variables
   bool perturbations_evaluated_; //!< Indicates whether the perturbations used for grad. est. have been evaluated.
   bool perturbation_evaluation_failed_; //!< Indicates whether at least one perturbation evaluation failed.
+  bool line_search_pending_; //!< Indicates that step candidates should be generated along direction_.
   int D_;        //!< Dimensionality of problem.
   boost::random::mt19937 gen_; //!< Random number generator.
   double a_k_;             //!< Gain sequence a at iteration k: \$ a_k = a/(A+k)^{\alpha} \$.
   double c_k_;    //!< Gain sequence c at iteration k: \$ c_k = c/k^{\gamma} \$
   Eigen::VectorXd g_k_;    //!< Gradient at iteration k.
   Eigen::VectorXd delta_k_; //!< Simultaneous perturbation vector at iteration k.
-
-  std::pair<Case *, Case *> perturbations_; //!< Perturbations currently used for gradient computation.
+  Eigen::VectorXd direction_; //!< Step direction at iteration k: the gradient, preconditioned with the Hessian in 2SPSA.
+  Eigen::MatrixXd hessian_estimate_; //!< Running average of the Hessian estimates (2SPSA).
+  int n_hessian_estimates_; //!< Number of iterations averaged in hessian_estimate_.
+
+  std::vector<std::pair<Case *, Case *>> perturbations_; //!< Perturbation pairs currently used for gradient computation.
+  std::vector<Eigen::VectorXd> deltas_; //!< The perturbation vector of each pair.
+  std::vector<std::pair<Case *, Case *>> hessian_perturbations_; //!< The pairs shifted by \$ c_k \tilde{\Delta}_k \$ (2SPSA). Null if the shifted cases violate constraints.
+  std::vector<Eigen::VectorXd> hessian_deltas_; //!< The shift vector \$ \tilde{\Delta}_k \$ of each pair (2SPSA).
+  QList<Case *> step_candidates_; //!< Step candidates currently being evaluated.
+  QSet<QUuid> pending_; //!< Cases generated in the current iteration that have not been evaluated yet.
   Case *estimate_; //!< The estimated best case. This is never actually evaluated.
 
   Eigen::VectorXd ub_; //!< Upper bounds
@@ -128,17 +152,63 @@ class SPSA : public Optimizer {
   void createPerturbations(Case *first, Case *second);
 
   /*!
-   * @brief Update g_k_ by using the two cases in perturbations_.
+   * @brief Generate the perturbation pairs for an iteration, and for 2SPSA the shifted pairs.
+   * Pairs for which no valid perturbations are found are discarded.
+   */
+  void createPerturbationPairs();
+
+  /*!
+   * @brief Update g_k_ by using the pairs in perturbations_.
    * The gradient is updated according to:
    * \$ g_k (\theta_k) = \frac{y(\theta_k + c_k \Delta_k)
    *                     - y(\theta_k - c_k \Delta_k}{2c_k}
    *                     * [\Delta^{-1}_{k1}, \Delta^{-1}_{k2}, ... , \Delta^{-1}_{kD} ]^T \$
+   * averaged over the successfully evaluated pairs.
+   * @return False if none of the pairs were successfully evaluated.
+   */
+  bool updateGradient();
+
+  /*!
+   * @brief Add the average Hessian estimate from the shifted pairs to the running average:
+   * \$ \hat{H}_k = \frac{1}{2} \left[ \frac{\delta G_k}{2 c_k} \Delta^{-T}_k
+   *                 + \left( \frac{\delta G_k}{2 c_k} \Delta^{-T}_k \right)^T \right] \$, where
+   * \$ \delta G_k \$ is the difference between the one-sided gradient estimates at the two
+   * cases of a pair, using the shifted cases.
+   */
+  void updateHessian();
+
+  /*!
+   * @brief Set direction_ to the gradient, preconditioned with the inverse of the Hessian
+   * estimate in 2SPSA. The eigenvalues of the Hessian estimate are replaced by their magnitude
+   * (bounded away from zero) to make it positive definite.
+   */
+  void updateDirection();
+
+  /*!
+   * @brief Generate step_candidates_ along -direction_, with the step lengths a_k
+   * scaled by powers of two.
+   */
+  void createStepCandidates();
+
+  /*!
+   * @brief Set the estimate to the best of the evaluated step candidates. If none of
+   * them were successfully evaluated, the step is taken as without line search.
+   */
+  void selectStepCandidate();
+
+  /*!
+   * @brief The objective function value of a case as a loss to be minimized.
+   */
+  double loss(Case *c) const;
+
+  /*!
+   * @brief Check whether a case was successfully evaluated.
    */
-  void updateGradient();
+  static bool isEvaluated(Case *c);
 
   /*!
    * @brief Update the estimate_ field (estimated best position).
-   * \$ \theta_{k+1} = \theta_k - a_k g_k(\theta_k) \$
+   * \$ \theta_{k+1} = \theta_k - a_k g_k(\theta_k) \$, with the gradient preconditioned in 2SPSA.
    *
    * If no new tentative best case has been found in the 0.2*max_iterations_ iterations,
    * the estimate will be set to the tentative best case.
@@ -148,6 +218,7 @@ class SPSA : public Optimizer {
   /*!
    * Compute the a_ parameter using init_step_magnitude_  after evaluation of the first pair of
    * perturbations. Only called if init_step_magnitude_ != 0.0.
+   * It is based on the first step direction, i.e. the first gradient.
    */
   void compute_a();
 };
@@ -18,6 +18,7 @@
    along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include "VFSA.h"
+#include <algorithm>
 #include <cmath>
 #include "Utilities/math.hpp"
 
@@ -55,9 +56,38 @@ VFSA::VFSA(Settings::Optimizer *settings,
     }
 
     evals_in_iteration_ = 0;
+
+    int n_chains = settings->parameters().vfsa_chains;
+    if (n_chains <= 0) {
+        n_chains = settings->parameters().parallel_evaluations;
+    }
+    if (n_chains > 1) {
+        is_async_ = true;
+        double ladder = settings->parameters().vfsa_temp_ladder;
+        for (int k = 0; k < n_chains; ++k) {
+            Chain chain;
+            chain.x = base_case->GetRealVarVector();
+            chain.ofv = base_case->objective_function_value();
+            chain.T0 = T_ * pow(ladder, (double)k / (n_chains - 1));
+            chain.T = chain.T0;
+            chain.busy = false;
+            chains_.append(chain);
+        }
+        if (VERB_OPT >= 1) {
+            Printer::ext_info("Running " + Printer::num2str(n_chains) + " chains with temperatures from "
+                                  + Printer::num2str(chains_.first().T.norm()) + " to "
+                                  + Printer::num2str(chains_.last().T.norm()) + ".", "Optimization", "VFSA");
+        }
+    }
+    swap_interval_ = settings->parameters().vfsa_swap_interval;
+    if (swap_interval_ <= 0) {
+        swap_interval_ = std::max(1, n_chains);
+    }
+    evals_since_swap_ = 0;
+    swap_parity_ = 0;
 }
 Optimization::Optimizer::TerminationCondition VFSA::IsFinished() {
-    if (case_handler_->CasesBeingEvaluated().size() > 0 || case_handler_->QueuedCases().size() > 0) {
+    if (case_handler_->NumberBeingEvaluated() > 0 || case_handler_->NumberQueued() > 0) {
         return NOT_FINISHED;
     }
     else if (iteration_ <= max_iterations_) {
@@ -68,6 +98,10 @@ Optimization::Optimizer::TerminationCondition VFSA::IsFinished() {
     }
 }
 void VFSA::handleEvaluatedCase(Optimization::Case *c) {
+    if (!chains_.isEmpty()) {
+        handleChainCase(c);
+        return;
+    }
     if (isImprovement(c)) { // Update tentative best case if improvement
         if (VERB_OPT >= 1) {
             Printer::ext_info("Found new best case in iteration " + Printer::num2str(iteration_) + ". OFV: "
@@ -89,6 +123,10 @@ void VFSA::handleEvaluatedCase(Optimization::Case *c) {
     evals_in_iteration_++;
 }
 void VFSA::iterate() {
+    if (!chains_.isEmpty()) {
+        iterateChains();
+        return;
+    }
     if (evals_in_iteration_ == evals_pr_iteration_) {
         iteration_++;
         if (VERB_OPT >= 3) Printer::ext_info("Starting iteration " + Printer::num2str(iteration_), "Optimization", "VFSA");
@@ -106,7 +144,91 @@ void VFSA::iterate() {
     }
 }
 
+void VFSA::handleScreenedOutCase(Optimization::Case *c) {
+    if (!chains_.isEmpty()) {
+        handleChainCase(c);
+        return;
+    }
+    evals_in_iteration_++;
+}
+void VFSA::handleChainCase(Optimization::Case *c) {
+    if (!chain_of_case_.contains(c->id())) {
+        return;
+    }
+    Chain &chain = chains_[chain_of_case_.take(c->id())];
+    chain.busy = false;
+    evals_in_iteration_++;
+    evals_since_swap_++;
+
+    bool evaluated = c->state.eval == Case::CaseState::E_DONE || c->state.eval == Case::CaseState::E_BOOKKEEPED;
+    if (evaluated) {
+        if (isImprovement(c)) {
+            if (VERB_OPT >= 1) {
+                Printer::ext_info("Found new best case in iteration " + Printer::num2str(iteration_) + ". OFV: "
+                                      + Printer::num2str(c->objective_function_value()), "Optimization", "VFSA");
+            }
+            updateTentativeBestCase(c);
+        }
+        // Metropolis step within the chain
+        double sel_prop = selectionProbability(chain.ofv, c->objective_function_value(), chain.T);
+        if (sel_prop > random_double(gen_)) {
+            chain.x = c->GetRealVarVector();
+            chain.ofv = c->objective_function_value();
+        }
+    }
+
+    if (evals_in_iteration_ >= evals_pr_iteration_ * chains_.size()) {
+        iteration_++;
+        evals_in_iteration_ = 0;
+        for (Chain &other : chains_) {
+            other.T = nextTemperature(other.T0);
+        }
+        if (VERB_OPT >= 3) Printer::ext_info("Starting iteration " + Printer::num2str(iteration_), "Optimization", "VFSA");
+    }
+    if (evals_since_swap_ >= swap_interval_) {
+        swapChains();
+        evals_since_swap_ = 0;
+    }
+}
+
+void VFSA::iterateChains() {
+    if (iteration_ > max_iterations_) {
+        return;
+    }
+    for (int k = 0; k < chains_.size(); ++k) {
+        if (chains_[k].busy) {
+            continue;
+        }
+        Case *new_case = createPerturbation(chains_[k].x, chains_[k].T);
+        chain_of_case_[new_case->id()] = k;
+        chains_[k].busy = true;
+        case_handler_->AddNewCase(new_case);
+    }
+}
+
+void VFSA::swapChains() {
+    int n_swaps = 0;
+    for (int i = swap_parity_; i + 1 < chains_.size(); i += 2) {
+        Chain &cold = chains_[i];
+        Chain &hot = chains_[i+1];
+        double cold_loss = mode_ == Settings::Optimizer::OptimizerMode::Maximize ? -cold.ofv : cold.ofv;
+        double hot_loss = mode_ == Settings::Optimizer::OptimizerMode::Maximize ? -hot.ofv : hot.ofv;
+        double exponent = (cold_loss - hot_loss) * (1.0 / cold.T.norm() - 1.0 / hot.T.norm());
+        if (exponent >= 0.0 || exp(exponent) > random_double(gen_)) {
+            std::swap(cold.x, hot.x);
+            std::swap(cold.ofv, hot.ofv);
+            n_swaps++;
+        }
+    }
+    swap_parity_ = 1 - swap_parity_;
+    if (VERB_OPT >= 3) Printer::ext_info("Swapped " + Printer::num2str(n_swaps) + " chain states.", "Optimization", "VFSA");
+}
+
 double VFSA::selectionProbability(const double old_ofv, const double new_ofv) const {
+    return selectionProbability(old_ofv, new_ofv, T_);
+}
+
+double VFSA::selectionProbability(const double old_ofv, const double new_ofv, const Eigen::VectorXd &T) const {
     double difference;
     if (mode_ == Settings::Optimizer::OptimizerMode::Maximize) {
         difference = old_ofv - new_ofv;
@@ -114,7 +236,7 @@ double VFSA::selectionProbability(const double old_ofv, const double new_ofv) co
     else {
         difference = new_ofv - old_ofv;
     }
-    return exp(-1.0 * difference / T_.norm());
+    return exp(-1.0 * difference / T.norm());
 }
 
 Eigen::VectorXd VFSA::nextTemperature(const Eigen::VectorXd old_T) const {
@@ -138,8 +260,12 @@ Eigen::VectorXd VFSA::updatingFactors(const Eigen::VectorXd T) {
 }
 
 Case * VFSA::createPerturbation() {
-    Eigen::VectorXd old = tentative_best_case_->GetRealVarVector();
-    Eigen::VectorXd ys = updatingFactors(T_);
+    return createPerturbation(tentative_best_case_->GetRealVarVector(), T_);
+}
+
+Case * VFSA::createPerturbation(const Eigen::VectorXd &x, const Eigen::VectorXd &T) {
+    Eigen::VectorXd old = x;
+    Eigen::VectorXd ys = updatingFactors(T);
 
     Eigen::VectorXd step = ys.cwiseProduct(max_ - min_);
     Eigen::VectorXd new_vars = old + step;
@@ -24,6 +24,8 @@
 #include "Utilities/math.hpp"
 #include "Utilities/random.hpp"
 #include <Eigen/Core>
+#include <QHash>
+#include <QList>
 
 namespace Optimization {
 namespace Optimizers {
@@ -38,6 +40,14 @@ namespace Optimizers {
  *      sounding data from various electrode arrays", Shashi Prakash Sharma, Computers & Geosciences (2012).
  *
  * Note that this algorithm requires boundary constraints to be specified.
+ *
+ * When VFSA-Chains is greater than one, the optimizer runs in multi-chain (parallel tempering) mode:
+ * the chains anneal concurrently at a geometric ladder of temperatures, spanning VFSA-TempLadder
+ * from the coldest to the hottest. Each chain has at most one case in flight, and a new perturbation
+ * is generated for a chain as soon as its previous case returns, so the chains keep all the workers
+ * busy without waiting for each other. Every VFSA-SwapInterval evaluations, the states of neighbouring
+ * chains are swapped with the parallel tempering acceptance probability, letting good states found by
+ * the hot chains migrate to the cold ones.
  */
 class VFSA : public Optimizer {
  public:
@@ -51,6 +61,7 @@ class VFSA : public Optimizer {
   TerminationCondition IsFinished() override;
  protected:
   void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Count the case towards the iteration, or free its chain.
   void iterate() override;
 
  private:
@@ -67,6 +78,11 @@ class VFSA : public Optimizer {
    */
   double selectionProbability(const double old_ofv, const double new_ofv) const;
 
+  /*!
+   * @brief Calculate the selection probability at the temperatures T.
+   */
+  double selectionProbability(const double old_ofv, const double new_ofv, const Eigen::VectorXd &T) const;
+
   /*!
    * @brief Compute the next temperature vector.
    *
@@ -96,6 +112,34 @@ class VFSA : public Optimizer {
    */
   Case *createPerturbation();
 
+  /*!
+   * @brief Create a new perturbation of the point x at the temperatures T.
+   */
+  Case *createPerturbation(const Eigen::VectorXd &x, const Eigen::VectorXd &T);
+
+  /*!
+   * @brief State of one of the chains in multi-chain mode.
+   */
+  struct Chain {
+    Eigen::VectorXd x;  //!< Current point.
+    double ofv;         //!< Objective function value at the current point.
+    Eigen::VectorXd T0; //!< Initial temperatures.
+    Eigen::VectorXd T;  //!< Current temperatures.
+    bool busy;          //!< Whether the chain has a case queued or being evaluated.
+  };
+
+  void handleChainCase(Case *c); //!< Accept or reject a case returned for one of the chains.
+  void iterateChains(); //!< Queue a perturbation for each idle chain.
+
+  /*!
+   * @brief Attempt to swap the states of neighbouring chains.
+   *
+   * Alternates between the even and the odd neighbour pairs. A swap between chains i and j is
+   * accepted with probability \$ min(1, exp( (E_i - E_j)(1/T_i - 1/T_j) )) \$, where \$ E \$ is
+   * the loss (the negated OFV when maximizing).
+   */
+  void swapChains();
+
   bool parallel_;              //!< Use parallel mode. If true, evals_pr_iteration_ cases will be generated immediately when a new iteration starts.
   int evals_pr_iteration_;     //!< Number of evaluations (perturbations) at each temperature level (iteration).
   int max_iterations_;         //!< Maximum number of iterations.
@@ -108,6 +152,12 @@ class VFSA : public Optimizer {
   Eigen::VectorXd min_;        //!< Vector containing lower bounds for variables.
   Eigen::VectorXd max_;        //!< Vector containing upper bounds for variables.
   Eigen::VectorXd c_;          //!< Constant used in updating the temperature.
+
+  QList<Chain> chains_;        //!< Chains in multi-chain mode (empty in single-chain mode), coldest first.
+  QHash<QUuid, int> chain_of_case_; //!< Index of the chain each case in flight belongs to.
+  int swap_interval_;          //!< Number of evaluations between swap attempts.
+  int evals_since_swap_;       //!< Number of evaluations since the last swap attempt.
+  int swap_parity_;            //!< Whether to attempt to swap the even (0) or odd (1) neighbour pairs next.
 };
 
 }
@@ -147,7 +147,7 @@ EGO::EGO(Settings::Optimizer *settings,
 }
 Optimization::Optimizer::TerminationCondition EGO::IsFinished() {
     TerminationCondition tc = NOT_FINISHED;
-    if (case_handler_->CasesBeingEvaluated().size() > 0)
+    if (case_handler_->NumberBeingEvaluated() > 0)
         return tc;
     if (evaluated_cases_ > max_evaluations_)
         tc = MAX_EVALS_REACHED;
@@ -169,6 +169,15 @@ void EGO::handleEvaluatedCase(Case *c) {
         Printer::ext_info("Found new tentative best case: " + Printer::num2str(c->objective_function_value()), "Optimization", "EGO");
     }
 }
+void EGO::warmStart(QList<Case *> cases) {
+    for (Case *c : cases) {
+        gp_->add_pattern(c->GetRealVarVector().data(), normalizer_ofv_.normalize(c->objective_function_value()));
+    }
+    QList<Case *> queued = case_handler_->QueuedCases();
+    for (int i = 0; i < queued.size() && i < cases.size(); ++i) {
+        case_handler_->CancelCase(queued[i]->id());
+    }
+}
 void EGO::iterate() {
     if (enable_logging_) {
         logger_->AddEntry(this);
@@ -206,7 +215,7 @@ void EGO::iterate() {
             cout << "Snapped to UB." << endl;
         }
     }
-    Case *new_case = new Case(case_handler_->AllCases()[0]);
+    Case *new_case = new Case(GetTentativeBestCase());
     new_case->SetRealVarValues(new_position);
     case_handler_->AddNewCase(new_case);
     iteration_++;
@@ -53,6 +53,7 @@ class EGO : public Optimizer {
  protected:
   void handleEvaluatedCase(Case *c) override;
   void iterate() override;
+  void warmStart(QList<Case *> cases) override; //!< Add the cases to the GP, in place of initial guesses.
 
  private:
   VectorXd lb_, ub_; //!< Upper and lower bounds
@@ -0,0 +1,120 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "finite_difference_gradient.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Optimization {
+namespace Optimizers {
+
+FiniteDifferenceGradient::FiniteDifferenceGradient(const Eigen::VectorXd &lower_bounds,
+                                                   const Eigen::VectorXd &upper_bounds,
+                                                   double relative_step, bool central) {
+    lb_ = lower_bounds;
+    ub_ = upper_bounds;
+    relative_step_ = relative_step;
+    central_ = central;
+    n_cases_ = 0;
+    n_submitted_ = 0;
+    n_failed_ = 0;
+}
+
+QList<Case *> FiniteDifferenceGradient::CreateCases(Case *center) {
+    components_.clear();
+    values_.clear();
+    submitted_.clear();
+    n_submitted_ = 0;
+
+    QList<Case *> cases;
+    Eigen::VectorXd x = center->GetRealVarVector();
+    for (int i = 0; i < x.size(); ++i) {
+        bool bounded = ub_[i] > lb_[i];
+        double h = bounded ? relative_step_ * (ub_[i] - lb_[i])
+                           : relative_step_ * std::max(1.0, std::abs(x[i]));
+        bool plus_ok = !bounded || x[i] + h <= ub_[i];
+        bool minus_ok = !bounded || x[i] - h >= lb_[i];
+        if (!central_ && plus_ok) {
+            minus_ok = false; // Forward differences only use the other side at the upper bound
+        }
+
+        Component component;
+        component.h = h;
+        if (plus_ok) {
+            auto c = new Case(center);
+            Eigen::VectorXd values = x;
+            values[i] += h;
+            c->SetRealVarValues(values);
+            component.plus = c->id();
+            cases.append(c);
+        }
+        if (minus_ok) {
+            auto c = new Case(center);
+            Eigen::VectorXd values = x;
+            values[i] -= h;
+            c->SetRealVarValues(values);
+            component.minus = c->id();
+            cases.append(c);
+        }
+        components_.push_back(component);
+    }
+    for (Case *c : cases) {
+        submitted_.insert(c->id(), false);
+    }
+    n_cases_ = cases.size();
+    return cases;
+}
+
+bool FiniteDifferenceGradient::Submit(Case *c) {
+    if (!submitted_.contains(c->id())) {
+        return false;
+    }
+    if (!submitted_[c->id()]) {
+        submitted_[c->id()] = true;
+        n_submitted_++;
+        if (c->state.eval == Case::CaseState::E_DONE || c->state.eval == Case::CaseState::E_BOOKKEEPED) {
+            values_.insert(c->id(), c->objective_function_value());
+        }
+    }
+    return true;
+}
+
+Eigen::VectorXd FiniteDifferenceGradient::Gradient(double center_ofv) const {
+    n_failed_ = 0;
+    Eigen::VectorXd gradient = Eigen::VectorXd::Zero(components_.size());
+    for (int i = 0; i < (int)components_.size(); ++i) {
+        const Component &component = components_[i];
+        bool plus = !component.plus.isNull() && values_.contains(component.plus);
+        bool minus = !component.minus.isNull() && values_.contains(component.minus);
+        if (plus && minus) {
+            gradient[i] = (values_[component.plus] - values_[component.minus])
+                / (2.0 * component.h);
+        }
+        else if (plus) {
+            gradient[i] = (values_[component.plus] - center_ofv) / component.h;
+        }
+        else if (minus) {
+            gradient[i] = (center_ofv - values_[component.minus]) / component.h;
+        }
+        else {
+            n_failed_++;
+        }
+    }
+    return gradient;
+}
+
+}
+}
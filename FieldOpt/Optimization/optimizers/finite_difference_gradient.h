@@ -0,0 +1,104 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_FINITE_DIFFERENCE_GRADIENT_H
+#define FIELDOPT_FINITE_DIFFERENCE_GRADIENT_H
+
+#include "Optimization/case.h"
+#include <Eigen/Core>
+#include <QHash>
+#include <QList>
+#include <QUuid>
+#include <vector>
+
+namespace Optimization {
+namespace Optimizers {
+
+/*!
+ * @brief The FiniteDifferenceGradient class estimates the gradient of the objective function
+ * with respect to the continuous variables from finite differences.
+ *
+ * All the perturbed cases for one gradient are created at once, so that they can be
+ * evaluated in parallel: n cases for forward differences, 2n for central differences.
+ * The step for variable i is relative_step * (ub_i - lb_i), or relative_step * max(1, |x_i|)
+ * for variables without bounds (ub_i <= lb_i, as returned by ConstraintHandler when there
+ * are no bound constraints). When a step would leave the bounds, the difference is taken in the other direction instead; central differences fall
+ * back to a one-sided difference in that case. A one-sided difference is also used if one
+ * of the two cases of a central difference fails to evaluate.
+ */
+class FiniteDifferenceGradient {
+ public:
+  /*!
+   * @param lower_bounds Lower bounds of the continuous variables.
+   * @param upper_bounds Upper bounds of the continuous variables.
+   * @param relative_step Step, relative to the range between the bounds.
+   * @param central Use central differences instead of forward differences.
+   */
+  FiniteDifferenceGradient(const Eigen::VectorXd &lower_bounds, const Eigen::VectorXd &upper_bounds,
+                           double relative_step, bool central);
+
+  /*!
+   * @brief Create the perturbed cases for a gradient at the center case. Any previous
+   * gradient is discarded.
+   * @return The cases to be evaluated. They are owned by the caller (normally the CaseHandler).
+   */
+  QList<Case *> CreateCases(Case *center);
+
+  /*!
+   * @brief Record an evaluated case.
+   * @return True if the case is one of the cases of the current gradient.
+   */
+  bool Submit(Case *c);
+
+  /*!
+   * @brief Check whether all the cases of the current gradient have been submitted.
+   */
+  bool Complete() const { return n_submitted_ == n_cases_; }
+
+  /*!
+   * @brief Compute the gradient of the objective function value.
+   * @param center_ofv The objective function value at the center case.
+   * @return The gradient. Components for which no difference could be taken are zero.
+   */
+  Eigen::VectorXd Gradient(double center_ofv) const;
+
+  int NumberFailed() const { return n_failed_; } //!< Number of components for which no difference could be taken.
+
+ private:
+  //! The perturbations of one variable. A null id means that the side is not used.
+  struct Component {
+    QUuid plus;
+    QUuid minus;
+    double h; //!< Step length.
+  };
+
+  Eigen::VectorXd lb_;
+  Eigen::VectorXd ub_;
+  double relative_step_;
+  bool central_;
+
+  std::vector<Component> components_;
+  QHash<QUuid, double> values_; //!< Objective function values of the successfully evaluated cases.
+  QHash<QUuid, bool> submitted_; //!< Whether each case of the current gradient has been submitted.
+  int n_cases_;
+  int n_submitted_;
+  mutable int n_failed_;
+};
+
+}
+}
+
+#endif //FIELDOPT_FINITE_DIFFERENCE_GRADIENT_H
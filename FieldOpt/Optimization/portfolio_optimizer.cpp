@@ -0,0 +1,370 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <Optimization/optimizers/compass_search.h>
+#include <Optimization/optimizers/APPS.h>
+#include <Optimization/optimizers/RGARDD.h>
+#include <Optimization/optimizers/PSO.h>
+#include <Optimization/optimizers/CMA_ES.h>
+#include <Optimization/optimizers/VFSA.h>
+#include <Optimization/optimizers/SPSA.h>
+#include <Optimization/optimizers/LBFGSB.h>
+#include <Optimization/optimizers/bayesian_optimization/EGO.h>
+#include <Utilities/printer.hpp>
+#include <Utilities/verbosity.h>
+#include "portfolio_optimizer.h"
+#include <QVector>
+#include <algorithm>
+
+namespace Optimization {
+
+PortfolioOptimizer::PortfolioOptimizer(Settings::Optimizer *settings,
+                                       Case *base_case,
+                                       Model::Properties::VariablePropertyContainer *variables,
+                                       Reservoir::Grid::Grid *grid,
+                                       Logger *logger
+)
+    : Optimizer(settings, base_case, variables, grid, logger)
+{
+    if (settings->HybridComponents().size() == 0)
+        throw std::runtime_error("The portfolio optimizer needs at least one component.");
+    variables_ = variables;
+    grid_ = grid;
+    window_ = settings->parameters().portfolio_window;
+    min_share_ = settings->parameters().portfolio_min_share;
+    last_termination_ = NOT_FINISHED;
+    is_async_ = true;
+
+    for (int i = 0; i < settings->HybridComponents().size(); ++i) {
+        Component comp;
+        comp.settings = new Settings::Optimizer(settings->HybridComponents()[i]);
+        comp.settings->SetRngSeed(comp.settings->parameters().rng_seed + i * 7);
+        comp.settings->set_mode(mode_);
+        comp.optimizer = initializeComponent(comp.settings, i);
+        components_.append(comp);
+        collectCases(i); // Some components generate cases in the constructor
+    }
+}
+
+Optimizer::TerminationCondition PortfolioOptimizer::IsFinished() {
+    if (case_handler_->NumberBeingEvaluated() > 0)
+        return TerminationCondition::NOT_FINISHED;
+    if (evaluated_cases_ >= max_evaluations_) {
+        if (last_termination_ == NOT_FINISHED) {
+            last_termination_ = MAX_EVALS_REACHED;
+            if (enable_logging_) {
+                logger_->AddEntry(this);
+            }
+        }
+        return TerminationCondition::MAX_EVALS_REACHED;
+    }
+    bool all_finished = true;
+    for (int i = 0; i < components_.size(); ++i) {
+        if (components_[i].termination == NOT_FINISHED && !isPending(i)) {
+            components_[i].termination = components_[i].optimizer->IsFinished();
+            if (components_[i].termination != NOT_FINISHED) {
+                last_termination_ = components_[i].termination;
+                if (VERB_OPT >= 1) Printer::ext_info("Component " + Printer::num2str(i) + " finished.", "Optimization", "PortfolioOptimizer");
+                if (enable_logging_) {
+                    logger_->AddEntry(this);
+                }
+            }
+        }
+        if (components_[i].termination == NOT_FINISHED)
+            all_finished = false;
+    }
+    return all_finished ? last_termination_ : TerminationCondition::NOT_FINISHED;
+}
+
+QList<double> PortfolioOptimizer::ComponentShares() const {
+    QList<double> shares;
+    double sum = 0.0;
+    for (int i = 0; i < components_.size(); ++i) {
+        double rate = components_[i].termination == NOT_FINISHED ? improvementRate(i) : 0.0;
+        shares.append(rate);
+        sum += rate;
+    }
+    if (sum == 0.0)
+        return shares;
+
+    // Give each running component at least the minimum share, then normalize again
+    double clamped_sum = 0.0;
+    for (int i = 0; i < shares.size(); ++i) {
+        if (shares[i] > 0.0)
+            shares[i] = std::max(shares[i] / sum, min_share_);
+        clamped_sum += shares[i];
+    }
+    for (int i = 0; i < shares.size(); ++i) {
+        shares[i] /= clamped_sum;
+    }
+    return shares;
+}
+
+QList<Optimizer::TerminationCondition> PortfolioOptimizer::ComponentTerminations() const {
+    QList<TerminationCondition> terminations;
+    for (const Component &comp : components_) {
+        terminations.append(comp.termination);
+    }
+    return terminations;
+}
+
+void PortfolioOptimizer::handleEvaluatedCase(Case *c) {
+    bool improvement = isImprovement(c);
+    if (improvement) {
+        if (VERB_OPT >= 1) {
+            std::stringstream ss;
+            ss << "Found better case." << "|";
+            ss << " ID: " << c->id().toString().toStdString() << "|";
+            ss << "OFV: " << c->objective_function_value();
+            Printer::ext_info(ss.str(), "Optimization", "PortfolioOptimizer");
+        }
+        updateTentativeBestCase(c);
+    }
+
+    // Pass the result on to every component waiting for it, as if it had evaluated the case itself
+    for (Subscription sub : subscribers_.take(c->id())) {
+        Component &comp = components_[sub.component];
+        CaseHandler *handler = comp.optimizer->case_handler_;
+        portfolio_case_.remove(sub.c->id());
+        handler->UpdateCaseObjectiveFunctionValue(sub.c->id(), c->objective_function_value());
+        handler->SetCaseState(sub.c->id(), c->state, c->GetWICTime(), c->GetSimTime());
+        handler->SetCaseFidelityOfvs(sub.c->id(), c);
+        handler->SetCaseEvaluated(sub.c->id());
+        comp.optimizer->evaluated_cases_++;
+        comp.recent.append(improvement);
+        if (comp.recent.size() > window_)
+            comp.recent.removeFirst();
+        comp.optimizer->handleEvaluatedCase(sub.c);
+        collectObsoleteCases(sub.component);
+    }
+    arbitrateQueue();
+}
+
+void PortfolioOptimizer::handleScreenedOutCase(Case *c) {
+    for (Subscription sub : subscribers_.take(c->id())) {
+        Component &comp = components_[sub.component];
+        portfolio_case_.remove(sub.c->id());
+        comp.optimizer->case_handler_->ScreenOutCase(sub.c->id());
+        comp.optimizer->handleScreenedOutCase(sub.c);
+        collectObsoleteCases(sub.component);
+    }
+}
+
+void PortfolioOptimizer::iterate() {
+    if (enable_logging_) {
+        logger_->AddEntry(this);
+    }
+    if (evaluated_cases_ >= max_evaluations_)
+        return;
+    for (int i = 0; i < components_.size(); ++i) {
+        Component &comp = components_[i];
+        if (comp.termination != NOT_FINISHED)
+            continue;
+        if (comp.optimizer->case_handler_->NumberQueued() == 0) {
+            // Synchronous components need all their cases evaluated before iterating
+            if (!comp.optimizer->is_async_ && isPending(i))
+                continue;
+            TerminationCondition cond = comp.optimizer->IsFinished();
+            if (cond != NOT_FINISHED) {
+                if (!isPending(i)) {
+                    comp.termination = cond;
+                    last_termination_ = cond;
+                    if (VERB_OPT >= 1) Printer::ext_info("Component " + Printer::num2str(i) + " finished.", "Optimization", "PortfolioOptimizer");
+                }
+                continue;
+            }
+            comp.optimizer->iterate();
+        }
+        collectCases(i);
+        collectObsoleteCases(i);
+    }
+    iteration_++;
+    arbitrateQueue();
+    if (VERB_OPT >= 2) {
+        QList<double> shares = ComponentShares();
+        std::stringstream ss;
+        ss << "Component shares:";
+        for (int i = 0; i < shares.size(); ++i) {
+            ss << " " << i << ": " << shares[i] << ";";
+        }
+        Printer::ext_info(ss.str(), "Optimization", "PortfolioOptimizer");
+    }
+}
+
+void PortfolioOptimizer::retainedCases(QSet<QUuid> &retained) const {
+    // The base case is shared with the components
+    for (const Component &comp : components_) {
+        if (comp.optimizer->tentative_best_case_ != nullptr)
+            retained.insert(comp.optimizer->tentative_best_case_->id());
+        comp.optimizer->retainedCases(retained);
+    }
+}
+
+void PortfolioOptimizer::collectCases(int component) {
+    CaseHandler *handler = components_[component].optimizer->case_handler_;
+    while (handler->NumberQueued() > 0) {
+        // The component considers the case to be under evaluation until the result is passed on
+        Case *c = handler->GetNextCaseForEvaluation();
+        Case *pending = findPendingCase(c);
+        if (pending == nullptr) {
+            pending = new Case(c);
+            case_handler_->AddNewCase(pending);
+        }
+        else if (VERB_OPT >= 2) {
+            Printer::ext_info("Case from component " + Printer::num2str(component) + " is already pending.",
+                              "Optimization", "PortfolioOptimizer");
+        }
+        subscribers_[pending->id()].append(Subscription{component, c});
+        portfolio_case_[c->id()] = pending->id();
+    }
+}
+
+void PortfolioOptimizer::collectObsoleteCases(int component) {
+    Optimizer *opt = components_[component].optimizer;
+    for (QUuid id : opt->TakeObsoleteCases()) {
+        if (!portfolio_case_.contains(id))
+            continue;
+        QUuid pending_id = portfolio_case_.take(id);
+        opt->case_handler_->CancelCase(id);
+        QList<Subscription> &subs = subscribers_[pending_id];
+        for (int i = subs.size() - 1; i >= 0; --i) {
+            if (subs[i].c->id() == id)
+                subs.removeAt(i);
+        }
+        if (subs.isEmpty()) {
+            subscribers_.remove(pending_id);
+            markObsolete(case_handler_->GetCase(pending_id));
+        }
+    }
+}
+
+Case *PortfolioOptimizer::findPendingCase(const Case *c) const {
+    for (auto it = subscribers_.constBegin(); it != subscribers_.constEnd(); ++it) {
+        Case *pending = case_handler_->GetCase(it.key());
+        if (pending->Equals(c))
+            return pending;
+    }
+    return nullptr;
+}
+
+bool PortfolioOptimizer::isPending(int component) const {
+    CaseHandler *handler = components_[component].optimizer->case_handler_;
+    return handler->NumberQueued() > 0 || handler->NumberBeingEvaluated() > 0;
+}
+
+double PortfolioOptimizer::improvementRate(int component) const {
+    // Laplace smoothed, so that components without a history get a fair share
+    const QList<bool> &recent = components_[component].recent;
+    return (recent.count(true) + 1.0) / (recent.size() + 2.0);
+}
+
+void PortfolioOptimizer::arbitrateQueue() {
+    if (components_.size() < 2 || case_handler_->NumberQueued() < 2)
+        return;
+    QList<Case *> queued = case_handler_->QueuedCases();
+    QVector<QList<QUuid>> per_component(components_.size());
+    QList<QUuid> unowned;
+    for (Case *c : queued) {
+        auto subs = subscribers_.constFind(c->id());
+        if (subs == subscribers_.constEnd() || subs->isEmpty())
+            unowned.append(c->id());
+        else
+            per_component[subs->first().component].append(c->id());
+    }
+
+    // Stride scheduling: each component advances by the inverse of its share when picked
+    QList<double> shares = ComponentShares();
+    QVector<double> stride(components_.size());
+    QVector<double> pass(components_.size());
+    QVector<int> next(components_.size(), 0);
+    for (int i = 0; i < components_.size(); ++i) {
+        stride[i] = 1.0 / std::max(shares[i], 1e-6);
+        pass[i] = stride[i] / 2.0;
+    }
+    QList<QUuid> order;
+    while (order.size() + unowned.size() < queued.size()) {
+        int pick = -1;
+        for (int i = 0; i < components_.size(); ++i) {
+            if (next[i] < per_component[i].size() && (pick < 0 || pass[i] < pass[pick]))
+                pick = i;
+        }
+        order.append(per_component[pick][next[pick]++]);
+        pass[pick] += stride[pick];
+    }
+    order.append(unowned);
+    case_handler_->ReorderQueue(order);
+}
+
+Optimizer *PortfolioOptimizer::initializeComponent(Settings::Optimizer *settings, int index) {
+    // The components get their own CaseHandler, so that each of them only sees its own cases
+    std::string compstr = "component " + Printer::num2str(index);
+    Optimizer *opt;
+    switch (settings->type()) {
+        case Settings::Optimizer::OptimizerType::Compass:
+            Printer::ext_info("Using Compass Search as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::CompassSearch(settings, tentative_best_case_, variables_, grid_, logger_,
+                                                0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::APPS:
+            Printer::ext_info("Using APPS as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::APPS(settings, tentative_best_case_, variables_, grid_, logger_,
+                                       0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::GeneticAlgorithm:
+            Printer::ext_info("Using Genetic Algorithm as " + compstr + " in portfolio.|RNG Seed: "
+                                  + Printer::num2str(settings->parameters().rng_seed), "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::RGARDD(settings, tentative_best_case_, variables_, grid_, logger_,
+                                         0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::EGO:
+            Printer::ext_info("Using EGO as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::BayesianOptimization::EGO(settings, tentative_best_case_, variables_, grid_, logger_,
+                                                            0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::PSO:
+            Printer::ext_info("Using PSO as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::PSO(settings, tentative_best_case_, variables_, grid_, logger_,
+                                      0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::CMA_ES:
+            Printer::ext_info("Using CMA-ES as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::CMA_ES(settings, tentative_best_case_, variables_, grid_, logger_,
+                                         0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::VFSA:
+            Printer::ext_info("Using VFSA as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::VFSA(settings, tentative_best_case_, variables_, grid_, logger_,
+                                       0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::SPSA:
+            Printer::ext_info("Using SPSA as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::SPSA(settings, tentative_best_case_, variables_, grid_, logger_,
+                                       0, constraint_handler_);
+            break;
+        case Settings::Optimizer::OptimizerType::LBFGSB:
+            Printer::ext_info("Using LBFGSB as " + compstr + " in portfolio.", "Optimization", "PortfolioOptimizer");
+            opt = new Optimizers::LBFGSB(settings, tentative_best_case_, variables_, grid_, logger_,
+                                         0, constraint_handler_);
+            break;
+        default:
+            throw std::runtime_error("Unable to initialize portfolio optimizer: algorithm not recognized.");
+    }
+    opt->DisableLogging();
+    return opt;
+}
+
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FIELDOPT_PORTFOLIO_OPTIMIZER_H
+#define FIELDOPT_PORTFOLIO_OPTIMIZER_H
+
+#include "optimizer.h"
+
+namespace Optimization {
+
+/*!
+ * The PortfolioOptimizer class runs several _component_ Optimizer objects concurrently,
+ * sharing one evaluation queue (and so one pool of workers and one bookkeeper).
+ *
+ * Unlike the HybridOptimizer, where the components take turns, all components that are not
+ * finished generate cases at the same time. Each component keeps its own CaseHandler, so
+ * that it sees only its own cases, and acts as it would on its own. The cases it generates
+ * are moved to the queue of the portfolio, which is the one the runner evaluates from.
+ * Synchronous components are only iterated when all their cases have been evaluated;
+ * asynchronous ones whenever their queue is empty.
+ *
+ * If a component generates a case equal to one that is already queued or being evaluated
+ * for another component, it is not queued again: both components get the result.
+ *
+ * Free workers are arbitrated between the components through the order of the queue. The
+ * queue is interleaved so that each component gets a share of the next evaluations
+ * proportional to its recent improvement rate: the fraction of its last PortfolioWindow
+ * evaluations that improved on the best case found by the portfolio. Each component with
+ * queued cases gets at least PortfolioMinShare of the evaluations.
+ *
+ * The portfolio is finished when all components are finished, or when MaxEvaluations
+ * evaluations have been made in total.
+ */
+class PortfolioOptimizer : public Optimizer {
+ public:
+  PortfolioOptimizer(
+      Settings::Optimizer *settings,
+      Case *base_case,
+      Model::Properties::VariablePropertyContainer *variables,
+      Reservoir::Grid::Grid *grid,
+      Logger *logger);
+
+  TerminationCondition IsFinished() override;
+
+  /*!
+   * @brief Get the share of the next evaluations each component currently gets.
+   */
+  QList<double> ComponentShares() const;
+
+  /*!
+   * @brief Get the termination condition of each component (NOT_FINISHED if it is still running).
+   */
+  QList<TerminationCondition> ComponentTerminations() const;
+
+ protected:
+  void handleEvaluatedCase(Case *c) override;
+  void handleScreenedOutCase(Case *c) override; //!< Screen out the case for every component waiting for it.
+  void iterate() override;
+  void retainedCases(QSet<QUuid> &retained) const override; //!< Cases retained by the components.
+
+ private:
+  struct Component {
+    Optimizer *optimizer;
+    Settings::Optimizer *settings;
+    QList<bool> recent; //!< Whether each of the latest evaluations improved on the best case of the portfolio.
+    TerminationCondition termination = NOT_FINISHED;
+  };
+
+  struct Subscription {
+    int component; //!< Index of the component waiting for the result.
+    Case *c; //!< The case in the CaseHandler of the component.
+  };
+
+  QList<Component> components_;
+  QHash<QUuid, QList<Subscription>> subscribers_; //!< Components waiting for each queued or evaluating case.
+  QHash<QUuid, QUuid> portfolio_case_; //!< Portfolio case for each component case waiting for a result.
+  int window_; //!< Number of recent evaluations used to compute the improvement rates.
+  double min_share_; //!< Smallest share of the evaluations given to a component with queued cases.
+  TerminationCondition last_termination_; //!< Termination condition of the last component to finish.
+
+  Model::Properties::VariablePropertyContainer *variables_;
+  Reservoir::Grid::Grid *grid_;
+
+  /*!
+   * Initialize a component algorithm.
+   * @param settings Settings for the component.
+   * @param index Index of the component.
+   */
+  Optimizer *initializeComponent(Settings::Optimizer *settings, int index);
+
+  /*!
+   * @brief Move the cases queued by a component to the queue of the portfolio, unless
+   * an equal case is already queued or being evaluated.
+   */
+  void collectCases(int component);
+
+  /*!
+   * @brief Cancel the cases a component has marked as obsolete. A portfolio case is only
+   * marked as obsolete when no component is waiting for it.
+   */
+  void collectObsoleteCases(int component);
+
+  Case *findPendingCase(const Case *c) const; //!< Find a queued or evaluating case equal to c.
+  bool isPending(int component) const; //!< Whether a component has cases queued or being evaluated.
+  double improvementRate(int component) const;
+
+  /*!
+   * @brief Interleave the queue so that each component gets its share of the next
+   * evaluations. The order of the cases of each component is kept.
+   */
+  void arbitrateQueue();
+};
+
+}
+
+#endif //FIELDOPT_PORTFOLIO_OPTIMIZER_H
@@ -0,0 +1,97 @@
+#include "case_screener.h"
+#include "Utilities/printer.hpp"
+#include "Utilities/verbosity.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Optimization {
+namespace Screening {
+
+CaseScreener::CaseScreener(Settings::Optimizer *settings, Settings::Optimizer::OptimizerMode mode) {
+    mode_ = settings->parameters().screening == "TopK" ? TOP_K : ORDER;
+    opt_mode_ = mode;
+    top_k_ = settings->parameters().screening_top_k;
+    parallel_evaluations_ = std::max(1, settings->parameters().parallel_evaluations);
+    max_samples_ = settings->parameters().screening_max_samples;
+}
+
+bool CaseScreener::fitSurrogate(CaseHandler *case_handler) {
+    std::vector<Eigen::VectorXd> points;
+    std::vector<double> values;
+    CaseView evaluated = case_handler->EvaluatedCasesView();
+    for (int i = evaluated.size() - 1; i >= 0 && points.size() < max_samples_; --i) {
+        Case *c = evaluated[i];
+        // Failed and timed out cases only carry a sentinel value; compacted cases have no variables
+        if (c->state.eval == Case::CaseState::EvalStatus::E_FAILED
+            || c->state.eval == Case::CaseState::EvalStatus::E_TIMEOUT
+            || c->IsCompacted())
+            continue;
+        points.push_back(c->GetRealVarVector());
+        values.push_back(c->objective_function_value());
+    }
+    if (points.empty() || points[0].size() == 0)
+        return false;
+    return surrogate_.Fit(points, values);
+}
+
+int CaseScreener::batchLimit(int batch_size) const {
+    if (mode_ == ORDER)
+        return batch_size;
+    int k = top_k_ > 0 ? top_k_ : std::max(parallel_evaluations_, (int)std::ceil(batch_size / 2.0));
+    return std::max(1, std::min(k, batch_size));
+}
+
+QList<Case *> CaseScreener::Screen(CaseHandler *case_handler) {
+    QList<Case *> screened_out;
+    QList<QUuid> order;
+    QList<Case *> fresh;
+    for (Case *c : case_handler->QueuedCases()) {
+        // Cases forwarded by an earlier call keep their place at the front of the queue
+        if (forwarded_ids_.contains(c->id()))
+            order.append(c->id());
+        else
+            fresh.append(c);
+    }
+    if (fresh.size() < 2 || !fitSurrogate(case_handler))
+        return screened_out;
+
+    std::vector<std::pair<double, Case *>> predictions;
+    for (Case *c : fresh) {
+        predictions.push_back(std::make_pair(surrogate_.Predict(c->GetRealVarVector()), c));
+    }
+    bool maximize = opt_mode_ == Settings::Optimizer::OptimizerMode::Maximize;
+    std::stable_sort(predictions.begin(), predictions.end(),
+                     [maximize](const std::pair<double, Case *> &a, const std::pair<double, Case *> &b) {
+                       return maximize ? a.first > b.first : a.first < b.first;
+                     });
+
+    int limit = batchLimit(predictions.size());
+    for (int i = 0; i < predictions.size(); ++i) {
+        if (i < limit) {
+            order.append(predictions[i].second->id());
+        }
+        else {
+            Case *c = predictions[i].second;
+            c->set_objective_function_value(predictions[i].first);
+            case_handler->ScreenOutCase(c->id());
+            screened_out.append(c);
+        }
+    }
+    case_handler->ReorderQueue(order);
+    forwarded_ids_.clear();
+    for (QUuid id : order) {
+        forwarded_ids_.insert(id);
+    }
+    screened_ += predictions.size();
+    forwarded_ += limit;
+
+    if (VERB_OPT >= 2) {
+        Printer::ext_info("Forwarded " + Printer::num2str(limit) + " of " + Printer::num2str((int)predictions.size())
+                          + " queued cases. Acceptance ratio so far: " + Printer::num2str(acceptance_ratio()),
+                          "Optimization", "CaseScreener");
+    }
+    return screened_out;
+}
+
+}
+}
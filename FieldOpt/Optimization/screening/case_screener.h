@@ -0,0 +1,65 @@
+#ifndef FIELDOPT_CASE_SCREENER_H
+#define FIELDOPT_CASE_SCREENER_H
+
+#include "rbf_surrogate.h"
+#include "Optimization/case.h"
+#include "Optimization/case_handler.h"
+#include "Settings/optimizer.h"
+#include <QSet>
+
+namespace Optimization {
+namespace Screening {
+
+/*!
+ * @brief The CaseScreener class pre-screens the cases queued by an optimizer before they
+ * are sent to the simulator.
+ *
+ * An RBFSurrogate is fitted to the most recently evaluated cases, and used to predict the
+ * objective function value of the queued cases. Depending on the Screening setting, the
+ * queue is then either
+ *  - Order: sorted so that the cases with the best predicted values are evaluated first; or
+ *  - TopK: sorted, and all but the best k cases are screened out. Screened out cases are
+ *    removed from the queue and marked with the Q_SCREENED queue status.
+ *
+ * Screening is skipped until enough cases have been evaluated to fit the surrogate.
+ */
+class CaseScreener {
+ public:
+  enum Mode { ORDER, TOP_K };
+
+  /*!
+   * @param settings Optimizer settings, providing the screening parameters.
+   * @param mode Whether the objective is maximized or minimized.
+   */
+  CaseScreener(Settings::Optimizer *settings, Settings::Optimizer::OptimizerMode mode);
+
+  /*!
+   * @brief Screen the cases queued in the case handler since the last call. Cases that were
+   * forwarded by an earlier call are left as they are, ahead of the new cases.
+   * @return The cases that were screened out, with the predicted objective function value set.
+   */
+  QList<Case *> Screen(CaseHandler *case_handler);
+
+  int screened() const { return screened_; } //!< Number of cases that have been screened.
+  int forwarded() const { return forwarded_; } //!< Number of screened cases forwarded to evaluation.
+  double acceptance_ratio() const { return screened_ > 0 ? forwarded_ / (double)screened_ : 1.0; }
+
+ private:
+  Mode mode_;
+  Settings::Optimizer::OptimizerMode opt_mode_;
+  int top_k_; //!< Number of cases to forward per batch in TopK mode. If < 1, max(parallel evaluations, half the batch).
+  int parallel_evaluations_;
+  int max_samples_; //!< Maximum number of evaluated cases to fit the surrogate to.
+  int screened_ = 0;
+  int forwarded_ = 0;
+  RBFSurrogate surrogate_;
+  QSet<QUuid> forwarded_ids_; //!< The queued cases that have already been screened and forwarded.
+
+  bool fitSurrogate(CaseHandler *case_handler);
+  int batchLimit(int batch_size) const; //!< Number of cases to forward from a batch.
+};
+
+}
+}
+
+#endif //FIELDOPT_CASE_SCREENER_H
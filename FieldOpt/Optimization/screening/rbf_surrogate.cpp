@@ -0,0 +1,92 @@
+#include "rbf_surrogate.h"
+#include <Eigen/Dense>
+#include <cmath>
+
+namespace Optimization {
+namespace Screening {
+
+namespace {
+
+const double kDuplicateTolerance = 1e-8; //!< Minimum distance between scaled training points.
+
+double phi(double r) {
+    return r * r * r;
+}
+
+}
+
+Eigen::VectorXd RBFSurrogate::scaled(const Eigen::VectorXd &point) const {
+    return (point - offset_).cwiseProduct(scale_);
+}
+
+bool RBFSurrogate::Fit(const std::vector<Eigen::VectorXd> &points, const std::vector<double> &values) {
+    is_ready_ = false;
+    centers_.clear();
+    if (points.empty() || points.size() != values.size())
+        return false;
+    int n_vars = points[0].size();
+
+    Eigen::VectorXd lower = points[0];
+    Eigen::VectorXd upper = points[0];
+    for (auto &point : points) {
+        lower = lower.cwiseMin(point);
+        upper = upper.cwiseMax(point);
+    }
+    offset_ = lower;
+    scale_ = Eigen::VectorXd::Ones(n_vars);
+    for (int d = 0; d < n_vars; ++d) {
+        if (upper(d) > lower(d))
+            scale_(d) = 1.0 / (upper(d) - lower(d));
+    }
+
+    std::vector<double> center_values;
+    for (int i = 0; i < points.size(); ++i) {
+        Eigen::VectorXd x = scaled(points[i]);
+        bool duplicate = false;
+        for (auto &center : centers_) {
+            if ((center - x).norm() < kDuplicateTolerance) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate && std::isfinite(values[i])) {
+            centers_.push_back(x);
+            center_values.push_back(values[i]);
+        }
+    }
+    int m = centers_.size();
+    if (m < n_vars + 2)
+        return false;
+
+    // [Phi P; P^T 0] [weights; tail] = [values; 0]
+    Eigen::MatrixXd A = Eigen::MatrixXd::Zero(m + n_vars + 1, m + n_vars + 1);
+    Eigen::VectorXd b = Eigen::VectorXd::Zero(m + n_vars + 1);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < i; ++j) {
+            A(i, j) = A(j, i) = phi((centers_[i] - centers_[j]).norm());
+        }
+        A(i, m) = A(m, i) = 1.0;
+        A.block(i, m + 1, 1, n_vars) = centers_[i].transpose();
+        A.block(m + 1, i, n_vars, 1) = centers_[i];
+        b(i) = center_values[i];
+    }
+    Eigen::VectorXd solution = A.colPivHouseholderQr().solve(b);
+    if (!solution.allFinite())
+        return false;
+    weights_ = solution.head(m);
+    tail_ = solution.tail(n_vars + 1);
+    is_ready_ = true;
+    return true;
+}
+
+double RBFSurrogate::Predict(const Eigen::VectorXd &point) const {
+    Eigen::VectorXd x = scaled(point);
+    double value = tail_(0) + tail_.tail(x.size()).dot(x);
+    for (int i = 0; i < centers_.size(); ++i) {
+        value += weights_(i) * phi((centers_[i] - x).norm());
+    }
+    return value;
+}
+
+}
+}
@@ -0,0 +1,54 @@
+#ifndef FIELDOPT_RBF_SURROGATE_H
+#define FIELDOPT_RBF_SURROGATE_H
+
+#include <Eigen/Core>
+#include <vector>
+
+namespace Optimization {
+namespace Screening {
+
+/*!
+ * @brief The RBFSurrogate class is a cheap interpolating surrogate model, using cubic
+ * radial basis functions with a linear polynomial tail.
+ *
+ * The variables are scaled to the unit hypercube spanned by the training points before
+ * fitting, so that variables with very different ranges (e.g. rates and coordinates)
+ * contribute equally to the distances. Points closer to an earlier point than a small
+ * tolerance (in the scaled space) are skipped, as duplicates make the system singular.
+ *
+ * Fitting requires solving a dense system in the number of points, so the number of
+ * training points should be kept moderate (a few hundred).
+ */
+class RBFSurrogate {
+ public:
+  RBFSurrogate() {}
+
+  /*!
+   * @brief Fit the surrogate to the points and values.
+   * @return True if the fit succeeded. The surrogate needs at least n_vars + 2 distinct points.
+   */
+  bool Fit(const std::vector<Eigen::VectorXd> &points, const std::vector<double> &values);
+
+  /*!
+   * @brief Predict the value at a point. Must only be called after a successful fit.
+   */
+  double Predict(const Eigen::VectorXd &point) const;
+
+  bool IsReady() const { return is_ready_; }
+  int size() const { return centers_.size(); } //!< Number of points the surrogate interpolates.
+
+ private:
+  bool is_ready_ = false;
+  Eigen::VectorXd offset_; //!< Lower corner of the training points' bounding box.
+  Eigen::VectorXd scale_;  //!< Inverse extent of the training points along each axis.
+  std::vector<Eigen::VectorXd> centers_; //!< Scaled training points.
+  Eigen::VectorXd weights_; //!< RBF weights, one per center.
+  Eigen::VectorXd tail_;    //!< Coefficients of the linear tail (constant first).
+
+  Eigen::VectorXd scaled(const Eigen::VectorXd &point) const;
+};
+
+}
+}
+
+#endif //FIELDOPT_RBF_SURROGATE_H
@@ -64,4 +64,25 @@ TEST_F(InterwellDistanceTest, Normalization) {
     EXPECT_NEAR(1.0, penalty_norm, 0.005);
 }
 
+TEST_F(InterwellDistanceTest, OriginCaseDeleted) {
+    iwd_settings_.min = 10;
+    iwd_constraint_ = new Optimization::Constraints::InterwellDistance(iwd_settings_, varcont_two_spline_wells_);
+    auto parent = new Optimization::Case(test_case);
+    EXPECT_TRUE(iwd_constraint_->CaseSatisfiesConstraint(parent));
+
+    // The feasible well set of the origin is found by id once the origin has been released
+    auto child = new Optimization::Case(parent);
+    child->set_origin_data(parent, 0, 1.0);
+    QUuid parent_id = parent->id();
+    delete parent;
+    EXPECT_EQ(parent_id, child->origin_case_id());
+    EXPECT_TRUE(iwd_constraint_->CaseSatisfiesConstraint(child));
+
+    // Both wells moved onto each other
+    auto collapsed = new Optimization::Case(child);
+    collapsed->set_origin_data(child, 0, 1.0);
+    collapsed->SetRealVarValues(Eigen::VectorXd::Zero(child->GetRealVarVector().size()));
+    EXPECT_FALSE(iwd_constraint_->CaseSatisfiesConstraint(collapsed));
+}
+
 }
@@ -79,6 +79,27 @@ TEST_F(APPSTest, GetNewCases) {
     EXPECT_EQ(test_case_1_3i_->GetIntegerVarVector()[0] - 8, new_case_4->GetIntegerVarVector()[0]);
 }
 
+TEST_F(APPSTest, GenerateCasesWithoutInactiveDirections) {
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    Optimization::Optimizer *minimizer = new APPS(settings_apps_min_unconstr_,
+                                                  test_case_2r_,
+                                                  varcont_prod_bhp_,
+                                                  grid_5spot_,
+                                                  logger_
+    );
+    int n_cases = minimizer->GenerateCases();
+    EXPECT_GT(n_cases, 0);
+    for (int i = 0; i < n_cases; ++i)
+        minimizer->GetCaseForEvaluation();
+    double iterations = minimizer->GetValues()["IterNr"][0];
+
+    // All directions are being evaluated, so asking for more cases (as the runner does
+    // whenever a worker is free) must neither generate cases nor count iterations
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(0, minimizer->GenerateCases());
+    EXPECT_EQ(iterations, minimizer->GetValues()["IterNr"][0]);
+}
+
 TEST_F(APPSTest, TestFunctionSpherical) {
     auto gen = get_random_generator(10);
     test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
@@ -109,6 +130,57 @@ TEST_F(APPSTest, TestFunctionSpherical) {
     EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.01);
 }
 
+TEST_F(APPSTest, CancelObsoleteCases) {
+    auto gen = get_random_generator(10);
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    Optimization::Optimizer *minimizer = new APPS(settings_apps_cancel_min_,
+                                                  test_case_2r_,
+                                                  varcont_prod_bhp_,
+                                                  grid_5spot_,
+                                                  logger_
+    );
+
+    QList<Optimization::Case *> under_eval = QList<Optimization::Case *>();
+    for (int i = 0; i < 3; ++i)
+        under_eval.append(minimizer->GetCaseForEvaluation());
+
+    int cancelled = 0;
+    while (minimizer->IsFinished() == Optimization::Optimizer::TerminationCondition::NOT_FINISHED) {
+        try {
+            under_eval.append(minimizer->GetCaseForEvaluation());
+        } catch (Optimization::CaseHandlerException e) {
+            std::cout << "Unable to get new case. Waiting for completed.";
+        }
+        if (under_eval.isEmpty())
+            break;
+        auto random_evaluated_case = under_eval.takeAt(random_integer(gen, 0, under_eval.size()-1));
+        random_evaluated_case->set_objective_function_value(Sphere(random_evaluated_case->GetRealVarVector()));
+        minimizer->SubmitEvaluatedCase(random_evaluated_case);
+
+        // Cancel the cases that became obsolete, as the runner would
+        for (QUuid id : minimizer->TakeObsoleteCases()) {
+            for (int i = 0; i < under_eval.size(); ++i) {
+                if (under_eval[i]->id() == id) {
+                    auto obsolete_case = under_eval.takeAt(i);
+                    obsolete_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_CANCELLED;
+                    minimizer->SubmitEvaluatedCase(obsolete_case);
+                    cancelled++;
+                    break;
+                }
+            }
+        }
+    }
+    EXPECT_GT(cancelled, 0);
+    EXPECT_GE(minimizer->case_handler()->NumberCancelled(), cancelled); // Queued cases are cancelled directly
+    for (auto c : minimizer->case_handler()->EvaluatedCases()) {
+        EXPECT_NE(Optimization::Case::CaseState::EvalStatus::E_CANCELLED, c->state.eval);
+    }
+    auto best_case = minimizer->GetTentativeBestCase();
+    EXPECT_NEAR(0.0, best_case->objective_function_value(), 0.01);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[0], 0.01);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.01);
+}
+
 TEST_F(APPSTest, TestFunctionRosenbrock) {
     auto gen = get_random_generator(10);
 
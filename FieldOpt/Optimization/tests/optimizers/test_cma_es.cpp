@@ -90,6 +90,24 @@ namespace {
         EXPECT_NEAR(1.0, best_case->GetRealVarVector()[1], 3);
     }
 
-}
+    TEST_F(CMA_ESTest, BIPOPMirroredSpherical) {
+        test_case_ga_spherical_6r_->set_objective_function_value(abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
+        settings_cma_es_bipop_min_->SetRngSeed(5);
+        settings_cma_es_bipop_min_->SetParallelEvaluations(8);
+        CMA_ES *minimizer = new CMA_ES(settings_cma_es_bipop_min_,
+            test_case_ga_spherical_6r_, varcont_6r_, grid_5spot_, logger_ );
+        EXPECT_EQ(0, minimizer->population_size() % 8);
 
+        while (!((Optimization::Optimizer *)minimizer)->IsFinished()) {
+            auto next_case = minimizer->GetCaseForEvaluation();
+            next_case->set_objective_function_value(Sphere(next_case->GetRealVarVector()));
+            minimizer->SubmitEvaluatedCase(next_case);
+            EXPECT_EQ(0, minimizer->population_size() % 8);
+        }
+        auto best_case = minimizer->GetTentativeBestCase();
+        EXPECT_NEAR(0.0, best_case->objective_function_value(), 1e-6);
+        EXPECT_NEAR(0.0, best_case->GetRealVarVector()[0], 1e-3);
+        EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 1e-3);
+    }
 
+}
@@ -36,6 +36,17 @@ using namespace std;
 
 namespace {
 
+//! Exposes the OFV normalizer.
+class WarmStartedEGO : public BayesianOptimization::EGO {
+ public:
+  WarmStartedEGO(Settings::Optimizer *settings, Optimization::Case *base_case,
+                 Model::Properties::VariablePropertyContainer *variables,
+                 Reservoir::Grid::Grid *grid, Logger *logger)
+      : EGO(settings, base_case, variables, grid, logger) {}
+
+  double NormalizedOfv(double ofv) const { return normalizer_ofv_.normalize(ofv); }
+};
+
 class EGOTest : public ::testing::Test,
                 public TestResources::TestResourceOptimizer,
                 public TestResources::TestResourceGrids
@@ -47,6 +58,19 @@ class EGOTest : public ::testing::Test,
   virtual ~EGOTest() {}
   virtual void SetUp() {}
 
+  //! Evaluated copies of the base case, with its variables scaled by each of the factors.
+  QList<Optimization::Case *> warmStartCases(const std::vector<double> &scales) {
+      QList<Optimization::Case *> cases;
+      for (double scale : scales) {
+          auto c = new Optimization::Case(test_case_ga_spherical_6r_);
+          c->SetRealVarValues(scale * test_case_ga_spherical_6r_->GetRealVarVector());
+          c->set_objective_function_value(Sphere(c->GetRealVarVector()));
+          c->state.eval = Optimization::Case::CaseState::E_DONE;
+          cases.append(c);
+      }
+      return cases;
+  }
+
   Optimization::Case *base_;
 
 };
@@ -144,6 +168,22 @@ TEST_F(EGOTest, TestFunctionSpherical) {
 //    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.2);
 }
 
+TEST_F(EGOTest, WarmStart) {
+    test_case_ga_spherical_6r_->set_objective_function_value(abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
+    auto ego = new WarmStartedEGO(settings_ego_max_, test_case_ga_spherical_6r_, varcont_6r_, grid_5spot_, logger_);
+    int n_queued = ego->case_handler()->NumberQueued();
+    auto cases = warmStartCases({2.0, 10.0, 0.5});
+    ego->WarmStart(cases);
+
+    for (auto c : cases) {
+        EXPECT_TRUE(ego->case_handler()->EvaluatedCases().contains(c));
+    }
+    EXPECT_EQ(cases[1]->id(), ego->GetTentativeBestCase()->id());
 
-}
+    // The normalizer is re-initialized from the largest value, which is normalized to 0.5
+    EXPECT_NEAR(0.5, ego->NormalizedOfv(cases[1]->objective_function_value()), 1e-9);
 
+    // The cases take the place of as many of the initial guesses
+    EXPECT_EQ(n_queued - 3, ego->case_handler()->NumberQueued());
+}
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "optimizers/ExhaustiveSearch2DVert.h"
+#include "Optimization/tests/test_resource_optimizer.h"
+#include "Reservoir/tests/test_resource_grids.h"
+
+using namespace Optimization::Optimizers;
+using namespace Model::Properties;
+
+namespace {
+
+class ExhaustiveSearch2DVertTest : public ::testing::Test,
+                                   public TestResources::TestResourceOptimizer,
+                                   public TestResources::TestResourceGrids
+{
+ protected:
+  ExhaustiveSearch2DVertTest() {
+      varcont_block_ = new VariablePropertyContainer();
+      QStringList names = QStringList() << "WellBlock#PROD#0#i" << "WellBlock#PROD#0#j" << "WellBlock#PROD#0#k";
+      for (QString name : names) {
+          auto prop = new DiscreteProperty(1);
+          prop->setName(name);
+          varcont_block_->AddVariable(prop);
+          if (name.endsWith("i")) i_id_ = prop->id();
+          if (name.endsWith("j")) j_id_ = prop->id();
+      }
+      base_ = new Optimization::Case(QHash<QUuid, bool>(), varcont_block_->GetDiscreteVariableValues(), QHash<QUuid, double>());
+      base_->set_objective_function_value(ofv(base_));
+  }
+  virtual ~ExhaustiveSearch2DVertTest() {}
+
+  // Distance to the column (17, 23)
+  double ofv(Optimization::Case *c) {
+      int i = c->integer_variables()[i_id_];
+      int j = c->integer_variables()[j_id_];
+      return (i - 17) * (i - 17) + (j - 23) * (j - 23);
+  }
+
+  int run(Optimization::Optimizer *optimizer) {
+      int n_evaluated = 0;
+      while (!optimizer->IsFinished()) {
+          EXPECT_LE(optimizer->GenerateCases(), 1); // Cases are generated lazily
+          auto next_case = optimizer->GetCaseForEvaluation();
+          next_case->set_objective_function_value(ofv(next_case));
+          next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+          optimizer->SubmitEvaluatedCase(next_case);
+          n_evaluated++;
+      }
+      return n_evaluated;
+  }
+
+  VariablePropertyContainer *varcont_block_;
+  Optimization::Case *base_;
+  QUuid i_id_;
+  QUuid j_id_;
+};
+
+TEST_F(ExhaustiveSearch2DVertTest, FullSweep) {
+    auto optimizer = new ExhaustiveSearch2DVert(settings_exhaustive_min_, base_, varcont_block_, grid_5spot_, logger_);
+    int n_active = 0;
+    for (int i = 0; i < grid_5spot_->Dimensions().nx; ++i) {
+        for (int j = 0; j < grid_5spot_->Dimensions().ny; ++j) {
+            for (int k = 0; k < grid_5spot_->Dimensions().nz; ++k) {
+                if (grid_5spot_->GetCell(i, j, k).is_active()) {
+                    n_active++;
+                    break;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(n_active, run(optimizer));
+    EXPECT_EQ(0, optimizer->GetTentativeBestCase()->objective_function_value());
+    EXPECT_EQ(17, optimizer->GetTentativeBestCase()->integer_variables()[i_id_]);
+    EXPECT_EQ(23, optimizer->GetTentativeBestCase()->integer_variables()[j_id_]);
+}
+
+TEST_F(ExhaustiveSearch2DVertTest, CoarseToFine) {
+    auto optimizer = new ExhaustiveSearch2DVert(settings_exhaustive_coarse_min_, base_, varcont_block_, grid_5spot_, logger_);
+    int n_columns = grid_5spot_->Dimensions().nx * grid_5spot_->Dimensions().ny;
+    EXPECT_LT(run(optimizer), n_columns / 4);
+    EXPECT_EQ(0, optimizer->GetTentativeBestCase()->objective_function_value());
+    EXPECT_EQ(17, optimizer->GetTentativeBestCase()->integer_variables()[i_id_]);
+    EXPECT_EQ(23, optimizer->GetTentativeBestCase()->integer_variables()[j_id_]);
+}
+
+TEST_F(ExhaustiveSearch2DVertTest, LastCoarseCaseFails) {
+    // The refinement never visits a column on the coarse grid, so the last such column is the
+    // last case of the coarse sweep
+    auto reference = new ExhaustiveSearch2DVert(settings_exhaustive_coarse_min_, base_, varcont_block_, grid_5spot_, logger_);
+    int n_reference = 0;
+    int last_i = 0, last_j = 0;
+    while (!reference->IsFinished()) {
+        auto next_case = reference->GetCaseForEvaluation();
+        int i = next_case->integer_variables()[i_id_];
+        int j = next_case->integer_variables()[j_id_];
+        if ((i - 1) % 4 == 0 && (j - 1) % 4 == 0) {
+            last_i = i;
+            last_j = j;
+        }
+        next_case->set_objective_function_value(ofv(next_case));
+        next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+        reference->SubmitEvaluatedCase(next_case);
+        n_reference++;
+    }
+
+    // The refinement still starts when that case fails
+    auto optimizer = new ExhaustiveSearch2DVert(settings_exhaustive_coarse_min_, base_, varcont_block_, grid_5spot_, logger_);
+    int n_evaluated = 0;
+    while (!optimizer->IsFinished()) {
+        auto next_case = optimizer->GetCaseForEvaluation();
+        if (next_case->integer_variables()[i_id_] == last_i && next_case->integer_variables()[j_id_] == last_j) {
+            next_case->state.eval = Optimization::Case::CaseState::E_FAILED;
+        }
+        else {
+            next_case->set_objective_function_value(ofv(next_case));
+            next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+        }
+        optimizer->SubmitEvaluatedCase(next_case);
+        n_evaluated++;
+    }
+    EXPECT_EQ(n_reference, n_evaluated);
+    EXPECT_EQ(0, optimizer->GetTentativeBestCase()->objective_function_value());
+    EXPECT_EQ(17, optimizer->GetTentativeBestCase()->integer_variables()[i_id_]);
+    EXPECT_EQ(23, optimizer->GetTentativeBestCase()->integer_variables()[j_id_]);
+}
+
+}
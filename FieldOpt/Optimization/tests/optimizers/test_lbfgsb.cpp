@@ -0,0 +1,94 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "optimizers/LBFGSB.h"
+#include "optimizers/finite_difference_gradient.h"
+#include "Optimization/tests/test_resource_optimizer.h"
+#include "Reservoir/tests/test_resource_grids.h"
+#include "Optimization/tests/test_resource_test_functions.h"
+
+using namespace TestResources::TestFunctions;
+using namespace Optimization::Optimizers;
+
+namespace {
+
+class LBFGSBTest : public ::testing::Test,
+                   public TestResources::TestResourceOptimizer,
+                   public TestResources::TestResourceGrids
+{
+ protected:
+  LBFGSBTest() {}
+  virtual ~LBFGSBTest() {}
+};
+
+TEST_F(LBFGSBTest, FiniteDifferenceGradient) {
+    Eigen::VectorXd x = test_case_ga_spherical_6r_->GetRealVarVector();
+    Eigen::VectorXd lb = x - Eigen::VectorXd::Ones(6);
+    Eigen::VectorXd ub = x + Eigen::VectorXd::Ones(6);
+    ub[0] = x[0]; // The first variable is at its upper bound
+    FiniteDifferenceGradient gradient(lb, ub, 1e-3, true);
+
+    auto cases = gradient.CreateCases(test_case_ga_spherical_6r_);
+    EXPECT_EQ(11, cases.size());
+    for (auto c : cases) {
+        EXPECT_FALSE(gradient.Complete());
+        EXPECT_LE(c->GetRealVarVector()[0], ub[0]);
+        c->set_objective_function_value(Sphere(c->GetRealVarVector()));
+        c->state.eval = Optimization::Case::CaseState::E_DONE;
+        EXPECT_TRUE(gradient.Submit(c));
+    }
+    EXPECT_TRUE(gradient.Complete());
+
+    Eigen::VectorXd g = gradient.Gradient(Sphere(x));
+    EXPECT_EQ(0, gradient.NumberFailed());
+    EXPECT_NEAR(2 * x[0], g[0], 1e-2); // One-sided difference
+    for (int i = 1; i < 6; ++i) {
+        EXPECT_NEAR(2 * x[i], g[i], 1e-6);
+    }
+}
+
+TEST_F(LBFGSBTest, TestFunctionSphericalMinimize) {
+    test_case_ga_spherical_6r_->set_objective_function_value(Sphere(test_case_ga_spherical_6r_->GetRealVarVector()));
+    Optimization::Optimizer *minimizer = new LBFGSB(settings_lbfgsb_min_,
+                                                    test_case_ga_spherical_6r_,
+                                                    varcont_6r_,
+                                                    grid_5spot_,
+                                                    logger_
+    );
+
+    while (!minimizer->IsFinished()) {
+        // The central differences (2n cases) or the step candidates are queued at once
+        QList<Optimization::Case *> batch;
+        int n_queued = minimizer->GenerateCases();
+        for (int i = 0; i < n_queued; ++i) {
+            batch.append(minimizer->GetCaseForEvaluation());
+        }
+        EXPECT_TRUE(batch.size() == 12 || batch.size() == 4);
+        for (auto next_case : batch) {
+            next_case->set_objective_function_value(Sphere(next_case->GetRealVarVector()));
+            next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+            minimizer->SubmitEvaluatedCase(next_case);
+        }
+    }
+    auto best_case = minimizer->GetTentativeBestCase();
+    EXPECT_NEAR(0.0, best_case->objective_function_value(), 1e-4);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[0], 1e-2);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 1e-2);
+}
+
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <tests/test_resource_optimizer.h>
+#include <Reservoir/tests/test_resource_grids.h>
+#include "portfolio_optimizer.h"
+#include "tests/test_resource_test_functions.h"
+#include "Utilities/math.hpp"
+#include "Runner/tests/test_resource_runner.hpp"
+
+using namespace TestResources::TestFunctions;
+
+namespace {
+class PortfolioTest : public ::testing::Test,
+                      public ::TestResources::TestResourceOptimizer,
+                      public ::TestResources::TestResourceGrids
+{
+ protected:
+  PortfolioTest() {}
+
+  virtual ~PortfolioTest() {}
+};
+
+TEST_F(PortfolioTest, Constructor) {
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    auto *portfolio = new Optimization::PortfolioOptimizer(settings_portfolio_min_,
+                                                           test_case_2r_,
+                                                           varcont_prod_bhp_,
+                                                           grid_5spot_,
+                                                           logger_
+    );
+    EXPECT_TRUE(portfolio->IsAsync());
+    EXPECT_EQ(2, portfolio->ComponentShares().size());
+    EXPECT_DOUBLE_EQ(0.5, portfolio->ComponentShares()[0]);
+    EXPECT_DOUBLE_EQ(0.5, portfolio->ComponentShares()[1]);
+}
+
+TEST_F(PortfolioTest, TestFunctionSpherical) {
+    auto gen = get_random_generator(10);
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    auto *portfolio = new Optimization::PortfolioOptimizer(settings_portfolio_min_,
+                                                           test_case_2r_,
+                                                           varcont_prod_bhp_,
+                                                           grid_5spot_,
+                                                           logger_
+    );
+
+    QList<Optimization::Case *> under_eval = QList<Optimization::Case *>();
+    while (portfolio->IsFinished() == Optimization::Optimizer::TerminationCondition::NOT_FINISHED) {
+        // Keep up to four cases under evaluation, as with four workers
+        while (under_eval.size() < 4 && portfolio->GenerateCases() > 0) {
+            Optimization::Case *new_case = portfolio->GetCaseForEvaluation();
+            for (Optimization::Case *c : under_eval) {
+                EXPECT_FALSE(new_case->Equals(c)); // Equal cases are only evaluated once
+            }
+            under_eval.append(new_case);
+        }
+        ASSERT_FALSE(under_eval.empty());
+        auto random_evaluated_case = under_eval.takeAt(random_integer(gen, 0, under_eval.size()-1));
+        random_evaluated_case->set_objective_function_value(Sphere(random_evaluated_case->GetRealVarVector()));
+        portfolio->SubmitEvaluatedCase(random_evaluated_case);
+    }
+    auto best_case = portfolio->GetTentativeBestCase();
+    EXPECT_NEAR(0.0, best_case->objective_function_value(), 0.01);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[0], 0.1);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.1);
+
+    double share_sum = 0.0;
+    for (double share : portfolio->ComponentShares()) {
+        share_sum += share;
+    }
+    EXPECT_TRUE(share_sum == 0.0 || std::abs(share_sum - 1.0) < 1e-9);
+}
+
+}
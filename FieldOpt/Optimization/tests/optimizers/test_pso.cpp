@@ -40,6 +40,19 @@ class PSOTest : public ::testing::Test,
   virtual ~PSOTest() {}
   virtual void SetUp() {}
 
+  //! Evaluated copies of the base case, with its variables scaled by each of the factors.
+  QList<Optimization::Case *> warmStartCases(const std::vector<double> &scales) {
+      QList<Optimization::Case *> cases;
+      for (double scale : scales) {
+          auto c = new Optimization::Case(test_case_ga_spherical_6r_);
+          c->SetRealVarValues(scale * test_case_ga_spherical_6r_->GetRealVarVector());
+          c->set_objective_function_value(Sphere(c->GetRealVarVector()));
+          c->state.eval = Optimization::Case::CaseState::E_DONE;
+          cases.append(c);
+      }
+      return cases;
+  }
+
   Optimization::Case *base_;
 
 };
@@ -86,4 +99,44 @@ TEST_F(PSOTest, TestFunctionRosenbrock) {
     EXPECT_NEAR(1.0, best_case->GetRealVarVector()[1], 0.5);
 }
 
+TEST_F(PSOTest, SteadyStateOutOfOrder) {
+    // Simulate four workers returning cases in random order
+    test_case_ga_spherical_6r_->set_objective_function_value(Sphere(test_case_ga_spherical_6r_->GetRealVarVector()));
+    Optimization::Optimizer *minimizer = new PSO(settings_pso_steady_state_min_,
+                                                    test_case_ga_spherical_6r_,
+                                                    varcont_6r_,
+                                                    grid_5spot_,
+                                                    logger_
+    );
+    EXPECT_TRUE(minimizer->IsAsync());
+    EXPECT_TRUE(runOutOfOrder(minimizer, Sphere));
+    auto best_case = minimizer->GetTentativeBestCase();
+    EXPECT_NEAR(0.0, best_case->objective_function_value(), 0.5);
+}
+
+TEST_F(PSOTest, WarmStart) {
+    test_case_ga_spherical_6r_->set_objective_function_value(abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
+    Optimization::Optimizer *minimizer = new PSO(settings_pso_min_,
+                                                 test_case_ga_spherical_6r_,
+                                                 varcont_6r_,
+                                                 grid_5spot_,
+                                                 logger_
+    );
+    auto cases = warmStartCases({0.5, 0.1, 0.3, 0.7, 0.9, 0.2});
+    minimizer->WarmStart(cases);
+
+    for (auto c : cases) {
+        EXPECT_TRUE(minimizer->case_handler()->EvaluatedCases().contains(c));
+    }
+    EXPECT_EQ(cases[1]->id(), minimizer->GetTentativeBestCase()->id());
+
+    // Half of the swarm (5 particles) is moved to the best cases, best first
+    QList<Optimization::Case *> best = {cases[1], cases[5], cases[2], cases[0], cases[3]};
+    auto queued = minimizer->case_handler()->QueuedCases();
+    EXPECT_EQ(10, queued.size());
+    for (int i = 0; i < best.size(); ++i) {
+        EXPECT_TRUE(queued[i]->GetRealVarVector().isApprox(best[i]->GetRealVarVector()));
+    }
+    EXPECT_FALSE(queued[5]->GetRealVarVector().isApprox(cases[4]->GetRealVarVector()));
+}
 }
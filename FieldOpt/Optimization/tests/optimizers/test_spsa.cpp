@@ -69,6 +69,33 @@ TEST_F(SPSATest, TestFunctionSphericalMinimize) {
 //    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.1);
 }
 
+TEST_F(SPSATest, TestFunctionSphericalBatched) {
+    test_case_ga_spherical_6r_->set_objective_function_value(abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
+    double initial_ofv = test_case_ga_spherical_6r_->objective_function_value();
+    Optimization::Optimizer *minimizer = new SPSA(settings_spsa_batch_min_,
+                                                    test_case_ga_spherical_6r_,
+                                                    varcont_6r_,
+                                                    grid_5spot_,
+                                                    logger_
+    );
+
+    while (!minimizer->IsFinished()) {
+        // Four pairs and four shifted pairs, or three step candidates, are queued at once
+        QList<Optimization::Case *> batch;
+        int n_queued = minimizer->GenerateCases();
+        for (int i = 0; i < n_queued; ++i) {
+            batch.append(minimizer->GetCaseForEvaluation());
+        }
+        EXPECT_TRUE(batch.size() == 16 || batch.size() == 3);
+        for (auto next_case : batch) {
+            next_case->set_objective_function_value(abs(Sphere(next_case->GetRealVarVector())));
+            next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+            minimizer->SubmitEvaluatedCase(next_case);
+        }
+    }
+    EXPECT_LT(minimizer->GetTentativeBestCase()->objective_function_value(), initial_ofv);
+}
+
 TEST_F(SPSATest, TestFunctionSphericalMaximize) {
     test_case_ga_spherical_6r_->set_objective_function_value(-1*abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
     settings_spsa_min_->SetRngSeed(5);
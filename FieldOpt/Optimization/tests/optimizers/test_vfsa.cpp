@@ -90,5 +90,29 @@ TEST_F(VFSATest, TestFunctionRosenbrock) {
 //    EXPECT_NEAR(1.0, best_case->GetRealVarVector()[0], 1);
 //    EXPECT_NEAR(1.0, best_case->GetRealVarVector()[1], 1);
 }
+
+TEST_F(VFSATest, TestFunctionSphericalChains) {
+    test_case_ga_spherical_6r_->set_objective_function_value(abs(Sphere(test_case_ga_spherical_6r_->GetRealVarVector())));
+    double initial_ofv = test_case_ga_spherical_6r_->objective_function_value();
+    Optimization::Optimizer *minimizer = new VFSA(settings_vfsa_chains_min_,
+                                                  test_case_ga_spherical_6r_,
+                                                  varcont_6r_,
+                                                  grid_5spot_,
+                                                  logger_
+    );
+
+    // One case per chain is in flight; a returned case is immediately replaced by one for the same chain
+    EXPECT_EQ(4, minimizer->GenerateCases());
+    int iter = 0;
+    while (!minimizer->IsFinished() && iter < 2000) {
+        auto next_case = minimizer->GetCaseForEvaluation();
+        next_case->set_objective_function_value(abs(Sphere(next_case->GetRealVarVector())));
+        next_case->state.eval = Optimization::Case::CaseState::E_DONE;
+        minimizer->SubmitEvaluatedCase(next_case);
+        EXPECT_LE(minimizer->GenerateCases(), 4);
+        iter++;
+    }
+    EXPECT_LT(minimizer->GetTentativeBestCase()->objective_function_value(), initial_ofv);
+}
 }
 
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <Runner/tests/test_resource_runner.hpp>
+#include "Optimization/screening/rbf_surrogate.h"
+#include "Optimization/screening/case_screener.h"
+#include "Optimization/optimizers/compass_search.h"
+#include "Optimization/tests/test_resource_optimizer.h"
+#include "Reservoir/tests/test_resource_grids.h"
+#include "Optimization/tests/test_resource_test_functions.h"
+
+using namespace TestResources::TestFunctions;
+using namespace Optimization::Screening;
+
+namespace {
+
+// Records which cases are passed to the algorithm as evaluated or as screened out
+class RecordingCompassSearch : public Optimization::Optimizers::CompassSearch {
+ public:
+  using CompassSearch::CompassSearch;
+  bool IsBetter(const Optimization::Case *c1, const Optimization::Case *c2) const { return isBetter(c1, c2); }
+  QSet<QUuid> handled;
+  QSet<QUuid> screened_out;
+ protected:
+  void handleEvaluatedCase(Optimization::Case *c) override {
+      handled.insert(c->id());
+      CompassSearch::handleEvaluatedCase(c);
+  }
+  void handleScreenedOutCase(Optimization::Case *c) override {
+      screened_out.insert(c->id());
+  }
+};
+
+class CaseScreenerTest : public ::testing::Test,
+                         public TestResources::TestResourceOptimizer,
+                         public TestResources::TestResourceGrids
+{
+ protected:
+  CaseScreenerTest() {}
+  virtual ~CaseScreenerTest() {}
+  virtual void SetUp() {}
+
+  Optimization::Case *make_case(double x, double y) {
+      auto c = new Optimization::Case(test_case_2r_);
+      Eigen::VectorXd vec(2);
+      vec << x, y;
+      c->SetRealVarValues(vec);
+      return c;
+  }
+};
+
+TEST_F(CaseScreenerTest, SurrogateInterpolates) {
+    std::vector<Eigen::VectorXd> points;
+    std::vector<double> values;
+    for (int i = -2; i <= 2; ++i) {
+        for (int j = -2; j <= 2; ++j) {
+            Eigen::VectorXd point(2);
+            point << i, 10.0 * j;
+            points.push_back(point);
+            values.push_back(point(0) * point(0) + 0.01 * point(1) * point(1));
+        }
+    }
+    RBFSurrogate surrogate;
+    EXPECT_FALSE(surrogate.IsReady());
+    EXPECT_TRUE(surrogate.Fit(points, values));
+    EXPECT_TRUE(surrogate.IsReady());
+    EXPECT_EQ(25, surrogate.size());
+
+    for (int k = 0; k < points.size(); ++k) {
+        EXPECT_NEAR(values[k], surrogate.Predict(points[k]), 1e-6);
+    }
+    Eigen::VectorXd inside(2);
+    inside << 0.5, 5.0;
+    EXPECT_NEAR(0.5, surrogate.Predict(inside), 0.2);
+
+    // Too few distinct points to fit
+    std::vector<Eigen::VectorXd> duplicates(5, points[0]);
+    EXPECT_FALSE(surrogate.Fit(duplicates, std::vector<double>(5, 1.0)));
+    EXPECT_FALSE(surrogate.IsReady());
+}
+
+TEST_F(CaseScreenerTest, TopK) {
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    auto case_handler = new Optimization::CaseHandler(test_case_2r_);
+    QList<Optimization::Case *> evaluated = {make_case(1, 1), make_case(-1, 1), make_case(1, -1),
+                                             make_case(-1, -1), make_case(2, 0), make_case(0, 2)};
+    for (auto c : evaluated) {
+        case_handler->AddNewCase(c);
+        auto next_case = case_handler->GetNextCaseForEvaluation();
+        next_case->set_objective_function_value(Sphere(next_case->GetRealVarVector()));
+        next_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+        case_handler->SetCaseEvaluated(next_case->id());
+    }
+
+    QList<Optimization::Case *> candidates = {make_case(1.8, 1.8), make_case(0.1, 0.2),
+                                              make_case(-1.5, 1.5), make_case(0.5, -0.5)};
+    case_handler->AddNewCases(candidates);
+
+    CaseScreener screener(settings_compass_search_screening_min_, Settings::Optimizer::OptimizerMode::Minimize);
+    QList<Optimization::Case *> screened_out = screener.Screen(case_handler);
+
+    EXPECT_EQ(2, case_handler->QueuedCases().size());
+    EXPECT_TRUE(case_handler->QueuedCases()[0]->id() == candidates[1]->id());
+    EXPECT_TRUE(case_handler->QueuedCases()[1]->id() == candidates[3]->id());
+
+    EXPECT_EQ(2, screened_out.size());
+    EXPECT_EQ(2, case_handler->NumberScreenedOut());
+    for (auto c : screened_out) {
+        EXPECT_EQ(Optimization::Case::CaseState::QueueStatus::Q_SCREENED, c->state.queue);
+        EXPECT_GT(c->objective_function_value(), 2.0);
+    }
+    EXPECT_EQ(4, screener.screened());
+    EXPECT_EQ(2, screener.forwarded());
+    EXPECT_FLOAT_EQ(0.5, screener.acceptance_ratio());
+
+    // Only the cases queued since the last call are screened; the forwarded cases stay ahead of them
+    QList<Optimization::Case *> more = {make_case(0.0, 0.0), make_case(2.5, 2.5), make_case(-0.2, 0.1)};
+    case_handler->AddNewCases(more);
+    screened_out = screener.Screen(case_handler);
+    EXPECT_EQ(1, screened_out.size());
+    EXPECT_TRUE(screened_out[0]->id() == more[1]->id());
+    EXPECT_EQ(4, case_handler->QueuedCases().size());
+    EXPECT_TRUE(case_handler->QueuedCases()[0]->id() == candidates[1]->id());
+    EXPECT_TRUE(case_handler->QueuedCases()[1]->id() == candidates[3]->id());
+    EXPECT_TRUE(screener.Screen(case_handler).isEmpty());
+    EXPECT_EQ(7, screener.screened());
+}
+
+TEST_F(CaseScreenerTest, CompassSearchSpherical) {
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    Optimization::Optimizer *minimizer = new Optimization::Optimizers::CompassSearch(
+        settings_compass_search_screening_min_, test_case_2r_, varcont_prod_bhp_, grid_5spot_, logger_);
+
+    while (!minimizer->IsFinished()) {
+        auto next_case = minimizer->GetCaseForEvaluation();
+        next_case->set_objective_function_value(Sphere(next_case->GetRealVarVector()));
+        minimizer->SubmitEvaluatedCase(next_case);
+    }
+    auto best_case = minimizer->GetTentativeBestCase();
+    EXPECT_NEAR(0.0, best_case->objective_function_value(), 0.01);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[0], 0.1);
+    EXPECT_NEAR(0.0, best_case->GetRealVarVector()[1], 0.1);
+}
+
+TEST_F(CaseScreenerTest, ScreenedOutCasesAreNotEvaluated) {
+    test_case_2r_->set_objective_function_value(Sphere(test_case_2r_->GetRealVarVector()));
+    auto minimizer = new RecordingCompassSearch(
+        settings_compass_search_screening_min_, test_case_2r_, varcont_prod_bhp_, grid_5spot_, logger_);
+
+    int n_submitted = 0;
+    while (!minimizer->IsFinished()) {
+        auto next_case = minimizer->GetCaseForEvaluation();
+        next_case->set_objective_function_value(Sphere(next_case->GetRealVarVector()));
+        next_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+        minimizer->SubmitEvaluatedCase(next_case);
+        n_submitted++;
+    }
+    EXPECT_GT(minimizer->screened_out.size(), 0);
+    EXPECT_EQ(n_submitted, minimizer->handled.size());
+    for (QUuid id : minimizer->screened_out) {
+        EXPECT_FALSE(minimizer->handled.contains(id));
+    }
+    auto best_case = minimizer->GetTentativeBestCase();
+    EXPECT_FALSE(minimizer->screened_out.contains(best_case->id()));
+    EXPECT_DOUBLE_EQ(Sphere(best_case->GetRealVarVector()), best_case->objective_function_value());
+
+    // A screened out case is never better than an evaluated case, whatever its prediction
+    auto screened = make_case(0.0, 0.0);
+    screened->set_objective_function_value(-1.0);
+    screened->state.queue = Optimization::Case::CaseState::QueueStatus::Q_SCREENED;
+    EXPECT_FALSE(minimizer->IsBetter(screened, best_case));
+    EXPECT_TRUE(minimizer->IsBetter(best_case, screened));
+}
+
+}
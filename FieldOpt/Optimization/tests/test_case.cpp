@@ -19,6 +19,20 @@ namespace {
         EXPECT_NO_THROW();
     }
 
+    TEST_F(CaseTest, AllocatedFromPool) {
+        int live = Optimization::Case::Pool().NumberLive();
+        auto copy = new Optimization::Case(test_case_2_3r_);
+        EXPECT_EQ(live + 1, Optimization::Case::Pool().NumberLive());
+        void *slot = copy;
+        delete copy;
+        EXPECT_EQ(live, Optimization::Case::Pool().NumberLive());
+
+        // The freed slot is reused by the next case
+        auto reused = new Optimization::Case(test_case_2_3r_);
+        EXPECT_EQ(slot, (void *)reused);
+        delete reused;
+    }
+
     TEST_F(CaseTest, UUIDs) {
         EXPECT_FALSE(test_case_1_3i_->id().isNull());
         EXPECT_FALSE(test_case_2_3r_->id().isNull());
@@ -33,6 +47,25 @@ namespace {
         EXPECT_FLOAT_EQ(-50.0, test_case_4_4b3i3r->objective_function_value());
     }
 
+    TEST_F(CaseTest, FidelityValues) {
+        EXPECT_EQ(Optimization::Case::FINE, test_case_2_3r_->GetFidelity());
+        EXPECT_FALSE(test_case_2_3r_->HasFidelityOfv(Optimization::Case::COARSE));
+        EXPECT_THROW(test_case_2_3r_->GetFidelityOfv(Optimization::Case::COARSE), Optimization::ObjectiveFunctionException);
+
+        test_case_2_3r_->SetFidelity(Optimization::Case::COARSE);
+        test_case_2_3r_->SetFidelityOfv(Optimization::Case::COARSE, 90.0);
+        EXPECT_EQ(Optimization::Case::COARSE, test_case_2_3r_->GetFidelity());
+        EXPECT_TRUE(test_case_2_3r_->HasFidelityOfv(Optimization::Case::COARSE));
+        EXPECT_FALSE(test_case_2_3r_->HasFidelityOfv(Optimization::Case::FINE));
+        EXPECT_FLOAT_EQ(90.0, test_case_2_3r_->GetFidelityOfv(Optimization::Case::COARSE));
+        EXPECT_FLOAT_EQ(100.0, test_case_2_3r_->objective_function_value());
+
+        // Trial points generated from a case start without fidelity values
+        auto copy = new Optimization::Case(test_case_2_3r_);
+        EXPECT_EQ(Optimization::Case::FINE, copy->GetFidelity());
+        EXPECT_FALSE(copy->HasFidelityOfv(Optimization::Case::COARSE));
+    }
+
     TEST_F(CaseTest, Equals) {
         EXPECT_FALSE(test_case_1_3i_->Equals(test_case_2_3r_));
         EXPECT_TRUE(test_case_3_4b3i3r_->Equals(test_case_4_4b3i3r));
@@ -75,7 +75,70 @@ namespace {
         EXPECT_FLOAT_EQ(123.0, case_handler_->EvaluatedCases().first()->objective_function_value());
     }
 
-// clear recent
+    TEST_F(CaseHandlerTest, CancelCase) {
+        Optimization::Case *running_case = case_handler_->GetNextCaseForEvaluation();
+        Optimization::Case *queued_case = case_handler_->QueuedCases()[1];
+        case_handler_->CancelCase(running_case->id());
+        case_handler_->CancelCase(queued_case->id());
+        EXPECT_EQ(2, case_handler_->QueuedCases().size());
+        EXPECT_EQ(0, case_handler_->CasesBeingEvaluated().size());
+        EXPECT_EQ(0, case_handler_->EvaluatedCases().size());
+        EXPECT_EQ(2, case_handler_->NumberCancelled());
+        EXPECT_EQ(Optimization::Case::CaseState::EvalStatus::E_CANCELLED, running_case->state.eval);
+        EXPECT_EQ(Optimization::Case::CaseState::QueueStatus::Q_DISCARDED, queued_case->state.queue);
+        EXPECT_THROW(case_handler_->CancelCase(queued_case->id()), Optimization::CaseHandlerException);
+    }
+
+    TEST_F(CaseHandlerTest, CountersAndView) {
+        EXPECT_EQ(4, case_handler_->NumberQueued());
+        for (int i = 0; i < 4; ++i) {
+            Optimization::Case *next_case = case_handler_->GetNextCaseForEvaluation();
+            EXPECT_EQ(3 - i, case_handler_->NumberQueued());
+            EXPECT_EQ(1, case_handler_->NumberBeingEvaluated());
+            next_case->set_objective_function_value(i);
+            case_handler_->SetCaseEvaluated(next_case->id());
+        }
+        EXPECT_EQ(0, case_handler_->NumberBeingEvaluated());
+        EXPECT_EQ(4, case_handler_->NumberEvaluated());
+        EXPECT_EQ(4, case_handler_->NumberRecentlyEvaluated());
+        EXPECT_THROW(case_handler_->SetCaseEvaluated(trivial_cases_[0]->id()), Optimization::CaseHandlerException);
+
+        auto view = case_handler_->EvaluatedCasesView();
+        EXPECT_EQ(4, view.size());
+        int i = 0;
+        for (auto c : view) {
+            EXPECT_TRUE(c->id() == trivial_cases_[i]->id());
+            EXPECT_TRUE(view[i] == c);
+            i++;
+        }
+        EXPECT_EQ(4, i);
+    }
+
+    TEST_F(CaseHandlerTest, CompactEvaluatedCases) {
+        for (int i = 0; i < 4; ++i) {
+            Optimization::Case *next_case = case_handler_->GetNextCaseForEvaluation();
+            next_case->set_objective_function_value(i);
+            case_handler_->SetCaseEvaluated(next_case->id());
+        }
+        QSet<QUuid> retain = { trivial_cases_[0]->id() };
+
+        // Keep the most recent case and the retained case
+        EXPECT_EQ(2, case_handler_->CompactEvaluatedCases(1, retain));
+        EXPECT_FALSE(trivial_cases_[0]->IsCompacted());
+        EXPECT_TRUE(trivial_cases_[1]->IsCompacted());
+        EXPECT_TRUE(trivial_cases_[2]->IsCompacted());
+        EXPECT_FALSE(trivial_cases_[3]->IsCompacted());
+        EXPECT_EQ(0, trivial_cases_[2]->GetRealVarVector().size());
+        EXPECT_FLOAT_EQ(2.0, trivial_cases_[2]->objective_function_value());
+        EXPECT_FALSE(trivial_cases_[2]->Equals(trivial_cases_[2]));
+
+        // Previously retained cases are compacted once released
+        EXPECT_EQ(2, case_handler_->CompactEvaluatedCases(0, QSet<QUuid>()));
+        EXPECT_TRUE(trivial_cases_[0]->IsCompacted());
+        EXPECT_TRUE(trivial_cases_[3]->IsCompacted());
+        EXPECT_EQ(4, case_handler_->NumberCompacted());
+        EXPECT_EQ(0, case_handler_->CompactEvaluatedCases(0, QSet<QUuid>()));
+    }
 
 
 
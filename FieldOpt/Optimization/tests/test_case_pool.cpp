@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <set>
+#include "Optimization/case_pool.h"
+
+namespace {
+
+class CasePoolTest : public ::testing::Test {
+ protected:
+  CasePoolTest() {}
+  virtual ~CasePoolTest() {}
+  virtual void SetUp() {}
+};
+
+TEST_F(CasePoolTest, ReusesFreedSlots) {
+    Optimization::CasePool pool(40, 4);
+    EXPECT_EQ(0, pool.NumberLive());
+    EXPECT_EQ(0, pool.NumberSlots());
+
+    std::vector<void *> objects;
+    for (int i = 0; i < 6; ++i) {
+        objects.push_back(pool.Allocate(40));
+    }
+    EXPECT_EQ(6, pool.NumberLive());
+    EXPECT_EQ(8, pool.NumberSlots());
+    EXPECT_LE(8 * 40, pool.ReservedBytes());
+    EXPECT_EQ(0, pool.ReservedBytes() % (8 * alignof(std::max_align_t))); // Slots are padded to keep them aligned
+    EXPECT_EQ(6, std::set<void *>(objects.begin(), objects.end()).size());
+
+    pool.Free(objects[2], 40);
+    EXPECT_EQ(5, pool.NumberLive());
+    EXPECT_EQ(objects[2], pool.Allocate(40));
+    EXPECT_EQ(8, pool.NumberSlots());
+
+    for (auto p : objects) {
+        pool.Free(p, 40);
+    }
+    EXPECT_EQ(0, pool.NumberLive());
+    EXPECT_EQ(8, pool.NumberSlots());
+}
+
+TEST_F(CasePoolTest, OtherSizes) {
+    Optimization::CasePool pool(40, 4);
+    void *p = pool.Allocate(100);
+    EXPECT_EQ(0, pool.NumberLive());
+    EXPECT_EQ(0, pool.NumberSlots());
+    pool.Free(p, 100);
+    pool.Free(nullptr, 40);
+    EXPECT_EQ(0, pool.NumberLive());
+}
+
+}
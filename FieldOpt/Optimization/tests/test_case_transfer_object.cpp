@@ -37,6 +37,8 @@ namespace {
     }
 
     TEST_F(CaseTransferObjectTest, SerializationAndDeserializationAndGeneratedCase) {
+        test_case_3_4b3i3r_->SetFidelity(Case::COARSE);
+        test_case_3_4b3i3r_->SetFidelityOfv(Case::COARSE, -45.0);
         auto cto1 = CaseTransferObject(test_case_3_4b3i3r_); // create a populated cto
 
         // Serialize
@@ -60,6 +62,9 @@ namespace {
         EXPECT_EQ(       test_case_3_4b3i3r_->integer_variables().size(), c->integer_variables().size());
         EXPECT_EQ(       test_case_3_4b3i3r_->real_variables().size(),    c->real_variables().size());
         EXPECT_EQ(       test_case_3_4b3i3r_->GetWICTime(),               c->GetWICTime());
+        EXPECT_EQ(       Case::COARSE,                                    c->GetFidelity());
+        EXPECT_FLOAT_EQ( -45.0,                                           c->GetFidelityOfv(Case::COARSE));
+        EXPECT_FALSE(    c->HasFidelityOfv(Case::FINE));
 
         for (auto id : test_case_3_4b3i3r_->integer_variables().keys())
             EXPECT_EQ(      test_case_3_4b3i3r_->integer_variables()[id], c->integer_variables()[id]);
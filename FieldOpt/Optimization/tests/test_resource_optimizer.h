@@ -24,7 +24,10 @@
 
 #include "Model/tests/test_resource_model.h"
 #include "Optimization/case.h"
+#include "Optimization/optimizer.h"
 #include "test_resource_cases.h"
+#include <functional>
+#include <random>
 
 namespace TestResources {
 class TestResourceOptimizer : public TestResourceModel, public TestResourceCases {
@@ -37,33 +40,84 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
 
       settings_compass_search_min_unconstr_ = new Settings::Optimizer(get_json_settings_compass_search_minimize_);
       settings_compass_search_max_unconstr_ = new Settings::Optimizer(get_json_settings_compass_search_maximize_);
+      settings_compass_search_screening_min_ = new Settings::Optimizer(get_json_settings_compass_search_screening_minimize_);
       settings_apps_min_unconstr_ = new Settings::Optimizer(get_json_settings_apps_minimize_);
       settings_apps_max_unconstr_ = new Settings::Optimizer(get_json_settings_apps_maximize_);
+      settings_apps_cancel_min_ = new Settings::Optimizer(get_json_settings_apps_cancel_minimize_);
       settings_cma_es_min_ = new Settings::Optimizer(get_json_settings_cma_es_minimize_);
+      settings_cma_es_bipop_min_ = new Settings::Optimizer(get_json_settings_cma_es_bipop_minimize_);
       settings_ga_min_ = new Settings::Optimizer(get_json_settings_ga_minimize_);
       settings_ga_max_ = new Settings::Optimizer(get_json_settings_ga_maximize_);
       settings_ego_max_ = new Settings::Optimizer(get_json_settings_ego_maximize_);
       settings_pso_min_ = new Settings::Optimizer(get_json_settings_pso_minimize_);
+      settings_ga_steady_state_min_ = new Settings::Optimizer(get_json_settings_ga_steady_state_minimize_);
+      settings_pso_steady_state_min_ = new Settings::Optimizer(get_json_settings_pso_steady_state_minimize_);
       settings_vfsa_min_ = new Settings::Optimizer(get_json_settings_vfsa_minimize_);
       settings_vfsa_max_ = new Settings::Optimizer(get_json_settings_vfsa_maximize_);
+      settings_vfsa_chains_min_ = new Settings::Optimizer(get_json_settings_vfsa_chains_minimize_);
       settings_spsa_min_ = new Settings::Optimizer(get_json_settings_spsa_minimize_);
       settings_spsa_max_ = new Settings::Optimizer(get_json_settings_spsa_maximize_);
+      settings_spsa_batch_min_ = new Settings::Optimizer(get_json_settings_spsa_batch_minimize_);
+      settings_lbfgsb_min_ = new Settings::Optimizer(get_json_settings_lbfgsb_minimize_);
+      settings_portfolio_min_ = new Settings::Optimizer(get_json_settings_portfolio_minimize_);
+      settings_exhaustive_min_ = new Settings::Optimizer(get_json_settings_exhaustive_minimize_);
+      settings_exhaustive_coarse_min_ = new Settings::Optimizer(get_json_settings_exhaustive_coarse_minimize_);
   }
 
   Optimization::Case *base_case_;
   Settings::Optimizer *settings_compass_search_min_unconstr_;
   Settings::Optimizer *settings_compass_search_max_unconstr_;
+  Settings::Optimizer *settings_compass_search_screening_min_;
   Settings::Optimizer *settings_apps_min_unconstr_;
   Settings::Optimizer *settings_apps_max_unconstr_;
+  Settings::Optimizer *settings_apps_cancel_min_;
   Settings::Optimizer *settings_ga_min_;
   Settings::Optimizer *settings_ga_max_;
   Settings::Optimizer *settings_vfsa_min_;
   Settings::Optimizer *settings_vfsa_max_;
+  Settings::Optimizer *settings_vfsa_chains_min_;
   Settings::Optimizer *settings_spsa_min_;
   Settings::Optimizer *settings_spsa_max_;
+  Settings::Optimizer *settings_spsa_batch_min_;
+  Settings::Optimizer *settings_lbfgsb_min_;
   Settings::Optimizer *settings_pso_min_;
+  Settings::Optimizer *settings_ga_steady_state_min_;
+  Settings::Optimizer *settings_pso_steady_state_min_;
   Settings::Optimizer *settings_ego_max_;
   Settings::Optimizer *settings_cma_es_min_;
+  Settings::Optimizer *settings_cma_es_bipop_min_;
+  Settings::Optimizer *settings_portfolio_min_;
+  Settings::Optimizer *settings_exhaustive_min_;
+  Settings::Optimizer *settings_exhaustive_coarse_min_;
+
+  /*!
+   * @brief Run an asynchronous optimizer until it is finished, simulating a number of workers
+   * that return the cases in random order.
+   * @param optimizer The optimizer to run.
+   * @param objective The objective function used to evaluate the cases.
+   * @param n_workers Number of cases evaluated concurrently.
+   * @return False if the optimizer stopped generating cases before it was finished.
+   */
+  bool runOutOfOrder(Optimization::Optimizer *optimizer,
+                     const std::function<double(Eigen::VectorXd)> &objective,
+                     int n_workers = 4) {
+      std::mt19937 gen(0);
+      std::vector<Optimization::Case *> being_evaluated;
+      while (!optimizer->IsFinished()) {
+          while ((int)being_evaluated.size() < n_workers && optimizer->GenerateCases() > 0) {
+              being_evaluated.push_back(optimizer->GetCaseForEvaluation());
+          }
+          if (being_evaluated.empty()) {
+              return false;
+          }
+          int i = std::uniform_int_distribution<int>(0, being_evaluated.size() - 1)(gen);
+          auto evaluated_case = being_evaluated[i];
+          being_evaluated.erase(being_evaluated.begin() + i);
+          evaluated_case->set_objective_function_value(objective(evaluated_case->GetRealVarVector()));
+          optimizer->SubmitEvaluatedCase(evaluated_case);
+      }
+      return being_evaluated.empty();
+  }
 
  private:
   QJsonObject obj_fun_ {
@@ -88,6 +142,19 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
       {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_compass_search_screening_minimize_ {
+      {"Type", "Compass"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"MaxEvaluations", 100},
+          {"InitialStepLength", 0.25},
+          {"MinimumStepLength", 0.01},
+          {"Screening", "TopK"},
+          {"Screening-TopK", 2}
+      }},
+      {"Objective", obj_fun_}
+  };
+
   QJsonObject get_json_settings_compass_search_maximize_ {
       {"Type", "Compass"},
       {"Mode", "Maximize"},
@@ -110,6 +177,18 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
       {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_apps_cancel_minimize_ {
+      {"Type", "APPS"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"MaxEvaluations", 500},
+          {"InitialStepLength", 0.64},
+          {"MinimumStepLength", 0.005},
+          {"CancelObsoleteCases", true}
+      }},
+      {"Objective", obj_fun_}
+  };
+
   QJsonObject get_json_settings_apps_maximize_ {
       {"Type", "APPS"},
       {"Mode", "Maximize"},
@@ -188,6 +267,23 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
       {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_vfsa_chains_minimize_ {
+      {"Type", "VFSA"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"VFSA-MaxIterations",          50},
+          {"VFSA-EvalsPrIteration",        5},
+          {"VFSA-InitTemp",             1E-3},
+          {"VFSA-TempScale",             0.1},
+          {"VFSA-Chains",                  4},
+          {"VFSA-TempLadder",          100.0},
+          {"VFSA-SwapInterval",            8},
+          {"LowerBoundReal",            -5.0},
+          {"UpperBoundReal",             5.0}
+      }},
+      {"Objective", obj_fun_}
+  };
+
 
   QJsonObject get_json_settings_spsa_minimize_ {
       {"Type", "SPSA"},
@@ -204,6 +300,77 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
       {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_spsa_batch_minimize_ {
+      {"Type", "SPSA"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"SPSA-MaxIterations",         100},
+          {"SPSA-c",                    0.05},
+          {"SPSA-InitStepMagnitude",     0.1},
+          {"SPSA-BatchSize",               4},
+          {"SPSA-Hessian",              true},
+          {"SPSA-StepCandidates",          3}
+      }},
+      {"Objective", obj_fun_}
+  };
+
+  QJsonObject get_json_settings_lbfgsb_minimize_ {
+      {"Type", "LBFGSB"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"LBFGSB-MaxIterations",        20},
+          {"LBFGSB-Memory",                5},
+          {"LBFGSB-FDStep",             1e-4},
+          {"LBFGSB-CentralDifferences", true},
+          {"LBFGSB-StepCandidates",        4}
+      }},
+      {"Objective", obj_fun_}
+  };
+
+  QJsonObject get_json_settings_portfolio_minimize_ {
+      {"Type", "Portfolio"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"MaxEvaluations", 600},
+          {"PortfolioWindow", 10}
+      }},
+      {"PortfolioComponents", QJsonArray{
+          QJsonObject{
+              {"Type", "Compass"},
+              {"Parameters", QJsonObject{
+                  {"MaxEvaluations", 300},
+                  {"InitialStepLength", 0.25},
+                  {"MinimumStepLength", 0.01}
+              }}
+          },
+          QJsonObject{
+              {"Type", "APPS"},
+              {"Parameters", QJsonObject{
+                  {"MaxEvaluations", 300},
+                  {"InitialStepLength", 0.64},
+                  {"MinimumStepLength", 0.005}
+              }}
+          }
+      }},
+      {"Objective", obj_fun_}
+  };
+
+  QJsonObject get_json_settings_exhaustive_minimize_ {
+      {"Type", "ExhaustiveSearch2DVert"},
+      {"Mode", "Minimize"},
+      {"Objective", obj_fun_}
+  };
+
+  QJsonObject get_json_settings_exhaustive_coarse_minimize_ {
+      {"Type", "ExhaustiveSearch2DVert"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"Exhaustive-Stride", 4},
+          {"Exhaustive-RefineTop", 2}
+      }},
+      {"Objective", obj_fun_}
+  };
+
   QJsonObject get_json_settings_spsa_maximize_ {
       {"Type", "SPSA"},
       {"Mode", "Maximize"},
@@ -219,6 +386,37 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
       {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_ga_steady_state_minimize_ {
+      {"Type", "GeneticAlgorithm"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"MaxGenerations",        100},
+          {"PopulationSize",        20},
+          {"CrossoverProbability",  0.1},
+          {"DecayRate",             4.0},
+          {"MutationStrength",      0.25},
+          {"StagnationLimit",       1e-10},
+          {"LowerBound",            -10.0},
+          {"UpperBound",            10.0},
+          {"SteadyState",           true}
+      }},
+      {"Objective", obj_fun_}
+  };
+  QJsonObject get_json_settings_pso_steady_state_minimize_ {
+      {"Type", "PSO"},
+      {"Mode", "Minimize"},
+      {"Parameters", QJsonObject{
+          {"MaxGenerations",        100},
+          {"PSO-SwarmSize",          10},
+          {"PSO-LearningFactor1",    2.2},
+          {"PSO-LearningFactor2",    1.8},
+          {"PSO-VelocityScale",      0.025},
+          {"LowerBound",            -5.0},
+          {"UpperBound",             5.0},
+          {"SteadyState",           true}
+      }},
+      {"Objective", obj_fun_}
+  };
   QJsonObject get_json_settings_pso_minimize_ {
       {"Type", "PSO"},
       {"Mode", "Minimize"},
@@ -247,6 +445,19 @@ class TestResourceOptimizer : public TestResourceModel, public TestResourceCases
           {"Objective", obj_fun_}
   };
 
+  QJsonObject get_json_settings_cma_es_bipop_minimize_ {
+          {"Type", "CMA_ES"},
+          {"Mode", "Minimize"},
+          {"Parameters", QJsonObject{
+                  {"MaxGenerations",        200},
+                  {"LowerBound",             -1},
+                  {"UpperBound",             1},
+                  {"CMA-ES-RestartStrategy", "BIPOP"},
+                  {"CMA-ES-Sampling", "Mirrored"}
+          }},
+          {"Objective", obj_fun_}
+  };
+
   QJsonObject get_json_settings_ego_maximize_ {
       {"Type", "EGO"},
       {"Mode", "Maximize"},
@@ -1,13 +1,18 @@
 SET(RUNNER_HEADERS
 	bookkeeper.h
+	evaluation_store.h
 	loggable.hpp
 	logger.h
+	run_log_reader.h
 	runners/abstract_runner.h
+	runners/core_allocator.h
 	runners/ensemble_helper.h
+	runners/fidelity_helper.h
 	runners/main_runner.h
 	runners/mpi_runner.h
 	runners/oneoff_runner.h
 	runners/overseer.h
+	runners/runtime_predictor.h
 	runners/serial_runner.h
 	runners/synchronous_mpi_runner.h
 	runners/worker.h
@@ -16,13 +21,18 @@ SET(RUNNER_HEADERS
 
 SET(RUNNER_SOURCES
 	bookkeeper.cpp
+	evaluation_store.cpp
 	logger.cpp
+	run_log_reader.cpp
 	runners/abstract_runner.cpp
+	runners/core_allocator.cpp
 	runners/ensemble_helper.cpp
+	runners/fidelity_helper.cpp
 	runners/main_runner.cpp
 	runners/mpi_runner.cpp
 	runners/oneoff_runner.cpp
 	runners/overseer.cpp
+	runners/runtime_predictor.cpp
 	runners/serial_runner.cpp
 	runners/synchronous_mpi_runner.cpp
 	runners/worker.cpp
@@ -32,6 +42,12 @@ SET(RUNNER_SOURCES
 SET(RUNNER_TESTS
 	tests/test_resource_runner.hpp
 	tests/test_bookkeeper.cpp
+	tests/test_core_allocator.cpp
+	tests/test_ensemble_helper.cpp
+	tests/test_evaluation_store.cpp
+	tests/test_fidelity_helper.cpp
+	tests/test_run_log_reader.cpp
 	tests/test_runtime_settings.cpp
+	tests/test_runtime_predictor.cpp
 )
 
@@ -0,0 +1,276 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/*!
+ * @file bench_fieldopt.cpp
+ * @brief Framework overhead benchmark.
+ *
+ * Runs FieldOpt with the in-process Analytic simulator for a set of optimizers, with
+ * the serial and (optionally) the synchronous MPI runner, and reports the number of
+ * cases evaluated per second along with the time spent per case in each traced stage
+ * (see Utilities/tracing.hpp). Because no reservoir simulator is involved, the numbers
+ * measure the optimizer, bookkeeping, logging and communication overhead only.
+ *
+ * The base driver file must describe a model that FieldOpt can load (grid and deck);
+ * its simulator, optimizer type and objective are replaced by the benchmark. A CSV
+ * summary is written to bench_results.csv in the output directory.
+ *
+ * Usage:
+ *   bench_fieldopt driver.json output-dir -g grid -s deck [--cases N] [--mpi-procs P]
+ */
+
+#include <boost/program_options.hpp>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+#ifndef FIELDOPT_EXEC
+#define FIELDOPT_EXEC "FieldOpt"
+#endif
+
+namespace {
+
+/// Stages reported per case, in order. The names are the ones used with TRACE_SCOPE.
+const std::vector<std::string> STAGES = {
+    "Iterate", "HandleEvaluatedCase", "ApplyCase", "ComputeWellBlocks",
+    "AnalyticFunction", "ObjectiveValue", "SendMessage", "RecvMessage"
+};
+
+struct StageTotal {
+  double us = 0.0;
+  long count = 0;
+};
+
+struct BenchResult {
+  std::string runner;
+  std::string optimizer;
+  long cases = 0;
+  double seconds = 0.0;
+  std::map<std::string, StageTotal> stages;
+};
+
+QJsonObject readJson(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("Unable to open " + path.toStdString());
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+        throw std::runtime_error("Unable to parse " + path.toStdString() + ": " + error.errorString().toStdString());
+    return doc.object();
+}
+
+void writeJson(const QJsonObject &json, const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        throw std::runtime_error("Unable to write " + path.toStdString());
+    file.write(QJsonDocument(json).toJson());
+}
+
+/*!
+ * Replace the simulator, optimizer type and objective in the base driver.
+ */
+QJsonObject benchDriver(QJsonObject driver, const std::string &optimizer, int cases, const std::string &function) {
+    QJsonObject simulator = driver["Simulator"].toObject();
+    simulator["Type"] = "Analytic";
+    simulator["AnalyticFunction"] = QString::fromStdString(function);
+    driver["Simulator"] = simulator;
+
+    QJsonObject json_optimizer = driver["Optimizer"].toObject();
+    json_optimizer["Type"] = QString::fromStdString(optimizer);
+    json_optimizer["Mode"] = "Minimize";
+    QJsonObject parameters = json_optimizer["Parameters"].toObject();
+    parameters["MaxEvaluations"] = cases;
+    parameters["MaxGenerations"] = cases;
+    parameters["MinimumStepLength"] = 1e-9;
+    json_optimizer["Parameters"] = parameters;
+    json_optimizer["Objective"] = QJsonObject{
+        {"Type", "WeightedSum"},
+        {"WeightedSumComponents", QJsonArray{QJsonObject{
+            {"Coefficient", 1.0}, {"Property", "CumulativeOilProduction"},
+            {"TimeStep", -1}, {"IsWellProp", false}
+        }}}
+    };
+    driver["Optimizer"] = json_optimizer;
+    return driver;
+}
+
+/*!
+ * Sum the durations of the complete events in all trace files written by a run (one per rank).
+ */
+void collectTraces(const QString &run_dir, BenchResult &result) {
+    QStringList trace_paths;
+    trace_paths << run_dir + "/trace.json";
+    for (QString rank_dir : QDir(run_dir).entryList(QStringList() << "rank*", QDir::Dirs)) {
+        trace_paths << run_dir + "/" + rank_dir + "/trace.json";
+    }
+    for (QString path : trace_paths) {
+        if (!QFile::exists(path))
+            continue;
+        for (auto event : readJson(path)["traceEvents"].toArray()) {
+            QJsonObject e = event.toObject();
+            if (e["ph"].toString() != "X")
+                continue;
+            StageTotal &total = result.stages[e["name"].toString().toStdString()];
+            total.us += e["dur"].toDouble();
+            total.count++;
+        }
+    }
+    result.cases = result.stages["AnalyticFunction"].count;
+}
+
+BenchResult runBenchmark(const po::variables_map &vm, const QJsonObject &base_driver,
+                         const std::string &runner, const std::string &optimizer) {
+    BenchResult result;
+    result.runner = runner;
+    result.optimizer = optimizer;
+
+    QString output_dir = QString::fromStdString(vm["output-dir"].as<std::string>());
+    QString name = QString::fromStdString(runner + "_" + optimizer);
+    QString run_dir = output_dir + "/" + name;
+    QString driver_path = output_dir + "/drivers/" + name + ".json";
+    QDir().mkpath(run_dir);
+    QDir().mkpath(output_dir + "/drivers");
+    writeJson(benchDriver(base_driver, optimizer, vm["cases"].as<int>(), vm["function"].as<std::string>()), driver_path);
+
+    std::stringstream cmd;
+    if (runner == "mpisync")
+        cmd << vm["mpirun"].as<std::string>() << " -n " << vm["mpi-procs"].as<int>() << " ";
+    cmd << vm["fieldopt"].as<std::string>() << " " << driver_path.toStdString() << " " << run_dir.toStdString()
+        << " -g " << vm["grid-path"].as<std::string>()
+        << " -s " << vm["sim-drv-path"].as<std::string>()
+        << " -r " << runner << " --trace -f"
+        << " > " << run_dir.toStdString() << "/stdout.log 2>&1";
+
+    auto start = std::chrono::steady_clock::now();
+    int status = std::system(cmd.str().c_str());
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (status != 0) {
+        std::cerr << "Run " << name.toStdString() << " failed (see " << run_dir.toStdString() << "/stdout.log)" << std::endl;
+        return result;
+    }
+    collectTraces(run_dir, result);
+    return result;
+}
+
+void printResult(const BenchResult &r) {
+    std::cout << std::left << std::setw(8) << r.runner << std::setw(18) << r.optimizer << std::right
+              << std::setw(8) << r.cases << std::setw(10) << std::fixed << std::setprecision(2) << r.seconds
+              << std::setw(12) << std::setprecision(1) << (r.seconds > 0 ? r.cases / r.seconds : 0.0);
+    for (auto stage : STAGES) {
+        auto it = r.stages.find(stage);
+        double per_case = it != r.stages.end() && r.cases > 0 ? it->second.us / r.cases : 0.0;
+        std::cout << std::setw(20) << std::setprecision(1) << per_case;
+    }
+    std::cout << std::endl;
+}
+
+void writeCsv(const std::vector<BenchResult> &results, const std::string &path) {
+    std::ofstream out(path);
+    out << "runner,optimizer,cases,seconds,cases_per_second";
+    for (auto stage : STAGES) out << "," << stage << "_us_per_case";
+    out << std::endl;
+    for (auto r : results) {
+        out << r.runner << "," << r.optimizer << "," << r.cases << "," << r.seconds << ","
+            << (r.seconds > 0 ? r.cases / r.seconds : 0.0);
+        for (auto stage : STAGES) {
+            out << "," << (r.cases > 0 ? r.stages[stage].us / r.cases : 0.0);
+        }
+        out << std::endl;
+    }
+}
+
+}
+
+int main(int argc, const char *argv[])
+{
+    po::options_description desc("bench_fieldopt options");
+    desc.add_options()
+        ("help,h", "print help message")
+        ("input-file", po::value<std::string>(), "base FieldOpt driver file")
+        ("output-dir", po::value<std::string>(), "directory to write the runs and the summary to")
+        ("grid-path,g", po::value<std::string>(), "path to model grid file")
+        ("sim-drv-path,s", po::value<std::string>(), "path to simulator deck")
+        ("cases,c", po::value<int>()->default_value(10000), "maximum number of cases per run")
+        ("optimizers,o", po::value<std::vector<std::string>>()->multitoken()->default_value(
+            std::vector<std::string>{"Compass", "APPS", "GeneticAlgorithm", "PSO", "CMA_ES", "VFSA", "SPSA", "LBFGSB"},
+            "Compass APPS GeneticAlgorithm PSO CMA_ES VFSA SPSA LBFGSB"), "optimizers to benchmark")
+        ("function", po::value<std::string>()->default_value("Rosenbrock"), "analytic function (Sphere/Rosenbrock)")
+        ("mpi-procs,m", po::value<int>()->default_value(0), "also run the mpisync runner with this many processes (>= 2)")
+        ("mpirun", po::value<std::string>()->default_value("mpirun"), "MPI launcher")
+        ("fieldopt", po::value<std::string>()->default_value(FIELDOPT_EXEC), "path to the FieldOpt executable")
+        ;
+    po::positional_options_description p;
+    p.add("input-file", 1);
+    p.add("output-dir", 1);
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(p).run(), vm);
+        po::notify(vm);
+    }
+    catch (std::exception &e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (vm.count("help") || !vm.count("input-file") || !vm.count("output-dir")
+        || !vm.count("grid-path") || !vm.count("sim-drv-path")) {
+        std::cout << "Usage: ./bench_fieldopt driver-file output-dir -g grid -s deck [options]" << std::endl;
+        std::cout << desc << std::endl;
+        return vm.count("help") ? 0 : 1;
+    }
+
+    std::vector<std::string> runners = {"serial"};
+    if (vm["mpi-procs"].as<int>() >= 2)
+        runners.push_back("mpisync");
+
+    std::vector<BenchResult> results;
+    try {
+        QJsonObject base_driver = readJson(QString::fromStdString(vm["input-file"].as<std::string>()));
+
+        std::cout << std::left << std::setw(8) << "Runner" << std::setw(18) << "Optimizer" << std::right
+                  << std::setw(8) << "Cases" << std::setw(10) << "Wall[s]" << std::setw(12) << "Cases/s";
+        for (auto stage : STAGES) std::cout << std::setw(20) << stage + "[us]";
+        std::cout << std::endl;
+
+        for (auto runner : runners) {
+            for (auto optimizer : vm["optimizers"].as<std::vector<std::string>>()) {
+                results.push_back(runBenchmark(vm, base_driver, runner, optimizer));
+                printResult(results.back());
+            }
+        }
+        writeCsv(results, vm["output-dir"].as<std::string>() + "/bench_results.csv");
+    }
+    catch (std::exception &e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
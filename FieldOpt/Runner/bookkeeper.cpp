@@ -6,17 +6,59 @@ namespace Runner {
     {
         tolerance_ = settings->bookkeeper_tolerance();
         case_handler_ = case_handler;
+        store_ = nullptr;
     }
 
     bool Bookkeeper::IsEvaluated(Optimization::Case *c, bool set_obj)
     {
-        for (auto evaluated_c : case_handler_->EvaluatedCases()) {
-            if (evaluated_c->Equals(c)) { // Case has been evaluated
+        for (auto evaluated_c : case_handler_->EvaluatedCasesView()) {
+            if (evaluated_c->Equals(c, tolerance_)) { // Case has been evaluated
                 if (set_obj) c->set_objective_function_value(evaluated_c->objective_function_value());
                 return true;
             }
         }
+        double ofv;
+        if (store_ != nullptr && store_->Lookup(storeKey(c), ofv)) {
+            if (set_obj) c->set_objective_function_value(ofv);
+            return true;
+        }
         return false;
     }
 
+    void Bookkeeper::SetEvaluationStore(EvaluationStore *store, Model::Properties::VariablePropertyContainer *variables)
+    {
+        store_ = store;
+        QMap<QString, QUuid> binary, integer, real; // Sorted by name
+        for (auto var : variables->GetBinaryVariables()->values()) binary[var->name()] = var->id();
+        for (auto var : variables->GetDiscreteVariables()->values()) integer[var->name()] = var->id();
+        for (auto var : variables->GetContinousVariables()->values()) real[var->name()] = var->id();
+        binary_ids_ = binary.values();
+        integer_ids_ = integer.values();
+        real_ids_ = real.values();
+    }
+
+    void Bookkeeper::Record(Optimization::Case *c)
+    {
+        if (store_ == nullptr || c->state.eval != Optimization::Case::CaseState::EvalStatus::E_DONE)
+            return;
+        if (c->HasFidelityOfv(Optimization::Case::COARSE)) { // Multi-fidelity case
+            if (c->HasFidelityOfv(Optimization::Case::FINE))
+                store_->Append(storeKey(c), c->GetFidelityOfv(Optimization::Case::FINE));
+            return;
+        }
+        store_->Append(storeKey(c), c->objective_function_value());
+    }
+
+    uint64_t Bookkeeper::storeKey(Optimization::Case *c) const
+    {
+        QHash<QUuid, bool> binary_variables = c->binary_variables();
+        QHash<QUuid, int> integer_variables = c->integer_variables();
+        QHash<QUuid, double> real_variables = c->real_variables();
+        std::vector<double> values;
+        for (QUuid id : binary_ids_) values.push_back(binary_variables.value(id));
+        for (QUuid id : integer_ids_) values.push_back(integer_variables.value(id));
+        for (QUuid id : real_ids_) values.push_back(real_variables.value(id));
+        return store_->Key(values);
+    }
+
 }
@@ -3,6 +3,8 @@
 
 #include "Settings/settings.h"
 #include "Optimization/case_handler.h"
+#include "Model/properties/variable_property_container.h"
+#include "evaluation_store.h"
 
 namespace Runner {
 
@@ -14,7 +16,11 @@ namespace Runner {
  * the already known value.
  *
  * The Bookkeeper uses the case_handler from the optimizer to keep track of which cases
- * have been evaluated.
+ * have been evaluated, comparing the variable values with the bookkeeper tolerance. If an
+ * EvaluationStore is set, cases evaluated in earlier runs on the same model are also found.
+ * The store rounds the variable values to the tolerance before hashing them, so it only
+ * finds cases whose values round to the same values; two cases within the tolerance of
+ * each other may still round differently.
  *
  * \todo Handle the case where a case is currently being evaluated; i.e. there exists a case
  * in the "under evaluation" list which is equal to the case being checked, but has a different
@@ -35,9 +41,34 @@ public:
      */
     bool IsEvaluated(Optimization::Case *c, bool set_obj=false);
 
+    /*!
+     * \brief SetEvaluationStore Also look cases up in a persistent evaluation store, and
+     * record evaluated cases in it (see Record()).
+     * \param store The store.
+     * \param variables The model variables. The values of a case are passed to the store
+     * ordered by variable name, as the variable ids differ between runs.
+     */
+    void SetEvaluationStore(EvaluationStore *store, Model::Properties::VariablePropertyContainer *variables);
+
+    /*!
+     * \brief Record Record the objective function value of an evaluated case in the
+     * evaluation store, if one is set. Only successfully simulated cases are recorded.
+     *
+     * In multi-fidelity runs, only cases evaluated on the fine model are recorded, with
+     * their fine value, as the coarse values are estimates. The values found in the store
+     * are therefore always true objective function values.
+     */
+    void Record(Optimization::Case *c);
+
 private:
     double tolerance_;
     Optimization::CaseHandler *case_handler_;
+    EvaluationStore *store_;
+    QList<QUuid> binary_ids_; //!< Binary variable ids, ordered by name.
+    QList<QUuid> integer_ids_; //!< Integer variable ids, ordered by name.
+    QList<QUuid> real_ids_; //!< Real variable ids, ordered by name.
+
+    uint64_t storeKey(Optimization::Case *c) const; //!< Key of a case in the evaluation store.
 };
 
 }
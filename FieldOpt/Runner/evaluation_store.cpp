@@ -0,0 +1,182 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "evaluation_store.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Runner {
+
+namespace {
+
+uint64_t fnv1a(const char *data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}
+
+EvaluationStore::EvaluationStore(const std::string &path, uint64_t model_key, double quantum) {
+    if (quantum <= 0)
+        throw std::runtime_error("The quantum of the evaluation store must be positive.");
+    path_ = path;
+    model_key_ = model_key;
+    quantum_ = quantum;
+    read_offset_ = 0;
+    nr_hits_ = 0;
+    nr_skipped_ = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+}
+
+uint64_t EvaluationStore::Key(const std::vector<double> &values) const {
+    uint64_t key = model_key_;
+    for (double value : values) {
+        long long quantized = std::llround(value / quantum_);
+        char bytes[sizeof(quantized)];
+        for (size_t i = 0; i < sizeof(quantized); ++i) {
+            bytes[i] = (char)((quantized >> (8 * i)) & 0xff);
+        }
+        key = fnv1a(bytes, sizeof(bytes), key);
+    }
+    return key;
+}
+
+bool EvaluationStore::Lookup(uint64_t key, double &ofv) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh();
+    auto record = records_.find(key);
+    if (record == records_.end())
+        return false;
+    ofv = record->second;
+    nr_hits_++;
+    return true;
+}
+
+void EvaluationStore::Append(uint64_t key, double ofv) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_[key] = ofv;
+    std::string line = formatRecord(key, ofv);
+    int fd = open(path_.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Unable to open the evaluation store " + path_ + " for writing.");
+    flock(fd, LOCK_EX);
+    size_t written = 0;
+    while (written < line.size()) {
+        ssize_t n = write(fd, line.data() + written, line.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += n;
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+    if (written < line.size())
+        throw std::runtime_error("Unable to write to the evaluation store " + path_ + ".");
+}
+
+void EvaluationStore::refresh() {
+    struct stat st;
+    if (stat(path_.c_str(), &st) != 0 || st.st_size <= read_offset_)
+        return;
+    int fd = open(path_.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    flock(fd, LOCK_SH);
+    std::string data;
+    if (lseek(fd, read_offset_, SEEK_SET) == read_offset_) {
+        char buffer[65536];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            data.append(buffer, n);
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    // Only complete lines are consumed; the rest is read again next time
+    size_t start = 0;
+    size_t end;
+    while ((end = data.find('\n', start)) != std::string::npos) {
+        uint64_t key;
+        double ofv;
+        if (parseRecord(data.substr(start, end - start), key, ofv))
+            records_[key] = ofv;
+        else
+            nr_skipped_++;
+        start = end + 1;
+    }
+    read_offset_ += start;
+}
+
+std::string EvaluationStore::formatRecord(uint64_t key, double ofv) {
+    char body[64];
+    snprintf(body, sizeof(body), "%016llx %.17g", (unsigned long long)key, ofv);
+    char line[96];
+    snprintf(line, sizeof(line), "%s %08llx\n", body,
+             (unsigned long long)(HashBytes(body) & 0xffffffffULL));
+    return std::string(line);
+}
+
+bool EvaluationStore::parseRecord(const std::string &line, uint64_t &key, double &ofv) const {
+    size_t checksum_start = line.rfind(' ');
+    if (checksum_start == std::string::npos || line.size() - checksum_start != 9)
+        return false;
+    std::string body = line.substr(0, checksum_start);
+    char *end;
+    unsigned long long checksum = strtoull(line.c_str() + checksum_start + 1, &end, 16);
+    if (*end != '\0' || checksum != (HashBytes(body) & 0xffffffffULL))
+        return false;
+    key = strtoull(body.c_str(), &end, 16);
+    if (end != body.c_str() + 16 || *end != ' ')
+        return false;
+    ofv = strtod(end + 1, &end);
+    return *end == '\0';
+}
+
+uint64_t EvaluationStore::HashBytes(const std::string &bytes, uint64_t seed) {
+    return fnv1a(bytes.data(), bytes.size(), seed);
+}
+
+uint64_t EvaluationStore::HashFile(const std::string &path, uint64_t seed) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Unable to open " + path + " for hashing.");
+    uint64_t hash = seed;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        hash = fnv1a(buffer, file.gcount(), hash);
+    }
+    return hash;
+}
+
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_EVALUATION_STORE_H
+#define FIELDOPT_EVALUATION_STORE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Runner {
+
+/*!
+ * @brief The EvaluationStore class is a file based store of objective function values,
+ * shared between runs, so that restarted or modified runs do not simulate the same
+ * cases again.
+ *
+ * Each record is keyed by a 64-bit hash of a model key, which should identify everything
+ * the objective function value depends on apart from the variables (e.g. the simulator
+ * deck, the grid and the objective definition), and the variable values, quantized to a
+ * given resolution.
+ *
+ * The file is append-only: each record is one line, written with a single write() to a
+ * file opened with O_APPEND while holding an exclusive lock, so that several processes
+ * can append to the same store. Each line carries a checksum; lines that are incomplete
+ * (e.g. from a crash during a write) or corrupted are skipped when the file is read.
+ * Records appended by other processes are picked up by Lookup() when the file has grown.
+ */
+class EvaluationStore {
+ public:
+  /*!
+   * @param path Path to the store file. It is created if it does not exist.
+   * @param model_key Hash identifying the model and objective (see HashBytes() and HashFile()).
+   * @param quantum Resolution the variable values are rounded to before hashing.
+   */
+  EvaluationStore(const std::string &path, uint64_t model_key, double quantum=1e-6);
+
+  /*!
+   * @brief Get the key of a set of variable values. The values must be in the same
+   * order in every run (e.g. ordered by variable name).
+   */
+  uint64_t Key(const std::vector<double> &values) const;
+
+  /*!
+   * @brief Look up the objective function value stored for a key.
+   * @return True if a value was found.
+   */
+  bool Lookup(uint64_t key, double &ofv);
+
+  /*!
+   * @brief Store the objective function value for a key, in memory and in the file.
+   */
+  void Append(uint64_t key, double ofv);
+
+  int Size() const { return records_.size(); } //!< Number of records known to the store.
+  int NumberHits() const { return nr_hits_; } //!< Number of successful lookups.
+  int NumberSkipped() const { return nr_skipped_; } //!< Number of invalid lines skipped when reading.
+
+  /*!
+   * @brief FNV-1a hash of a string of bytes. Pass the previous hash as seed to combine hashes.
+   */
+  static uint64_t HashBytes(const std::string &bytes, uint64_t seed=14695981039346656037ULL);
+
+  /*!
+   * @brief FNV-1a hash of the contents of a file, read in blocks.
+   */
+  static uint64_t HashFile(const std::string &path, uint64_t seed=14695981039346656037ULL);
+
+ private:
+  std::string path_;
+  uint64_t model_key_;
+  double quantum_;
+  std::unordered_map<uint64_t, double> records_;
+  long read_offset_; //!< Number of bytes of the file that have been read.
+  int nr_hits_;
+  int nr_skipped_;
+  std::mutex mutex_;
+
+  void refresh(); //!< Read the records appended to the file since the last read.
+  static std::string formatRecord(uint64_t key, double ofv);
+  bool parseRecord(const std::string &line, uint64_t &key, double &ofv) const;
+};
+
+}
+
+#endif //FIELDOPT_EVALUATION_STORE_H
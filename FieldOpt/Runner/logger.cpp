@@ -55,6 +55,11 @@ Logger::Logger(Runner::RuntimeSettings *rts,
         }
     }
 
+    if (write_logs_ && rts->async_logging()) {
+        writer_.reset(new Utilities::FileHandling::AsyncFileWriter());
+        Utilities::FileHandling::AsyncFileWriter::InstallSignalHandlers();
+    }
+
     if (write_logs_) {
         // Write CSV headers
         if (!is_worker_) {
@@ -71,7 +76,10 @@ Logger::Logger(Runner::RuntimeSettings *rts,
         QJsonDocument json_doc = QJsonDocument(json_base);
         QFile json_file(ext_log_path_);
         json_file.open(QFile::WriteOnly);
-        json_file.write(json_doc.toJson(QJsonDocument::Indented));
+        if (writer_) // Entries are written in front of the closing brackets
+            json_file.write(("{\"Cases\": [\n" + ext_log_footer_).c_str());
+        else
+            json_file.write(json_doc.toJson(QJsonDocument::Indented));
         json_file.close();
     }
 }
@@ -92,7 +100,7 @@ void Logger::logRunnerState(Loggable *obj) {
     st << "Model update done?  " << obj->GetState()["mod-update-done"] << "\n";
     st << "Simulation done?    " << obj->GetState()["sim-done"] << "\n\n";
     st << "Last update: " << obj->GetState()["last-update"];
-    Utilities::FileHandling::WriteStringToFile(QString::fromStdString(st.str()), run_state_path_);
+    writeFile(QString::fromStdString(st.str()), run_state_path_);
 }
 void Logger::logCase(Loggable *obj) {
     if (!write_logs_ || is_worker_)
@@ -111,7 +119,7 @@ void Logger::logCase(Loggable *obj) {
         entry << " , " << setw(cas_log_col_widths_["OFnVal"]) << scientific << obj->GetValues()["OFvSTD"][0];
     }
     string str = entry.str();
-    Utilities::FileHandling::WriteLineToFile(QString::fromStdString(str), cas_log_path_);
+    appendLine(QString::fromStdString(str), cas_log_path_);
     return;
 }
 void Logger::logOptimizer(Loggable *obj) {
@@ -128,12 +136,14 @@ void Logger::logOptimizer(Loggable *obj) {
     entry << fixed << setfill('0') << setw(opt_log_col_widths_["TimONr"]) << obj->GetValues()["TimONr"][0] << " , ";
     entry << fixed << setfill('0') << setw(opt_log_col_widths_["FailNr"]) << obj->GetValues()["FailNr"][0] << " , ";
     entry << fixed << setfill('0') << setw(opt_log_col_widths_["InvlNr"]) << obj->GetValues()["InvlNr"][0] << " , ";
+    entry << fixed << setfill('0') << setw(opt_log_col_widths_["LiveCs"]) << obj->GetValues()["LiveCs"][0] << " , ";
+    entry << fixed << setfill('0') << setw(opt_log_col_widths_["MemoMB"]) << obj->GetValues()["MemoMB"][0] << " , ";
     entry.precision(6);
     entry << setw(opt_log_col_widths_["CBOFnV"]) << scientific << obj->GetValues()["CBOFnV"][0] << " , ";
     entry.precision(0);
     entry << obj->GetId().toString().toStdString();
     string str = entry.str();
-    Utilities::FileHandling::WriteLineToFile(QString::fromStdString(str), opt_log_path_);
+    appendLine(QString::fromStdString(str), opt_log_path_);
     return;
 }
 void Logger::logExtended(Loggable *obj) {
@@ -184,6 +194,13 @@ void Logger::logExtended(Loggable *obj) {
     // Compdat string
     new_entry.insert("COMPDAT", QString::fromStdString(obj->GetState()["COMPDAT"]));
 
+    if (writer_) {
+        std::string entry = QJsonDocument(new_entry).toJson(QJsonDocument::Compact).toStdString();
+        writer_->InsertBeforeFooter(ext_log_path_.toStdString(),
+                                    (n_ext_log_cases_ > 0 ? "," : "") + entry + "\n", ext_log_footer_);
+        n_ext_log_cases_++;
+        return;
+    }
 
     // Open existing document
     QFile json_file(ext_log_path_);
@@ -213,6 +230,25 @@ void Logger::logExtended(Loggable *obj) {
     return;
 }
 
+void Logger::appendLine(const QString &line, const QString &path) {
+    if (writer_)
+        writer_->Append(path.toStdString(), line.toStdString());
+    else
+        Utilities::FileHandling::WriteLineToFile(line, path);
+}
+
+void Logger::writeFile(const QString &content, const QString &path) {
+    if (writer_)
+        writer_->Replace(path.toStdString(), content.toStdString());
+    else
+        Utilities::FileHandling::WriteStringToFile(content, path);
+}
+
+void Logger::Flush() {
+    if (writer_)
+        writer_->Flush();
+}
+
 void Logger::collectExtendedLogs() {
     if (!write_logs_ || is_worker_) return;
 
@@ -354,6 +390,7 @@ void Logger::FinalizePrerunSummary() {
 void Logger::FinalizePostrunSummary() {
     if (!write_logs_ || is_worker_) return;
 
+    Flush();
     collectExtendedLogs(); // Collect all the extended json logs into one
 
     stringstream sum;
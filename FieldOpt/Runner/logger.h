@@ -22,6 +22,7 @@
 
 #include "string"
 #include "map"
+#include <memory>
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
@@ -33,6 +34,7 @@
 #include "Model/model.h"
 #include "Simulation/results/results.h"
 #include "loggable.hpp"
+#include "Utilities/async_writer.hpp"
 
 using namespace std;
 
@@ -54,6 +56,12 @@ using namespace std;
  *
  * Finally, files indicating the current state of each worker will be written when
  * running in parallel (state_runner.txt).
+ *
+ * When the --async-logging flag is set, AddEntry only formats the entry; the files are
+ * written by a background thread (see Utilities/async_writer.hpp). Each entry in the
+ * extended log is then written in front of the closing brackets of the JSON document,
+ * instead of the document being read back, parsed and rewritten. Flush() must be called
+ * before the logs are read.
  */
 class Logger
 {
@@ -70,6 +78,12 @@ class Logger
   void FinalizePrerunSummary();
   void FinalizePostrunSummary();
 
+  /*!
+   * @brief Block until all entries added so far have been written. Does nothing
+   * unless async logging is enabled.
+   */
+  void Flush();
+
  private:
   bool is_worker_; //!< Indicates whether or not this logger is on a worker process. This determines which logs are written.
   bool write_logs_;
@@ -81,6 +95,9 @@ class Logger
   QString run_state_path_; //!< Path to the runner state file.
   QString summary_prerun_path_; //!< Path to the pre-run summary file.
   QString summary_postrun_path_; //!< Path to the pre-run summary file.
+  std::unique_ptr<Utilities::FileHandling::AsyncFileWriter> writer_; //!< Background writer. Only set when async logging is enabled.
+  int n_ext_log_cases_ = 0; //!< Number of cases in the extended log. Only used when async logging is enabled.
+  const std::string ext_log_footer_ = "]}\n"; //!< End of the extended log when async logging is enabled.
 
   map<string, vector<double>> sum_mod_valmap_; //!< Model summary value map.
   map<string, vector<double>> sum_opt_valmap_; //!< Optimizer summary value map.
@@ -114,10 +131,12 @@ class Logger
       {"TimONr", 6},
       {"FailNr", 6},
       {"InvlNr", 6},
+      {"LiveCs", 6},
+      {"MemoMB", 6},
       {"CBOFnV", 12},
       {"CurBst", 41}
   };
-  const QString opt_log_header_ = "             TimeSt ,   TimeEl ,   TimeIt , IterNr , TotlNr , EvalNr , BkpdNr , TimONr , FailNr , InvlNr ,       CBOFnV ,                                 CurBst";
+  const QString opt_log_header_ = "             TimeSt ,   TimeEl ,   TimeIt , IterNr , TotlNr , EvalNr , BkpdNr , TimONr , FailNr , InvlNr , LiveCs , MemoMB ,       CBOFnV ,                                 CurBst";
 
   void logCase(Loggable *obj);
   void logOptimizer(Loggable *obj);
@@ -125,6 +144,9 @@ class Logger
   void logSummary(Loggable *obj);
   void logRunnerState(Loggable *obj);
 
+  void appendLine(const QString &line, const QString &path); //!< Append a line to a file, directly or through the writer.
+  void writeFile(const QString &content, const QString &path); //!< Replace the contents of a file, directly or through the writer.
+
   /*!
    * @brief Append a well description to the summary.
    * @param w Well to append description of.
@@ -0,0 +1,145 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "run_log_reader.h"
+#include "Utilities/printer.hpp"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <cmath>
+#include <stdexcept>
+
+namespace Runner {
+
+RunLogReader::RunLogReader(const std::string &directory) {
+    QString dir = QString::fromStdString(directory);
+    readCaseLog(dir + "/log_cases.csv");
+    readExtendedLog(dir + "/log_extended.json");
+}
+
+QList<Optimization::Case *> RunLogReader::Cases(Model::Properties::VariablePropertyContainer *variables) const {
+    QList<Optimization::Case *> cases;
+    int n_incomplete = 0;
+    for (QUuid id : order_) {
+        Record record = records_[id];
+        if (record.eval_status != "OKAY" && record.eval_status != "BKPD")
+            continue;
+
+        // Start from the current values, so that the hashes have the same keys as the base case
+        QHash<QUuid, bool> binary_values = variables->GetBinaryVariableValues();
+        QHash<QUuid, int> integer_values = variables->GetDiscreteVariableValues();
+        QHash<QUuid, double> real_values = variables->GetContinousVariableValues();
+        QHash<QString, double> logged = variable_values_.value(id);
+        bool complete = true;
+        for (auto var : variables->GetBinaryVariables()->values()) {
+            if (!logged.contains(var->name())) complete = false;
+            else binary_values[var->id()] = logged[var->name()] != 0.0;
+        }
+        for (auto var : variables->GetDiscreteVariables()->values()) {
+            if (!logged.contains(var->name())) complete = false;
+            else integer_values[var->id()] = (int)std::lround(logged[var->name()]);
+        }
+        for (auto var : variables->GetContinousVariables()->values()) {
+            if (!logged.contains(var->name())) complete = false;
+            else real_values[var->id()] = logged[var->name()];
+        }
+        if (!complete) {
+            n_incomplete++;
+            continue;
+        }
+
+        auto c = new Optimization::Case(binary_values, integer_values, real_values);
+        bool duplicate = false;
+        for (auto other : cases) {
+            if (other->Equals(c)) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            delete c;
+            continue;
+        }
+        c->set_objective_function_value(record.ofv);
+        c->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+        cases.append(c);
+    }
+    if (n_incomplete > 0) {
+        Printer::ext_warn(Printer::num2str(n_incomplete) + " logged cases lack values for some of the variables. "
+                              "They are not used.", "Runner", "RunLogReader");
+    }
+    return cases;
+}
+
+void RunLogReader::readCaseLog(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        throw std::runtime_error("Unable to open the case log " + path.toStdString() + ".");
+    QTextStream stream(&file);
+
+    QStringList header = stream.readLine().split(",");
+    for (int i = 0; i < header.size(); ++i) {
+        header[i] = header[i].trimmed();
+    }
+    int status_col = header.indexOf("EvalSt");
+    int ofv_col = header.indexOf("OFnVal");
+    int id_col = header.indexOf("CaseId");
+    if (status_col < 0 || ofv_col < 0 || id_col < 0)
+        throw std::runtime_error("Unexpected header in the case log " + path.toStdString() + ".");
+
+    while (!stream.atEnd()) {
+        QStringList columns = stream.readLine().split(",");
+        if (columns.size() < header.size())
+            continue; // E.g. an incomplete last line
+        bool ok;
+        Record record;
+        record.eval_status = columns[status_col].trimmed();
+        record.ofv = columns[ofv_col].trimmed().toDouble(&ok);
+        QUuid id = QUuid(columns[id_col].trimmed());
+        if (!ok || id.isNull())
+            continue;
+        if (!records_.contains(id))
+            order_.append(id);
+        records_[id] = record;
+    }
+}
+
+void RunLogReader::readExtendedLog(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error("Unable to open the extended log " + path.toStdString() + ".");
+    QJsonDocument json = QJsonDocument::fromJson(file.readAll());
+    if (!json.isObject() || !json.object()["Cases"].isArray())
+        throw std::runtime_error("Unable to parse the extended log " + path.toStdString() + ".");
+
+    for (auto entry : json.object()["Cases"].toArray()) {
+        QJsonObject case_entry = entry.toObject();
+        QUuid id = QUuid(case_entry["UUID"].toString());
+        QHash<QString, double> values;
+        for (auto var : case_entry["Variables"].toArray()) {
+            QJsonObject var_entry = var.toObject();
+            for (QString key : var_entry.keys()) {
+                if (key.startsWith("Var#"))
+                    values[key.mid(4)] = var_entry[key].toDouble();
+            }
+        }
+        variable_values_[id] = values; // The last entry for a case is the one after it was applied
+    }
+}
+
+}
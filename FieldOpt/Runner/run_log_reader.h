@@ -0,0 +1,76 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_RUN_LOG_READER_H
+#define FIELDOPT_RUN_LOG_READER_H
+
+#include "Optimization/case.h"
+#include "Model/properties/variable_property_container.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QUuid>
+#include <string>
+
+namespace Runner {
+
+/*!
+ * @brief The RunLogReader class reads the evaluated cases from the logs written by a
+ * previous run (log_cases.csv and log_extended.json), so that they can be used to
+ * warm start a new run (see the --warm-start option).
+ *
+ * The case log provides the evaluation status and objective function value of each case;
+ * the extended log provides the variable values, keyed by variable name. The two are
+ * joined on the case id.
+ */
+class RunLogReader {
+ public:
+  /*!
+   * @param directory The output directory of the previous run.
+   */
+  RunLogReader(const std::string &directory);
+
+  /*!
+   * @brief Create cases for the successfully evaluated cases in the logs.
+   *
+   * The variable values are matched to the variables in the container by name, as the
+   * variable ids differ between runs. Cases that lack a value for any of the variables
+   * (e.g. because variables have been added since the previous run), and cases that are
+   * equal to a case already returned, are skipped.
+   * @param variables The variables of the current model.
+   * @return The cases, with objective function values, in the order they were logged.
+   */
+  QList<Optimization::Case *> Cases(Model::Properties::VariablePropertyContainer *variables) const;
+
+  int NumberRecords() const { return order_.size(); } //!< Number of cases in the case log.
+
+ private:
+  struct Record {
+    QString eval_status; //!< EvalSt column of the case log.
+    double ofv; //!< OFnVal column of the case log.
+  };
+
+  QList<QUuid> order_; //!< Case ids in the order they were logged.
+  QHash<QUuid, Record> records_;
+  QHash<QUuid, QHash<QString, double>> variable_values_; //!< Variable values by name, from the extended log.
+
+  void readCaseLog(const QString &path);
+  void readExtendedLog(const QString &path);
+};
+
+}
+
+#endif //FIELDOPT_RUN_LOG_READER_H
@@ -25,12 +25,15 @@
 #include <Optimization/optimizers/GeneticAlgorithm.h>
 #include <Optimization/optimizers/RGARDD.h>
 #include <Optimization/hybrid_optimizer.h>
+#include <Optimization/portfolio_optimizer.h>
 #include <Optimization/optimizers/bayesian_optimization/EGO.h>
 #include "Optimization/optimizers/PSO.h"
 #include "Optimization/optimizers/CMA_ES.h"
 #include "Optimization/optimizers/VFSA.h"
 #include "Optimization/optimizers/SPSA.h"
+#include "Optimization/optimizers/LBFGSB.h"
 #include "Simulation/simulator_interfaces/ix_simulator.h"
+#include "Simulation/simulator_interfaces/analytic_simulator.h"
 #include "abstract_runner.h"
 #include "Optimization/optimizers/compass_search.h"
 #include "Optimization/optimizers/ExhaustiveSearch2DVert.h"
@@ -40,6 +43,7 @@
 #include "Utilities/math.hpp"
 #include "Utilities/printer.hpp"
 #include "Utilities/verbosity.h"
+#include "Utilities/tracing.hpp"
 
 namespace Runner {
 
@@ -54,6 +58,7 @@ AbstractRunner::AbstractRunner(RuntimeSettings *runtime_settings)
     base_case_ = 0;
     optimizer_ = 0;
     bookkeeper_ = 0;
+    evaluation_store_ = 0;
 }
 
 double AbstractRunner::sentinelValue() const
@@ -78,11 +83,24 @@ void AbstractRunner::InitializeSettings(QString output_subdirectory)
 
     if (settings_->simulator()->is_ensemble()) {
         is_ensemble_run_ = true;
-        ensemble_helper_ = EnsembleHelper(settings_->simulator()->get_ensemble(), settings_->optimizer()->parameters().rng_seed);
+        ensemble_helper_ = EnsembleHelper(settings_->simulator()->get_ensemble(), settings_->optimizer()->parameters().rng_seed,
+                                          settings_->optimizer()->mode() == Settings::Optimizer::OptimizerMode::Maximize);
     }
     else {
         is_ensemble_run_ = false;
     }
+
+    is_multi_fidelity_run_ = settings_->simulator()->is_multi_fidelity();
+    if (is_multi_fidelity_run_) {
+        fidelity_helper_ = FidelityHelper(settings_);
+    }
+}
+
+void AbstractRunner::InitializeTracing(int pid)
+{
+    if (runtime_settings_->trace()) {
+        Tracing::Tracer::Instance().Enable(runtime_settings_->paths().GetPath(Paths::OUTPUT_DIR) + "/trace.json", pid);
+    }
 }
 
 void AbstractRunner::InitializeModel()
@@ -119,6 +137,10 @@ void AbstractRunner::InitializeSimulator()
             if (VERB_RUN >= 1) Printer::info("Using INTERSECT reservoir simulator.");
             simulator_ = new Simulation::IXSimulator(settings_, model_);
             break;
+        case ::Settings::Simulator::SimulatorType::Analytic:
+            if (VERB_RUN >= 1) Printer::info("Using in-process analytic simulator.");
+            simulator_ = new Simulation::AnalyticSimulator(settings_, model_);
+            break;
         default:
             throw std::runtime_error("Unable to initialize runner: simulator set in driver file not recognized.");
     }
@@ -174,6 +196,14 @@ void AbstractRunner::InitializeBaseCase()
         model_->wellCost(settings_->optimizer());
         base_case_->set_objective_function_value(objective_function_->value());
     }
+    if (is_multi_fidelity_run_) {
+        // The base case is the first incumbent, so it needs a value from both models
+        base_case_->SetFidelityOfv(Optimization::Case::FINE, base_case_->objective_function_value());
+        if (VERB_RUN >= 1) Printer::ext_info("Simulating base case on the coarse model.", "Runner", "AbstractRunner");
+        if (!evaluateFidelity(base_case_, Optimization::Case::COARSE))
+            throw std::runtime_error("Unable to evaluate the base case on the coarse model.");
+        base_case_->set_objective_function_value(base_case_->GetFidelityOfv(Optimization::Case::FINE));
+    }
     if (VERB_RUN >= 1) Printer::ext_info("Base case objective function value set to " + Printer::num2str(base_case_->objective_function_value()), "Runner", "AbstractRunner");
 }
 
@@ -182,6 +212,10 @@ void AbstractRunner::InitializeOptimizer()
     if (base_case_ == 0 || model_ == 0)
         throw std::runtime_error("The Base Case and the Model must be initialized before the Optimizer");
 
+    settings_->optimizer()->SetParallelEvaluations(parallelEvaluations());
+    if (!runtime_settings_->warm_start().empty())
+        InitializeWarmStart();
+
     switch (settings_->optimizer()->type()) {
         case Settings::Optimizer::OptimizerType::Compass:
             if (VERB_RUN >= 1) Printer::ext_info("Using CompassSearch optimization algorithm.", "Runner", "AbstractRunner");
@@ -243,6 +277,16 @@ void AbstractRunner::InitializeOptimizer()
             );
             optimizer_->SetVerbosityLevel(runtime_settings_->verbosity_level());
             break;
+        case Settings::Optimizer::OptimizerType::Portfolio:
+            if (VERB_RUN >= 1) Printer::ext_info("Using Portfolio optimization algorithm.", "Runner", "AbstractRunner");
+            optimizer_ = new Optimization::PortfolioOptimizer(settings_->optimizer(),
+                                                              base_case_,
+                                                              model_->variables(),
+                                                              model_->grid(),
+                                                              logger_
+            );
+            optimizer_->SetVerbosityLevel(runtime_settings_->verbosity_level());
+            break;
         case Settings::Optimizer::OptimizerType::PSO:
             if (VERB_RUN >= 1) Printer::ext_info("Using PSO optimization algorithm.", "Runner", "AbstractRunner");
             optimizer_ = new Optimization::Optimizers::PSO(settings_->optimizer(),
@@ -254,7 +298,7 @@ void AbstractRunner::InitializeOptimizer()
             optimizer_->SetVerbosityLevel(runtime_settings_->verbosity_level());
             break;
         case Settings::Optimizer::OptimizerType::CMA_ES:
-            if (VERB_RUN >= 1) Printer::ext_info("Using PSO optimization algorithm.", "Runner", "AbstractRunner");
+            if (VERB_RUN >= 1) Printer::ext_info("Using CMA-ES optimization algorithm.", "Runner", "AbstractRunner");
             optimizer_ = new Optimization::Optimizers::CMA_ES(settings_->optimizer(),
                                                            base_case_,
                                                            model_->variables(),
@@ -283,10 +327,51 @@ void AbstractRunner::InitializeOptimizer()
             );
             optimizer_->SetVerbosityLevel(runtime_settings_->verbosity_level());
             break;
+        case Settings::Optimizer::OptimizerType::LBFGSB:
+            if (VERB_RUN >= 1) Printer::ext_info("Using LBFGSB optimization algorithm.", "Runner", "AbstractRunner");
+            optimizer_ = new Optimization::Optimizers::LBFGSB(settings_->optimizer(),
+                                                             base_case_,
+                                                             model_->variables(),
+                                                             model_->grid(),
+                                                             logger_
+            );
+            optimizer_->SetVerbosityLevel(runtime_settings_->verbosity_level());
+            break;
         default:
             throw std::runtime_error("Unable to initialize runner: optimization algorithm set in driver file not recognized.");
     }
     optimizer_->EnableConstraintLogging(QString::fromStdString(runtime_settings_->paths().GetPath(Paths::OUTPUT_DIR)));
+    if (!warm_start_cases_.empty())
+        optimizer_->WarmStart(warm_start_cases_);
+}
+
+void AbstractRunner::InitializeWarmStart()
+{
+    if (is_multi_fidelity_run_) {
+        // The logged objective function values do not tell which model they were computed on
+        Printer::ext_warn("Warm start is not supported for multi-fidelity runs. Ignoring.", "Runner", "AbstractRunner");
+        return;
+    }
+    RunLogReader reader(runtime_settings_->warm_start());
+    warm_start_cases_ = reader.Cases(model_->variables());
+    if (VERB_RUN >= 1) Printer::ext_info("Read " + Printer::num2str(warm_start_cases_.size()) + " of "
+                                             + Printer::num2str(reader.NumberRecords()) + " logged cases for warm start.",
+                                         "Runner", "AbstractRunner");
+
+    bool maximize = settings_->optimizer()->mode() == Settings::Optimizer::OptimizerMode::Maximize;
+    Optimization::Case *best = base_case_;
+    for (auto c : warm_start_cases_) {
+        if (maximize ? c->objective_function_value() > best->objective_function_value()
+                     : c->objective_function_value() < best->objective_function_value())
+            best = c;
+    }
+    if (best != base_case_) {
+        warm_start_cases_.removeOne(best);
+        base_case_ = best;
+        if (VERB_RUN >= 1) Printer::ext_info("Starting from the best previous case. Objective function value: "
+                                                 + Printer::num2str(base_case_->objective_function_value()),
+                                             "Runner", "AbstractRunner");
+    }
 }
 
 void AbstractRunner::InitializeBookkeeper()
@@ -295,6 +380,20 @@ void AbstractRunner::InitializeBookkeeper()
         throw std::runtime_error("The Settings and the Optimizer must be initialized before the Bookkeeper.");
 
     bookkeeper_ = new Bookkeeper(settings_, optimizer_->case_handler());
+
+    if (!runtime_settings_->evaluation_store().empty()) {
+        // Key the store by everything the objective function value depends on besides the variables
+        uint64_t model_key = EvaluationStore::HashBytes(settings_->EvaluationFingerprint());
+        for (Paths::Path path : {Paths::SIM_DRIVER_FILE, Paths::GRID_FILE, Paths::SIM_SCH_FILE, Paths::SIM_SCH_INSET_FILE}) {
+            if (runtime_settings_->paths().IsSet(path) && FileExists(runtime_settings_->paths().GetPath(path)))
+                model_key = EvaluationStore::HashFile(runtime_settings_->paths().GetPath(path), model_key);
+        }
+        double quantum = settings_->bookkeeper_tolerance() > 0 ? settings_->bookkeeper_tolerance() : 1e-6;
+        evaluation_store_ = new EvaluationStore(runtime_settings_->evaluation_store(), model_key, quantum);
+        bookkeeper_->SetEvaluationStore(evaluation_store_, model_->variables());
+        if (VERB_RUN >= 1) Printer::ext_info("Using evaluation store with " + Printer::num2str(evaluation_store_->Size())
+                                                 + " stored evaluations.", "Runner", "AbstractRunner");
+    }
 }
 
 void AbstractRunner::InitializeLogger(QString output_subdir, bool write_logs)
@@ -333,6 +432,10 @@ void AbstractRunner::PrintCompletionMessage() const {
     }
 }
 
+int AbstractRunner::simulationThreads(Optimization::Case *c) const {
+    return c->GetSimThreads() > 0 ? c->GetSimThreads() : runtime_settings_->threads_per_sim();
+}
+
 int AbstractRunner::timeoutValue() const {
     if (simulation_times_.size() == 0 || runtime_settings_->simulation_timeout() == 0)
         return 10000;
@@ -341,6 +444,19 @@ int AbstractRunner::timeoutValue() const {
     }
 }
 
+bool AbstractRunner::evaluateFidelity(Optimization::Case *c, Optimization::Case::Fidelity fidelity) {
+    auto fidelity_model = fidelity_helper_.GetModel(fidelity);
+    model_->set_grid_path(fidelity_model.grid());
+    model_->ApplyCase(c);
+    bool success = simulator_->Evaluate(fidelity_model, timeoutValue(), simulationThreads(c));
+    if (success) {
+        model_->wellCost(settings_->optimizer());
+        c->SetFidelityOfv(fidelity, objective_function_->value());
+        c->set_objective_function_value(c->GetFidelityOfv(fidelity));
+    }
+    return success;
+}
+
 void AbstractRunner::FinalizeInitialization(bool write_logs) {
     if (write_logs) {
         logger_->AddEntry(runtime_settings_);
@@ -350,13 +466,23 @@ void AbstractRunner::FinalizeInitialization(bool write_logs) {
 
 void AbstractRunner::FinalizeRun(bool write_logs) {
     if (optimizer_ != 0) { // This indicates whether or not we're on a worker process
+        if (is_multi_fidelity_run_) { // Write the best case to the fine deck
+            model_->set_grid_path(fidelity_helper_.GetModel(Optimization::Case::FINE).grid());
+            simulator_->SelectRealization(fidelity_helper_.GetModel(Optimization::Case::FINE));
+            if (VERB_RUN >= 1) Printer::ext_info(fidelity_helper_.GetStateString(), "Runner", "AbstractRunner");
+        }
         model_->ApplyCase(optimizer_->GetTentativeBestCase());
         simulator_->WriteDriverFilesOnly();
         PrintCompletionMessage();
+        if (evaluation_store_ != 0 && VERB_RUN >= 1)
+            Printer::ext_info(Printer::num2str(evaluation_store_->NumberHits()) + " cases found in the evaluation store.",
+                              "Runner", "AbstractRunner");
     }
     model_->Finalize();
+    logger_->Flush();
     if (write_logs)
         logger_->FinalizePostrunSummary();
+    Tracing::Tracer::Instance().Flush();
 }
 
 }
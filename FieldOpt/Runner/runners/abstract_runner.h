@@ -34,8 +34,10 @@
 #include "Simulation/simulator_interfaces/simulator.h"
 #include "Settings/settings.h"
 #include "bookkeeper.h"
+#include "run_log_reader.h"
 #include "Runner/logger.h"
 #include "ensemble_helper.h"
+#include "fidelity_helper.h"
 #include <vector>
 #include "Optimization/objective/NPV.h"
 
@@ -68,6 +70,7 @@ class AbstractRunner
   AbstractRunner(RuntimeSettings *runtime_settings);
 
   Bookkeeper *bookkeeper_;
+  EvaluationStore *evaluation_store_; //!< Evaluations shared between runs. Null if not used.
   Model::Model *model_;
   Settings::Settings *settings_;
   RuntimeSettings *runtime_settings_;
@@ -77,8 +80,11 @@ class AbstractRunner
   Simulation::Simulator *simulator_;
   Logger *logger_;
   std::vector<int> simulation_times_;
+  QList<Optimization::Case *> warm_start_cases_; //!< Cases evaluated in a previous run (see --warm-start).
   bool is_ensemble_run_;
   EnsembleHelper ensemble_helper_;
+  bool is_multi_fidelity_run_;
+  FidelityHelper fidelity_helper_;
 
   void PrintCompletionMessage() const;
 
@@ -101,13 +107,51 @@ class AbstractRunner
    */
   int timeoutValue() const;
 
+  /*!
+   * @brief Get the number of threads to simulate a case with: the number set for the case
+   * by the overseer if dynamic threads are enabled, otherwise the threads-per-simulation setting.
+   */
+  int simulationThreads(Optimization::Case *c) const;
+
+  /*!
+   * @brief Get the number of cases the runner is able to evaluate concurrently. This is passed
+   * on to the optimizer, so that population based algorithms can match their population
+   * size to it.
+   */
+  virtual int parallelEvaluations() const { return 1; }
+
+  /*!
+   * @brief Evaluate a case on one of the models in a multi-fidelity run.
+   *
+   * The grid used to compute well indices is switched to the one belonging to the model
+   * before the case is applied, and the simulation is run on the model's deck. If the
+   * simulation succeeds, the objective function value is stored for the fidelity and
+   * set as the case's objective function value.
+   * @return True if the simulation was successful.
+   */
+  bool evaluateFidelity(Optimization::Case *c, Optimization::Case::Fidelity fidelity);
+
   void InitializeSettings(QString output_subdirectory="");
+
+  /*!
+   * @brief Start recording a trace if the --trace flag was given. Must be called after
+   * InitializeSettings. The trace is written to trace.json in the output directory by FinalizeRun.
+   * @param pid Process id to write in the trace (the MPI rank).
+   */
+  void InitializeTracing(int pid=0);
   void InitializeModel();
   void InitializeSimulator();
   void EvaluateBaseModel();
   void InitializeObjectiveFunction();
   void InitializeBaseCase();
   void InitializeOptimizer();
+
+  /*!
+   * @brief Read the evaluated cases of the previous run given by the --warm-start option.
+   * If the best of them is better than the base case, it replaces the base case, so that
+   * the optimizer starts from it. The rest are passed to the optimizer by InitializeOptimizer.
+   */
+  void InitializeWarmStart();
   void InitializeBookkeeper();
   void FinalizeInitialization(bool write_logs); //!< Write the pre-run summary
   void FinalizeRun(bool write_logs); //!< Finalize the run, writing data to the summary log.
@@ -0,0 +1,76 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "core_allocator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Runner {
+
+CoreAllocator::CoreAllocator(int max_threads) {
+    max_threads_ = max_threads;
+}
+
+void CoreAllocator::AddWorker(int rank, const std::string &node, int cores) {
+    workers_[rank] = WorkerState{node, 0};
+    node_cores_[node] = std::max(node_cores_[node], std::max(1, cores));
+}
+
+int CoreAllocator::Allocate(int rank, int waiting) {
+    if (workers_.count(rank) == 0)
+        throw std::runtime_error("Unable to allocate threads: unknown worker.");
+    WorkerState &worker = workers_[rank];
+    if (worker.threads > 0)
+        Release(rank);
+    int free_cores = Cores(worker.node) - ThreadsInUse(worker.node);
+    // The worker has been released, so it is one of the free workers, and waiting includes its case
+    int starting = std::max(1, std::min(waiting, freeWorkers(worker.node)));
+    int threads = std::max(1, free_cores / starting);
+    if (max_threads_ > 0)
+        threads = std::min(threads, max_threads_);
+    worker.threads = threads;
+    return threads;
+}
+
+void CoreAllocator::Release(int rank) {
+    if (workers_.count(rank) > 0)
+        workers_[rank].threads = 0;
+}
+
+int CoreAllocator::ThreadsInUse(const std::string &node) const {
+    int threads = 0;
+    for (auto const &w : workers_) {
+        if (w.second.node == node)
+            threads += w.second.threads;
+    }
+    return threads;
+}
+
+int CoreAllocator::Cores(const std::string &node) const {
+    auto it = node_cores_.find(node);
+    return it != node_cores_.end() ? it->second : 0;
+}
+
+int CoreAllocator::freeWorkers(const std::string &node) const {
+    int n = 0;
+    for (auto const &w : workers_) {
+        if (w.second.node == node && w.second.threads == 0)
+            n++;
+    }
+    return n;
+}
+
+}
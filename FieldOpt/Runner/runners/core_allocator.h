@@ -0,0 +1,88 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_CORE_ALLOCATOR_H
+#define FIELDOPT_CORE_ALLOCATOR_H
+
+#include <map>
+#include <string>
+
+namespace Runner {
+
+/*!
+ * @brief The CoreAllocator class decides how many threads each simulation may use, so that
+ * the cores of each node are shared between the simulations running on it.
+ *
+ * When a case is handed to a worker, the free cores on the worker's node are divided
+ * evenly between the cases that are expected to start on the node now: the number of
+ * cases waiting for a worker, but at most the number of free workers on the node. At the
+ * start of an iteration this gives each simulation its share of the node; at the tail of
+ * an iteration, when a single case is left, it gets all the cores that are free.
+ *
+ * The threads are held until Release() is called for the worker. Threads are only assigned
+ * when a simulation starts: the threads of running simulations are not changed when other
+ * simulations on the node finish, and the cores they free are only used by the simulations
+ * started after that. The number of waiting cases is the length of the global queue, so
+ * when several nodes have free workers, each of them assumes it will start all the waiting
+ * cases it has room for.
+ */
+class CoreAllocator {
+ public:
+  /*!
+   * @param max_threads Maximum number of threads to give one simulation (0: no limit).
+   */
+  CoreAllocator(int max_threads=0);
+
+  /*!
+   * @brief Add a worker.
+   * @param rank Rank of the worker.
+   * @param node Name of the node the worker runs on.
+   * @param cores Number of cores on the node. The largest value given for a node is used.
+   */
+  void AddWorker(int rank, const std::string &node, int cores);
+
+  /*!
+   * @brief Get the number of threads for a simulation started by a worker, and mark the
+   * worker as running.
+   * @param rank Rank of the worker.
+   * @param waiting Number of cases waiting for a worker, including this one.
+   */
+  int Allocate(int rank, int waiting);
+
+  /*!
+   * @brief Return the threads held by a worker.
+   */
+  void Release(int rank);
+
+  int ThreadsInUse(const std::string &node) const; //!< Number of threads held by the workers on a node.
+  int Cores(const std::string &node) const; //!< Number of cores on a node.
+
+ private:
+  struct WorkerState {
+    std::string node;
+    int threads; //!< Threads held by the worker; 0 if it is not running.
+  };
+
+  int max_threads_;
+  std::map<std::string, int> node_cores_;
+  std::map<int, WorkerState> workers_;
+
+  int freeWorkers(const std::string &node) const;
+};
+
+}
+
+#endif //FIELDOPT_CORE_ALLOCATOR_H
@@ -25,6 +25,10 @@
 #include "Utilities/random.hpp"
 #include "Utilities/verbosity.h"
 #include "Utilities/printer.hpp"
+#include "Utilities/math.hpp"
+#include <boost/math/distributions/students_t.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace Runner {
 
@@ -32,10 +36,24 @@ EnsembleHelper::EnsembleHelper() {
     current_case_ = 0;
     rzn_queue_ = std::vector<std::string>();
     rzn_busy_ = std::vector<std::string>();
+    incumbent_ = nullptr;
+    maximize_ = true;
+    is_rejected_ = false;
+    n_rejected_ = 0;
+    n_skipped_ = 0;
+    n_dispatched_ = 0;
+    n_warm_dispatched_ = 0;
+    n_warm_timed_ = 0;
+    n_cold_timed_ = 0;
+    warm_seconds_ = 0.0;
+    cold_seconds_ = 0.0;
 }
 
-EnsembleHelper::EnsembleHelper(const Settings::Ensemble &ensemble, int rng_seed) {
+EnsembleHelper::EnsembleHelper(const Settings::Ensemble &ensemble, int rng_seed, bool maximize)
+    : EnsembleHelper()
+{
     ensemble_ = ensemble;
+    maximize_ = maximize;
     current_case_ = 0;
     rzn_queue_ = std::vector<std::string>();
     rzn_busy_ = std::vector<std::string>();
@@ -47,14 +65,23 @@ EnsembleHelper::EnsembleHelper(const Settings::Ensemble &ensemble, int rng_seed)
 
     assert(n_select_ <= ensemble.GetAliases().size());
 }
-void EnsembleHelper::SetActiveCase(Optimization::Case *c) {
+void EnsembleHelper::SetActiveCase(Optimization::Case *c, Optimization::Case *incumbent) {
     if (!IsCaseDone()) {
         std::cerr << "ERROR: Unable to set new active case before the previous case is done." << std::endl;
         throw std::runtime_error("Error in EnsembleHelper.");
     }
 
     current_case_ = c;
+    incumbent_ = incumbent;
+    is_rejected_ = false;
     selectRealizations();
+    if (ensemble_.IsRacing() && incumbent_ != nullptr) {
+        // The queue is consumed from the back, so move realizations the incumbent has values for there
+        auto incumbent_ofvs = incumbent_->GetRealizationOFVMap();
+        std::stable_partition(rzn_queue_.begin(), rzn_queue_.end(), [&](const std::string &alias) {
+          return !incumbent_ofvs.contains(QString::fromStdString(alias));
+        });
+    }
     eval_start_time_ = std::chrono::high_resolution_clock::now();
 }
 bool EnsembleHelper::IsCaseDone() const {
@@ -72,7 +99,7 @@ Optimization::Case *EnsembleHelper::GetCaseForEval() {
     std::string next_alias = rzn_queue_.back();
     rzn_queue_.pop_back();
     rzn_busy_.push_back(next_alias);
-    case_copy->SetEnsembleRealization(QString::fromStdString(next_alias));// TODO: This is a duplicate case that wont get deleted, i.e. a MEMORY LEAK.
+    case_copy->SetEnsembleRealization(QString::fromStdString(next_alias));
     return case_copy;
 }
 void EnsembleHelper::SubmitEvaluatedRealization(Optimization::Case *c) {
@@ -93,6 +120,35 @@ void EnsembleHelper::SubmitEvaluatedRealization(Optimization::Case *c) {
                   << std::endl;
     }
     rzn_busy_.erase(rzn_busy_.begin() + alias_pos);
+
+    auto dispatch = in_flight_.find(c->GetEnsembleRealization().toStdString());
+    if (dispatch != in_flight_.end()) {
+        if (c->state.eval == Optimization::Case::CaseState::E_DONE) {
+            double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()
+                                                               - dispatch->second.start).count();
+            if (dispatch->second.warm) {
+                n_warm_timed_++;
+                warm_seconds_ += seconds;
+            }
+            else {
+                n_cold_timed_++;
+                cold_seconds_ += seconds;
+            }
+        }
+        in_flight_.erase(dispatch);
+    }
+
+    if (ensemble_.IsRacing() && !is_rejected_ && !rzn_queue_.empty() && isRacingLoser(racing_estimate_)) {
+        if (VERB_RUN >= 2) {
+            Printer::ext_info("Case rejected by racing after " + Printer::num2str(current_case_->GetRealizationOFVMap().size())
+                                  + " realizations. Skipping " + Printer::num2str((int)rzn_queue_.size()) + " realizations.",
+                              "Runner", "EnsembleHelper");
+        }
+        is_rejected_ = true;
+        n_rejected_++;
+        n_skipped_ += rzn_queue_.size();
+        rzn_queue_.clear();
+    }
 }
 Optimization::Case *EnsembleHelper::GetEvaluatedCase() {
     if (!IsCaseDone()) {
@@ -101,13 +157,39 @@ Optimization::Case *EnsembleHelper::GetEvaluatedCase() {
     }
     rzn_queue_ = std::vector<std::string>();
     rzn_busy_ = std::vector<std::string>();
-    current_case_->set_objective_function_value(current_case_->GetEnsembleAverageOfv());
+    if (is_rejected_) {
+        current_case_->set_objective_function_value(racing_estimate_);
+    }
+    else {
+        current_case_->set_objective_function_value(current_case_->GetEnsembleAverageOfv());
+    }
     auto eval_end_time = std::chrono::high_resolution_clock::now();
     auto time_diff = std::chrono::duration_cast<std::chrono::milliseconds>(eval_end_time - eval_start_time_);
     current_case_->SetSimTime(time_diff.count() / 1000);
     current_case_->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
     return current_case_;
 }
+bool EnsembleHelper::isRacingLoser(double &estimate) const {
+    if (incumbent_ == nullptr)
+        return false;
+    auto incumbent_ofvs = incumbent_->GetRealizationOFVMap();
+    auto ofvs = current_case_->GetRealizationOFVMap();
+    std::vector<double> differences;
+    for (auto alias : ofvs.keys()) {
+        if (incumbent_ofvs.contains(alias))
+            differences.push_back(ofvs[alias] - incumbent_ofvs[alias]);
+    }
+    if (differences.size() < ensemble_.RacingMinRealizations())
+        return false;
+
+    double mean = calc_average(differences);
+    boost::math::students_t t_dist(differences.size() - 1);
+    double half_width = boost::math::quantile(t_dist, ensemble_.RacingConfidence())
+        * calc_standard_deviation(differences) / std::sqrt(differences.size());
+    estimate = incumbent_->objective_function_value() + mean;
+    return maximize_ ? mean + half_width < 0 : mean - half_width > 0;
+}
+
 void EnsembleHelper::selectRealizations() {
     auto all_aliases = ensemble_.GetAliases();
 
@@ -148,6 +230,14 @@ std::string EnsembleHelper::GetStateString() const {
         str << "Current case done: " << (IsCaseDone() ? "Yes" : "No") << std::endl;
         str << "                N. Queued Cases: " << NQueuedCases();
         str << "                N. Busy Cases:   " << NBusyCases();
+        if (ensemble_.IsRacing()) {
+            str << "                N. Rejected Cases: " << NRejectedCases();
+            str << "                N. Skipped Realizations: " << NSkippedRealizations();
+        }
+        if (NDispatches() > 0) {
+            str << "                N. Warm Dispatches: " << NWarmDispatches() << "/" << NDispatches();
+            str << "                Cold Start Cost: " << ColdStartCost() << "s";
+        }
     }
     return str.str();
 }
@@ -159,6 +249,7 @@ bool EnsembleHelper::HasAssignedWorkers(const std::string &alias) const {
 int EnsembleHelper::GetAssignedWorker(const std::string &alias, std::vector<int> free_workers) {
     for (int rank : free_workers) {
         if (isAssignedToWorker(alias, rank)) {// Check if the realization has been assigned to one of the free workers
+            recordDispatch(alias, rank, true);
             return rank; // If it has, return that rank
         }
     }
@@ -170,10 +261,97 @@ int EnsembleHelper::AssignNewWorker(const std::string &alias, std::vector<int> f
     assert(free_workers.size() > 0);
     auto loads = workerLoads(free_workers);
     int least_loaded_worker = loads.front().first;
-    assigend_workers_[alias].push_back(least_loaded_worker);
+    recordDispatch(alias, least_loaded_worker, false);
     return least_loaded_worker;
 }
 
+bool EnsembleHelper::ScheduleNextRealization(const std::vector<int> &free_workers) {
+    double cold_start_cost = ColdStartCost();
+    int cold_candidate = -1;
+    // The queue is consumed from the back, so search from there to keep the selection order
+    for (int i = rzn_queue_.size() - 1; i >= 0; --i) {
+        const std::string &alias = rzn_queue_[i];
+        bool worth_waiting = false;
+        for (int rank : assigend_workers_.at(alias)) {
+            if (std::find(free_workers.begin(), free_workers.end(), rank) != free_workers.end()) {
+                std::rotate(rzn_queue_.begin() + i, rzn_queue_.begin() + i + 1, rzn_queue_.end());
+                return true;
+            }
+            double remaining = expectedRemainingTime(rank);
+            if (remaining >= 0 && remaining < cold_start_cost) {
+                worth_waiting = true;
+            }
+        }
+        if (cold_candidate < 0 && !worth_waiting) {
+            cold_candidate = i;
+        }
+    }
+    if (cold_candidate < 0) {
+        if (VERB_RUN >= 2) {
+            Printer::ext_info("All queued realizations are waiting for a busy warm worker.", "Runner", "EnsembleHelper");
+        }
+        return false;
+    }
+    std::rotate(rzn_queue_.begin() + cold_candidate, rzn_queue_.begin() + cold_candidate + 1, rzn_queue_.end());
+    return true;
+}
+
+double EnsembleHelper::ColdStartCost() const {
+    if (n_warm_timed_ == 0 || n_cold_timed_ == 0) {
+        return 0.0;
+    }
+    return std::max(0.0, cold_seconds_ / n_cold_timed_ - warm_seconds_ / n_warm_timed_);
+}
+
+void EnsembleHelper::recordDispatch(const std::string &alias, const int rank, const bool warm) {
+    auto &cache = worker_cache_[rank];
+    auto cached = std::find(cache.begin(), cache.end(), alias);
+    if (cached != cache.end()) {
+        cache.erase(cached);
+    }
+    else {
+        assigend_workers_[alias].push_back(rank);
+    }
+    cache.push_front(alias);
+
+    // The worker always keeps the base grid, leaving room for one realization less
+    if (ensemble_.MaxCachedGrids() > 0) {
+        while (cache.size() > ensemble_.MaxCachedGrids() - 1) {
+            auto &workers = assigend_workers_[cache.back()];
+            workers.erase(std::remove(workers.begin(), workers.end(), rank), workers.end());
+            cache.pop_back();
+        }
+    }
+
+    in_flight_[alias] = Dispatch{rank, warm, std::chrono::high_resolution_clock::now()};
+    n_dispatched_++;
+    if (warm) {
+        n_warm_dispatched_++;
+    }
+}
+
+double EnsembleHelper::expectedRemainingTime(const int rank) const {
+    for (auto const &dispatch : in_flight_) {
+        if (dispatch.second.rank != rank) {
+            continue;
+        }
+        double expected;
+        if (dispatch.second.warm && n_warm_timed_ > 0) {
+            expected = warm_seconds_ / n_warm_timed_;
+        }
+        else if (!dispatch.second.warm && n_cold_timed_ > 0) {
+            expected = cold_seconds_ / n_cold_timed_;
+        }
+        else {
+            return -1.0;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()
+                                                           - dispatch.second.start).count();
+        return std::max(0.0, expected - elapsed);
+    }
+    return 0.0;
+}
+
 bool EnsembleHelper::isAssignedToWorker(const std::string &alias, const int rank) const {
     auto workers = assigend_workers_.at(alias);
     if (std::find(workers.begin(), workers.end(), rank) != workers.end()) {
@@ -27,6 +27,7 @@
 #include "Settings/ensemble.h"
 #include "Optimization/case.h"
 #include <chrono>
+#include <list>
 
 namespace Runner {
 
@@ -38,15 +39,22 @@ class EnsembleHelper {
 
  public:
   EnsembleHelper();
-  EnsembleHelper(const Settings::Ensemble &ensemble, int rng_seed=0);
+  EnsembleHelper(const Settings::Ensemble &ensemble, int rng_seed=0, bool maximize=true);
 
   /*!
    * Set a new active case and populate the realization queue
    * for it. You will not be able to set a new active case
    * until all the realizations selected for this one have been
    * evaluated.
+   *
+   * When racing is enabled, the case is compared to the incumbent
+   * as realizations are evaluated. The realizations the incumbent
+   * has been evaluated on are dispatched first, so that the
+   * comparison can be made on paired values.
+   * @param c The case to evaluate.
+   * @param incumbent The current best case. Racing is skipped if this is null or has no realization values.
    */
-  void SetActiveCase(Optimization::Case *c);
+  void SetActiveCase(Optimization::Case *c, Optimization::Case *incumbent=nullptr);
 
   /*!
    * Check whether all the realizations selected for the currently
@@ -76,7 +84,8 @@ class EnsembleHelper {
 
   /*!
    * Get a copy of the currently active case, with the realization
-   * tag properly set.
+   * tag properly set. The caller takes ownership of the copy; it
+   * may be deleted once it has been submitted or sent to a worker.
    */
   Optimization::Case *GetCaseForEval();
 
@@ -90,10 +99,17 @@ class EnsembleHelper {
   /*!
    * Get a case that has had all the selected realizations evaluated.
    * This case will have a filled realization-ofv map.
+   *
+   * If the case was rejected by racing, the map only holds the
+   * realizations that were evaluated, and the objective function
+   * value is the incumbent's value plus the mean paired difference.
    * @return
    */
   Optimization::Case *GetEvaluatedCase();
 
+  int NRejectedCases() const { return n_rejected_; } //!< Number of cases rejected by racing.
+  int NSkippedRealizations() const { return n_skipped_; } //!< Number of realization evaluations saved by racing.
+
   /*!
    * Get the realization object refereincing the alias string.
    */
@@ -132,6 +148,30 @@ class EnsembleHelper {
    */
   int AssignNewWorker(const std::string &alias, std::vector<int> free_workers);
 
+  /*!
+   * @brief Move the queued realization that should be dispatched next to the head of
+   * the queue, so that it is returned by the next call to GetCaseForEval.
+   *
+   * A worker is considered warm for a realization if it has recently evaluated it, i.e.
+   * if the realization's grid is still in the worker's cache (see Ensemble::MaxCachedGrids;
+   * the workers' LRU caches are mirrored here). Realizations that are warm on one of the
+   * free workers are preferred. Otherwise, a realization is only dispatched cold if none
+   * of the busy workers it is warm on is expected to finish within the cold-start cost.
+   * @param free_workers Vector of ranks for the workers that are currently not working.
+   * @return False if all queued realizations should wait for a busy warm worker.
+   */
+  bool ScheduleNextRealization(const std::vector<int> &free_workers);
+
+  /*!
+   * @brief Estimated extra time (in seconds) needed to evaluate a realization on a cold
+   * worker, i.e. the mean cold evaluation time minus the mean warm evaluation time.
+   * Zero until both warm and cold evaluations have been observed.
+   */
+  double ColdStartCost() const;
+
+  int NWarmDispatches() const { return n_warm_dispatched_; } //!< Number of realizations sent to a warm worker.
+  int NDispatches() const { return n_dispatched_; } //!< Number of realizations sent to a worker.
+
  private:
 
   /*!
@@ -140,6 +180,15 @@ class EnsembleHelper {
    */
   void selectRealizations();
 
+  /*!
+   * @brief Check whether the active case is worse than the incumbent, using a one-sided
+   * paired t-test on the realizations evaluated for both.
+   * @param estimate Set to the estimated ensemble objective function value of the active case.
+   * @return True if the upper (lower, when minimizing) confidence bound of the difference
+   * between the active case and the incumbent shows that the case is worse.
+   */
+  bool isRacingLoser(double &estimate) const;
+
   /*!
    * @brief Get the number of realizations that have been assigned to a worker.
    * @param rank Rank of the worker to check.
@@ -155,6 +204,18 @@ class EnsembleHelper {
    */
   bool isAssignedToWorker(const std::string &alias, const int rank) const;
 
+  /*!
+   * @brief Record that a realization has been sent to a worker, and mark it as
+   * the most recently used realization in the worker's cache.
+   */
+  void recordDispatch(const std::string &alias, const int rank, const bool warm);
+
+  /*!
+   * @brief Get the expected number of seconds until a busy worker finishes.
+   * @return 0 if the worker is not busy; a negative number if no timings are available yet.
+   */
+  double expectedRemainingTime(const int rank) const;
+
   /*!
    * @brief Get a sorted vector of pairs <rank, assigned realizations>.
    * @param free_workers Vector of ranks for the workers that are currently not working.
@@ -198,10 +259,37 @@ class EnsembleHelper {
   std::chrono::high_resolution_clock::time_point eval_start_time_;
 
   /*!
-   * Mapping of realizations to one or more worker ranks.
+   * Mapping of realizations to one or more worker ranks. A realization is only
+   * assigned to a worker as long as it is in the worker's cache.
    */
   std::map<std::string, std::vector<int> > assigend_workers_;
 
+  /*!
+   * Realizations assumed to be cached on each worker, most recently used first.
+   */
+  std::map<int, std::list<std::string> > worker_cache_;
+
+  struct Dispatch {
+    int rank;
+    bool warm;
+    std::chrono::high_resolution_clock::time_point start;
+  };
+  std::map<std::string, Dispatch> in_flight_; //!< Realizations currently being evaluated by a worker.
+
+  int n_dispatched_;
+  int n_warm_dispatched_;
+  int n_warm_timed_; //!< Number of timed evaluations on warm workers.
+  int n_cold_timed_; //!< Number of timed evaluations on cold workers.
+  double warm_seconds_; //!< Total time spent in evaluations on warm workers.
+  double cold_seconds_; //!< Total time spent in evaluations on cold workers.
+
+  Optimization::Case *incumbent_; //!< The best case when the active case was set. Used when racing.
+  bool maximize_;
+  bool is_rejected_; //!< Whether the active case has been rejected by racing.
+  double racing_estimate_; //!< Estimated objective function value for a rejected case.
+  int n_rejected_;
+  int n_skipped_;
+
 };
 
 }
@@ -0,0 +1,93 @@
+#include <cmath>
+#include "fidelity_helper.h"
+#include "Utilities/verbosity.h"
+#include "Utilities/printer.hpp"
+
+namespace Runner {
+
+using Optimization::Case;
+
+FidelityHelper::FidelityHelper() {
+    margin_ = 0.0;
+    maximize_ = true;
+    n_coarse_ = 0;
+    n_promoted_ = 0;
+}
+
+FidelityHelper::FidelityHelper(Settings::Settings *settings)
+    : FidelityHelper()
+{
+    fine_data_ = settings->paths().GetPath(Paths::SIM_DRIVER_FILE);
+    fine_schedule_ = settings->paths().GetPath(Paths::SIM_SCH_FILE);
+    fine_grid_ = settings->paths().GetPath(Paths::GRID_FILE);
+
+    auto coarse = settings->simulator()->coarse_model();
+    coarse_data_ = coarse.data();
+    coarse_schedule_ = coarse.schedule();
+    coarse_grid_ = coarse.grid();
+
+    margin_ = settings->simulator()->promotion_margin();
+    maximize_ = settings->optimizer()->mode() == Settings::Optimizer::OptimizerMode::Maximize;
+}
+
+FidelityHelper::FidelityHelper(double margin, bool maximize)
+    : FidelityHelper()
+{
+    margin_ = margin;
+    maximize_ = maximize;
+}
+
+Settings::Ensemble::Realization FidelityHelper::GetModel(const Case::Fidelity fidelity) const {
+    if (fidelity == Case::COARSE)
+        return Settings::Ensemble::Realization("coarse", coarse_data_, coarse_schedule_, coarse_grid_);
+    else
+        return Settings::Ensemble::Realization("fine", fine_data_, fine_schedule_, fine_grid_);
+}
+
+bool FidelityHelper::Promote(Case *c, Case *incumbent) {
+    n_coarse_++;
+    if (!incumbent->HasFidelityOfv(Case::COARSE) || !incumbent->HasFidelityOfv(Case::FINE)) {
+        n_promoted_++;
+        return true;
+    }
+    double coarse = c->GetFidelityOfv(Case::COARSE);
+    double incumbent_coarse = incumbent->GetFidelityOfv(Case::COARSE);
+    double incumbent_fine = incumbent->GetFidelityOfv(Case::FINE);
+    double margin = margin_ * std::abs(incumbent_coarse);
+
+    bool promote = maximize_ ? coarse >= incumbent_coarse - margin
+                             : coarse <= incumbent_coarse + margin;
+    if (promote) {
+        n_promoted_++;
+    }
+    else {
+        c->set_objective_function_value(coarse + incumbent_fine - incumbent_coarse);
+    }
+    if (VERB_RUN >= 2) {
+        Printer::ext_info((promote ? "Promoted" : "Did not promote") + std::string(" case with coarse value ")
+                              + Printer::num2str(coarse) + " (incumbent: " + Printer::num2str(incumbent_coarse) + "). "
+                              + GetStateString(), "Runner", "FidelityHelper");
+    }
+    return promote;
+}
+
+void FidelityHelper::QueuePromotedCase(Case *c) {
+    c->SetFidelity(Case::FINE);
+    promoted_queue_.push_back(c);
+}
+
+Case *FidelityHelper::GetPromotedCase() {
+    if (!HasPromotedCases()) {
+        throw std::runtime_error("No promoted cases are waiting for evaluation.");
+    }
+    Case *c = promoted_queue_.front();
+    promoted_queue_.pop_front();
+    return c;
+}
+
+std::string FidelityHelper::GetStateString() const {
+    return "Promoted " + Printer::num2str(n_promoted_) + " of " + Printer::num2str(n_coarse_)
+        + " coarse evaluations; " + Printer::num2str((int)promoted_queue_.size()) + " waiting for fine evaluation.";
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef FIELDOPT_FIDELITY_HELPER_H
+#define FIELDOPT_FIDELITY_HELPER_H
+
+#include <deque>
+#include "Settings/settings.h"
+#include "Settings/simulator.h"
+#include "Settings/optimizer.h"
+#include "Settings/ensemble.h"
+#include "Optimization/case.h"
+
+namespace Runner {
+
+/*!
+ * The FidelityHelper class contains facilities that help the Runner
+ * classes deal with multi-fidelity runs.
+ *
+ * In a multi-fidelity run every case is first evaluated on a coarse
+ * (e.g. upscaled) model. Only cases whose coarse objective function
+ * value lies within the promotion margin of the incumbent's coarse
+ * value are promoted to, and evaluated on, the fine model. Cases that
+ * are not promoted are given a bias-corrected coarse value, i.e. the
+ * coarse value shifted by the difference between the incumbent's fine
+ * and coarse values. Such a case can thus never become the new incumbent.
+ *
+ * The incumbent (the optimizer's tentative best case) must have been
+ * evaluated on both models; this is ensured by evaluating the base case
+ * on both models during initialization.
+ */
+class FidelityHelper {
+
+ public:
+  FidelityHelper();
+  FidelityHelper(Settings::Settings *settings);
+
+  /*!
+   * @param margin Promotion margin, relative to the incumbent's coarse value.
+   * @param maximize Whether the objective function is maximized.
+   */
+  FidelityHelper(double margin, bool maximize);
+
+  /*!
+   * Get the model (deck, schedule and grid paths) for a fidelity level.
+   */
+  Settings::Ensemble::Realization GetModel(const Optimization::Case::Fidelity fidelity) const;
+
+  /*!
+   * @brief Decide whether a case that has been evaluated on the coarse model
+   * should be promoted to the fine model.
+   *
+   * If the case is not promoted, its objective function value is set to the
+   * bias-corrected coarse value.
+   * @param c Case with the coarse objective function value set.
+   * @param incumbent The current best case.
+   * @return True if the case should be evaluated on the fine model.
+   */
+  bool Promote(Optimization::Case *c, Optimization::Case *incumbent);
+
+  /*!
+   * Add a promoted case to the queue of cases waiting for a fine evaluation.
+   * The fidelity of the case is set to FINE. Ownership of the case is not
+   * transferred; it is handed back by GetPromotedCase().
+   */
+  void QueuePromotedCase(Optimization::Case *c);
+
+  /*!
+   * Check whether any promoted cases are waiting for a fine evaluation.
+   */
+  bool HasPromotedCases() const { return !promoted_queue_.empty(); }
+
+  /*!
+   * Get the next promoted case waiting for a fine evaluation.
+   */
+  Optimization::Case *GetPromotedCase();
+
+  int NCoarseEvaluations() const { return n_coarse_; } //!< Number of cases a promotion has been decided for.
+  int NPromoted() const { return n_promoted_; } //!< Number of cases promoted to the fine model.
+
+  /*!
+   * Get a string describing the state of the FidelityHelper.
+   */
+  std::string GetStateString() const;
+
+ private:
+  std::string fine_data_;
+  std::string fine_schedule_;
+  std::string fine_grid_;
+  std::string coarse_data_;
+  std::string coarse_schedule_;
+  std::string coarse_grid_;
+  double margin_; //!< Promotion margin, relative to the incumbent's coarse value.
+  bool maximize_;
+
+  int n_coarse_;
+  int n_promoted_;
+  std::deque<Optimization::Case *> promoted_queue_; //!< Promoted cases waiting for a fine evaluation.
+};
+
+}
+
+#endif //FIELDOPT_FIDELITY_HELPER_H
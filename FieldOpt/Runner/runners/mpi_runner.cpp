@@ -4,10 +4,15 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/mpi/status.hpp>
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <iostream>
+#include <algorithm>
+#include <thread>
 #include "Utilities/verbosity.h"
 #include "Utilities/printer.hpp"
+#include "Utilities/tracing.hpp"
 
 BOOST_IS_MPI_DATATYPE(boost::uuids::uuid)
 
@@ -17,11 +22,20 @@ namespace MPI {
 MPIRunner::MPIRunner(RuntimeSettings *rts) : AbstractRunner(rts) {
     rank_ = world_.rank();
     simulator_delay_ = rts->simulation_delay();
+    if (rts->dynamic_threads()) { // Let the overseer know which ranks share a node
+        int cores = rts->cores_per_node() > 0 ? rts->cores_per_node() : (int)std::thread::hardware_concurrency();
+        mpi::all_gather(world_, mpi::environment::processor_name(), processor_names_);
+        mpi::all_gather(world_, cores, processor_cores_);
+    }
 }
 
 void MPIRunner::SendMessage(Message &message) {
+    TRACE_SCOPE("SendMessage", "MPI");
     std::string s;
-    if (message.c != nullptr) {
+    if (message.tag == CASE_CANCEL) {
+        s = message.case_id.toString().toStdString();
+    }
+    else if (message.c != nullptr) {
         auto cto = Optimization::CaseTransferObject(message.c);
         std::ostringstream oss;
         boost::archive::text_oarchive oa(oss);
@@ -37,12 +51,14 @@ void MPIRunner::SendMessage(Message &message) {
 }
 
 void MPIRunner::RecvMessage(Message &message) {
+    TRACE_SCOPE("RecvMessage", "MPI");
     Optimization::CaseTransferObject cto;
     std::string s;
     printMessage("Waiting to receive a message with tag " + boost::lexical_cast<std::string>(message.tag)
                      + " (" + tag_to_string[message.tag] + ") "
                      + " from source " + boost::lexical_cast<std::string>(message.source), 2);
-    mpi::status status = world_.recv(message.source, ANY_TAG, s);
+    // Cancellations are polled for separately while simulating, so only receive them when asked for
+    mpi::status status = world_.recv(message.source, message.tag == CASE_CANCEL ? CASE_CANCEL : ANY_TAG, s);
     message.set_status(status);
     message.tag = status.tag();
 
@@ -78,6 +94,11 @@ void MPIRunner::RecvMessage(Message &message) {
     else if (message.tag == CASE_EVAL_TIMEOUT) {
         printMessage("Received a case that was terminated due to timeout.", 2);
     }
+    else if (message.tag == CASE_CANCEL) {
+        printMessage("Received a case cancellation.", 2);
+        message.c = nullptr;
+        message.case_id = QUuid(QString::fromStdString(s));
+    }
     else {
         printMessage("Received message with an unrecognized tag. Throwing exception.");
         throw std::runtime_error("RecvMessage received a message with an unrecognized tag.");
@@ -111,6 +132,13 @@ int MPIRunner::SimulatorDelay() const {
     return simulator_delay_;
 }
 
+int MPIRunner::parallelEvaluations() const {
+    int n_workers = world_.size() - 1;
+    if (runtime_settings_->max_parallel_sims() > 0)
+        n_workers = std::min(n_workers, runtime_settings_->max_parallel_sims());
+    return std::max(1, n_workers);
+}
+
 void MPIRunner::printMessage(std::string message, int min_verb) {
     if (VERB_RUN >= min_verb) {
         std::string time_stamp = QDateTime::currentDateTime().toString("hh:mm").toStdString();
@@ -37,12 +37,13 @@ class MPIRunner : public AbstractRunner {
    * CASE_EVAL_SUCCESS: To be used when sending successfully evaluated cases.
    * CASE_EVAL_INVALID: To be used when sending cases that were some some reason deemed invalid.
    * CASE_EVAL_TIMEOUT: To be used when sending cases whose simulation was terminated by a timeout condition.
+   * CASE_CANCEL: To be sent by the overseer to cancel the simulation of an obsolete case. Carries only the case id.
    * MODEL_SYNC: To be used when sending model synchronization objects.
    * ANY_TAG: This will match any tag.
    * TERMINATE: This tag should be sent by the overseer to terminate a worker.
    */
   enum MsgTag : int {
-    CASE_UNEVAL = 1, CASE_EVAL_SUCCESS = 2, CASE_EVAL_INVALID = 3, CASE_EVAL_TIMEOUT = 4,
+    CASE_UNEVAL = 1, CASE_EVAL_SUCCESS = 2, CASE_EVAL_INVALID = 3, CASE_EVAL_TIMEOUT = 4, CASE_CANCEL = 5,
     MODEL_SYNC = 10, TERMINATE = 100,
     ANY_TAG = MPI_ANY_TAG
   };
@@ -53,6 +54,7 @@ class MPIRunner : public AbstractRunner {
       {2, "successfully evaluated case"},
       {3, "invalid case"},
       {4, "timed out case"},
+      {5, "case cancellation"},
       {10, "model synchronization object"},
       {100, "termination signal"}
   };
@@ -73,11 +75,13 @@ class MPIRunner : public AbstractRunner {
             case 2: return CASE_EVAL_SUCCESS;
             case 3: return CASE_EVAL_INVALID;
             case 4: return CASE_EVAL_TIMEOUT;
+            case 5: return CASE_CANCEL;
             case 10: return MODEL_SYNC;
             case 100: return TERMINATE;
         }
     }
     Optimization::Case *c; //!< The case associated with the message (if any).
+    QUuid case_id; //!< The id of the case to be cancelled (CASE_CANCEL messages only).
     int tag; //!< The tag for the message.
     int source; //!< The rank of the process sending the message.
     int destination; //!< The rank of the process receiving the message.
@@ -120,6 +124,12 @@ class MPIRunner : public AbstractRunner {
 
   int SimulatorDelay() const;
 
+  /*!
+   * @brief One case can be evaluated by each worker process, limited by the max-parallel-simulations
+   * runtime setting.
+   */
+  int parallelEvaluations() const override;
+
  protected:
   MPIRunner(RuntimeSettings *rts);
 
@@ -128,6 +138,8 @@ class MPIRunner : public AbstractRunner {
   int rank_;
   int scheduler_rank_ = 0;
   int simulator_delay_;
+  std::vector<std::string> processor_names_; //!< Name of the node each rank runs on. Only gathered with dynamic threads.
+  std::vector<int> processor_cores_; //!< Number of cores on the node each rank runs on. Only gathered with dynamic threads.
 
   /*!
    * @brief Print a message to the console.
@@ -17,12 +17,46 @@
    along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include "overseer.h"
+#include "Utilities/filehandling.hpp"
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
 namespace Runner {
 namespace MPI {
+
+namespace {
+
+/*!
+ * Group cases are predicted within: simulations on different realizations or fidelities
+ * are not comparable.
+ */
+std::string predictionGroup(Optimization::Case *c) {
+    return c->GetEnsembleRealization().toStdString()
+        + (c->GetFidelity() == Optimization::Case::COARSE ? "/coarse" : "/fine");
+}
+
+/*!
+ * Variable values ordered by id. Unlike GetRealVarVector, this also works on cases
+ * received from workers.
+ */
+std::vector<double> predictionFeatures(Optimization::Case *c) {
+    QHash<QUuid, double> real_variables = c->real_variables();
+    QHash<QUuid, int> integer_variables = c->integer_variables();
+    QList<QUuid> real_ids = real_variables.keys();
+    QList<QUuid> integer_ids = integer_variables.keys();
+    std::sort(real_ids.begin(), real_ids.end());
+    std::sort(integer_ids.begin(), integer_ids.end());
+    std::vector<double> features;
+    for (QUuid id : real_ids) features.push_back(real_variables[id]);
+    for (QUuid id : integer_ids) features.push_back(integer_variables[id]);
+    return features;
+}
+
+}
+
 Overseer::Overseer(MPIRunner *runner) {
     runner_ = runner;
     runner_->BroadcastModel();
@@ -48,12 +82,23 @@ void Overseer::AssignCase(Optimization::Case *c, int preferred_worker) {
         runner_->printMessage("Waiting for simulator delay ...", 2);
         std::this_thread::sleep_until(last_sim_start_ + chrono::seconds(runner_->SimulatorDelay()));
     }
+    if (predict_runtimes_) {
+        PendingPrediction prediction{predictionGroup(c), predictionFeatures(c), -1};
+        prediction.predicted = runtime_predictor_.Predict(prediction.group, prediction.features);
+        if (prediction.predicted > 0 && timeout_factor_ > 0)
+            c->SetSimTimeout(std::max(1, (int)std::ceil(timeout_factor_ * prediction.predicted)));
+        pending_predictions_[c->id()] = prediction;
+    }
+    if (dynamic_threads_) {
+        c->SetSimThreads(core_allocator_.Allocate(worker->rank, waiting_cases_()));
+    }
     auto msg = MPIRunner::Message();
     msg.tag = MPIRunner::MsgTag ::CASE_UNEVAL;
     msg.destination = worker->rank;
     msg.c = c;
     runner_->SendMessage(msg);
     worker->start();
+    worker->case_id = c->id();
     last_sim_start_ = current_time();
     c->state.eval = Optimization::Case::CaseState::EvalStatus::E_CURRENT;
     runner_->printMessage("Assigned case to worker " + boost::lexical_cast<std::string>(worker->rank), 2);
@@ -64,13 +109,66 @@ Optimization::Case *Overseer::RecvEvaluatedCase() {
     auto message = MPIRunner::Message();
     runner_->RecvMessage(message);
     workers_[message.source]->stop();
+    if (dynamic_threads_)
+        core_allocator_.Release(message.source);
     runner_->printMessage("Received case with tag " + boost::lexical_cast<std::string>(message.tag)
                               + " from worker " + boost::lexical_cast<std::string>(message.source), 2);
     runner_->printMessage("Current status for workers:\n" + workerStatusSummary(), 2);
     last_case_tag = message.get_tag();
+    if (predict_runtimes_)
+        recordRuntime(message.c);
     return message.c;
 }
 
+void Overseer::EnableRuntimePrediction(int timeout_factor, const QString &log_path) {
+    predict_runtimes_ = true;
+    timeout_factor_ = timeout_factor;
+    prediction_log_path_ = log_path;
+    if (Utilities::FileHandling::FileExists(prediction_log_path_))
+        Utilities::FileHandling::DeleteFile(prediction_log_path_);
+    Utilities::FileHandling::WriteLineToFile("CaseId,Group,Predicted,Actual", prediction_log_path_);
+}
+
+void Overseer::EnableDynamicThreads(std::function<int()> waiting_cases) {
+    if (runner_->processor_names_.size() != runner_->world_.size())
+        throw std::runtime_error("Dynamic threads require the node of each rank to be known.");
+    for (int i = 1; i < runner_->world_.size(); ++i) {
+        core_allocator_.AddWorker(i, runner_->processor_names_[i], runner_->processor_cores_[i]);
+    }
+    waiting_cases_ = waiting_cases;
+    dynamic_threads_ = true;
+}
+
+double Overseer::PredictRuntime(Optimization::Case *c) const {
+    if (!predict_runtimes_)
+        return -1;
+    return runtime_predictor_.Predict(predictionGroup(c), predictionFeatures(c));
+}
+
+void Overseer::recordRuntime(Optimization::Case *c) {
+    if (!pending_predictions_.contains(c->id()))
+        return;
+    PendingPrediction prediction = pending_predictions_.take(c->id());
+    // Only complete simulations say anything about the runtime
+    if (last_case_tag != MPIRunner::MsgTag::CASE_EVAL_SUCCESS
+        || c->state.eval == Optimization::Case::CaseState::EvalStatus::E_CANCELLED
+        || c->GetSimTime() <= 0)
+        return;
+    if (prediction.predicted >= 0)
+        runtime_predictor_.RecordError(prediction.predicted, c->GetSimTime());
+    runtime_predictor_.AddObservation(prediction.group, prediction.features, c->GetSimTime());
+    Utilities::FileHandling::WriteLineToFile(
+        QString("%1,%2,%3,%4").arg(c->id().toString()).arg(QString::fromStdString(prediction.group))
+            .arg(prediction.predicted).arg(c->GetSimTime()),
+        prediction_log_path_);
+}
+
+std::string Overseer::RuntimePredictionSummary() const {
+    return "Runtime prediction: " + boost::lexical_cast<std::string>(runtime_predictor_.NumberOfPredictionsChecked())
+        + " predictions checked. Mean absolute error: " + boost::lexical_cast<std::string>(runtime_predictor_.MeanAbsoluteError())
+        + " s. Mean relative error: " + boost::lexical_cast<std::string>(runtime_predictor_.MeanRelativeError()) + ".";
+}
+
 Overseer::WorkerStatus * Overseer::getFreeWorker() {
     if (NumberOfFreeWorkers() == 0) throw std::runtime_error("No free workers in network.");
     for (int i = 1; i < runner_->world_.size(); ++i) {
@@ -124,6 +222,21 @@ int Overseer::NumberOfBusyWorkers() {
     return workers_.count() - NumberOfFreeWorkers();
 }
 
+bool Overseer::CancelCase(const QUuid &id) {
+    for (auto worker : workers_.values()) {
+        if (worker->working && worker->case_id == id) {
+            auto msg = MPIRunner::Message();
+            msg.tag = MPIRunner::MsgTag::CASE_CANCEL;
+            msg.destination = worker->rank;
+            msg.case_id = id;
+            runner_->SendMessage(msg);
+            nr_cancelled_++;
+            return true;
+        }
+    }
+    return false;
+}
+
 std::vector<int> Overseer::GetFreeWorkerRanks() const {
     std::vector<int> free_workers;
     for (int i = 1; i < runner_->world_.size(); ++i) {
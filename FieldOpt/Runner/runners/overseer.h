@@ -20,8 +20,11 @@
 #define FIELDOPT_OVERSEER_H
 
 #include "mpi_runner.h"
+#include "runtime_predictor.h"
+#include "core_allocator.h"
 #include "Utilities/time.hpp"
 #include <chrono>
+#include <functional>
 
 namespace Runner {
 namespace MPI {
@@ -42,10 +45,55 @@ class Overseer {
 
   /*!
    * @brief Wait to receive an evaluated case.
-   * @return An evaluated case object.
+   * @return An evaluated case object. This is a copy of the case that was assigned,
+   * owned by the caller.
    */
   Optimization::Case *RecvEvaluatedCase();
 
+  /*!
+   * @brief Cancel the simulation of a case that is being evaluated by a worker, by sending
+   * it a message with the CASE_CANCEL tag. The worker will still send the case back, with
+   * the E_CANCELLED evaluation status (or with its results, if it finished before
+   * receiving the cancellation).
+   * @param id Id of the case to be cancelled.
+   * @return True if a worker evaluating the case was found.
+   */
+  bool CancelCase(const QUuid &id);
+
+  int NumberOfCancellations() const { return nr_cancelled_; } //!< Number of cancellations sent to workers.
+
+  /*!
+   * @brief Predict the simulation time of each case when it is assigned, and record the
+   * actual time when it is received. The predicted and actual times are written to a CSV file.
+   * @param timeout_factor If larger than 0, the case is sent with a timeout of this factor
+   * times the predicted time, overriding the worker's own timeout.
+   * @param log_path Path to the file to write the predictions to.
+   */
+  void EnableRuntimePrediction(int timeout_factor, const QString &log_path);
+
+  bool IsRuntimePredictionEnabled() const { return predict_runtimes_; }
+
+  /*!
+   * @brief Get the predicted simulation time of a case in seconds, or -1 if the runtime
+   * prediction is not enabled or no simulation times have been recorded yet.
+   */
+  double PredictRuntime(Optimization::Case *c) const;
+
+  /*!
+   * @brief Get a string summarizing the accuracy of the runtime predictions.
+   */
+  std::string RuntimePredictionSummary() const;
+
+  /*!
+   * @brief Decide the number of threads for each simulation when the case is assigned,
+   * by dividing the cores of the worker's node between the running simulations (see
+   * CoreAllocator). The number is sent along with the case. Requires the node names
+   * to have been gathered by the MPIRunner (the --dynamic-threads flag).
+   * @param waiting_cases Function returning the number of cases waiting to be assigned,
+   * including the one being assigned.
+   */
+  void EnableDynamicThreads(std::function<int()> waiting_cases);
+
   /*!
    * @brief Wait for a message with the TERMINATE tag from each of the workers to confirm termination
    * before moving on to finalization.
@@ -81,6 +129,7 @@ class Overseer {
     int rank; //!< The rank of the process the worker is running on.
     bool working = false; //!< Indicates if the worker is currently performing simulations.
     QDateTime working_since; //!< The last time a job was sent to the worker.
+    QUuid case_id; //!< Id of the last case sent to the worker.
     int working_seconds() { //!< Number of seconds since last work was sent to the process.
         return time_since_seconds(working_since);
     }
@@ -121,6 +170,25 @@ class Overseer {
   std::string workerStatusSummary();
 
   std::chrono::system_clock::time_point last_sim_start_; //!< Time stamp for the start of the previous simulation.
+  int nr_cancelled_ = 0;
+
+  struct PendingPrediction {
+    std::string group;
+    std::vector<double> features;
+    double predicted;
+  };
+
+  bool predict_runtimes_ = false;
+  int timeout_factor_ = 0;
+  QString prediction_log_path_;
+  RuntimePredictor runtime_predictor_;
+  QHash<QUuid, PendingPrediction> pending_predictions_; //!< Features and predictions of the cases being evaluated.
+
+  void recordRuntime(Optimization::Case *c); //!< Record the simulation time of a received case.
+
+  bool dynamic_threads_ = false;
+  CoreAllocator core_allocator_;
+  std::function<int()> waiting_cases_;
 };
 }
 }
@@ -0,0 +1,114 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "runtime_predictor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Runner {
+
+RuntimePredictor::RuntimePredictor(int k, int max_observations) {
+    k_ = std::max(1, k);
+    max_observations_ = std::max(1, max_observations);
+    n_errors_ = 0;
+    sum_abs_error_ = 0.0;
+    sum_rel_error_ = 0.0;
+}
+
+void RuntimePredictor::AddObservation(const std::string &group, const std::vector<double> &features, double seconds) {
+    observations_.push_back(Observation{group, features, seconds});
+    if (observations_.size() > max_observations_)
+        observations_.pop_front();
+}
+
+double RuntimePredictor::Predict(const std::string &group, const std::vector<double> &features) const {
+    if (observations_.empty())
+        return -1;
+
+    // Use the observations from the same group if there are any; otherwise all of them
+    std::vector<const Observation *> pool;
+    for (const Observation &o : observations_) {
+        if (o.group == group)
+            pool.push_back(&o);
+    }
+    if (pool.empty()) {
+        for (const Observation &o : observations_) {
+            pool.push_back(&o);
+        }
+    }
+
+    // Neighbours must have the same number of features; fall back to the mean of the pool
+    std::vector<const Observation *> comparable;
+    for (const Observation *o : pool) {
+        if (!features.empty() && o->features.size() == features.size())
+            comparable.push_back(o);
+    }
+    if (comparable.empty()) {
+        double sum = 0.0;
+        for (const Observation *o : pool) sum += o->seconds;
+        return sum / pool.size();
+    }
+
+    // Scale each feature by its range, so that no variable dominates the distance
+    std::vector<double> lower(features), upper(features);
+    for (const Observation *o : comparable) {
+        for (int i = 0; i < features.size(); ++i) {
+            lower[i] = std::min(lower[i], o->features[i]);
+            upper[i] = std::max(upper[i], o->features[i]);
+        }
+    }
+    std::vector<std::pair<double, double>> neighbours; // (distance, seconds)
+    for (const Observation *o : comparable) {
+        double d2 = 0.0;
+        for (int i = 0; i < features.size(); ++i) {
+            double range = upper[i] - lower[i];
+            if (range > 0) {
+                double d = (features[i] - o->features[i]) / range;
+                d2 += d * d;
+            }
+        }
+        neighbours.push_back(std::make_pair(std::sqrt(d2), o->seconds));
+    }
+    int k = std::min(k_, (int)neighbours.size());
+    std::partial_sort(neighbours.begin(), neighbours.begin() + k, neighbours.end());
+
+    double weighted_sum = 0.0;
+    double weight_sum = 0.0;
+    for (int i = 0; i < k; ++i) {
+        double weight = 1.0 / (neighbours[i].first + 1e-6);
+        weighted_sum += weight * neighbours[i].second;
+        weight_sum += weight;
+    }
+    return weighted_sum / weight_sum;
+}
+
+void RuntimePredictor::RecordError(double predicted, double actual) {
+    double error = std::abs(predicted - actual);
+    sum_abs_error_ += error;
+    sum_rel_error_ += error / std::max(actual, 1.0);
+    n_errors_++;
+}
+
+double RuntimePredictor::MeanRelativeError() const {
+    return n_errors_ > 0 ? sum_rel_error_ / n_errors_ : 0.0;
+}
+
+double RuntimePredictor::MeanAbsoluteError() const {
+    return n_errors_ > 0 ? sum_abs_error_ / n_errors_ : 0.0;
+}
+
+}
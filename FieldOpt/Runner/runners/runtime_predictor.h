@@ -0,0 +1,96 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_RUNTIME_PREDICTOR_H
+#define FIELDOPT_RUNTIME_PREDICTOR_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Runner {
+
+/*!
+ * @brief The RuntimePredictor class predicts the simulation time of a case from the
+ * recorded simulation times of the cases closest to it.
+ *
+ * Each observation consists of a group (the realization and fidelity the case was
+ * simulated on), a feature vector (the variable values of the case) and the simulation
+ * time. A prediction is the inverse-distance weighted mean of the times of the k nearest
+ * observations in the same group, where each feature is scaled by the range it spans in
+ * the recorded observations. If nothing has been recorded for the group yet, all groups
+ * are used. Only the most recent observations are kept.
+ *
+ * The errors of the predictions are accumulated by RecordError(), so that the quality of
+ * the predictor can be judged from the logs.
+ */
+class RuntimePredictor {
+ public:
+  /*!
+   * @param k Number of neighbours to use.
+   * @param max_observations Number of observations to keep.
+   */
+  RuntimePredictor(int k=5, int max_observations=500);
+
+  /*!
+   * @brief Record the simulation time of a case.
+   * @param group Realization and fidelity the case was simulated on.
+   * @param features Variable values of the case.
+   * @param seconds The simulation time.
+   */
+  void AddObservation(const std::string &group, const std::vector<double> &features, double seconds);
+
+  /*!
+   * @brief Predict the simulation time of a case.
+   * @return The predicted time in seconds, or -1 if nothing has been recorded.
+   */
+  double Predict(const std::string &group, const std::vector<double> &features) const;
+
+  /*!
+   * @brief Record the error of a prediction once the actual time is known.
+   */
+  void RecordError(double predicted, double actual);
+
+  int NumberOfObservations() const { return observations_.size(); }
+  int NumberOfPredictionsChecked() const { return n_errors_; }
+
+  /*!
+   * @brief Mean of |predicted - actual| / actual over the checked predictions.
+   * Actual times below one second are counted as one second.
+   */
+  double MeanRelativeError() const;
+
+  double MeanAbsoluteError() const; //!< Mean of |predicted - actual| in seconds.
+
+ private:
+  struct Observation {
+    std::string group;
+    std::vector<double> features;
+    double seconds;
+  };
+
+  int k_;
+  int max_observations_;
+  std::deque<Observation> observations_;
+
+  int n_errors_;
+  double sum_abs_error_;
+  double sum_rel_error_;
+};
+
+}
+
+#endif //FIELDOPT_RUNTIME_PREDICTOR_H
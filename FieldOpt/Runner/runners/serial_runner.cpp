@@ -28,6 +28,7 @@ SerialRunner::SerialRunner(Runner::RuntimeSettings *runtime_settings)
 {
     InitializeLogger();
     InitializeSettings();
+    InitializeTracing();
     InitializeModel();
     InitializeSimulator();
     EvaluateBaseModel();
@@ -44,7 +45,7 @@ void SerialRunner::Execute()
         Optimization::Case *new_case;
         if (is_ensemble_run_) {
             if (ensemble_helper_.IsCaseDone()) {
-                ensemble_helper_.SetActiveCase(optimizer_->GetCaseForEvaluation());
+                ensemble_helper_.SetActiveCase(optimizer_->GetCaseForEvaluation(), optimizer_->GetTentativeBestCase());
             }
             if (VERB_RUN >= 3) Printer::ext_info("Getting ensemble case.", "Runner", "Serial Runner");
             new_case = ensemble_helper_.GetCaseForEval();
@@ -60,6 +61,9 @@ void SerialRunner::Execute()
             if (VERB_RUN >= 3) Printer::ext_info("Bookkeeped case.", "Runner", "Serial Runner");
             new_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_BOOKKEEPED;
         }
+        else if (is_multi_fidelity_run_) {
+            evaluateMultiFidelity(new_case);
+        }
         else {
             try {
                 bool simulation_success = true;
@@ -97,6 +101,8 @@ void SerialRunner::Execute()
                     new_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
                     new_case->SetSimTime(sim_time);
                     simulation_times_.push_back((sim_time));
+                    if (!is_ensemble_run_)
+                        bookkeeper_->Record(new_case);
                 }
                 else {
                     new_case->set_objective_function_value(sentinelValue());
@@ -114,6 +120,7 @@ void SerialRunner::Execute()
         }
         if (is_ensemble_run_) {
             ensemble_helper_.SubmitEvaluatedRealization(new_case);
+            last_realization_case_.reset(new_case);
             if  (ensemble_helper_.IsCaseDone()) {
                 optimizer_->SubmitEvaluatedCase(ensemble_helper_.GetEvaluatedCase());
             }
@@ -126,4 +133,38 @@ void SerialRunner::Execute()
     FinalizeRun(true);
 }
 
+void SerialRunner::evaluateMultiFidelity(Optimization::Case *c) {
+    try {
+        auto start = QDateTime::currentDateTime();
+        c->state.eval = Optimization::Case::CaseState::EvalStatus::E_CURRENT;
+        if (VERB_RUN >= 3) Printer::ext_info("Simulating case on the coarse model.", "Runner", "Serial Runner");
+        bool simulation_success = evaluateFidelity(c, Optimization::Case::COARSE);
+        if (simulation_success && fidelity_helper_.Promote(c, optimizer_->GetTentativeBestCase())) {
+            if (VERB_RUN >= 3) Printer::ext_info("Simulating case on the fine model.", "Runner", "Serial Runner");
+            auto fine_start = QDateTime::currentDateTime();
+            simulation_success = evaluateFidelity(c, Optimization::Case::FINE);
+            if (simulation_success)
+                simulation_times_.push_back(time_span_seconds(fine_start, QDateTime::currentDateTime()));
+        }
+        int sim_time = time_span_seconds(start, QDateTime::currentDateTime());
+        c->SetSimTime(sim_time);
+        if (simulation_success) {
+            c->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+            bookkeeper_->Record(c);
+        }
+        else {
+            c->set_objective_function_value(sentinelValue());
+            c->state.eval = Optimization::Case::CaseState::EvalStatus::E_FAILED;
+            c->state.err_msg = Optimization::Case::CaseState::ErrorMessage::ERR_SIM;
+            if (sim_time >= timeoutValue())
+                c->state.eval = Optimization::Case::CaseState::EvalStatus::E_TIMEOUT;
+        }
+    } catch (std::runtime_error e) {
+        Printer::ext_warn("Exception thrown while applying/simulating case: " + std::string(e.what()) + ". Setting obj. fun. value to sentinel value.", "Runner", "SerialRunner");
+        c->set_objective_function_value(sentinelValue());
+        c->state.eval = Optimization::Case::CaseState::EvalStatus::E_FAILED;
+        c->state.err_msg = Optimization::Case::CaseState::ErrorMessage::ERR_WIC;
+    }
+}
+
 }
@@ -20,6 +20,7 @@
 #define SERIALRUNNER_H
 
 #include "abstract_runner.h"
+#include <memory>
 
 namespace Runner {
 
@@ -38,6 +39,17 @@ class SerialRunner : public AbstractRunner
   // AbstractRunner interface
  private:
   void Execute();
+
+  /*!
+   * @brief Evaluate a case on the coarse model, and on the fine model if it is promoted.
+   */
+  void evaluateMultiFidelity(Optimization::Case *c);
+
+  /*!
+   * @brief The last evaluated realization copy. It is kept alive until the next one has
+   * been applied to the model, which refers to it for logging until then.
+   */
+  std::unique_ptr<Optimization::Case> last_realization_case_;
 };
 
 }
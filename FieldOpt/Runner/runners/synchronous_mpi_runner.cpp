@@ -17,6 +17,7 @@
    along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include "synchronous_mpi_runner.h"
+#include <limits>
 
 namespace Runner {
 namespace MPI {
@@ -26,6 +27,7 @@ SynchronousMPIRunner::SynchronousMPIRunner(RuntimeSettings *rts) : MPIRunner(rts
 
     if (world_.rank() == 0) {
         InitializeSettings("rank" + QString::number(rank()));
+        InitializeTracing(rank());
 
         InitializeLogger();
         InitializeModel();
@@ -36,15 +38,24 @@ SynchronousMPIRunner::SynchronousMPIRunner(RuntimeSettings *rts) : MPIRunner(rts
         InitializeOptimizer();
         InitializeBookkeeper();
         overseer_ = new MPI::Overseer(this);
+        if (runtime_settings_->dynamic_threads()) {
+            overseer_->EnableDynamicThreads([this]() { return optimizer_->nr_queued_cases() + 1; });
+        }
+        if (runtime_settings_->predict_runtimes()) {
+            overseer_->EnableRuntimePrediction(runtime_settings_->simulation_timeout(),
+                QString::fromStdString(runtime_settings_->paths().GetPath(Paths::OUTPUT_DIR)) + "/log_runtime_prediction.csv");
+        }
         FinalizeInitialization(true);
     }
     else {
         InitializeLogger("rank" + QString::number(rank()));
         InitializeSettings("rank" + QString::number(rank()));
+        InitializeTracing(rank());
         InitializeModel();
         InitializeSimulator();
         InitializeObjectiveFunction();
         worker_ = new MPI::Worker(this);
+        simulator_->SetCancellationCheck([this]() { return worker_->IsCurrentCaseCancelled(); });
         FinalizeInitialization(false);
     }
 }
@@ -60,8 +71,12 @@ void SynchronousMPIRunner::Execute() {
       else {
           printMessage("Getting new case from optimizer.", 2);
           new_case = optimizer_->GetCaseForEvaluation();
+          if (is_multi_fidelity_run_) {
+              new_case->SetFidelity(Optimization::Case::COARSE);
+          }
           if (is_ensemble_run_) {
-              ensemble_helper_.SetActiveCase(new_case);
+              ensemble_helper_.SetActiveCase(new_case, optimizer_->GetTentativeBestCase());
+              ensemble_helper_.ScheduleNextRealization(overseer_->GetFreeWorkerRanks());
               new_case = ensemble_helper_.GetCaseForEval();
           }
       }
@@ -74,6 +89,7 @@ void SynchronousMPIRunner::Execute() {
           if (is_ensemble_run_) {
               int worker_rank = ensemble_helper_.GetAssignedWorker(new_case->GetEnsembleRealization().toStdString(), overseer_->GetFreeWorkerRanks());
               overseer_->AssignCase(new_case, worker_rank);
+              delete new_case; // The realization copy has been sent to the worker
           }
           else {
               overseer_->AssignCase(new_case);
@@ -84,9 +100,10 @@ void SynchronousMPIRunner::Execute() {
 
     auto wait_for_evaluated_case = [&]() mutable {
       printMessage("Waiting to receive evaluated case...", 2);
-      auto evaluated_case = overseer_->RecvEvaluatedCase(); // TODO: This is a duplicate case that wont get deleted, i.e. a MEMORY LEAK.
+      auto evaluated_case = overseer_->RecvEvaluatedCase(); // A copy; deleted once it has been submitted
       printMessage("Evaluated case received.", 2);
-      if (overseer_->last_case_tag == MPIRunner::MsgTag::CASE_EVAL_SUCCESS) {
+      if (overseer_->last_case_tag == MPIRunner::MsgTag::CASE_EVAL_SUCCESS
+          && evaluated_case->state.eval != Optimization::Case::CaseState::EvalStatus::E_CANCELLED) {
           printMessage("Setting state for evaluated case.", 2);
           evaluated_case->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
           printMessage("Setting timings for evaluated case.", 2);
@@ -98,6 +115,7 @@ void SynchronousMPIRunner::Execute() {
       if (is_ensemble_run_) {
           printMessage("Submitting evaluated realization to ensemble helper.", 2);
           ensemble_helper_.SubmitEvaluatedRealization(evaluated_case);
+          delete evaluated_case;
           if (ensemble_helper_.IsCaseDone()) {
               printMessage("All selected realizations evaluated. Getting composite case.", 2);
               auto evaluated_case = ensemble_helper_.GetEvaluatedCase();
@@ -107,10 +125,24 @@ void SynchronousMPIRunner::Execute() {
               printMessage("Submitted evaluated case to optimizer and model.", 2);
           }
       }
+      else if (is_multi_fidelity_run_ && evaluated_case->GetFidelity() == Optimization::Case::COARSE
+          && overseer_->last_case_tag == MPIRunner::MsgTag::CASE_EVAL_SUCCESS
+          && evaluated_case->state.eval != Optimization::Case::CaseState::EvalStatus::E_CANCELLED
+          && fidelity_helper_.Promote(evaluated_case, optimizer_->GetTentativeBestCase())) {
+          printMessage("Promoting case to the fine model.", 2);
+          fidelity_helper_.QueuePromotedCase(evaluated_case);
+      }
       else {
+          bookkeeper_->Record(evaluated_case);
           optimizer_->SubmitEvaluatedCase(evaluated_case);
+          delete evaluated_case;
           printMessage("Submitted evaluated case to optimizer.", 2);
       }
+      for (auto id : optimizer_->TakeObsoleteCases()) {
+          if (overseer_->CancelCase(id)) {
+              printMessage("Sent cancellation for obsolete case.", 2);
+          }
+      }
     };
 
     if (rank() == 0) { // Overseer
@@ -121,14 +153,28 @@ void SynchronousMPIRunner::Execute() {
             if (is_ensemble_run_) {
                 printMessage(ensemble_helper_.GetStateString(), 2);
             }
-            if (is_ensemble_run_ && ensemble_helper_.IsCaseAvailableForEval()) {
+            if (is_multi_fidelity_run_ && fidelity_helper_.HasPromotedCases()) {
+                printMessage("Promoted cases waiting for fine evaluation.", 2);
+                if (overseer_->NumberOfFreeWorkers() > 0) {
+                    auto promoted_case = fidelity_helper_.GetPromotedCase();
+                    overseer_->AssignCase(promoted_case);
+                    delete promoted_case; // The received copy has been sent to the worker
+                    printMessage("Promoted case assigned to worker.", 2);
+                }
+                else {
+                    printMessage("No free workers available. Waiting for an evaluated case.", 2);
+                    wait_for_evaluated_case();
+                }
+            }
+            else if (is_ensemble_run_ && ensemble_helper_.IsCaseAvailableForEval()) {
                 printMessage("Queued realization cases available.", 2);
-                if (overseer_->NumberOfFreeWorkers() > 0) { // Free workers available
+                if (overseer_->NumberOfFreeWorkers() > 0
+                    && ensemble_helper_.ScheduleNextRealization(overseer_->GetFreeWorkerRanks())) { // Free workers available
                     printMessage("Free workers available. Handling next case.", 2);
                     handle_new_case();
                 }
-                else { // No workers available
-                    printMessage("No free workers available. Waiting for an evaluated case.", 2);
+                else { // No workers available, or waiting for warm workers
+                    printMessage("No suitable free workers available. Waiting for an evaluated case.", 2);
                     wait_for_evaluated_case();
                 }
             }
@@ -151,6 +197,17 @@ void SynchronousMPIRunner::Execute() {
                 printMessage("No queued cases available.", 2);
                 if (overseer_->NumberOfBusyWorkers() == 0) { // All workers are free
                     printMessage("No workers are busy. Starting next iteration.", 2);
+                    if (optimizer_->GenerateCases() > 0) {
+                        scheduleLongestFirst();
+                        handle_new_case();
+                    }
+                    else { // E.g. an asynchronous optimizer with nothing to generate yet
+                        printMessage("No cases generated. Checking for termination.", 2);
+                    }
+                }
+                else if (optimizer_->IsAsync() && overseer_->NumberOfFreeWorkers() > 0
+                    && optimizer_->GenerateCases() > 0) { // Asynchronous optimizer generated cases for free workers
+                    printMessage("Free workers available. Handling new case from asynchronous optimizer.", 2);
                     handle_new_case();
                 }
                 else { // Some workers are performing simulations
@@ -159,10 +216,14 @@ void SynchronousMPIRunner::Execute() {
                 }
             }
         }
-        FinalizeRun(true);
-        overseer_->TerminateWorkers();
+        if (overseer_->IsRuntimePredictionEnabled())
+            printMessage(overseer_->RuntimePredictionSummary());
         printMessage("Terminating workers.", 2);
+        overseer_->TerminateWorkers();
+        // The workers flush their logs before confirming, so the extended logs are complete
+        // when they are collected by FinalizeRun
         overseer_->EnsureWorkerTermination();
+        FinalizeRun(true);
         env_.~environment();
         return;
     }
@@ -178,54 +239,73 @@ void SynchronousMPIRunner::Execute() {
                 simulation_done_ = false;
                 logger_->AddEntry(this);
                 bool simulation_success = true;
-                if (is_ensemble_run_) {
-                    printMessage("Updating grid path.", 2);
-                    model_->set_grid_path(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()).grid());
-                }
-                printMessage("Applying case to model.", 2);
-                model_->ApplyCase(worker_->GetCurrentCase());
-                model_update_done_ = true; logger_->AddEntry(this);
-                auto start = QDateTime::currentDateTime();
-                if (runtime_settings_->simulation_timeout() == 0 && settings_->simulator()->max_minutes() < 0) {
-                    printMessage("Starting model evaluation.", 2);
-                    simulator_->Evaluate();
+                QDateTime start;
+                if (is_multi_fidelity_run_) {
+                    printMessage("Starting multi-fidelity model evaluation.", 2);
+                    start = QDateTime::currentDateTime();
+                    simulation_success = evaluateFidelity(worker_->GetCurrentCase(), worker_->GetCurrentCase()->GetFidelity());
+                    model_update_done_ = true;
                 }
-                else if (simulation_times_.size() == 0 && settings_->simulator()->max_minutes() > 0) {
-                    if (!is_ensemble_run_) {
-                        printMessage("Starting model evaluation with timeout.", 2);
-                        simulation_success = simulator_->Evaluate(settings_->simulator()->max_minutes() * 60,
-                                                                  runtime_settings_->threads_per_sim());
+                else {
+                    if (is_ensemble_run_) {
+                        printMessage("Updating grid path.", 2);
+                        model_->set_grid_path(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()).grid());
                     }
-                    else {
-                        printMessage("Starting ensemble model evaluation with timeout.", 2);
-                        simulation_success = simulator_->Evaluate(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()),
-                                                                  settings_->simulator()->max_minutes() * 60,
-                                                                  runtime_settings_->threads_per_sim());
+                    printMessage("Applying case to model.", 2);
+                    model_->ApplyCase(worker_->GetCurrentCase());
+                    model_update_done_ = true; logger_->AddEntry(this);
+                    start = QDateTime::currentDateTime();
+                    if (runtime_settings_->simulation_timeout() == 0 && settings_->simulator()->max_minutes() < 0) {
+                        printMessage("Starting model evaluation.", 2);
+                        // Monitored without a timeout, so that the simulation can still be cancelled
+                        simulation_success = simulator_->Evaluate(std::numeric_limits<int>::max() / 2,
+                                                                  simulationThreads(worker_->GetCurrentCase()));
                     }
-                }
-                else {
-                    if (!is_ensemble_run_) {
-                        printMessage("Starting model evaluation with timeout.", 2);
-                        simulation_success = simulator_->Evaluate(timeoutValue(), runtime_settings_->threads_per_sim());
+                    else if (simulation_times_.size() == 0 && settings_->simulator()->max_minutes() > 0) {
+                        if (!is_ensemble_run_) {
+                            printMessage("Starting model evaluation with timeout.", 2);
+                            simulation_success = simulator_->Evaluate(settings_->simulator()->max_minutes() * 60,
+                                                                      simulationThreads(worker_->GetCurrentCase()));
+                        }
+                        else {
+                            printMessage("Starting ensemble model evaluation with timeout.", 2);
+                            simulation_success = simulator_->Evaluate(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()),
+                                                                      settings_->simulator()->max_minutes() * 60,
+                                                                      simulationThreads(worker_->GetCurrentCase()));
+                        }
                     }
                     else {
-                        printMessage("Starting ensemble model evaluation with timeout.", 2);
-                        simulation_success = simulator_->Evaluate(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()),
-                                                                  settings_->simulator()->max_minutes() * 60,
-                                                                  runtime_settings_->threads_per_sim());
+                        int case_timeout = worker_->GetCurrentCase()->GetSimTimeout(); // Set from the predicted runtime, if any
+                        if (!is_ensemble_run_) {
+                            printMessage("Starting model evaluation with timeout.", 2);
+                            simulation_success = simulator_->Evaluate(case_timeout > 0 ? case_timeout : timeoutValue(),
+                                                                      simulationThreads(worker_->GetCurrentCase()));
+                        }
+                        else {
+                            printMessage("Starting ensemble model evaluation with timeout.", 2);
+                            simulation_success = simulator_->Evaluate(ensemble_helper_.GetRealization(worker_->GetCurrentCase()->GetEnsembleRealization().toStdString()),
+                                                                      case_timeout > 0 ? case_timeout : settings_->simulator()->max_minutes() * 60,
+                                                                      simulationThreads(worker_->GetCurrentCase()));
+                        }
                     }
                 }
                 simulation_done_ = true; logger_->AddEntry(this);
                 auto end = QDateTime::currentDateTime();
                 int sim_time = time_span_seconds(start, end);
-                if (simulation_success) {
+                if (!simulation_success && simulator_->WasCancelled()) {
+                    printMessage("Cancelled. Setting objective function value to SENTINEL VALUE.", 2);
+                    worker_->GetCurrentCase()->state.eval = Optimization::Case::CaseState::EvalStatus::E_CANCELLED;
+                    worker_->GetCurrentCase()->set_objective_function_value(sentinelValue());
+                }
+                else if (simulation_success) {
                     tag = MPIRunner::MsgTag::CASE_EVAL_SUCCESS;
                     printMessage("Setting objective function value.", 2);
                     model_->wellCost(settings_->optimizer());
                     worker_->GetCurrentCase()->set_objective_function_value(objective_function_->value());
                     worker_->GetCurrentCase()->SetSimTime(sim_time);
                     worker_->GetCurrentCase()->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
-                    simulation_times_.push_back(sim_time);
+                    if (!is_multi_fidelity_run_ || worker_->GetCurrentCase()->GetFidelity() == Optimization::Case::FINE)
+                        simulation_times_.push_back(sim_time); // Coarse simulation times would skew the timeout
                 }
                 else {
                     tag = MPIRunner::MsgTag::CASE_EVAL_TIMEOUT;
@@ -266,18 +346,50 @@ void SynchronousMPIRunner::initialDistribution() {
 
     if (!is_ensemble_run_) { // Single-realization run
         while (optimizer_->nr_queued_cases() > 0 && overseer_->NumberOfFreeWorkers() > 1) { // Leave one free worker
-            overseer_->AssignCase(optimizer_->GetCaseForEvaluation());
+            auto next_case = optimizer_->GetCaseForEvaluation();
+            if (is_multi_fidelity_run_) {
+                next_case->SetFidelity(Optimization::Case::COARSE);
+            }
+            overseer_->AssignCase(next_case);
         }
     }
     else { // Ensemble run
         auto next_case = optimizer_->GetCaseForEvaluation();
-        ensemble_helper_.SetActiveCase(next_case);
+        ensemble_helper_.SetActiveCase(next_case, optimizer_->GetTentativeBestCase());
         while (ensemble_helper_.IsCaseAvailableForEval() && overseer_->NumberOfFreeWorkers() > 1) {
-            overseer_->AssignCase(ensemble_helper_.GetCaseForEval());
+            auto realization_case = ensemble_helper_.GetCaseForEval();
+            int worker_rank = ensemble_helper_.GetAssignedWorker(realization_case->GetEnsembleRealization().toStdString(),
+                                                                 overseer_->GetFreeWorkerRanks());
+            overseer_->AssignCase(realization_case, worker_rank);
+            delete realization_case;
         }
 
     }
 }
+void SynchronousMPIRunner::scheduleLongestFirst() {
+    if (!overseer_->IsRuntimePredictionEnabled() || is_ensemble_run_ || optimizer_->IsAsync()
+        || optimizer_->nr_queued_cases() < 2)
+        return;
+    std::vector<std::pair<double, Optimization::Case *>> predictions;
+    for (auto c : optimizer_->case_handler()->QueuedCases()) {
+        if (is_multi_fidelity_run_)
+            c->SetFidelity(Optimization::Case::COARSE); // As when the case is handed out
+        predictions.push_back(std::make_pair(overseer_->PredictRuntime(c), c));
+    }
+    if (predictions[0].first < 0) // Nothing recorded yet
+        return;
+    std::stable_sort(predictions.begin(), predictions.end(),
+                     [](const std::pair<double, Optimization::Case *> &a, const std::pair<double, Optimization::Case *> &b) {
+                       return a.first > b.first;
+                     });
+    QList<QUuid> order;
+    for (auto p : predictions) {
+        order.append(p.second->id());
+    }
+    optimizer_->case_handler()->ReorderQueue(order);
+    printMessage("Queued cases ordered by predicted runtime, longest first.", 2);
+}
+
 Loggable::LogTarget SynchronousMPIRunner::GetLogTarget() {
     return STATE_RUNNER;
 }
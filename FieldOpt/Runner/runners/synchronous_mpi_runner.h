@@ -56,6 +56,12 @@ class SynchronousMPIRunner : public MPIRunner, public Loggable {
    */
   void initialDistribution();
 
+  /*!
+   * @brief Order the optimizer's queue by predicted runtime, longest first, so that the
+   * longest simulations of an iteration do not start last. Only done for synchronous
+   * optimizers when runtime prediction is enabled (the --predict-runtimes flag).
+   */
+  void scheduleLongestFirst();
 
 };
 
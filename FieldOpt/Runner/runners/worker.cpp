@@ -24,16 +24,22 @@ namespace MPI {
 
 Worker::Worker(MPIRunner *runner) {
     runner_ = runner;
+    current_case_ = nullptr;
     runner_->RecvModelSynchronizationObject();
     std::cout << "Initialized Worker on " << runner_->world().rank() << std::endl;
 }
 
 void Worker::RecvUnevaluatedCase() {
+    current_case_cancelled_ = false;
     auto msg = MPIRunner::Message();
-    msg.source = runner_->scheduler_rank_;
-    msg.tag = MPIRunner::MsgTag::CASE_UNEVAL;
-    runner_->RecvMessage(msg);
+    do { // Discard cancellations that arrived after the previous case was done
+        msg = MPIRunner::Message();
+        msg.source = runner_->scheduler_rank_;
+        msg.tag = MPIRunner::MsgTag::CASE_UNEVAL;
+        runner_->RecvMessage(msg);
+    } while (msg.get_tag() == MPIRunner::MsgTag::CASE_CANCEL);
     current_tag_ = msg.get_tag();
+    previous_case_.reset(current_case_);
     if (msg.get_tag() != MPIRunner::MsgTag::TERMINATE)
         current_case_ = msg.c;
     else {
@@ -61,5 +67,22 @@ Optimization::Case *Worker::GetCurrentCase() {
     return current_case_;
 }
 
+bool Worker::IsCurrentCaseCancelled() {
+    recvCancellations();
+    return current_case_cancelled_;
+}
+
+void Worker::recvCancellations() {
+    while (runner_->world().iprobe(runner_->scheduler_rank_, MPIRunner::MsgTag::CASE_CANCEL)) {
+        auto msg = MPIRunner::Message();
+        msg.source = runner_->scheduler_rank_;
+        msg.tag = MPIRunner::MsgTag::CASE_CANCEL;
+        runner_->RecvMessage(msg);
+        if (current_case_ != nullptr && msg.case_id == current_case_->id()) {
+            current_case_cancelled_ = true;
+        }
+    }
+}
+
 }
 }
@@ -21,6 +21,7 @@
 #define FIELDOPT_WOKER_H
 
 #include "mpi_runner.h"
+#include <memory>
 
 namespace Runner {
 namespace MPI {
@@ -34,6 +35,10 @@ class Worker {
 
   /*!
    * @brief Receive an unevaluated case from the Scheduler and set it as the current_case_.
+   *
+   * The worker owns the received cases. The previous case is kept alive until the next
+   * one is received, because the Model refers to the last case applied to it until a
+   * new one is applied.
    */
   void RecvUnevaluatedCase();
 
@@ -49,12 +54,25 @@ class Worker {
   void ConfirmFinalization();
 
   Optimization::Case *GetCurrentCase();
+
+  /*!
+   * @brief Check (without blocking) whether the overseer has cancelled the current case.
+   * Cancellations of other (already finished) cases are discarded.
+   */
+  bool IsCurrentCaseCancelled();
   MPIRunner::MsgTag GetCurrentTag() { return current_tag_; }
 
  private:
   MPIRunner *runner_;
   Optimization::Case *current_case_;
+  std::unique_ptr<Optimization::Case> previous_case_; //!< The case received before the current one.
   MPIRunner::MsgTag current_tag_;
+  bool current_case_cancelled_ = false;
+
+  /*!
+   * @brief Receive all pending cancellation messages.
+   */
+  void recvCancellations();
 };
 }
 }
@@ -56,10 +56,27 @@ RuntimeSettings::RuntimeSettings(int argc, const char *argv[])
         threads_per_sim_ = vm["threads-per-simulation"].as<int>();
     } else threads_per_sim_ = 1;
 
+    dynamic_threads_ = vm.count("dynamic-threads") != 0;
+    if (vm.count("cores-per-node")) {
+        cores_per_node_ = vm["cores-per-node"].as<int>();
+    } else cores_per_node_ = 0;
+
     if (vm.count("simulation-timeout")) {
         simulation_timeout_ = vm["simulation-timeout"].as<int>();
     } else simulation_timeout_ = 0;
 
+    trace_ = vm.count("trace") != 0;
+    async_logging_ = vm.count("async-logging") != 0;
+    predict_runtimes_ = vm.count("predict-runtimes") != 0;
+    if (vm.count("evaluation-store")) {
+        evaluation_store_ = GetAbsoluteFilePath(vm["evaluation-store"].as<std::string>());
+    } else evaluation_store_ = "";
+    if (vm.count("warm-start")) {
+        warm_start_ = GetAbsoluteFilePath(vm["warm-start"].as<std::string>());
+        if (!DirectoryExists(warm_start_))
+            throw std::runtime_error("The warm start directory " + warm_start_ + " does not exist.");
+    } else warm_start_ = "";
+
     if (vm.count("runner-type")) {
         QString runner_str = QString::fromStdString(vm["runner-type"].as<std::string>());
         if (QString::compare(runner_str, "serial") == 0)
@@ -131,6 +148,12 @@ RuntimeSettings::RuntimeSettings(int argc, const char *argv[])
         std::cout << "Max parallel sims:   " << (max_parallel_sims_ > 0 ? boost::lexical_cast<std::string>(max_parallel_sims_) : "default") << std::endl;
         std::cout << "Simulation delay:    " << simulation_delay_ << " seconds" << std::endl;
         std::cout << "Threads pr sim:      " << boost::lexical_cast<std::string>(threads_per_sim_) << std::endl;
+        std::cout << "Dynamic threads:     " << dynamic_threads_ << std::endl;
+        std::cout << "Write trace:         " << trace_ << std::endl;
+        std::cout << "Async logging:       " << async_logging_ << std::endl;
+        std::cout << "Predict runtimes:    " << predict_runtimes_ << std::endl;
+        std::cout << "Evaluation store:    " << (evaluation_store_.empty() ? "none" : evaluation_store_) << std::endl;
+        std::cout << "Warm start from:     " << (warm_start_.empty() ? "none" : warm_start_) << std::endl;
         str_out = "Current/specified paths:";
         std::cout << "\n" << str_out << "\n" << std::string(str_out.length(),'-') << std::endl;
         std::cout << "Current dir:-------" << GetCurrentDirectoryPath().toStdString() << std::endl;
@@ -185,6 +208,9 @@ po::variables_map RuntimeSettings::createVariablesMap(int argc, const char **arg
          "start max <arg> parallel simulations")
         ("threads-per-simulation,n", po::value<int>(&thr_per_sim)->default_value(1),
          "number of threads allocated to each simulation")
+        ("dynamic-threads", "let the overseer divide the cores of each node between the running simulations (mpisync runner)")
+        ("cores-per-node", po::value<int>()->default_value(0),
+         "number of cores on each node, used with --dynamic-threads (default: detect)")
         ("runner-type,r", po::value<std::string>(),
          "type of runner (serial/oneoff/mpisync)")
         ("grid-path,g", po::value<std::string>(),
@@ -205,6 +231,13 @@ po::variables_map RuntimeSettings::createVariablesMap(int argc, const char **arg
          "path to simulator driver file (e.g. *.DATA)")
         ("simulation-timeout,t", po::value<int>(&simulation_timeout)->default_value(0),
          "Simulations will be terminated after running for t*(lowest_recorded_time)")
+        ("trace", "write a Chrome trace (trace.json) of each process to its output directory")
+        ("async-logging", "write the logs from a background thread instead of on each entry")
+        ("predict-runtimes", "predict simulation times from similar cases; used for per-case timeouts and to start the longest cases first (mpisync runner)")
+        ("evaluation-store", po::value<std::string>(),
+         "path to a file where evaluated cases are stored, and looked up by later runs on the same model")
+        ("warm-start", po::value<std::string>(),
+         "path to the output directory of a previous run; its evaluated cases are used to seed the optimizer")
         ("well-prod-points,p", po::value<std::vector<double>>()->multitoken(),
          "Production well position coordinates")
         ("well-inj-points,i", po::value<std::vector<double>>()->multitoken(),
@@ -241,10 +274,15 @@ map<string, string> RuntimeSettings::GetState() {
     map<string, string> statemap;
     statemap["verbosity"] = boost::lexical_cast<string>(verbosity_level_);
     statemap["Max. parallel sims"] = boost::lexical_cast<string>(max_parallel_sims_);
-    statemap["Threads pr. sim"] = boost::lexical_cast<string>(threads_per_sim_);
+    statemap["Threads pr. sim"] = dynamic_threads_ ? "Dynamic" : boost::lexical_cast<string>(threads_per_sim_);
     statemap["Simulator timeout"] = boost::lexical_cast<string>(simulation_timeout_);
 
     statemap["Overwrite existing files"] = overwrite_existing_ ? "Yes" : "No";
+    statemap["Write trace"] = trace_ ? "Yes" : "No";
+    statemap["Async logging"] = async_logging_ ? "Yes" : "No";
+    statemap["Predict runtimes"] = predict_runtimes_ ? "Yes" : "No";
+    statemap["Evaluation store"] = evaluation_store_.empty() ? "None" : evaluation_store_;
+    statemap["Warm start"] = warm_start_.empty() ? "None" : warm_start_;
 
     switch (runner_type_) {
         case SERIAL: statemap["runner"] = "Serial"; break;
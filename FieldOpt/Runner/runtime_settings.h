@@ -54,8 +54,15 @@ class RuntimeSettings : public Loggable
   bool overwrite_existing() const { return overwrite_existing_; }
   int max_parallel_sims() const { return max_parallel_sims_; }
   int threads_per_sim() const { return threads_per_sim_; }
+  bool dynamic_threads() const { return dynamic_threads_; }
+  int cores_per_node() const { return cores_per_node_; }
   int simulation_timeout() const { return simulation_timeout_; }
   int simulation_delay() const { return simulation_delay_; }
+  bool trace() const { return trace_; }
+  bool async_logging() const { return async_logging_; }
+  bool predict_runtimes() const { return predict_runtimes_; }
+  std::string evaluation_store() const { return evaluation_store_; }
+  std::string warm_start() const { return warm_start_; }
   RunnerType runner_type() const { return runner_type_; }
   QPair<QVector<double>, QVector<double>> prod_coords() const { return prod_coords_; }
   QPair<QVector<double>, QVector<double>> inje_coords() const { return inje_coords_; }
@@ -72,7 +79,14 @@ class RuntimeSettings : public Loggable
   int simulation_delay_; //!< Minimum delay between start of each simulation (in seconds).
   int max_parallel_sims_; //!< Maximum number of parallel simulations to start. This is important to define if you for example have a limited number of simulator licenses.
   int threads_per_sim_; //!< Number of threads to be used pr. simulation. Only works for ADGPRS.
+  bool dynamic_threads_; //!< Whether or not the number of threads pr. simulation should be decided by the overseer (see runners/core_allocator.h).
+  int cores_per_node_; //!< Number of cores on each node, used with dynamic threads. 0 means detect.
   int simulation_timeout_; //!< Simulations will be terminated after running for simulation_timeout_ times the lowest recorded simulation time up to that point.
+  bool trace_; //!< Whether or not to record a Chrome trace of the run (see Utilities/tracing.hpp).
+  bool async_logging_; //!< Whether or not log entries should be written by a background thread (see Utilities/async_writer.hpp).
+  bool predict_runtimes_; //!< Whether or not the overseer should predict simulation times to set timeouts and order the cases (see runners/runtime_predictor.h).
+  std::string evaluation_store_; //!< Path to a file storing evaluated cases across runs (see evaluation_store.h). Empty if not used.
+  std::string warm_start_; //!< Output directory of a previous run to seed the optimizer with (see run_log_reader.h). Empty if not used.
   RunnerType runner_type_; //!< The type of runner to be used (e.g. serial or parallel).
   QPair<QVector<double>, QVector<double>> prod_coords_; //!< The spline coordinates for the production well
   QPair<QVector<double>, QVector<double>> inje_coords_; //!< The spline coordinates for the injection well
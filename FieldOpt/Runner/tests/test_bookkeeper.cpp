@@ -23,6 +23,7 @@
 #include "Optimization/optimizers/compass_search.h"
 #include "Settings/tests/test_resource_example_file_paths.hpp"
 #include "test_resource_runner.hpp"
+#include <cstdio>
 
 namespace {
 
@@ -68,4 +69,42 @@ TEST_F(BookkeeperTest, Bookkeeping) {
     EXPECT_TRUE(bookkeeper_->IsEvaluated(c1));
 }
 
+TEST_F(BookkeeperTest, EvaluationStore) {
+    std::string path = "/tmp/fieldopt_test_bookkeeper_store.txt";
+    std::remove(path.c_str());
+    Runner::EvaluationStore store(path, 42);
+    bookkeeper_->SetEvaluationStore(&store, model_->variables());
+
+    c1->set_objective_function_value(100);
+    c1->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+    bookkeeper_->Record(c1);
+    c1->set_objective_function_value(0);
+    EXPECT_TRUE(bookkeeper_->IsEvaluated(c1, true));
+    EXPECT_DOUBLE_EQ(100, c1->objective_function_value());
+
+    // Cases only evaluated on the coarse model are not recorded
+    c2->SetFidelity(Optimization::Case::COARSE);
+    c2->SetFidelityOfv(Optimization::Case::COARSE, 50);
+    c2->set_objective_function_value(50);
+    c2->state.eval = Optimization::Case::CaseState::EvalStatus::E_DONE;
+    bookkeeper_->Record(c2);
+    EXPECT_FALSE(bookkeeper_->IsEvaluated(c2));
+
+    // Promoted cases are recorded with their fine value, which is found for either fidelity
+    c2->SetFidelity(Optimization::Case::FINE);
+    c2->SetFidelityOfv(Optimization::Case::FINE, 70);
+    c2->set_objective_function_value(70);
+    bookkeeper_->Record(c2);
+    c2->SetFidelity(Optimization::Case::COARSE);
+    c2->set_objective_function_value(0);
+    EXPECT_TRUE(bookkeeper_->IsEvaluated(c2, true));
+    EXPECT_DOUBLE_EQ(70, c2->objective_function_value());
+
+    // Failed cases are not recorded
+    c3->state.eval = Optimization::Case::CaseState::EvalStatus::E_FAILED;
+    bookkeeper_->Record(c3);
+    EXPECT_FALSE(bookkeeper_->IsEvaluated(c3));
+    std::remove(path.c_str());
+}
+
 }
@@ -0,0 +1,83 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/runners/core_allocator.h"
+
+using namespace Runner;
+
+namespace {
+
+class CoreAllocatorTest : public ::testing::Test {
+ protected:
+  CoreAllocatorTest() {
+      // Two nodes with 16 cores and four workers each
+      for (int rank = 1; rank <= 8; ++rank) {
+          allocator_.AddWorker(rank, rank <= 4 ? "node1" : "node2", 16);
+      }
+  }
+  CoreAllocator allocator_;
+};
+
+TEST_F(CoreAllocatorTest, FullQueueSharesNode) {
+    for (int rank = 1; rank <= 4; ++rank) {
+        EXPECT_EQ(4, allocator_.Allocate(rank, 20));
+    }
+    EXPECT_EQ(16, allocator_.ThreadsInUse("node1"));
+    EXPECT_EQ(0, allocator_.ThreadsInUse("node2"));
+}
+
+TEST_F(CoreAllocatorTest, TailGetsFreeCores) {
+    EXPECT_EQ(4, allocator_.Allocate(1, 10));
+    EXPECT_EQ(4, allocator_.Allocate(2, 9));
+    EXPECT_EQ(8, allocator_.Allocate(3, 1)); // Last case: all remaining cores
+    EXPECT_EQ(16, allocator_.ThreadsInUse("node1"));
+    EXPECT_EQ(1, allocator_.Allocate(4, 1)); // Node is full; never less than one thread
+}
+
+TEST_F(CoreAllocatorTest, EarlyFinish) {
+    for (int rank = 1; rank <= 4; ++rank) {
+        EXPECT_EQ(4, allocator_.Allocate(rank, 20));
+    }
+    // One simulation finishes early. The running simulations keep their threads, so the
+    // last case only gets the cores that were freed
+    allocator_.Release(1);
+    EXPECT_EQ(12, allocator_.ThreadsInUse("node1"));
+    EXPECT_EQ(4, allocator_.Allocate(1, 1));
+
+    // Once the others finish, a new case gets the whole node
+    for (int rank = 1; rank <= 4; ++rank) {
+        allocator_.Release(rank);
+    }
+    EXPECT_EQ(16, allocator_.Allocate(2, 1));
+}
+
+TEST_F(CoreAllocatorTest, Release) {
+    EXPECT_EQ(16, allocator_.Allocate(5, 1));
+    allocator_.Release(5);
+    EXPECT_EQ(0, allocator_.ThreadsInUse("node2"));
+    EXPECT_EQ(8, allocator_.Allocate(6, 2));
+}
+
+TEST_F(CoreAllocatorTest, MaxThreads) {
+    CoreAllocator allocator(6);
+    allocator.AddWorker(1, "node", 32);
+    EXPECT_EQ(6, allocator.Allocate(1, 1));
+    EXPECT_THROW(allocator.Allocate(2, 1), std::runtime_error);
+}
+
+}
@@ -0,0 +1,214 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/runners/ensemble_helper.h"
+#include "Optimization/tests/test_resource_optimizer.h"
+#include "Settings/tests/test_resource_example_file_paths.hpp"
+
+using Optimization::Case;
+
+namespace {
+
+class EnsembleHelperTest : public ::testing::Test,
+                           public TestResources::TestResourceOptimizer
+{
+ protected:
+  EnsembleHelperTest() : ensemble_(TestResources::ExampleFilePaths::norne_ensemble_) {
+      ensemble_.SetRacing(3, 0.9);
+      // The incumbent's value on realization k is 100 + 10k
+      incumbent_ = new Case(test_case_2r_);
+      for (int k = 0; k < ensemble_.GetAliases().size(); ++k) {
+          incumbent_->SetRealizationOfv(QString::fromStdString(ensemble_.GetAliases()[k]), 100.0 + 10.0 * k);
+      }
+      incumbent_->set_objective_function_value(incumbent_->GetEnsembleAverageOfv());
+  }
+
+  //! Evaluate a realization of the active case: the incumbent's value plus an offset.
+  void submit(Runner::EnsembleHelper &helper, Case *c, const QHash<QString, double> &offsets) {
+      QString alias = c->GetEnsembleRealization();
+      c->set_objective_function_value(incumbent_->GetRealizationOFVMap()[alias] + offsets[alias]);
+      c->state.eval = Case::CaseState::E_DONE;
+      helper.SubmitEvaluatedRealization(c);
+  }
+
+  //! Offsets with the given mean and an alternating +/- spread across the realizations.
+  QHash<QString, double> offsets(double mean, double spread) {
+      QHash<QString, double> offsets;
+      for (int k = 0; k < ensemble_.GetAliases().size(); ++k) {
+          offsets[QString::fromStdString(ensemble_.GetAliases()[k])] = mean + (k % 2 == 0 ? spread : -spread);
+      }
+      return offsets;
+  }
+
+  Settings::Ensemble ensemble_;
+  Case *incumbent_;
+};
+
+TEST_F(EnsembleHelperTest, ClearLoserStopsEarly) {
+    Runner::EnsembleHelper helper(ensemble_, 0, true);
+    auto c = new Case(test_case_2r_);
+    auto diffs = offsets(-50.0, 1.0);
+    helper.SetActiveCase(c, incumbent_);
+
+    int n_evaluated = 0;
+    while (helper.IsCaseAvailableForEval()) {
+        submit(helper, helper.GetCaseForEval(), diffs);
+        n_evaluated++;
+    }
+    EXPECT_TRUE(helper.IsCaseDone());
+    EXPECT_EQ(3, n_evaluated);
+    EXPECT_EQ(1, helper.NRejectedCases());
+    EXPECT_EQ(5, helper.NSkippedRealizations());
+
+    // The estimate is the incumbent's value plus the mean paired difference
+    auto evaluated = helper.GetEvaluatedCase();
+    EXPECT_EQ(3, evaluated->GetRealizationOFVMap().size());
+    double mean_diff = 0.0;
+    for (auto alias : evaluated->GetRealizationOFVMap().keys()) {
+        mean_diff += diffs[alias] / 3.0;
+    }
+    EXPECT_NEAR(incumbent_->objective_function_value() + mean_diff, evaluated->objective_function_value(), 1e-9);
+}
+
+TEST_F(EnsembleHelperTest, LoserWithRealizationsInFlight) {
+    Runner::EnsembleHelper helper(ensemble_, 0, false); // Minimizing; the case is worse when it is higher
+    auto c = new Case(test_case_2r_);
+    auto diffs = offsets(50.0, 1.0);
+    helper.SetActiveCase(c, incumbent_);
+
+    QList<Case *> dispatched;
+    for (int i = 0; i < 4; ++i) {
+        dispatched.append(helper.GetCaseForEval());
+    }
+    for (int i = 0; i < 3; ++i) {
+        submit(helper, dispatched[i], diffs);
+    }
+    // The remaining queued realizations are dropped, but the one in flight is still awaited
+    EXPECT_FALSE(helper.IsCaseAvailableForEval());
+    EXPECT_FALSE(helper.IsCaseDone());
+    EXPECT_EQ(4, helper.NSkippedRealizations());
+    submit(helper, dispatched[3], diffs);
+    EXPECT_TRUE(helper.IsCaseDone());
+
+    auto evaluated = helper.GetEvaluatedCase();
+    EXPECT_EQ(4, evaluated->GetRealizationOFVMap().size());
+    EXPECT_GT(evaluated->objective_function_value(), incumbent_->objective_function_value());
+}
+
+TEST_F(EnsembleHelperTest, CloseCaseRunsToCompletion) {
+    Runner::EnsembleHelper helper(ensemble_, 0, true);
+    auto c = new Case(test_case_2r_);
+    helper.SetActiveCase(c, incumbent_);
+
+    int n_evaluated = 0;
+    while (helper.IsCaseAvailableForEval()) {
+        submit(helper, helper.GetCaseForEval(), offsets(-0.5, 5.0));
+        n_evaluated++;
+    }
+    EXPECT_EQ(8, n_evaluated);
+    EXPECT_EQ(0, helper.NRejectedCases());
+    EXPECT_EQ(0, helper.NSkippedRealizations());
+
+    auto evaluated = helper.GetEvaluatedCase();
+    EXPECT_EQ(8, evaluated->GetRealizationOFVMap().size());
+    EXPECT_NEAR(incumbent_->objective_function_value() - 0.5, evaluated->objective_function_value(), 1e-9);
+}
+
+TEST_F(EnsembleHelperTest, NoRacingWithoutIncumbent) {
+    Runner::EnsembleHelper helper(ensemble_, 0, true);
+    helper.SetActiveCase(new Case(test_case_2r_));
+
+    int n_evaluated = 0;
+    while (helper.IsCaseAvailableForEval()) {
+        submit(helper, helper.GetCaseForEval(), offsets(-50.0, 1.0));
+        n_evaluated++;
+    }
+    EXPECT_EQ(8, n_evaluated);
+    EXPECT_EQ(0, helper.NRejectedCases());
+}
+
+TEST_F(EnsembleHelperTest, WarmWorkerIsPreferred) {
+    Runner::EnsembleHelper helper(ensemble_, 0, true);
+    helper.SetActiveCase(new Case(test_case_2r_));
+    std::map<std::string, int> worker;
+    while (helper.IsCaseAvailableForEval()) {
+        EXPECT_TRUE(helper.ScheduleNextRealization({1, 2}));
+        auto c = helper.GetCaseForEval();
+        std::string alias = c->GetEnsembleRealization().toStdString();
+        int rank = worker.size() % 2 == 0 ? 1 : 2;
+        worker[alias] = helper.GetAssignedWorker(alias, {rank});
+        submit(helper, c, offsets(0.0, 0.0));
+    }
+    helper.GetEvaluatedCase();
+    EXPECT_EQ(0, helper.NWarmDispatches());
+
+    // Only worker 2 is free: a realization it has evaluated is dispatched next, to it
+    helper.SetActiveCase(new Case(test_case_2r_));
+    EXPECT_TRUE(helper.ScheduleNextRealization({2}));
+    auto c = helper.GetCaseForEval();
+    std::string alias = c->GetEnsembleRealization().toStdString();
+    EXPECT_EQ(2, worker[alias]);
+    EXPECT_EQ(2, helper.GetAssignedWorker(alias, {2}));
+    EXPECT_EQ(1, helper.NWarmDispatches());
+    EXPECT_EQ(9, helper.NDispatches());
+}
+
+TEST_F(EnsembleHelperTest, WarmWorkersMirrorGridCache) {
+    // Each worker keeps the base grid and two realizations
+    ensemble_.SetMaxCachedGrids(3);
+    Runner::EnsembleHelper helper(ensemble_, 0, true);
+    helper.SetActiveCase(new Case(test_case_2r_));
+    std::vector<std::string> order;
+    for (int i = 0; i < 3; ++i) {
+        auto c = helper.GetCaseForEval();
+        order.push_back(c->GetEnsembleRealization().toStdString());
+        EXPECT_EQ(1, helper.GetAssignedWorker(order.back(), {1}));
+        submit(helper, c, offsets(0.0, 0.0));
+    }
+    // The first realization has been released from the worker's cache
+    EXPECT_FALSE(helper.HasAssignedWorkers(order[0]));
+    EXPECT_TRUE(helper.HasAssignedWorkers(order[1]));
+    EXPECT_TRUE(helper.HasAssignedWorkers(order[2]));
+
+    while (helper.IsCaseAvailableForEval()) {
+        auto c = helper.GetCaseForEval();
+        helper.GetAssignedWorker(c->GetEnsembleRealization().toStdString(), {2});
+        submit(helper, c, offsets(0.0, 0.0));
+    }
+    helper.GetEvaluatedCase();
+
+    // A warm realization is dispatched again and becomes the most recently used one, so the
+    // next cold dispatch to the worker releases the other realization
+    helper.SetActiveCase(new Case(test_case_2r_));
+    EXPECT_TRUE(helper.ScheduleNextRealization({1}));
+    auto c = helper.GetCaseForEval();
+    EXPECT_EQ(order[1], c->GetEnsembleRealization().toStdString());
+    EXPECT_EQ(1, helper.GetAssignedWorker(order[1], {1}));
+    submit(helper, c, offsets(0.0, 0.0));
+    EXPECT_EQ(1, helper.NWarmDispatches());
+
+    c = helper.GetCaseForEval();
+    EXPECT_EQ(order[0], c->GetEnsembleRealization().toStdString());
+    EXPECT_EQ(1, helper.GetAssignedWorker(order[0], {1}));
+    submit(helper, c, offsets(0.0, 0.0));
+    EXPECT_TRUE(helper.HasAssignedWorkers(order[0]));
+    EXPECT_TRUE(helper.HasAssignedWorkers(order[1]));
+    EXPECT_FALSE(helper.HasAssignedWorkers(order[2]));
+}
+
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/evaluation_store.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+class EvaluationStoreTest : public ::testing::Test {
+ protected:
+  EvaluationStoreTest() {
+      path_ = "/tmp/fieldopt_test_evaluation_store.txt";
+      std::remove(path_.c_str());
+  }
+  virtual ~EvaluationStoreTest() {
+      std::remove(path_.c_str());
+  }
+
+  std::string path_;
+};
+
+TEST_F(EvaluationStoreTest, Keys) {
+    Runner::EvaluationStore store(path_, 42, 1e-3);
+    EXPECT_EQ(store.Key({1.0, 2.0}), store.Key({1.0001, 1.9999}));
+    EXPECT_NE(store.Key({1.0, 2.0}), store.Key({1.01, 2.0}));
+    EXPECT_NE(store.Key({1.0, 2.0}), store.Key({2.0, 1.0}));
+
+    Runner::EvaluationStore other_model(path_, 43, 1e-3);
+    EXPECT_NE(store.Key({1.0, 2.0}), other_model.Key({1.0, 2.0}));
+}
+
+TEST_F(EvaluationStoreTest, AppendAndLookup) {
+    Runner::EvaluationStore store(path_, 42);
+    double ofv = 0;
+    EXPECT_FALSE(store.Lookup(store.Key({1.0, 2.0}), ofv));
+    store.Append(store.Key({1.0, 2.0}), 123.456);
+    EXPECT_TRUE(store.Lookup(store.Key({1.0, 2.0}), ofv));
+    EXPECT_DOUBLE_EQ(123.456, ofv);
+    EXPECT_EQ(1, store.NumberHits());
+}
+
+TEST_F(EvaluationStoreTest, ReusedAcrossInstances) {
+    {
+        Runner::EvaluationStore store(path_, 42);
+        store.Append(store.Key({1.0}), 1.0 / 3.0);
+        store.Append(store.Key({2.0}), -5e10);
+    }
+    Runner::EvaluationStore reopened(path_, 42);
+    EXPECT_EQ(2, reopened.Size());
+    double ofv = 0;
+    EXPECT_TRUE(reopened.Lookup(reopened.Key({1.0}), ofv));
+    EXPECT_EQ(1.0 / 3.0, ofv); // Stored without loss of precision
+    EXPECT_TRUE(reopened.Lookup(reopened.Key({2.0}), ofv));
+    EXPECT_EQ(-5e10, ofv);
+}
+
+TEST_F(EvaluationStoreTest, PicksUpRecordsFromOtherWriters) {
+    Runner::EvaluationStore first(path_, 42);
+    Runner::EvaluationStore second(path_, 42);
+    second.Append(second.Key({3.0}), 7.0);
+    double ofv = 0;
+    EXPECT_TRUE(first.Lookup(first.Key({3.0}), ofv));
+    EXPECT_EQ(7.0, ofv);
+}
+
+TEST_F(EvaluationStoreTest, SkipsInvalidLines) {
+    {
+        Runner::EvaluationStore store(path_, 42);
+        store.Append(store.Key({1.0}), 1.0);
+    }
+    {
+        std::ofstream file(path_, std::ios::app);
+        file << "0123456789abcdef 2.5 00000000\n"; // Wrong checksum
+        file << "garbage\n";
+        file << "0123456789ab"; // Incomplete line, e.g. from a crash
+    }
+    Runner::EvaluationStore store(path_, 42);
+    EXPECT_EQ(1, store.Size());
+    EXPECT_EQ(2, store.NumberSkipped());
+    double ofv = 0;
+    EXPECT_TRUE(store.Lookup(store.Key({1.0}), ofv));
+}
+
+TEST_F(EvaluationStoreTest, ConcurrentAppends) {
+    Runner::EvaluationStore first(path_, 42);
+    Runner::EvaluationStore second(path_, 42);
+    auto append = [](Runner::EvaluationStore *store, int offset) {
+        for (int i = 0; i < 200; ++i) {
+            store->Append(store->Key({(double)(offset + i)}), offset + i);
+        }
+    };
+    std::thread t1(append, &first, 0);
+    std::thread t2(append, &first, 1000);
+    std::thread t3(append, &second, 2000);
+    t1.join();
+    t2.join();
+    t3.join();
+
+    Runner::EvaluationStore reopened(path_, 42);
+    EXPECT_EQ(600, reopened.Size());
+    EXPECT_EQ(0, reopened.NumberSkipped());
+}
+
+}
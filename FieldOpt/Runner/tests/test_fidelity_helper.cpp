@@ -0,0 +1,106 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/runners/fidelity_helper.h"
+#include "Optimization/case_transfer_object.h"
+#include "Optimization/optimizers/compass_search.h"
+#include "Optimization/tests/test_resource_optimizer.h"
+#include "Reservoir/tests/test_resource_grids.h"
+
+using Optimization::Case;
+
+namespace {
+
+class FidelityHelperTest : public ::testing::Test,
+                           public TestResources::TestResourceOptimizer,
+                           public TestResources::TestResourceGrids
+{
+ protected:
+  FidelityHelperTest() {
+      incumbent_ = make_case(100.0, 90.0);
+  }
+
+  Case *make_case(double coarse, double fine) {
+      auto c = new Case(test_case_2r_);
+      c->SetFidelityOfv(Case::COARSE, coarse);
+      if (fine != 0.0) {
+          c->SetFidelityOfv(Case::FINE, fine);
+          c->set_objective_function_value(fine);
+      }
+      return c;
+  }
+
+  Case *incumbent_; //!< Coarse value 100, fine value 90.
+};
+
+TEST_F(FidelityHelperTest, PromoteWithinMarginMaximize) {
+    Runner::FidelityHelper helper(0.1, true);
+    EXPECT_TRUE(helper.Promote(make_case(120.0, 0.0), incumbent_)); // Better than the incumbent
+    EXPECT_TRUE(helper.Promote(make_case(95.0, 0.0), incumbent_));  // Within the margin (>= 90)
+    EXPECT_TRUE(helper.Promote(make_case(90.0, 0.0), incumbent_));  // At the margin
+
+    auto c = make_case(80.0, 0.0);
+    EXPECT_FALSE(helper.Promote(c, incumbent_));
+    EXPECT_DOUBLE_EQ(80.0 + 90.0 - 100.0, c->objective_function_value());
+    EXPECT_EQ(4, helper.NCoarseEvaluations());
+    EXPECT_EQ(3, helper.NPromoted());
+}
+
+TEST_F(FidelityHelperTest, PromoteWithinMarginMinimize) {
+    Runner::FidelityHelper helper(0.1, false);
+    EXPECT_TRUE(helper.Promote(make_case(80.0, 0.0), incumbent_));
+    EXPECT_TRUE(helper.Promote(make_case(110.0, 0.0), incumbent_));
+
+    auto c = make_case(120.0, 0.0);
+    EXPECT_FALSE(helper.Promote(c, incumbent_));
+    EXPECT_DOUBLE_EQ(120.0 + 90.0 - 100.0, c->objective_function_value());
+}
+
+TEST_F(FidelityHelperTest, NoMargin) {
+    Runner::FidelityHelper helper(0.0, true);
+    EXPECT_TRUE(helper.Promote(make_case(100.0, 0.0), incumbent_));
+    EXPECT_FALSE(helper.Promote(make_case(99.9, 0.0), incumbent_));
+}
+
+TEST_F(FidelityHelperTest, PromoteWithoutIncumbentValues) {
+    // The incumbent has only been evaluated on the coarse model
+    Runner::FidelityHelper helper(0.0, true);
+    auto c = make_case(10.0, 0.0);
+    EXPECT_TRUE(helper.Promote(c, make_case(100.0, 0.0)));
+    EXPECT_EQ(1, helper.NPromoted());
+}
+
+TEST_F(FidelityHelperTest, SubmittedCaseKeepsFidelityValues) {
+    // With the MPI runners, the evaluated case is a copy of the case in the case handler
+    auto optimizer = new Optimization::Optimizers::CompassSearch(
+        settings_compass_search_min_unconstr_, incumbent_, varcont_prod_bhp_, grid_5spot_, logger_);
+    auto c = optimizer->GetCaseForEvaluation();
+    Optimization::CaseTransferObject cto(c);
+    auto evaluated = cto.CreateCase();
+    evaluated->SetFidelityOfv(Case::COARSE, 95.0);
+    evaluated->SetFidelityOfv(Case::FINE, 85.0);
+    evaluated->set_objective_function_value(85.0);
+    evaluated->state.eval = Case::CaseState::E_DONE;
+    optimizer->SubmitEvaluatedCase(evaluated);
+
+    auto stored = optimizer->case_handler()->GetCase(c->id());
+    EXPECT_DOUBLE_EQ(95.0, stored->GetFidelityOfv(Case::COARSE));
+    EXPECT_DOUBLE_EQ(85.0, stored->GetFidelityOfv(Case::FINE));
+}
+
+}
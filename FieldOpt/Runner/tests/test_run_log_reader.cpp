@@ -0,0 +1,76 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/run_log_reader.h"
+#include "Model/tests/test_resource_variable_property_container.h"
+#include <QDir>
+#include <fstream>
+
+namespace {
+
+class RunLogReaderTest : public ::testing::Test,
+                         public TestResources::TestResourceVariablePropertyContainer
+{
+ protected:
+  RunLogReaderTest() {
+      dir_ = "/tmp/fieldopt_test_run_log_reader";
+      QDir().mkpath(QString::fromStdString(dir_));
+      std::ofstream cases(dir_ + "/log_cases.csv");
+      cases << "             TimeSt , EvalSt , ConsSt , ErrMsg ,   SimDur ,   WicDur ,       OFnVal ,                                 CaseId\n";
+      cases << "2019-01-01 00:00:00 ,   OKAY ,   OKAY ,   OKAY , 00:00:10 , 00:00:00 , 1.000000e+02 ,{11111111-1111-1111-1111-111111111111}\n";
+      cases << "2019-01-01 00:00:10 ,   OKAY ,   OKAY ,   OKAY , 00:00:10 , 00:00:00 , 2.500000e+02 ,{22222222-2222-2222-2222-222222222222}\n";
+      cases << "2019-01-01 00:00:20 ,   FAIL ,   OKAY ,   SIML , 00:00:10 , 00:00:00 , 1.000000e-04 ,{33333333-3333-3333-3333-333333333333}\n";
+      cases << "2019-01-01 00:00:30 ,   BKPD ,   OKAY ,   OKAY , 00:00:00 , 00:00:00 , 2.500000e+02 ,{44444444-4444-4444-4444-444444444444}\n";
+      cases << "2019-01-01 00:00:40 ,   OKAY ,   OKAY ,   OKAY , 00:00:10 , 00:00:00 , 3.000000e+02 ,{55555555-5555-5555-5555-555555555555}\n";
+      cases.close();
+      std::ofstream ext(dir_ + "/log_extended.json");
+      ext << "{\"Cases\": [\n";
+      ext << "{\"UUID\":\"{11111111-1111-1111-1111-111111111111}\",\"Variables\":[{\"Var#BHP#PRODUCER#0\":1.5},{\"Var#BHP#PRODUCER#10\":2.5}],\"ProductionData\":[],\"COMPDAT\":\"\"},\n";
+      ext << "{\"UUID\":\"{22222222-2222-2222-2222-222222222222}\",\"Variables\":[{\"Var#BHP#PRODUCER#0\":3.0},{\"Var#BHP#PRODUCER#10\":4.0}],\"ProductionData\":[],\"COMPDAT\":\"\"},\n";
+      ext << "{\"UUID\":\"{33333333-3333-3333-3333-333333333333}\",\"Variables\":[{\"Var#BHP#PRODUCER#0\":5.0},{\"Var#BHP#PRODUCER#10\":6.0}],\"ProductionData\":[],\"COMPDAT\":\"\"},\n";
+      ext << "{\"UUID\":\"{44444444-4444-4444-4444-444444444444}\",\"Variables\":[{\"Var#BHP#PRODUCER#0\":3.0},{\"Var#BHP#PRODUCER#10\":4.0}],\"ProductionData\":[],\"COMPDAT\":\"\"},\n";
+      ext << "{\"UUID\":\"{55555555-5555-5555-5555-555555555555}\",\"Variables\":[{\"Var#BHP#PRODUCER#0\":7.0}],\"ProductionData\":[],\"COMPDAT\":\"\"}\n";
+      ext << "]}\n";
+  }
+  virtual ~RunLogReaderTest() {
+      QDir(QString::fromStdString(dir_)).removeRecursively();
+  }
+
+  std::string dir_;
+};
+
+TEST_F(RunLogReaderTest, Cases) {
+    Runner::RunLogReader reader(dir_);
+    EXPECT_EQ(5, reader.NumberRecords());
+
+    // The failed case, the bookkeeped duplicate and the case lacking a variable are skipped
+    auto cases = reader.Cases(varcont_prod_bhp_);
+    ASSERT_EQ(2, cases.size());
+    EXPECT_DOUBLE_EQ(100.0, cases[0]->objective_function_value());
+    EXPECT_DOUBLE_EQ(250.0, cases[1]->objective_function_value());
+    EXPECT_DOUBLE_EQ(1.5, cases[0]->real_variables()[prod_bhp_0_->id()]);
+    EXPECT_DOUBLE_EQ(2.5, cases[0]->real_variables()[prod_bhp_10_->id()]);
+    EXPECT_DOUBLE_EQ(3.0, cases[1]->real_variables()[prod_bhp_0_->id()]);
+    EXPECT_DOUBLE_EQ(4.0, cases[1]->real_variables()[prod_bhp_10_->id()]);
+}
+
+TEST_F(RunLogReaderTest, MissingLogs) {
+    EXPECT_THROW(Runner::RunLogReader("/tmp/fieldopt_test_run_log_reader_missing"), std::runtime_error);
+}
+
+}
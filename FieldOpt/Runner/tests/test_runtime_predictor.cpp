@@ -0,0 +1,80 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Runner/runners/runtime_predictor.h"
+
+using namespace Runner;
+
+namespace {
+
+class RuntimePredictorTest : public ::testing::Test {
+ protected:
+  RuntimePredictorTest() : predictor_(2, 100) {}
+  RuntimePredictor predictor_;
+};
+
+TEST_F(RuntimePredictorTest, NoObservations) {
+    EXPECT_EQ(-1, predictor_.Predict("r1", {0.0, 0.0}));
+}
+
+TEST_F(RuntimePredictorTest, NearestNeighbours) {
+    // Simulation time grows with the first variable; the second variable is noise on a larger scale
+    for (int i = 0; i <= 10; ++i) {
+        predictor_.AddObservation("r1", {(double)i, 1000.0 * (i % 3)}, 10.0 * i);
+    }
+    EXPECT_NEAR(0.0, predictor_.Predict("r1", {0.0, 0.0}), 1e-3);
+    EXPECT_NEAR(100.0, predictor_.Predict("r1", {10.0, 1000.0}), 1e-3);
+    double between = predictor_.Predict("r1", {8.5, 1500.0});
+    EXPECT_GT(between, 40.0);
+    EXPECT_LT(between, 100.0);
+}
+
+TEST_F(RuntimePredictorTest, Groups) {
+    predictor_.AddObservation("r1", {0.0}, 10.0);
+    predictor_.AddObservation("r2", {0.0}, 100.0);
+    EXPECT_NEAR(10.0, predictor_.Predict("r1", {0.0}), 1e-3);
+    EXPECT_NEAR(100.0, predictor_.Predict("r2", {0.0}), 1e-3);
+    EXPECT_NEAR(55.0, predictor_.Predict("r3", {0.0}), 1e-3); // Unknown group: all observations
+}
+
+TEST_F(RuntimePredictorTest, MismatchedFeatures) {
+    predictor_.AddObservation("r1", {0.0, 1.0}, 10.0);
+    predictor_.AddObservation("r1", {5.0, 1.0}, 30.0);
+    EXPECT_NEAR(20.0, predictor_.Predict("r1", {}), 1e-9);
+    EXPECT_NEAR(20.0, predictor_.Predict("r1", {1.0}), 1e-9);
+}
+
+TEST_F(RuntimePredictorTest, KeepsRecentObservations) {
+    RuntimePredictor predictor(1, 3);
+    for (int i = 0; i < 5; ++i) {
+        predictor.AddObservation("r1", {(double)i}, i);
+    }
+    EXPECT_EQ(3, predictor.NumberOfObservations());
+    EXPECT_NEAR(2.0, predictor.Predict("r1", {0.0}), 1e-9);
+}
+
+TEST_F(RuntimePredictorTest, Errors) {
+    EXPECT_EQ(0.0, predictor_.MeanRelativeError());
+    predictor_.RecordError(12.0, 10.0);
+    predictor_.RecordError(5.0, 10.0);
+    EXPECT_EQ(2, predictor_.NumberOfPredictionsChecked());
+    EXPECT_NEAR(3.5, predictor_.MeanAbsoluteError(), 1e-9);
+    EXPECT_NEAR(0.35, predictor_.MeanRelativeError(), 1e-9);
+}
+
+}
@@ -22,6 +22,7 @@
 #include <boost/algorithm/string/trim.hpp>
 #include "ensemble.h"
 #include "Utilities/filehandling.hpp"
+#include <stdexcept>
 namespace Settings {
 
 using namespace Utilities::FileHandling;
@@ -106,5 +107,19 @@ int Ensemble::NSelect() const {
 void Ensemble::SetNSelect(const int n) {
     n_select_ = n;
 }
+void Ensemble::SetRacing(const int min_realizations, const double confidence) {
+    if (min_realizations < 2)
+        throw std::runtime_error("At least two realizations must be evaluated before a case can be rejected by racing.");
+    if (confidence <= 0.5 || confidence >= 1.0)
+        throw std::runtime_error("The racing confidence level must be between 0.5 and 1.");
+    racing_ = true;
+    racing_min_realizations_ = min_realizations;
+    racing_confidence_ = confidence;
+}
+void Ensemble::SetMaxCachedGrids(const int n) {
+    if (n != 0 && n < 2)
+        throw std::runtime_error("MaxCachedGrids must be 0 (unbounded) or at least 2 (the base grid and one realization).");
+    max_cached_grids_ = n;
+}
 
 }
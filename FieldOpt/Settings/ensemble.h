@@ -94,11 +94,36 @@ class Ensemble {
 
   int NSelect() const;
   void SetNSelect(const int n);
+
+  /*!
+   * @brief Enable racing: realizations are evaluated incrementally, and the remaining
+   * realizations for a case are dropped once the case is statistically worse than the
+   * incumbent.
+   * @param min_realizations Minimum number of evaluated realizations before a case can be rejected.
+   * @param confidence Confidence level of the one-sided test used to reject cases (e.g. 0.9).
+   */
+  void SetRacing(const int min_realizations, const double confidence);
+  bool IsRacing() const { return racing_; }
+  int RacingMinRealizations() const { return racing_min_realizations_; }
+  double RacingConfidence() const { return racing_confidence_; }
+
+  /*!
+   * @brief Bound the number of grids each worker keeps loaded. When the bound is
+   * reached, the least recently used grid is released. The scheduler uses the same
+   * bound to track which realizations are warm on which worker.
+   * @param n Maximum number of cached grids per worker, including the base grid. 0 means unbounded.
+   */
+  void SetMaxCachedGrids(const int n);
+  int MaxCachedGrids() const { return max_cached_grids_; }
   const Realization &GetRealization(const std::string &alias) const;
   std::vector<std::string> GetAliases() const;
 
  private:
   int n_select_; //!< Number of realizations to be selected for each evaluation. Will be set to all if not specified in driver.
+  bool racing_ = false; //!< Whether racing is used to stop evaluating realizations for losing cases early.
+  int racing_min_realizations_ = 5;
+  double racing_confidence_ = 0.9;
+  int max_cached_grids_ = 0; //!< Maximum number of grids cached per worker. 0 means unbounded.
   std::string ensemble_parent_dir_;
   std::map<std::string, Realization> realizations_;
 
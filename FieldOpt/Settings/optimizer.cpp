@@ -36,11 +36,14 @@ Optimizer::Optimizer(QJsonObject json_optimizer)
 
     if (type_ != ExhaustiveSearch2DVert) {
         mode_ = parseMode(json_optimizer);
-        if (type_ == Hybrid) {
+        if (type_ == Hybrid || type_ == Portfolio) {
             hybrid_components_ = parseHybridComponents(json_optimizer);
         }
-        parameters_ = parseParameters(json_parameters);
     }
+    else if (json_optimizer.contains("Mode")) { // Only used to rank the columns in the coarse-to-fine mode
+        mode_ = parseMode(json_optimizer);
+    }
+    parameters_ = parseParameters(json_parameters);
     objective_ = parseObjective(json_objective);
 
 
@@ -192,9 +195,9 @@ Optimizer::Constraint Optimizer::parseSingleConstraint(QJsonObject json_constrai
             optimizer_constraint.min = json_constraint["MinDistance"].toDouble();
             optimizer_constraint.min_distance = json_constraint["MinDistance"].toDouble();
         }
-        if (optimizer_constraint.wells.length() != 2)
+        if (optimizer_constraint.wells.length() < 2)
             throw UnableToParseOptimizerConstraintsSectionException("WellSplineInterwellDistance constraint"
-                                                                    " needs a Wells array with exactly two well names specified.");
+                                                                    " needs a Wells array with at least two well names specified.");
     }
     else if (QString::compare(constraint_type, "PolarAzimuth") == 0 || QString::compare(constraint_type, "PolarElevation") == 0){
         if (constraint_type == "PolarAzimuth") {
@@ -247,9 +250,9 @@ Optimizer::Constraint Optimizer::parseSingleConstraint(QJsonObject json_constrai
         optimizer_constraint.max_length = json_constraint["MaxLength"].toDouble();
         optimizer_constraint.min_distance = json_constraint["MinDistance"].toDouble();
         optimizer_constraint.max_iterations = json_constraint["MaxIterations"].toInt();
-        if (optimizer_constraint.wells.length() != 2)
+        if (optimizer_constraint.wells.length() < 2)
             throw UnableToParseOptimizerConstraintsSectionException("WellSplineInterwellDistance constraint"
-                                                                    " needs a Wells array with exactly two well names specified.");
+                                                                    " needs a Wells array with at least two well names specified.");
     }
     else if (QString::compare(constraint_type, "CombinedWellSplineLengthInterwellDistanceReservoirBoundary") == 0) {
         optimizer_constraint.type = ConstraintType::CombinedWellSplineLengthInterwellDistanceReservoirBoundary;
@@ -263,9 +266,9 @@ Optimizer::Constraint Optimizer::parseSingleConstraint(QJsonObject json_constrai
         optimizer_constraint.box_jmax = json_constraint["BoxJmax"].toInt();
         optimizer_constraint.box_kmin = json_constraint["BoxKmin"].toInt();
         optimizer_constraint.box_kmax = json_constraint["BoxKmax"].toInt();
-        if (optimizer_constraint.wells.length() != 2)
+        if (optimizer_constraint.wells.length() < 2)
             throw UnableToParseOptimizerConstraintsSectionException(
-                "WellSplineInterwellDistanceReservoirBoundary constraint needs a Wells array with exactly two well names specified.");
+                "WellSplineInterwellDistanceReservoirBoundary constraint needs a Wells array with at least two well names specified.");
     }
     else throw UnableToParseOptimizerConstraintsSectionException("Constraint type " + constraint_type.toStdString() + " not recognized.");
     return optimizer_constraint;
@@ -313,6 +316,8 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
         if (json_parameters.contains("Pattern"))
             params.pattern = json_parameters["Pattern"].toString();
         else params.pattern = "Compass";
+        if (json_parameters.contains("CancelObsoleteCases"))
+            params.cancel_obsolete_cases = json_parameters["CancelObsoleteCases"].toBool();
 
         // GA parameters
         if (json_parameters.contains("MaxGenerations"))
@@ -342,6 +347,25 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
         if (json_parameters.contains("UpperBound"))
             params.upper_bound = json_parameters["UpperBound"].toDouble();
         else params.upper_bound = 10;
+        if (json_parameters.contains("Screening")) {
+            QStringList available_modes = { "None", "Order", "TopK" };
+            if (available_modes.contains(json_parameters["Screening"].toString())) {
+                params.screening = json_parameters["Screening"].toString().toStdString();
+            }
+            else {
+                Printer::error("Screening mode " + json_parameters["Screening"].toString().toStdString() + " not recognized.");
+                Printer::info("Available screening modes: " + available_modes.join(", ").toStdString());
+                throw std::runtime_error("Failed reading screening settings.");
+            }
+        }
+        if (json_parameters.contains("Screening-TopK"))
+            params.screening_top_k = json_parameters["Screening-TopK"].toInt();
+        if (json_parameters.contains("Screening-MaxSamples"))
+            params.screening_max_samples = json_parameters["Screening-MaxSamples"].toInt();
+        if (json_parameters.contains("CompactCaseHistory"))
+            params.compact_case_history = json_parameters["CompactCaseHistory"].toInt();
+        if (json_parameters.contains("SteadyState"))
+            params.steady_state = json_parameters["SteadyState"].toBool();
 
         // PSO parameters
         if(json_parameters.contains("PSO-LearningFactor1")){
@@ -395,10 +419,56 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
             }
         }
 
+        // ExhaustiveSearch2DVert parameters
+        if (json_parameters.contains("Exhaustive-Stride")) {
+            if (json_parameters["Exhaustive-Stride"].toInt() >= 1) {
+                params.exhaustive_stride = json_parameters["Exhaustive-Stride"].toInt();
+            }
+            else {
+                throw std::runtime_error("Invalid value for setting Exhaustive-Stride");
+            }
+        }
+        if (json_parameters.contains("Exhaustive-RefineTop")) {
+            params.exhaustive_refine_top = json_parameters["Exhaustive-RefineTop"].toInt();
+        }
+        if (json_parameters.contains("Exhaustive-SkipInactive")) {
+            params.exhaustive_skip_inactive = json_parameters["Exhaustive-SkipInactive"].toBool();
+        }
+
         // CMA-ES Parameters
         if (json_parameters.contains("ImproveBaseCase")) {
             params.improve_base_case = json_parameters["ImproveBaseCase"].toBool();
         }
+        if (json_parameters.contains("CMA-ES-RestartStrategy")) {
+            QStringList available_strategies = { "None", "IPOP", "BIPOP" };
+            if (available_strategies.contains(json_parameters["CMA-ES-RestartStrategy"].toString())) {
+                params.cma_es_restart_strategy = json_parameters["CMA-ES-RestartStrategy"].toString().toStdString();
+            }
+            else {
+                Printer::error("CMA-ES-RestartStrategy " + json_parameters["CMA-ES-RestartStrategy"].toString().toStdString() + " not recognized.");
+                Printer::info("Available restart strategies: " + available_strategies.join(", ").toStdString());
+                throw std::runtime_error("Failed reading CMA-ES settings.");
+            }
+        }
+        if (json_parameters.contains("CMA-ES-MaxRestarts")) {
+            params.cma_es_max_restarts = json_parameters["CMA-ES-MaxRestarts"].toInt();
+        }
+        if (json_parameters.contains("CMA-ES-IncPopSize")) {
+            params.cma_es_inc_pop_size = json_parameters["CMA-ES-IncPopSize"].toDouble();
+            if (params.cma_es_inc_pop_size < 1.0)
+                throw std::runtime_error("CMA-ES-IncPopSize must be at least 1.");
+        }
+        if (json_parameters.contains("CMA-ES-Sampling")) {
+            QStringList available_methods = { "Random", "Mirrored", "Orthogonal" };
+            if (available_methods.contains(json_parameters["CMA-ES-Sampling"].toString())) {
+                params.cma_es_sampling = json_parameters["CMA-ES-Sampling"].toString().toStdString();
+            }
+            else {
+                Printer::error("CMA-ES-Sampling " + json_parameters["CMA-ES-Sampling"].toString().toStdString() + " not recognized.");
+                Printer::info("Available sampling methods: " + available_methods.join(", ").toStdString());
+                throw std::runtime_error("Failed reading CMA-ES settings.");
+            }
+        }
 
         // VFSA Parameters
         if (json_parameters.contains("VFSA-EvalsPrIteration")) {
@@ -416,6 +486,15 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
         if (json_parameters.contains("VFSA-TempScale")) {
             params.vfsa_temp_scale = json_parameters["VFSA-TempScale"].toDouble();
         }
+        if (json_parameters.contains("VFSA-Chains")) {
+            params.vfsa_chains = json_parameters["VFSA-Chains"].toInt();
+        }
+        if (json_parameters.contains("VFSA-TempLadder")) {
+            params.vfsa_temp_ladder = json_parameters["VFSA-TempLadder"].toDouble();
+        }
+        if (json_parameters.contains("VFSA-SwapInterval")) {
+            params.vfsa_swap_interval = json_parameters["VFSA-SwapInterval"].toInt();
+        }
 
         // SPSA Parameters
         if (json_parameters.contains("SPSA-MaxIterations")) {
@@ -439,6 +518,35 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
         if (json_parameters.contains("SPSA-InitStepMagnitude")) {
             params.spsa_init_step_magnitude = json_parameters["SPSA-InitStepMagnitude"].toDouble();
         }
+        if (json_parameters.contains("SPSA-BatchSize")) {
+            params.spsa_batch_size = json_parameters["SPSA-BatchSize"].toInt();
+        }
+        if (json_parameters.contains("SPSA-Hessian")) {
+            params.spsa_hessian = json_parameters["SPSA-Hessian"].toBool();
+        }
+        if (json_parameters.contains("SPSA-StepCandidates")) {
+            params.spsa_step_candidates = json_parameters["SPSA-StepCandidates"].toInt();
+        }
+
+        // LBFGSB parameters
+        if (json_parameters.contains("LBFGSB-MaxIterations")) {
+            params.lbfgsb_max_iterations = json_parameters["LBFGSB-MaxIterations"].toInt();
+        }
+        if (json_parameters.contains("LBFGSB-Memory")) {
+            params.lbfgsb_memory = json_parameters["LBFGSB-Memory"].toInt();
+        }
+        if (json_parameters.contains("LBFGSB-FDStep")) {
+            params.lbfgsb_fd_step = json_parameters["LBFGSB-FDStep"].toDouble();
+        }
+        if (json_parameters.contains("LBFGSB-CentralDifferences")) {
+            params.lbfgsb_central_differences = json_parameters["LBFGSB-CentralDifferences"].toBool();
+        }
+        if (json_parameters.contains("LBFGSB-StepCandidates")) {
+            params.lbfgsb_step_candidates = json_parameters["LBFGSB-StepCandidates"].toInt();
+        }
+        if (json_parameters.contains("LBFGSB-ProjGradTolerance")) {
+            params.lbfgsb_proj_grad_tolerance = json_parameters["LBFGSB-ProjGradTolerance"].toDouble();
+        }
 
 
         // Hybrid parameters
@@ -467,6 +575,25 @@ Optimizer::Parameters Optimizer::parseParameters(QJsonObject &json_parameters) {
             }
         }
 
+        // Portfolio parameters
+        if (json_parameters.contains("PortfolioWindow")) {
+            if (json_parameters["PortfolioWindow"].toInt() >= 1) {
+                params.portfolio_window = json_parameters["PortfolioWindow"].toInt();
+            }
+            else {
+                throw std::runtime_error("Invalid value for setting PortfolioWindow");
+            }
+        }
+        if (json_parameters.contains("PortfolioMinShare")) {
+            double min_share = json_parameters["PortfolioMinShare"].toDouble();
+            if (min_share >= 0.0 && min_share <= 1.0) {
+                params.portfolio_min_share = min_share;
+            }
+            else {
+                throw std::runtime_error("Invalid value for setting PortfolioMinShare");
+            }
+        }
+
 
         // RNG seed
         if (json_parameters.contains("RNGSeed")) {
@@ -601,12 +728,17 @@ Optimizer::OptimizerType Optimizer::parseType(QString &type) {
         opt_type = OptimizerType::SPSA;
     else if (QString::compare(type, "Hybrid") == 0)
         opt_type = OptimizerType::Hybrid;
+    else if (QString::compare(type, "Portfolio") == 0)
+        opt_type = OptimizerType::Portfolio;
+    else if (QString::compare(type, "LBFGSB") == 0)
+        opt_type = OptimizerType::LBFGSB;
     else throw OptimizerTypeNotRecognizedException("The optimizer type " + type.toStdString() + " was not recognized.");
     return opt_type;
 }
 QList<Optimizer::HybridComponent> Optimizer::parseHybridComponents(QJsonObject &json_optimizer) {
     QList<HybridComponent> comps;
-    for (auto json_comp : json_optimizer["HybridComponents"].toArray()) {
+    QString key = type_ == Portfolio ? "PortfolioComponents" : "HybridComponents";
+    for (auto json_comp : json_optimizer[key].toArray()) {
         HybridComponent comp;
         QString type = json_comp.toObject()["Type"].toString();
         QJsonObject json_params = json_comp.toObject()["Parameters"].toObject();
@@ -40,7 +40,7 @@ class Optimizer
  public:
   Optimizer(){}
   Optimizer(QJsonObject json_optimizer);
-  enum OptimizerType { Compass, APPS, ExhaustiveSearch2DVert, GeneticAlgorithm, EGO, PSO, VFSA, SPSA, Hybrid, CMA_ES };
+  enum OptimizerType { Compass, APPS, ExhaustiveSearch2DVert, GeneticAlgorithm, EGO, PSO, VFSA, SPSA, Hybrid, CMA_ES, Portfolio, LBFGSB };
   enum OptimizerMode { Maximize, Minimize };
   enum ConstraintType { BHP, Rate, SplinePoints,
     WellSplineLength, WellSplineInterwellDistance, WellSplineDomain,
@@ -58,6 +58,11 @@ class Optimizer
     // Common parameters
     int max_evaluations; //!< Maximum number of evaluations allowed before terminating the optimization run.
     int rng_seed;        //!< Seed to be used for random number renerators in relevant algorithms.
+    int parallel_evaluations = 1; //!< Number of cases that can be evaluated concurrently. Set by the runner, not read from the driver file.
+    std::string screening = "None"; //!< Surrogate pre-screening of queued cases: None, Order or TopK. Default: None.
+    int screening_top_k = -1;        //!< Number of cases to forward per batch when screening with TopK. Default: max(parallel evaluations, half the batch).
+    int screening_max_samples = 300; //!< Maximum number of evaluated cases to fit the screening surrogate to. Default: 300.
+    int compact_case_history = 0; //!< Drop the variable values of superseded cases every this many evaluations, keeping this many recent ones intact. Default: 0 (off).
 
     // GSS parameters
     double initial_step_length; //!< The initial step length in the algorithm when applicable.
@@ -69,6 +74,7 @@ class Optimizer
     double auto_step_init_scale = 0.25; //!< Scaling factor for auto-determined initial step lengths (e.g. 0.25*(upper-lower)
     double auto_step_conv_scale = 0.01; //!< Scaling factor for auto-determined convergence step lengths (e.g. 0.01*(upper-lower)
     QString pattern;                     //!< The pattern to be used for GSS algorithms.
+    bool cancel_obsolete_cases = false; //!< Cancel queued and running polls that become obsolete when APPS finds an improvement.
 
     // GA parameters
     int max_generations;      //!< Max iterations. Default: 50
@@ -80,6 +86,7 @@ class Optimizer
     double stagnation_limit;  //!< Stagnation limit. Default: 1e-10.
     double lower_bound;       //!< Simple lower bound. This is applied to _all_ variables. Default: -10.0.
     double upper_bound;       //!< Simple upper bound. This is applied to _all_ variables. Default: +10.0.
+    bool steady_state = false; //!< Use the asynchronous steady-state variant of the GA or PSO, issuing a new case for each returned one. Default: false.
 
     // PSO parameters
     double pso_learning_factor_1; //!< Learning factor (c1), from the swarms best known perturbation. Default: 2
@@ -99,9 +106,29 @@ class Optimizer
     bool vfsa_parallel = false;      //!< Run generate evals_pr_iteration cases immedeately in each generation? Default: false.
     double vfsa_init_temp = 1.0;     //!< Initial temperature (same used for all dimensions). Default: 1.0.
     double vfsa_temp_scale = 1.0;    //!< Constant used in scaling temperature. Default: 1.0.
+    int vfsa_chains = 1;             //!< Number of concurrent annealing chains (parallel tempering). 0: one per parallel evaluation. Default: 1.
+    double vfsa_temp_ladder = 10.0;  //!< Ratio between the temperatures of the hottest and the coldest chain. Default: 10.0.
+    int vfsa_swap_interval = 0;      //!< Number of evaluations between attempts to swap the states of neighbouring chains. 0: the number of chains. Default: 0.
+
+    // LBFGSB Parameters
+    int lbfgsb_max_iterations = 50;        //!< Maximum number of iterations (gradient evaluations). Default: 50.
+    int lbfgsb_memory = 5;                 //!< Number of correction pairs kept for the quasi-Newton approximation. Default: 5.
+    double lbfgsb_fd_step = 1e-3;          //!< Finite-difference step, relative to the range between the bounds. Default: 1e-3.
+    bool lbfgsb_central_differences = true; //!< Use central (2n cases) instead of forward (n cases) differences. Default: true.
+    int lbfgsb_step_candidates = 4;        //!< Number of step lengths evaluated in parallel in each line search. 0: one per parallel evaluation. Default: 4.
+    double lbfgsb_proj_grad_tolerance = 1e-6; //!< Terminate when the infinity norm of the projected gradient is below this. Default: 1e-6.
+
+    // ExhaustiveSearch2DVert parameters
+    int exhaustive_stride = 1;            //!< Stride of the first sweep over the columns. Greater than 1 enables the coarse-to-fine mode. Default: 1.
+    int exhaustive_refine_top = 5;        //!< Number of best columns from the coarse sweep refined at full resolution. Default: 5.
+    bool exhaustive_skip_inactive = true; //!< Skip columns with no active cells. Default: true.
 
     // CMA-ES Parameters
     bool improve_base_case = false;
+    std::string cma_es_restart_strategy = "None"; //!< Restart strategy when a run stagnates: None, IPOP or BIPOP. Default: None.
+    int cma_es_max_restarts = 9;       //!< Maximum number of restarts when using IPOP or BIPOP. Default: 9.
+    double cma_es_inc_pop_size = 2.0;  //!< Factor by which the population size grows for each (large) restart. Default: 2.
+    std::string cma_es_sampling = "Random"; //!< How offspring are sampled: Random, Mirrored or Orthogonal. Default: Random.
 
     // SPSA Parameters
     int spsa_max_iterations = 50; //!< Maximum number of iterations to be performed. Default: 50.
@@ -111,6 +138,9 @@ class Optimizer
     double spsa_A = 5;            //!< Affects step length in early iterations. Default: 10% of max iterations.
     double spsa_a = 0.0;          //!< Affects step lengths. Default and recommended: automatically compute from spsa_init_step_magnitude.
     double spsa_init_step_magnitude = 0.0; //!< Smallest desired step magnitude in early iterations.
+    int spsa_batch_size = 1;      //!< Number of perturbation pairs per iteration; their gradient estimates are averaged. 0: fit the number of parallel evaluations. Default: 1.
+    bool spsa_hessian = false;    //!< Also estimate the Hessian from the perturbation pairs and take Newton-type steps (2SPSA). Default: false.
+    int spsa_step_candidates = 0; //!< Number of step lengths to evaluate in parallel along each step direction. 0: take the step without evaluating it. Default: 0.
 
     // Hybrid parameters
     /*!
@@ -144,11 +174,28 @@ class Optimizer
      * Example: "Optimizer": { "Type": "Hybrid", "Parameters": { "HybridMaxIterations": 2 } }
      */
     int hybrid_max_iterations = 2;
+
+    // Portfolio parameters
+    /*!
+     * @brief Number of recent evaluations of each component used to compute its improvement
+     * rate, which decides the share of the free workers it gets.
+     *
+     * Example: "Optimizer": { "Type": "Portfolio", "Parameters": { "PortfolioWindow": 20 } }
+     */
+    int portfolio_window = 20;
+
+    /*!
+     * @brief Smallest share of the free workers given to a component with queued cases,
+     * regardless of its improvement rate, so that no component is starved.
+     *
+     * Example: "Optimizer": { "Type": "Portfolio", "Parameters": { "PortfolioMinShare": 0.1 } }
+     */
+    double portfolio_min_share = 0.1;
   };
 
   struct Objective {
     ObjectiveType type; //!< The objective definition type (e.g. WeightedSum, NPV)
-    bool use_penalty_function; //!< Whether or not to use penalty function (default: false).
+    bool use_penalty_function = false; //!< Whether or not to use penalty function (default: false).
     bool use_well_cost; //!<Whether or not to use costs associated to wells in calculation of the objective.
     bool separatehorizontalandvertical; //!<Whether or not to use different values in the horizontal or vertical direction
     double wellCostXY; //!<Cost associated with drilling in the horizontal plane [$/m]
@@ -205,8 +252,9 @@ class Optimizer
   Parameters parameters() const { return parameters_; } //!< Get the optimizer parameters.
   Objective objective() const { return objective_; } //!< Get the optimizer objective function.
   QList<Constraint> constraints() const { return constraints_; } //!< Get the optimizer constraints.
-  QList<HybridComponent> HybridComponents() { return hybrid_components_; } // Get the list of hybrid-optimizer components when using the HYBRID type.
+  QList<HybridComponent> HybridComponents() { return hybrid_components_; } // Get the list of hybrid-optimizer components when using the HYBRID or PORTFOLIO type.
   void SetRngSeed(const int seed) { parameters_.rng_seed = seed; } //!< Change the RNG seed (used by HybridOptimizer).
+  void SetParallelEvaluations(const int n) { parameters_.parallel_evaluations = n; } //!< Set the number of concurrent evaluations (used by the runner).
 
 
  private:
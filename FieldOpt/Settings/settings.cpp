@@ -49,6 +49,14 @@ namespace Settings {
         return QString("%1\n%2").arg(header.join(",")).arg(content.join(","));
     }
 
+    std::string Settings::EvaluationFingerprint() const
+    {
+        QJsonObject fingerprint;
+        fingerprint["Model"] = json_driver_->value("Model");
+        fingerprint["Objective"] = json_driver_->value("Optimizer").toObject().value("Objective");
+        return QJsonDocument(fingerprint).toJson(QJsonDocument::Compact).toStdString();
+    }
+
     void Settings::readDriverFile()
     {
         QFile *file = new QFile(QString::fromStdString(paths_.GetPath(Paths::DRIVER_FILE)));
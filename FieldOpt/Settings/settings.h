@@ -70,6 +70,13 @@ class Settings
 
   QString GetLogCsvString() const; //!< Get a string containing the CSV header and contents for the log.
 
+  /*!
+   * @brief Get the sections of the driver file the objective function value of a case
+   * depends on (the Model section and the optimizer Objective section) as compact JSON.
+   * Used to key the evaluation store in the Runner library.
+   */
+  std::string EvaluationFingerprint() const;
+
   Paths &paths() { return paths_; }
 
  private:
@@ -34,6 +34,7 @@ Simulator::Simulator(QJsonObject json_simulator, Paths &paths)
     setParams(json_simulator);
     setCommands(json_simulator);
     setFluidModel(json_simulator);
+    setMultiFidelity(json_simulator);
 }
 
 void Simulator::setPaths(QJsonObject json_simulator, Paths &paths) {
@@ -59,6 +60,16 @@ void Simulator::setPaths(QJsonObject json_simulator, Paths &paths) {
         if (json_simulator.contains("SelectRealizations")) {
             ensemble_.SetNSelect(json_simulator["SelectRealizations"].toInt());
         }
+        if (json_simulator.contains("Racing") && json_simulator["Racing"].toBool()) {
+            int min_realizations = 5;
+            double confidence = 0.9;
+            set_opt_prop_int(min_realizations, json_simulator, "RacingMinRealizations");
+            set_opt_prop_double(confidence, json_simulator, "RacingConfidence");
+            ensemble_.SetRacing(min_realizations, confidence);
+        }
+        if (json_simulator.contains("MaxCachedGrids")) {
+            ensemble_.SetMaxCachedGrids(json_simulator["MaxCachedGrids"].toInt());
+        }
     }
 }
 
@@ -72,6 +83,8 @@ void Simulator::setType(QJsonObject json_simulator) {
         type_ = SimulatorType::Flow;
     else if (QString::compare(type, "IX", Qt::CaseInsensitive) == 0)
         type_ = SimulatorType::INTERSECT;
+    else if (QString::compare(type, "Analytic", Qt::CaseInsensitive) == 0)
+        type_ = SimulatorType::Analytic;
     else throw SimulatorTypeNotRecognizedException(
             "The simulator type " + type.toStdString() + " was not recognized");
 }
@@ -81,6 +94,16 @@ void Simulator::setParams(QJsonObject json_simulator) {
     set_opt_prop_bool(ecl_use_actionx_, json_simulator, "UseACTIONX");
     set_opt_prop_bool(use_post_sim_script_, json_simulator, "UsePostSimScript");
     set_opt_prop_bool(read_external_json_results_, json_simulator, "ReadExternalJsonResults");
+
+    if (json_simulator.contains("AnalyticFunction")) {
+        QString function = json_simulator["AnalyticFunction"].toString();
+        if (QString::compare(function, "Sphere", Qt::CaseInsensitive) == 0)
+            analytic_function_ = AnalyticFunction::Sphere;
+        else if (QString::compare(function, "Rosenbrock", Qt::CaseInsensitive) == 0)
+            analytic_function_ = AnalyticFunction::Rosenbrock;
+        else throw SimulatorTypeNotRecognizedException(
+                "The analytic function " + function.toStdString() + " was not recognized");
+    }
 }
 
 void Simulator::setCommands(QJsonObject json_simulator) {
@@ -111,4 +134,29 @@ void Simulator::setFluidModel(QJsonObject json_simulator) {
     else fluid_model_ = SimulatorFluidModel::BlackOil;
 }
 
+void Simulator::setMultiFidelity(QJsonObject json_simulator) {
+    if (!json_simulator.contains("MultiFidelity"))
+        return;
+    if (is_ensemble_)
+        throw DriverFileInconsistentException("Multi-fidelity evaluation can not be combined with ensemble runs.");
+    if (type_ != SimulatorType::ECLIPSE && type_ != SimulatorType::Flow)
+        throw DriverFileInconsistentException("Multi-fidelity evaluation is only supported for ECLIPSE and Flow.");
+
+    QJsonObject json_fidelity = json_simulator["MultiFidelity"].toObject();
+    set_req_prop_string(coarse_driver_path_, json_fidelity, "CoarseDriverPath");
+    set_req_prop_string(coarse_grid_path_, json_fidelity, "CoarseGridPath");
+    std::string schedule_file;
+    set_req_prop_string(schedule_file, json_fidelity, "CoarseScheduleFile");
+    coarse_schedule_path_ = GetParentDirectoryPath(coarse_driver_path_) + "/" + schedule_file;
+    set_opt_prop_double(promotion_margin_, json_fidelity, "PromotionMargin");
+
+    for (auto path : {coarse_driver_path_, coarse_schedule_path_, coarse_grid_path_}) {
+        if (!FileExists(path, false))
+            throw FileNotFoundException(path);
+    }
+    if (promotion_margin_ < 0)
+        throw DriverFileInconsistentException("The multi-fidelity PromotionMargin must be non-negative.");
+    is_multi_fidelity_ = true;
+}
+
 }
@@ -39,7 +39,8 @@ class Simulator
 
  public:
   Simulator(QJsonObject json_simulator, Paths &paths);
-  enum SimulatorType { ECLIPSE, ADGPRS, Flow, INTERSECT };
+  enum SimulatorType { ECLIPSE, ADGPRS, Flow, INTERSECT, Analytic };
+  enum AnalyticFunction { Sphere, Rosenbrock };
   enum SimulatorFluidModel { BlackOil, DeadOil };
 
 
@@ -63,6 +64,33 @@ class Simulator
 
   Ensemble get_ensemble() const { return ensemble_; }
 
+  /*!
+   * @brief Check whether this is a multi-fidelity run, i.e. whether cases should first be
+   * evaluated on a coarse model, and only promoted to the fine (regular) model if the
+   * coarse value is within the promotion margin of the incumbent.
+   */
+  bool is_multi_fidelity() const { return is_multi_fidelity_; }
+
+  /*!
+   * @brief Get the coarse model (deck, schedule and grid) used in a multi-fidelity run.
+   * It is returned as a realization so that it can be passed directly to the simulator.
+   */
+  Ensemble::Realization coarse_model() const {
+      return Ensemble::Realization("coarse", coarse_driver_path_, coarse_schedule_path_, coarse_grid_path_);
+  }
+
+  /*!
+   * @brief Get the relative margin (fraction of the incumbent's coarse value) within
+   * which a case's coarse value must lie for the case to be promoted to the fine model.
+   */
+  double promotion_margin() const { return promotion_margin_; }
+
+  /*!
+   * @brief Get the function evaluated by the Analytic simulator (Sphere or Rosenbrock, both
+   * to be minimized). Only used when the simulator type is Analytic.
+   */
+  AnalyticFunction analytic_function() const { return analytic_function_; }
+
   /*!
    * Get the fluid model.
    */
@@ -106,6 +134,12 @@ class Simulator
   bool read_external_json_results_ = false;
   int max_minutes_ = -1;
   Ensemble ensemble_;
+  bool is_multi_fidelity_ = false;
+  std::string coarse_driver_path_;
+  std::string coarse_schedule_path_;
+  std::string coarse_grid_path_;
+  double promotion_margin_ = 0.05;
+  AnalyticFunction analytic_function_ = AnalyticFunction::Rosenbrock;
 
 
   void setPaths(QJsonObject json_simulator, Paths &paths);
@@ -113,6 +147,7 @@ class Simulator
   void setParams(QJsonObject json_simulator);
   void setCommands(QJsonObject json_simulator);
   void setFluidModel(QJsonObject json_simulator);
+  void setMultiFidelity(QJsonObject json_simulator);
 
 };
 
@@ -25,8 +25,10 @@
 
 #include <gtest/gtest.h>
 #include <QString>
+#include <QJsonArray>
 
 #include "Settings/tests/test_resource_settings.hpp"
+#include "Settings/settings_exceptions.h"
 
 using namespace Settings;
 
@@ -48,4 +50,79 @@ TEST_F(SimulatorSettingsTest, Fields) {
     EXPECT_EQ(settings_simulator_->commands()->size(), 1);
 }
 
+TEST_F(SimulatorSettingsTest, MultiFidelity) {
+    EXPECT_FALSE(settings_simulator_->is_multi_fidelity());
+
+    QJsonObject json_simulator{
+        {"Type", "ECLIPSE"},
+        {"Commands", QJsonArray{"eclrun eclipse"}},
+        {"MultiFidelity", QJsonObject{
+            {"CoarseDriverPath", QString::fromStdString(TestResources::ExampleFilePaths::norne_deck_)},
+            {"CoarseScheduleFile", "INCLUDE/BC0407_HIST01122006.SCH"},
+            {"CoarseGridPath", QString::fromStdString(TestResources::ExampleFilePaths::grid_horzwel_)},
+            {"PromotionMargin", 0.1}
+        }}
+    };
+    auto simulator = Simulator(json_simulator, paths_);
+    EXPECT_TRUE(simulator.is_multi_fidelity());
+    EXPECT_FLOAT_EQ(0.1, simulator.promotion_margin());
+    EXPECT_STREQ(TestResources::ExampleFilePaths::norne_deck_.c_str(), simulator.coarse_model().data().c_str());
+    EXPECT_STREQ(TestResources::ExampleFilePaths::norne_sch_.c_str(), simulator.coarse_model().schedule().c_str());
+    EXPECT_STREQ(TestResources::ExampleFilePaths::grid_horzwel_.c_str(), simulator.coarse_model().grid().c_str());
+
+    QJsonObject json_fidelity = json_simulator["MultiFidelity"].toObject();
+    json_fidelity["CoarseGridPath"] = "/no/such/grid.EGRID";
+    json_simulator["MultiFidelity"] = json_fidelity;
+    EXPECT_THROW(Simulator(json_simulator, paths_), FileNotFoundException);
+}
+
+TEST_F(SimulatorSettingsTest, Racing) {
+    Paths paths = paths_;
+    paths.SetPath(Paths::ENSEMBLE_FILE, TestResources::ExampleFilePaths::norne_ensemble_);
+    QJsonObject json_simulator{
+        {"Type", "ECLIPSE"},
+        {"Commands", QJsonArray{"eclrun eclipse"}},
+        {"SelectRealizations", 6}
+    };
+    auto simulator = Simulator(json_simulator, paths);
+    EXPECT_TRUE(simulator.is_ensemble());
+    EXPECT_EQ(8, simulator.get_ensemble().GetAliases().size());
+    EXPECT_EQ(6, simulator.get_ensemble().NSelect());
+    EXPECT_FALSE(simulator.get_ensemble().IsRacing());
+    EXPECT_EQ(0, simulator.get_ensemble().MaxCachedGrids());
+
+    json_simulator["Racing"] = true;
+    json_simulator["MaxCachedGrids"] = 3;
+    auto racing_defaults = Simulator(json_simulator, paths).get_ensemble();
+    EXPECT_TRUE(racing_defaults.IsRacing());
+    EXPECT_EQ(5, racing_defaults.RacingMinRealizations());
+    EXPECT_FLOAT_EQ(0.9, racing_defaults.RacingConfidence());
+    EXPECT_EQ(3, racing_defaults.MaxCachedGrids());
+
+    json_simulator["RacingMinRealizations"] = 3;
+    json_simulator["RacingConfidence"] = 0.95;
+    auto racing = Simulator(json_simulator, paths).get_ensemble();
+    EXPECT_EQ(3, racing.RacingMinRealizations());
+    EXPECT_FLOAT_EQ(0.95, racing.RacingConfidence());
+
+    json_simulator["RacingMinRealizations"] = 1;
+    EXPECT_THROW(Simulator(json_simulator, paths), std::runtime_error);
+    json_simulator["RacingMinRealizations"] = 3;
+    json_simulator["RacingConfidence"] = 1.5;
+    EXPECT_THROW(Simulator(json_simulator, paths), std::runtime_error);
+}
+
+TEST_F(SimulatorSettingsTest, Analytic) {
+    QJsonObject json_simulator{
+        {"Type", "Analytic"},
+        {"AnalyticFunction", "Sphere"}
+    };
+    auto simulator = Simulator(json_simulator, paths_);
+    EXPECT_EQ(Simulator::SimulatorType::Analytic, simulator.type());
+    EXPECT_EQ(Simulator::AnalyticFunction::Sphere, simulator.analytic_function());
+
+    json_simulator["AnalyticFunction"] = "Ackley";
+    EXPECT_THROW(Simulator(json_simulator, paths_), SimulatorTypeNotRecognizedException);
+}
+
 }
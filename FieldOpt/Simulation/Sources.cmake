@@ -2,11 +2,13 @@
 SET(SIMULATION_HEADERS
 	execution_scripts/execution_scripts.h
 	results/adgprsresults.h
+	results/analytic_results.h
 	results/eclresults.h
 	results/results.h
 	results/results_exceptions.h
     results/json_results.h
 	simulator_interfaces/adgprssimulator.h
+	simulator_interfaces/analytic_simulator.h
 	simulator_interfaces/driver_file_writers/adgprsdriverfilewriter.h
 	simulator_interfaces/driver_file_writers/driver_parts/adgprs_driver_parts/adgprs_wellcontrols.h
 	simulator_interfaces/driver_file_writers/driver_parts/adgprs_driver_parts/wellstre.h
@@ -15,6 +17,7 @@ SET(SIMULATION_HEADERS
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/compsegs.h
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/ecldriverpart.h
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_section.h
+	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_template.h
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/wellcontrols.h
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/welsegs.h
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/welspecs.h
@@ -36,8 +39,10 @@ SET(SIMULATION_HEADERS
 
 SET(SIMULATION_SOURCES
 	results/adgprsresults.cpp
+	results/analytic_results.cpp
 	results/eclresults.cpp
 	simulator_interfaces/adgprssimulator.cpp
+	simulator_interfaces/analytic_simulator.cpp
 	simulator_interfaces/driver_file_writers/adgprsdriverfilewriter.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/adgprs_driver_parts/adgprs_wellcontrols.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/adgprs_driver_parts/wellstre.cpp
@@ -46,6 +51,7 @@ SET(SIMULATION_SOURCES
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/compsegs.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/ecldriverpart.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_section.cpp
+	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_template.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/wellcontrols.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/welsegs.cpp
 	simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/welspecs.cpp
@@ -68,11 +74,13 @@ SET(SIMULATION_TESTS
 	tests/simulator_interfaces/driver_file_writers/adgprs_driver_file_writer.cpp
 	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_compdat.cpp
 	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_schedule_section.cpp
+	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_schedule_template.cpp
 	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_wellcontrols.cpp
 	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_welspecs.cpp
 	tests/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/test_schedule_inset.cpp
 	tests/simulator_interfaces/driver_file_writers/flow_driver_file_writer.cpp
 	tests/simulator_interfaces/test_adgprssimulator.cpp
+	tests/simulator_interfaces/test_analytic_simulator.cpp
 	tests/simulator_interfaces/test_eclsimulator.cpp
 	tests/simulator_interfaces/test_ix_simulator.cpp
 )
@@ -1,11 +1,20 @@
 #!/bin/bash
 # Parameter 1: Work direcory.
-# Parameter 2: Path to ADGPRS driver file
-# Note that this assumes that (a link to) ADGPRS is found at /usr/bin/adgprs
+# Parameter 2: Path to Flow driver file
+# Parameter 3: Number of threads to excute with (optional)
+# Note that this assumes that (a link to) Flow is found at /usr/bin/flow
 
+# Determine number of threads
+if [ -z "$3" ]
+then
+    threads=1 # Default to 1 threads
+else
+    threads=$3
+fi
 
 # Switch to work directory
 cd $1
 
-# Execute eclipse with the file path as parameter
+# Execute flow with the file path as parameter
+export OMP_NUM_THREADS=$threads
 exec /usr/bin/flow $2 >/dev/null 2>/dev/null
@@ -1,5 +1,6 @@
 #include "adgprsresults.h"
 #include <iostream>
+#include "Utilities/tracing.hpp"
 
 namespace Simulation { namespace Results {
 
@@ -18,6 +19,7 @@ double AdgprsResults::GetValue(int well_nr, Results::Property prop, int time_ind
 
 void AdgprsResults::ReadResults(QString file_path)
 {
+    TRACE_SCOPE("ReadResults", "Simulation");
     if (file_path.split(".vars.h5").length() == 1)
         file_path = file_path + ".vars.h5"; // Append the suffix if it's not already there
     file_path_ = file_path;
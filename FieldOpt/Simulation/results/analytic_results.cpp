@@ -0,0 +1,68 @@
+#include "analytic_results.h"
+
+namespace Simulation {
+namespace Results {
+
+void AnalyticResults::SetValue(double value, std::vector<double> times)
+{
+    value_ = value;
+    times_ = times;
+    if (times_.empty())
+        times_.push_back(0.0);
+    setAvailable();
+}
+
+void AnalyticResults::ReadResults(QString file_path)
+{
+}
+
+void AnalyticResults::DumpResults()
+{
+    setUnavailable();
+}
+
+double AnalyticResults::GetValue(Results::Property prop)
+{
+    if (!isAvailable()) throw ResultsNotAvailableException();
+    return GetValueVector(prop).back();
+}
+
+double AnalyticResults::GetValue(Results::Property prop, int time_index)
+{
+    if (!isAvailable()) throw ResultsNotAvailableException();
+    if (time_index < 0 || time_index >= times_.size())
+        throw std::runtime_error("In AnalyticResults: The time index " + std::to_string(time_index) + " is out of range.");
+    return GetValueVector(prop)[time_index];
+}
+
+double AnalyticResults::GetValue(Results::Property prop, QString well)
+{
+    if (!isAvailable()) throw ResultsNotAvailableException();
+    return 0.0;
+}
+
+double AnalyticResults::GetValue(Results::Property prop, QString well, int time_index)
+{
+    if (!isAvailable()) throw ResultsNotAvailableException();
+    return 0.0;
+}
+
+std::vector<double> AnalyticResults::GetValueVector(Results::Property prop)
+{
+    if (!isAvailable()) throw ResultsNotAvailableException();
+    switch (prop) {
+        case CumulativeOilProduction: {
+            std::vector<double> values(times_.size(), value_);
+            double t_end = times_.back() - times_.front();
+            for (int i = 0; i < times_.size() && t_end > 0; ++i) {
+                values[i] = value_ * (times_[i] - times_.front()) / t_end;
+            }
+            return values;
+        }
+        case Time: return times_;
+        default:   return std::vector<double>(times_.size(), 0.0);
+    }
+}
+
+}
+}
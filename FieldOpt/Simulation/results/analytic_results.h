@@ -0,0 +1,43 @@
+#ifndef FIELDOPT_ANALYTIC_RESULTS_H
+#define FIELDOPT_ANALYTIC_RESULTS_H
+
+#include "results.h"
+
+namespace Simulation {
+namespace Results {
+
+/*!
+ * \brief The AnalyticResults class holds the synthetic results produced by the AnalyticSimulator.
+ *
+ * The value of the analytic function is reported as the final field cumulative oil production;
+ * the intermediate values grow linearly with time. All other field and well properties are zero,
+ * and Time holds the control times of the model.
+ */
+class AnalyticResults : public Results
+{
+ public:
+  AnalyticResults() {}
+
+  /*!
+   * \brief SetValue Set the function value and the report times, and mark the results as available.
+   */
+  void SetValue(double value, std::vector<double> times);
+
+  void ReadResults(QString file_path); //!< Does nothing: analytic results are set with SetValue.
+  void DumpResults();
+
+  double GetValue(Property prop);
+  double GetValue(Property prop, int time_index);
+  double GetValue(Property prop, QString well);
+  double GetValue(Property prop, QString well, int time_index);
+  std::vector<double> GetValueVector(Property prop);
+
+ private:
+  double value_ = 0.0;
+  std::vector<double> times_;
+};
+
+}
+}
+
+#endif //FIELDOPT_ANALYTIC_RESULTS_H
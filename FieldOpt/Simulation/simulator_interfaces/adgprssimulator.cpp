@@ -85,7 +85,8 @@ void AdgprsSimulator::UpdateFilePaths()
 {
     script_args_ = (QStringList() << QString::fromStdString(paths_.GetPath(Paths::SIM_WORK_DIR ))
                                   << QString::fromStdString(paths_.GetPath(Paths::SIM_WORK_DIR ))
-                                      + "/" + driver_file_name_);
+                                      + "/" + driver_file_name_)
+                                  << "1"; // Number of threads; set by Evaluate(timeout, threads)
 }
 
 bool AdgprsSimulator::Evaluate(int timeout, int threads) {
@@ -98,7 +99,7 @@ bool AdgprsSimulator::Evaluate(int timeout, int threads) {
     std::cout << "Starting monitored simulation with timeout " << timeout << std::endl;
     bool success = ::Utilities::Unix::ExecShellScriptTimeout(
         QString::fromStdString(paths_.GetPath(Paths::SIM_EXEC_SCRIPT_FILE)),
-        script_args_, t);
+        script_args_, t, cancellation_check_, &cancelled_);
     if (success) {
         paths_.SetPath(Paths::SIM_HDF5_FILE,
                        paths_.GetPath(Paths::SIM_WORK_DIR) + "/"
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include "analytic_simulator.h"
+#include "Optimization/tests/test_resource_test_functions.h"
+#include "Utilities/tracing.hpp"
+
+namespace Simulation {
+
+AnalyticSimulator::AnalyticSimulator(Settings::Settings *settings, Model::Model *model)
+    : Simulator(settings)
+{
+    model_ = model;
+    analytic_results_ = new Results::AnalyticResults();
+    results_ = analytic_results_;
+}
+
+void AnalyticSimulator::Evaluate()
+{
+    TRACE_SCOPE("AnalyticFunction", "Simulation");
+    if (results_->isAvailable()) results_->DumpResults();
+    Eigen::VectorXd xs = variableVector();
+    double value = 0.0;
+    switch (settings_->simulator()->analytic_function()) {
+        case Settings::Simulator::AnalyticFunction::Sphere:
+            value = TestResources::TestFunctions::Sphere(xs);
+            break;
+        case Settings::Simulator::AnalyticFunction::Rosenbrock:
+            value = xs.size() > 1 ? TestResources::TestFunctions::Rosenbrock(xs) : 0.0;
+            break;
+    }
+    std::vector<double> times;
+    for (int t : control_times_) {
+        times.push_back(t);
+    }
+    analytic_results_->SetValue(value, times);
+    updateResultsInModel();
+}
+
+bool AnalyticSimulator::Evaluate(int timeout, int threads)
+{
+    Evaluate();
+    return true;
+}
+
+bool AnalyticSimulator::Evaluate(const Settings::Ensemble::Realization &realization, int timeout, int threads)
+{
+    Evaluate();
+    return true;
+}
+
+Eigen::VectorXd AnalyticSimulator::variableVector() const
+{
+    QList<Model::Properties::ContinousProperty *> variables = model_->variables()->GetContinousVariables()->values();
+    std::sort(variables.begin(), variables.end(),
+              [](const Model::Properties::ContinousProperty *a, const Model::Properties::ContinousProperty *b) {
+                return a->name() < b->name();
+              });
+    Eigen::VectorXd xs(variables.size());
+    for (int i = 0; i < variables.size(); ++i) {
+        xs[i] = variables[i]->value();
+    }
+    return xs;
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef FIELDOPT_ANALYTIC_SIMULATOR_H
+#define FIELDOPT_ANALYTIC_SIMULATOR_H
+
+#include "simulator.h"
+#include "Simulation/results/analytic_results.h"
+
+namespace Simulation {
+
+/*!
+ * \brief The AnalyticSimulator class evaluates an analytic test function over the continuous
+ * model variables in-process, instead of running a reservoir simulator.
+ *
+ * It is meant for measuring the overhead of FieldOpt itself (optimizer, bookkeeping, logging
+ * and MPI communication) without depending on a licensed simulator. The variables are ordered
+ * by name to form the function argument, and the function value is reported as the final field
+ * cumulative oil production (see AnalyticResults). The test functions are formulated for
+ * minimization.
+ *
+ * No driver files are written and nothing is executed.
+ */
+class AnalyticSimulator : public Simulator {
+ public:
+  AnalyticSimulator(Settings::Settings *settings, Model::Model *model);
+
+  void Evaluate() override;
+  bool Evaluate(int timeout, int threads=1) override;
+  bool Evaluate(const Settings::Ensemble::Realization &realization, int timeout, int threads=1) override;
+  void SelectRealization(const Settings::Ensemble::Realization &realization) override {}
+  void WriteDriverFilesOnly() override {}
+  void CleanUp() override {}
+
+ protected:
+  void UpdateFilePaths() override {}
+
+ private:
+  Results::AnalyticResults *analytic_results_;
+
+  Eigen::VectorXd variableVector() const; //!< Continuous variable values, ordered by variable name.
+};
+
+}
+
+#endif //FIELDOPT_ANALYTIC_SIMULATOR_H
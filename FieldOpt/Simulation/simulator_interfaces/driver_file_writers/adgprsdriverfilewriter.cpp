@@ -5,6 +5,7 @@
 #include "Simulation/simulator_interfaces/driver_file_writers/driver_parts/adgprs_driver_parts/adgprs_wellcontrols.h"
 #include <iostream>
 #include "Utilities/filehandling.hpp"
+#include "Utilities/tracing.hpp"
 
 namespace Simulation {
 
@@ -16,6 +17,7 @@ AdgprsDriverFileWriter::AdgprsDriverFileWriter(Settings::Settings *settings, Mod
 
 void AdgprsDriverFileWriter::WriteDriverFile(QString output_dir)
 {
+    TRACE_SCOPE("WriteDriverFile", "Simulation");
     auto welspecs = ECLDriverParts::Welspecs(model_->wells());
     auto compdat = ECLDriverParts::Compdat(model_->wells());
     model_->SetCompdatString(compdat.GetPartString());
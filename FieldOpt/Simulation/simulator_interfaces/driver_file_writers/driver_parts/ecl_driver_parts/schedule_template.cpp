@@ -0,0 +1,267 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "schedule_template.h"
+#include "schedule_section.h"
+#include "Utilities/verbosity.h"
+#include "Utilities/printer.hpp"
+#include <cstdio>
+
+namespace Simulation {
+namespace ECLDriverParts {
+
+namespace {
+
+int sign(double value) {
+    return value > 0 ? 1 : (value < 0 ? 2 : 0);
+}
+
+}
+
+ScheduleTemplate::ScheduleTemplate(bool static_structure) {
+    static_structure_ = static_structure;
+    enabled_ = true;
+    compiled_ = false;
+    n_compilations_ = 0;
+}
+
+void ScheduleTemplate::Render(QList<Model::Wells::Well *> *wells, const QList<int> &control_times,
+                              ScheduleInsets &insets, std::string &buffer) {
+    if (!enabled_) {
+        buffer = Schedule(wells, control_times, insets).GetPartString().toStdString();
+        return;
+    }
+    if (!compiled_ || !matches(wells, control_times)) {
+        compile(wells, control_times, insets, buffer);
+        return;
+    }
+    render(wells, buffer);
+}
+
+bool ScheduleTemplate::matches(QList<Model::Wells::Well *> *wells, const QList<int> &control_times) const {
+    if (control_times != control_times_ || wells->size() != (int)n_controls_.size()) {
+        return false;
+    }
+    size_t index = 0;
+    for (int w = 0; w < wells->size(); ++w) {
+        auto controls = wells->at(w)->controls();
+        if (controls->size() != n_controls_[w]) {
+            return false;
+        }
+        for (auto control : *controls) {
+            ControlLayout current = layout(control);
+            const ControlLayout &compiled = layouts_[index++];
+            if (current.time_step != compiled.time_step || current.open != compiled.open
+                || current.mode != compiled.mode || current.fluid != compiled.fluid
+                || current.signs != compiled.signs) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ScheduleTemplate::compile(QList<Model::Wells::Well *> *wells, const QList<int> &control_times,
+                               ScheduleInsets &insets, std::string &buffer) {
+    n_compilations_++;
+    compiled_ = false;
+    std::string expected = Schedule(wells, control_times, insets).GetPartString().toStdString();
+
+    text_.clear();
+    segments_.clear();
+    layouts_.clear();
+    n_controls_.clear();
+    control_times_ = control_times;
+    for (auto well : *wells) {
+        n_controls_.push_back(well->controls()->size());
+        for (auto control : *well->controls()) {
+            layouts_.push_back(layout(control));
+        }
+    }
+
+    // Mirrors the Schedule constructor
+    bool valid = true;
+    if (insets.HasInset(-1)) {
+        text_ += insets.GetInset(-1);
+    }
+    for (int ts : control_times) {
+        if (static_structure_) {
+            text_ += Welspecs(wells, ts).GetPartString().toStdString();
+        }
+        else {
+            addSlot(WELSPECS, -1, -1, BHP, ts);
+        }
+        if (insets.HasInset(ts)) {
+            text_ += insets.GetInset(ts);
+        }
+        if (static_structure_) {
+            text_ += Compdat(wells, ts).GetPartString().toStdString();
+            text_ += Welsegs(wells, ts).GetPartString().toStdString();
+            text_ += Compsegs(wells, ts).GetPartString().toStdString();
+            text_ += Wsegvalv(wells, ts).GetPartString().toStdString();
+        }
+        else {
+            addSlot(COMPLETIONS, -1, -1, BHP, ts);
+        }
+
+        // The entries are in the order WellControls creates them, followed by the time progression
+        WellControls controls(wells, control_times, ts);
+        QStringList entries = controls.GetWellEntryList();
+        int n_entries = 0;
+        int entries_length = 0;
+        for (int w = 0; w < wells->size(); ++w) {
+            for (int c = 0; c < wells->at(w)->controls()->size(); ++c) {
+                if (wells->at(w)->controls()->at(c)->time_step() != ts) {
+                    continue;
+                }
+                if (n_entries >= entries.size()
+                    || !compileControlEntry(entries[n_entries], w, c, wells->at(w)->IsInjector())) {
+                    valid = false;
+                    break;
+                }
+                entries_length += entries[n_entries].size();
+                n_entries++;
+            }
+        }
+        text_ += controls.GetPartString().mid(entries_length).toStdString();
+    }
+    text_ += "\n\n";
+    addSlot(NONE, -1, -1, BHP, -1);
+
+    if (valid) {
+        render(wells, buffer);
+        valid = buffer == expected;
+    }
+    if (!valid) {
+        Printer::ext_warn("The rendered schedule template differs from the schedule. Disabling the template.",
+                          "Simulation", "ScheduleTemplate");
+        enabled_ = false;
+        buffer = expected;
+        return;
+    }
+    compiled_ = true;
+    if (VERB_SIM >= 2) {
+        Printer::ext_info("Compiled schedule template with " + Printer::num2str((int)segments_.size() - 1)
+                              + " slots and " + Printer::num2str((int)text_.size()) + " bytes of static text.",
+                          "Simulation", "ScheduleTemplate");
+    }
+}
+
+bool ScheduleTemplate::compileControlEntry(const QString &entry, int well, int control, bool is_injector) {
+    // See WellControls::createProducerEntry and WellControls::createInjectorEntry
+    QString prefix = is_injector ? "WCONINJE\n   " : "WCONPROD\n   ";
+    QString suffix = "/\n/\n\n";
+    if (!entry.startsWith(prefix) || !entry.endsWith(suffix)) {
+        return false;
+    }
+    QStringList fields = entry.mid(prefix.size(), entry.size() - prefix.size() - suffix.size()).split(" ");
+    if (fields.size() != (is_injector ? 7 : 9)) {
+        return false;
+    }
+    text_ += prefix.toStdString();
+    for (int i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            text_ += " ";
+        }
+        ControlField field;
+        bool numeric = true;
+        if (is_injector) {
+            if (i == 4) field = LIQUID_RATE;
+            else if (i == 6) field = BHP;
+            else numeric = false;
+        }
+        else {
+            if (i >= 3) field = (ControlField)(i - 3); // Rates and BHP in ControlField order
+            else numeric = false;
+        }
+        if (numeric && fields[i] != "1*") {
+            addSlot(CONTROL, well, control, field, -1);
+        }
+        else {
+            text_ += fields[i].toStdString();
+        }
+    }
+    text_ += suffix.toStdString();
+    return true;
+}
+
+void ScheduleTemplate::addSlot(SlotType slot, int well, int control, ControlField field, int time_step) {
+    Segment segment;
+    segment.text_begin = segments_.empty() ? 0 : segments_.back().text_end;
+    segment.text_end = text_.size();
+    segment.slot = slot;
+    segment.well = well;
+    segment.control = control;
+    segment.field = field;
+    segment.time_step = time_step;
+    segments_.push_back(segment);
+}
+
+void ScheduleTemplate::render(QList<Model::Wells::Well *> *wells, std::string &buffer) const {
+    buffer.clear();
+    char number[32];
+    for (const Segment &segment : segments_) {
+        buffer.append(text_, segment.text_begin, segment.text_end - segment.text_begin);
+        switch (segment.slot) {
+            case CONTROL: {
+                // Same format as QString::number
+                int length = snprintf(number, sizeof(number), "%g",
+                                      value(wells->at(segment.well)->controls()->at(segment.control), segment.field));
+                buffer.append(number, length);
+                break;
+            }
+            case WELSPECS:
+                buffer += Welspecs(wells, segment.time_step).GetPartString().toStdString();
+                break;
+            case COMPLETIONS:
+                buffer += Compdat(wells, segment.time_step).GetPartString().toStdString();
+                buffer += Welsegs(wells, segment.time_step).GetPartString().toStdString();
+                buffer += Compsegs(wells, segment.time_step).GetPartString().toStdString();
+                buffer += Wsegvalv(wells, segment.time_step).GetPartString().toStdString();
+                break;
+            case NONE:
+                break;
+        }
+    }
+}
+
+ScheduleTemplate::ControlLayout ScheduleTemplate::layout(const Model::Wells::Control *control) {
+    ControlLayout layout;
+    layout.time_step = control->time_step();
+    layout.open = control->open();
+    layout.mode = (int)control->mode();
+    layout.fluid = (int)control->injection_fluid();
+    layout.signs = 0;
+    for (int field = OIL_RATE; field <= BHP; ++field) {
+        layout.signs |= sign(value(control, (ControlField)field)) << (2 * field);
+    }
+    return layout;
+}
+
+double ScheduleTemplate::value(const Model::Wells::Control *control, ControlField field) {
+    switch (field) {
+        case OIL_RATE: return control->oilRate();
+        case WATER_RATE: return control->waterRate();
+        case GAS_RATE: return control->gasRate();
+        case LIQUID_RATE: return control->liquidRate();
+        case RESERVOIR_RATE: return control->reservoirRate();
+        case BHP: return control->bhp();
+    }
+    return 0.0;
+}
+
+}
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+   This file is part of the FieldOpt project.
+
+   FieldOpt is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   FieldOpt is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with FieldOpt.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef FIELDOPT_SCHEDULE_TEMPLATE_H
+#define FIELDOPT_SCHEDULE_TEMPLATE_H
+
+#include "Model/wells/well.h"
+#include "schedule_insets.h"
+#include <QList>
+#include <string>
+#include <vector>
+
+namespace Simulation {
+namespace ECLDriverParts {
+
+/*!
+ * @brief The ScheduleTemplate class renders the same schedule as the Schedule class, but
+ * from a template compiled from it, so that only the variable fields are formatted for
+ * each case.
+ *
+ * The template consists of static text and typed slots:
+ *  - Control slots hold one numeric field (a rate or BHP) of a WCONPROD/WCONINJE entry.
+ *    They are formatted directly into the output buffer.
+ *  - Structure slots hold the WELSPECS, or the COMPDAT, WELSEGS, COMPSEGS and WSEGVALV
+ *    keywords, of a control time. They are rendered with the regular driver parts. When
+ *    the well structure is static (i.e. the only variables are well controls), they are
+ *    instead compiled into static text.
+ *
+ * The layout of each control entry (open/shut, control mode, injection fluid, and the sign
+ * of each rate and the BHP, which decide the fields that are written) is recorded. The
+ * template is compiled again when a layout, or the number of wells, controls or control
+ * times, changes. After each compilation the rendered template is checked against the
+ * output of Schedule; if they differ, the template is disabled and Schedule is used.
+ */
+class ScheduleTemplate {
+ public:
+  /*!
+   * @param static_structure Whether the well structure (placement, completions, segments
+   * and valves) is the same for all cases, so that it can be compiled into static text.
+   */
+  ScheduleTemplate(bool static_structure);
+
+  /*!
+   * @brief Render the schedule for the current state of the wells.
+   * @param buffer Buffer to render into. Its contents are replaced, but its capacity is
+   * reused, so passing the same buffer every time avoids reallocations.
+   */
+  void Render(QList<Model::Wells::Well *> *wells, const QList<int> &control_times,
+              ScheduleInsets &insets, std::string &buffer);
+
+  int NumberCompilations() const { return n_compilations_; } //!< Number of times the template has been compiled.
+  bool IsEnabled() const { return enabled_; } //!< False if the template has been disabled in favor of Schedule.
+
+ private:
+  enum SlotType { NONE, CONTROL, WELSPECS, COMPLETIONS };
+  enum ControlField { OIL_RATE, WATER_RATE, GAS_RATE, LIQUID_RATE, RESERVOIR_RATE, BHP };
+
+  //! Static text followed by a slot.
+  struct Segment {
+    size_t text_begin;  //!< Start of the static text in text_.
+    size_t text_end;    //!< End of the static text in text_.
+    SlotType slot;
+    int well;           //!< Well index, for control slots.
+    int control;        //!< Control index in the well, for control slots.
+    ControlField field; //!< Field, for control slots.
+    int time_step;      //!< Control time, for structure slots.
+  };
+
+  //! The properties of a control that decide the layout of its entry.
+  struct ControlLayout {
+    int time_step;
+    bool open;
+    int mode;
+    int fluid;
+    int signs; //!< Sign of each rate and the BHP, two bits each.
+  };
+
+  bool static_structure_;
+  bool enabled_;
+  bool compiled_;
+  int n_compilations_;
+
+  std::string text_;              //!< Static text of all segments.
+  std::vector<Segment> segments_;
+  QList<int> control_times_;      //!< Control times the template was compiled for.
+  std::vector<int> n_controls_;   //!< Number of controls of each well the template was compiled for.
+  std::vector<ControlLayout> layouts_; //!< Layout of all controls of all wells, in order.
+
+  /*!
+   * @brief Check whether the wells still have the layout the template was compiled for.
+   */
+  bool matches(QList<Model::Wells::Well *> *wells, const QList<int> &control_times) const;
+
+  /*!
+   * @brief Compile the template and check it against the output of Schedule, which is
+   * left in the buffer.
+   */
+  void compile(QList<Model::Wells::Well *> *wells, const QList<int> &control_times,
+               ScheduleInsets &insets, std::string &buffer);
+
+  /*!
+   * @brief Compile a WCONPROD or WCONINJE entry, making slots of its numeric fields.
+   * @return False if the entry does not have the expected format.
+   */
+  bool compileControlEntry(const QString &entry, int well, int control, bool is_injector);
+
+  void addSlot(SlotType slot, int well, int control, ControlField field, int time_step);
+  void render(QList<Model::Wells::Well *> *wells, std::string &buffer) const;
+
+  static ControlLayout layout(const Model::Wells::Control *control);
+  static double value(const Model::Wells::Control *control, ControlField field);
+};
+
+}
+}
+
+#endif //FIELDOPT_SCHEDULE_TEMPLATE_H
@@ -30,6 +30,7 @@
 #include "Simulation/simulator_interfaces/simulator_exceptions.h"
 #include "Utilities/filehandling.hpp"
 #include "Utilities/verbosity.h"
+#include "Utilities/tracing.hpp"
 
 namespace Simulation {
 
@@ -45,10 +46,17 @@ EclDriverFileWriter::EclDriverFileWriter(Settings::Settings *settings, Model::Mo
     if (settings->paths().IsSet(Paths::SIM_SCH_INSET_FILE)) {
         insets_ = ECLDriverParts::ScheduleInsets(settings->paths().GetPath(Paths::SIM_SCH_INSET_FILE));
     }
+
+    // The well structure only changes between cases if there are variables other than the controls
+    auto variables = model->variables();
+    bool static_structure = variables->BinaryVariableSize() == 0 && variables->DiscreteVariableSize() == 0
+        && variables->ContinousVariableSize() == variables->GetWellControlVariables().size();
+    schedule_template_ = new ECLDriverParts::ScheduleTemplate(static_structure);
 }
 
 void EclDriverFileWriter::WriteDriverFile(QString schedule_file_path)
 {
+    TRACE_SCOPE("WriteDriverFile", "Simulation");
     if (VERB_SIM >= 2) {
         auto fp = schedule_file_path.toStdString();
         Printer::ext_info("Writing driver file to " + fp + ".", "Simulation", "EclDriverFileWriter");
@@ -56,9 +64,12 @@ void EclDriverFileWriter::WriteDriverFile(QString schedule_file_path)
     assert(FileExists(schedule_file_path));
 
     if (use_actionx_ == false) {
-        Schedule schedule = ECLDriverParts::Schedule(model_->wells(), settings_->model()->control_times(), insets_);
-        model_->SetCompdatString(schedule.GetPartString());
-        Utilities::FileHandling::WriteStringToFile(schedule.GetPartString(), schedule_file_path);
+        schedule_template_->Render(model_->wells(), settings_->model()->control_times(), insets_, schedule_buffer_);
+        model_->SetCompdatString(QString::fromStdString(schedule_buffer_));
+        if (schedule_buffer_.empty() || schedule_buffer_.back() != '\n')
+            schedule_buffer_ += "\n";
+        schedule_buffer_ += "\n"; // Same output as WriteStringToFile
+        Utilities::FileHandling::WriteBufferToFile(schedule_buffer_, schedule_file_path);
     }
     else {
         Utilities::FileHandling::WriteStringToFile(QString::fromStdString(buildActionStrings()), schedule_file_path);
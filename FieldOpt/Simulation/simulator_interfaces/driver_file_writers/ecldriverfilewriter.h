@@ -30,6 +30,8 @@
 #include "Settings/simulator.h"
 #include "Model/model.h"
 #include "driver_parts/ecl_driver_parts/schedule_insets.h"
+#include "driver_parts/ecl_driver_parts/schedule_template.h"
+#include <string>
 
 namespace Simulation {
     class ECLSimulator;
@@ -54,6 +56,8 @@ private:
     ::Settings::Settings *settings_;
     ECLDriverParts::ScheduleInsets insets_;
     bool use_actionx_;
+    ECLDriverParts::ScheduleTemplate *schedule_template_; //!< Renders the schedule when ACTIONX is not used.
+    std::string schedule_buffer_; //!< Reused between cases to avoid reallocating the schedule.
 };
 
 }
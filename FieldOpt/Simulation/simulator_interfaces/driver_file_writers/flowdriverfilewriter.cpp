@@ -2,6 +2,7 @@
 #include <simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/compdat.h>
 #include <simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/wellcontrols.h>
 #include <Utilities/filehandling.hpp>
+#include <Utilities/tracing.hpp>
 #include "flowdriverfilewriter.h"
 
 namespace Simulation {
@@ -13,6 +14,7 @@ FlowDriverFileWriter::FlowDriverFileWriter(::Settings::Settings *settings,
 }
 
 void FlowDriverFileWriter::WriteDriverFile(QString output_dir) {
+    TRACE_SCOPE("WriteDriverFile", "Simulation");
     auto welspecs = ECLDriverParts::Welspecs(model_->wells());
     auto compdat = ECLDriverParts::Compdat(model_->wells());
     auto wellcontrols = ECLDriverParts::WellControls(model_->wells(), settings_->model()->control_times());
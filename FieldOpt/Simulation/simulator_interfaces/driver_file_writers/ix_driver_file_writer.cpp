@@ -22,6 +22,7 @@
 #include "driver_parts/ix_driver_parts/report_tuning.hpp"
 #include "driver_parts/ix_driver_parts/ix_control.hpp"
 #include "driver_parts/ix_driver_parts/flow_control_device.hpp"
+#include "Utilities/tracing.hpp"
 
 namespace Simulation {
 
@@ -30,6 +31,7 @@ IXDriverFileWriter::IXDriverFileWriter(Model::Model *model) {
 }
 
 void IXDriverFileWriter::WriteDriverFile(std::string fm_edits_path) {
+    TRACE_SCOPE("WriteDriverFile", "Simulation");
     std::string fm_edits = "MODEL_DEFINITION\n\n";
     fm_edits += IXParts::FieldManagementStandardReport();
     fm_edits += IXParts::EclReports();
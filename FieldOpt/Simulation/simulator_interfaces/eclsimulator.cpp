@@ -82,7 +82,7 @@ bool ECLSimulator::Evaluate(int timeout, int threads) {
     }
     bool success = ::Utilities::Unix::ExecShellScriptTimeout(
         QString::fromStdString(paths_.GetPath(Paths::SIM_EXEC_SCRIPT_FILE)),
-        script_args_, t);
+        script_args_, t, cancellation_check_, &cancelled_);
     if (VERB_SIM >= 2) Printer::info("Monitored simulation done.");
     if (success) {
         if (VERB_SIM >= 2) Printer::info("Simulation successful. Reading results.");
@@ -95,13 +95,17 @@ bool ECLSimulator::Evaluate(int timeout, int threads) {
 }
 
 bool ECLSimulator::Evaluate(const Settings::Ensemble::Realization &realization, int timeout, int threads) {
+    SelectRealization(realization);
+    return Evaluate(timeout, threads);
+}
+
+void ECLSimulator::SelectRealization(const Settings::Ensemble::Realization &realization) {
     driver_file_name_ = QString::fromStdString(FileName(realization.data()));
     driver_parent_dir_name_ = QString::fromStdString(ParentDirectoryName(realization.data()));
     deck_name_ = driver_file_name_.split(".").first();
     paths_.SetPath(Paths::SIM_DRIVER_FILE, realization.data());
     paths_.SetPath(Paths::SIM_DRIVER_DIR , GetParentDirectoryPath(realization.data()));
     paths_.SetPath(Paths::SIM_SCH_FILE   , realization.schedule());
-    return Evaluate(timeout, threads);
 }
 
 void ECLSimulator::CleanUp()
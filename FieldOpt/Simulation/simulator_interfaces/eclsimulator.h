@@ -53,6 +53,7 @@ class ECLSimulator : public Simulator
   void Evaluate() override;
   bool Evaluate(int timeout, int threads=1) override;
   bool Evaluate(const Settings::Ensemble::Realization &realization, int timeout, int threads=1) override;
+  void SelectRealization(const Settings::Ensemble::Realization &realization) override;
 
   void WriteDriverFilesOnly() override;
   /*!
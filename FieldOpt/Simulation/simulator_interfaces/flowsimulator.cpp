@@ -87,7 +87,8 @@ void FlowSimulator::UpdateFilePaths()
 {
     script_args_ = (QStringList() << QString::fromStdString(paths_.GetPath(Paths::SIM_WORK_DIR ))
                                   << QString::fromStdString(paths_.GetPath(Paths::SIM_WORK_DIR ))
-                                      + "/" + driver_file_name_);
+                                      + "/" + driver_file_name_)
+                                  << "1"; // Number of threads; set by Evaluate(timeout, threads)
 }
 
 bool FlowSimulator::Evaluate(int timeout, int threads) {
@@ -100,7 +101,7 @@ bool FlowSimulator::Evaluate(int timeout, int threads) {
     std::cout << "Starting monitored simulation with timeout " << timeout << std::endl;
     bool success = ::Utilities::Unix::ExecShellScriptTimeout(
         QString::fromStdString(paths_.GetPath(Paths::SIM_EXEC_SCRIPT_FILE)),
-        script_args_, t);
+        script_args_, t, cancellation_check_, &cancelled_);
     if (success) {
         results_->ReadResults(driver_file_writer_->output_driver_file_name_);
     }
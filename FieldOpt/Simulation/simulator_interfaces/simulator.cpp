@@ -88,4 +88,8 @@ void Simulator::updateResultsInModel() {
     model_->SetResult("FWPT", results_->GetValueVector(Results::Results::Property::CumulativeWaterProduction));
 }
 
+void Simulator::SelectRealization(const Settings::Ensemble::Realization &realization) {
+    throw std::runtime_error("Selecting realizations is not supported by this simulator interface.");
+}
+
 }
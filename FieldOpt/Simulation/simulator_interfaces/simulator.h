@@ -20,6 +20,7 @@
 #define SIMULATOR
 
 #include <QString>
+#include <functional>
 #include "Model/model.h"
 #include "Simulation/results/results.h"
 #include "Settings/settings.h"
@@ -74,6 +75,12 @@ class Simulator {
    */
   virtual bool Evaluate(const Settings::Ensemble::Realization &realization, int timeout, int threads=1) = 0;
 
+  /*!
+   * @brief Point the simulator to the deck and schedule of a realization (or of one of the
+   * models in a multi-fidelity run) without running a simulation. Subsequent calls to
+   * Evaluate(timeout, threads) and WriteDriverFilesOnly() will use these paths.
+   */
+  virtual void SelectRealization(const Settings::Ensemble::Realization &realization);
 
 
   /*!
@@ -92,6 +99,18 @@ class Simulator {
 
   void SetVerbosityLevel(int level);
 
+  /*!
+   * @brief Set a function that is polled while a simulation with a timeout is running.
+   * If it returns true, the simulation is killed and WasCancelled() will return true.
+   * Evaluate() without a timeout cannot be cancelled; use a large timeout instead.
+   */
+  void SetCancellationCheck(std::function<bool()> check) { cancellation_check_ = check; }
+
+  /*!
+   * @brief Check whether the last simulation was cancelled through the cancellation check.
+   */
+  bool WasCancelled() const { return cancelled_; }
+
  protected:
   /*!
    * Set various path variables. Should only be called by child classes.
@@ -123,6 +142,8 @@ class Simulator {
   QList<int> control_times_;
   virtual void UpdateFilePaths() = 0;
   int verbosity_level_; //!< Verbosity level for runtime console logging.
+  std::function<bool()> cancellation_check_; //!< Polled while simulating; may be empty.
+  bool cancelled_ = false; //!< Whether the last simulation was cancelled.
 };
 
 }
@@ -0,0 +1,59 @@
+#include <Model/tests/test_resource_model.h>
+#include <gtest/gtest.h>
+#include "Simulation/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_section.h"
+#include "Simulation/simulator_interfaces/driver_file_writers/driver_parts/ecl_driver_parts/schedule_template.h"
+
+using namespace ::Simulation::ECLDriverParts;
+
+namespace {
+
+class DriverPartScheduleTemplateTest : public ::testing::Test, public TestResources::TestResourceModel {
+protected:
+    DriverPartScheduleTemplateTest(){}
+    virtual ~DriverPartScheduleTemplateTest(){}
+
+    std::string schedule() {
+        return Schedule(model_->wells(), settings_model_->control_times(), insets_).GetPartString().toStdString();
+    }
+
+    ScheduleInsets insets_;
+    std::string buffer_;
+};
+
+TEST_F(DriverPartScheduleTemplateTest, SameAsSchedule) {
+    for (bool static_structure : {true, false}) {
+        ScheduleTemplate schedule_template(static_structure);
+        schedule_template.Render(model_->wells(), settings_model_->control_times(), insets_, buffer_);
+        EXPECT_TRUE(schedule_template.IsEnabled());
+        EXPECT_EQ(schedule(), buffer_);
+
+        // Changing control values only re-renders the slots
+        for (auto well : *model_->wells()) {
+            for (auto control : *well->controls()) {
+                if (control->bhp() > 0) control->setBhp(control->bhp() * 1.5 + 0.123456789);
+                if (control->rate() > 0) control->setRate(control->rate() * 0.75 + 1e6);
+            }
+        }
+        schedule_template.Render(model_->wells(), settings_model_->control_times(), insets_, buffer_);
+        EXPECT_EQ(schedule(), buffer_);
+        EXPECT_EQ(1, schedule_template.NumberCompilations());
+    }
+}
+
+TEST_F(DriverPartScheduleTemplateTest, RecompilesWhenLayoutChanges) {
+    ScheduleTemplate schedule_template(true);
+    schedule_template.Render(model_->wells(), settings_model_->control_times(), insets_, buffer_);
+
+    auto control = model_->wells()->first()->controls()->first();
+    control->setOpen(!control->open());
+    schedule_template.Render(model_->wells(), settings_model_->control_times(), insets_, buffer_);
+    EXPECT_EQ(2, schedule_template.NumberCompilations());
+    EXPECT_EQ(schedule(), buffer_);
+
+    control->setOpen(!control->open());
+    schedule_template.Render(model_->wells(), settings_model_->control_times(), insets_, buffer_);
+    EXPECT_EQ(3, schedule_template.NumberCompilations());
+    EXPECT_EQ(schedule(), buffer_);
+}
+
+}
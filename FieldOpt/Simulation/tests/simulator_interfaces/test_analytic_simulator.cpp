@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "Model/tests/test_resource_model.h"
+#include "Optimization/tests/test_resource_test_functions.h"
+#include "Simulation/simulator_interfaces/analytic_simulator.h"
+
+using namespace Simulation;
+using namespace TestResources;
+
+namespace {
+
+class AnalyticSimulatorTest : public testing::Test, public TestResourceModel {
+ protected:
+  AnalyticSimulatorTest() {
+      simulator_ = new AnalyticSimulator(settings_full_, model_);
+  }
+  virtual ~AnalyticSimulatorTest() {}
+
+  Simulator *simulator_;
+};
+
+TEST_F(AnalyticSimulatorTest, Evaluate) {
+    EXPECT_FALSE(simulator_->results()->isAvailable());
+    EXPECT_TRUE(simulator_->Evaluate(10, 1));
+    EXPECT_TRUE(simulator_->results()->isAvailable());
+
+    auto variables = model_->variables()->GetContinousVariables()->values();
+    std::sort(variables.begin(), variables.end(),
+              [](const Model::Properties::ContinousProperty *a, const Model::Properties::ContinousProperty *b) {
+                return a->name() < b->name();
+              });
+    Eigen::VectorXd xs(variables.size());
+    for (int i = 0; i < variables.size(); ++i) {
+        xs[i] = variables[i]->value();
+    }
+    double expected = TestFunctions::Rosenbrock(xs);
+    auto results = simulator_->results();
+    EXPECT_DOUBLE_EQ(expected, results->GetValue(Results::Results::Property::CumulativeOilProduction));
+    EXPECT_DOUBLE_EQ(0.0, results->GetValue(Results::Results::Property::CumulativeWaterProduction));
+
+    auto times = results->GetValueVector(Results::Results::Property::Time);
+    auto fopt = results->GetValueVector(Results::Results::Property::CumulativeOilProduction);
+    EXPECT_EQ(settings_model_->control_times().size(), times.size());
+    EXPECT_DOUBLE_EQ(0.0, fopt.front());
+    EXPECT_DOUBLE_EQ(expected, fopt.back());
+}
+
+}
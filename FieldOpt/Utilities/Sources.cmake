@@ -7,6 +7,8 @@ SET(UTILITIES_HEADERS
 	printer.hpp
 	stringhelpers.hpp
 	time.hpp
+	tracing.hpp
+	async_writer.hpp
 	random.hpp
 	system.hpp
 	verbosity.h
@@ -22,4 +24,6 @@ SET(UTILITIES_TESTS
 	tests/test_printer.cpp
 	tests/test_time.cpp
 	tests/test_random.cpp
+	tests/test_tracing.cpp
+	tests/test_async_writer.cpp
 )
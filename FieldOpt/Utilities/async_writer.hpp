@@ -0,0 +1,382 @@
+/// This file contains a file writer that performs the writes on a background thread.
+#ifndef FIELDOPT_ASYNC_WRITER_HPP
+#define FIELDOPT_ASYNC_WRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Utilities {
+namespace FileHandling {
+
+/*!
+ * @brief The AsyncFileWriter class moves file writes off the calling thread.
+ *
+ * Append() and Replace() push a record onto a lock-free multi-producer queue and return
+ * immediately. A background thread drains the queue every flush interval (or when Flush()
+ * is called), opening each file once per batch. When several Replace() records for the
+ * same file are in a batch, only the last one is written. InsertBeforeFooter() keeps a
+ * file that ends with a fixed footer (e.g. the closing brackets of a JSON document) valid
+ * while records are added to it, without rewriting the rest of the file.
+ *
+ * All records are written when Flush() is called and when the writer is destroyed. If
+ * InstallSignalHandlers() has been called, the records still queued are also written when
+ * the process receives SIGINT, SIGTERM, SIGSEGV, SIGABRT, SIGBUS or SIGFPE, after which
+ * the previous handler for the signal is invoked. The signal handler only uses
+ * async-signal-safe system calls, but it can not write a batch the background thread
+ * was writing when the signal arrived.
+ */
+class AsyncFileWriter {
+ public:
+  /*!
+   * @param flush_interval_ms Maximum time a record waits in the queue before it is written.
+   */
+  explicit AsyncFileWriter(int flush_interval_ms=200)
+      : flush_interval_ms_(flush_interval_ms) {
+      stub_.next.store(nullptr, std::memory_order_relaxed);
+      head_.store(&stub_, std::memory_order_relaxed);
+      tail_ = &stub_;
+      registerWriter(this);
+      thread_ = std::thread(&AsyncFileWriter::run, this);
+  }
+
+  ~AsyncFileWriter() {
+      {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+      }
+      cv_.notify_all();
+      thread_.join();
+      unregisterWriter(this);
+  }
+
+  AsyncFileWriter(const AsyncFileWriter &) = delete;
+  AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+  /*!
+   * @brief Append text to a file. A newline is added if the text does not end with one.
+   */
+  void Append(const std::string &path, std::string text) {
+      if (text.empty() || text.back() != '\n')
+          text.push_back('\n');
+      push(new Record(path, std::move(text), false));
+  }
+
+  /*!
+   * @brief Replace the contents of a file.
+   */
+  void Replace(const std::string &path, std::string text) {
+      push(new Record(path, std::move(text), true));
+  }
+
+  /*!
+   * @brief Write text in front of the footer at the end of a file, keeping the footer last.
+   * The file must already end with the footer (e.g. written with Replace()), and should not
+   * be written with Append().
+   */
+  void InsertBeforeFooter(const std::string &path, std::string text, const std::string &footer) {
+      auto r = new Record(path, std::move(text), false);
+      r->footer = footer;
+      push(r);
+  }
+
+  /*!
+   * @brief Block until all records enqueued before the call have been written.
+   */
+  void Flush() {
+      long target = enqueued_.load(std::memory_order_acquire);
+      std::unique_lock<std::mutex> lock(mutex_);
+      flush_target_ = std::max(flush_target_, target);
+      cv_.notify_all();
+      cv_.wait(lock, [&]() { return written_ >= target; });
+  }
+
+  long NumberWritten() const { //!< Number of records written so far.
+      std::lock_guard<std::mutex> lock(mutex_);
+      return written_;
+  }
+
+  /*!
+   * @brief Install handlers writing the queued records of all writers on fatal signals.
+   * Calling this more than once has no effect.
+   */
+  static void InstallSignalHandlers() {
+      static std::once_flag once;
+      std::call_once(once, []() {
+        for (int i = 0; i < N_SIGNALS; ++i) {
+            struct sigaction action = {};
+            action.sa_handler = &AsyncFileWriter::handleSignal;
+            sigemptyset(&action.sa_mask);
+            sigaction(fatalSignals()[i], &action, &previousActions()[i]);
+        }
+      });
+  }
+
+ private:
+  struct Record {
+    Record() {}
+    Record(const std::string &p, std::string t, bool r) : path(p), text(std::move(t)), replace(r) {}
+    std::atomic<Record *> next{nullptr};
+    std::string path;
+    std::string text;
+    bool replace = false;
+    std::string footer; //!< Set for InsertBeforeFooter() records.
+  };
+
+  /*!
+   * Push onto the intrusive multi-producer single-consumer queue (D. Vyukov). Never blocks.
+   */
+  void push(Record *r) {
+      enqueued_.fetch_add(1, std::memory_order_acq_rel);
+      link(r);
+  }
+
+  void link(Record *r) {
+      r->next.store(nullptr, std::memory_order_relaxed);
+      Record *prev = head_.exchange(r, std::memory_order_acq_rel);
+      prev->next.store(r, std::memory_order_release);
+  }
+
+  /*!
+   * Pop the oldest record. Returns nullptr if the queue is empty, or if the next
+   * record is still being linked by a producer. Must only be called by the consumer.
+   */
+  Record *pop() {
+      Record *tail = tail_;
+      Record *next = tail->next.load(std::memory_order_acquire);
+      if (tail == &stub_) {
+          if (next == nullptr)
+              return nullptr;
+          tail_ = next;
+          tail = next;
+          next = next->next.load(std::memory_order_acquire);
+      }
+      if (next != nullptr) {
+          tail_ = next;
+          return tail;
+      }
+      if (tail != head_.load(std::memory_order_acquire))
+          return nullptr;
+      link(&stub_);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next != nullptr) {
+          tail_ = next;
+          return tail;
+      }
+      return nullptr;
+  }
+
+  void run() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+          lock.unlock();
+          long n = writeBatch();
+          lock.lock();
+          written_ += n;
+          cv_.notify_all();
+          if (stop_ && written_ >= enqueued_.load(std::memory_order_acquire))
+              break;
+          if (stop_ || written_ < flush_target_) {
+              // A producer has counted a record it has not linked yet
+              lock.unlock();
+              std::this_thread::yield();
+              lock.lock();
+              continue;
+          }
+          cv_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_),
+                       [&]() { return stop_ || written_ < flush_target_; });
+      }
+  }
+
+  /*!
+   * Write all records that can be popped, opening each file once.
+   * @return The number of records written.
+   */
+  long writeBatch() {
+      std::vector<Record *> batch;
+      while (consumer_busy_.test_and_set(std::memory_order_acquire)) {
+          std::this_thread::yield(); // A signal handler is draining the queue
+      }
+      for (Record *r = pop(); r != nullptr; r = pop()) {
+          batch.push_back(r);
+      }
+      std::map<std::string, size_t> last_replace;
+      for (size_t i = 0; i < batch.size(); ++i) {
+          if (batch[i]->replace)
+              last_replace[batch[i]->path] = i;
+      }
+      std::map<std::string, std::ofstream> streams;
+      std::map<std::string, std::pair<std::string, std::string>> inserts; // Text and footer for each file
+      for (size_t i = 0; i < batch.size(); ++i) {
+          Record *r = batch[i];
+          if (r->replace) {
+              if (last_replace[r->path] != i)
+                  continue;
+              streams.erase(r->path);
+              inserts.erase(r->path);
+              std::ofstream out(r->path, std::ios::out | std::ios::trunc);
+              out << r->text;
+          }
+          else if (!r->footer.empty()) {
+              if (last_replace.count(r->path) > 0 && last_replace[r->path] > i)
+                  continue; // Overwritten later in the batch
+              auto &insert = inserts[r->path];
+              insert.first += r->text;
+              insert.second = r->footer;
+          }
+          else {
+              auto it = streams.find(r->path);
+              if (it == streams.end())
+                  it = streams.emplace(r->path, std::ofstream(r->path, std::ios::out | std::ios::app)).first;
+              it->second << r->text;
+          }
+      }
+      streams.clear();
+      for (auto &insert : inserts) {
+          insertBeforeFooter(insert.first, insert.second.first, insert.second.second);
+      }
+      consumer_busy_.clear(std::memory_order_release);
+      for (Record *r : batch) {
+          delete r;
+      }
+      return batch.size();
+  }
+
+  /*!
+   * Write text in front of the footer at the end of the file, followed by the footer.
+   */
+  static void insertBeforeFooter(const std::string &path, const std::string &text, const std::string &footer) {
+      std::fstream out(path, std::ios::in | std::ios::out | std::ios::binary);
+      if (!out.is_open()) {
+          std::ofstream(path) << text << footer;
+          return;
+      }
+      out.seekp(0, std::ios::end);
+      std::streamoff size = out.tellp();
+      out.seekp(std::max<std::streamoff>(0, size - (std::streamoff)footer.size()));
+      out << text << footer;
+  }
+
+  /*!
+   * Write all of the text to the file descriptor, using async-signal-safe calls only.
+   */
+  static void writeAll(int fd, const std::string &text) {
+      const char *data = text.data();
+      size_t left = text.size();
+      while (left > 0) {
+          ssize_t n = ::write(fd, data, left);
+          if (n <= 0)
+              break;
+          data += n;
+          left -= n;
+      }
+  }
+
+  /*!
+   * Write the queued records using async-signal-safe calls only. The records are not freed.
+   */
+  void drainFromSignal() {
+      for (int attempt = 0; consumer_busy_.test_and_set(std::memory_order_acquire); ++attempt) {
+          if (attempt >= 500)
+              return; // The consumer was interrupted, or is stuck writing
+          struct timespec ms = {0, 1000000};
+          nanosleep(&ms, nullptr);
+      }
+      for (Record *r = pop(); r != nullptr; r = pop()) {
+          bool insert = !r->footer.empty();
+          int flags = O_WRONLY | O_CREAT | (r->replace ? O_TRUNC : (insert ? 0 : O_APPEND));
+          int fd = ::open(r->path.c_str(), flags, 0644);
+          if (fd < 0)
+              continue;
+          if (insert) {
+              off_t size = ::lseek(fd, 0, SEEK_END);
+              if (size >= (off_t)r->footer.size())
+                  ::lseek(fd, size - (off_t)r->footer.size(), SEEK_SET);
+          }
+          writeAll(fd, r->text);
+          if (insert)
+              writeAll(fd, r->footer);
+          ::close(fd);
+      }
+      consumer_busy_.clear(std::memory_order_release);
+  }
+
+  static const int N_SIGNALS = 6;
+  static const int MAX_WRITERS = 16;
+
+  static const int *fatalSignals() {
+      static const int signals[N_SIGNALS] = {SIGINT, SIGTERM, SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+      return signals;
+  }
+
+  static struct sigaction *previousActions() {
+      static struct sigaction actions[N_SIGNALS];
+      return actions;
+  }
+
+  static std::atomic<AsyncFileWriter *> *writers() {
+      static std::atomic<AsyncFileWriter *> registry[MAX_WRITERS];
+      return registry;
+  }
+
+  static void registerWriter(AsyncFileWriter *writer) {
+      for (int i = 0; i < MAX_WRITERS; ++i) {
+          AsyncFileWriter *expected = nullptr;
+          if (writers()[i].compare_exchange_strong(expected, writer))
+              return;
+      }
+  }
+
+  static void unregisterWriter(AsyncFileWriter *writer) {
+      for (int i = 0; i < MAX_WRITERS; ++i) {
+          AsyncFileWriter *expected = writer;
+          if (writers()[i].compare_exchange_strong(expected, nullptr))
+              return;
+      }
+  }
+
+  static void handleSignal(int sig) {
+      for (int i = 0; i < MAX_WRITERS; ++i) {
+          AsyncFileWriter *writer = writers()[i].load();
+          if (writer != nullptr)
+              writer->drainFromSignal();
+      }
+      for (int i = 0; i < N_SIGNALS; ++i) {
+          if (fatalSignals()[i] == sig) {
+              sigaction(sig, &previousActions()[i], nullptr);
+              break;
+          }
+      }
+      raise(sig);
+  }
+
+  int flush_interval_ms_;
+  std::atomic<Record *> head_; //!< Most recently pushed record. Producers exchange this.
+  Record *tail_;               //!< Oldest record. Only touched by the consumer.
+  Record stub_;
+  std::atomic<long> enqueued_{0};
+  std::atomic_flag consumer_busy_ = ATOMIC_FLAG_INIT; //!< Held while popping, by the thread or a signal handler.
+
+  mutable std::mutex mutex_; //!< Guards the members below. Never taken by producers.
+  std::condition_variable cv_;
+  bool stop_ = false;
+  long flush_target_ = 0; //!< Number of records Flush() callers are waiting for.
+  long written_ = 0;
+  std::thread thread_;
+};
+
+}
+}
+
+#endif //FIELDOPT_ASYNC_WRITER_HPP
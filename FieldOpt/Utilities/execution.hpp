@@ -24,10 +24,14 @@
 #include "Utilities/filehandling.hpp"
 #include "Utilities/verbosity.h"
 #include "Utilities/printer.hpp"
+#include "Utilities/tracing.hpp"
 #include <iostream>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <assert.h>
+#include <chrono>
+#include <functional>
+#include <algorithm>
 
 namespace Utilities {
 namespace Unix {
@@ -68,6 +72,7 @@ inline QString Exec(QString directory, QStringList commands, bool verbose=false)
  */
 inline void ExecShellScript(QString script_path, QStringList args)
 {
+    TRACE_SCOPE("ExecShellScript", "Simulation");
     if (!Utilities::FileHandling::FileExists(script_path))
         throw std::runtime_error("File not found: " + script_path.toStdString());
     QString command = script_path + " " + args.join(" ");
@@ -103,10 +108,14 @@ inline pid_t fork_child(QString script_path, QStringList arglist)
         char *ccmnd = cmd.toLatin1().data();
         char *cscrp = script_path.toLatin1().data();
         char *cargs[] = {ccmnd, carg1, carg2, carg3, (char *)0};
+        setpgid(0, 0); // Run the script and the processes it starts in their own process group
         execvp(cscrp, cargs);
         delete carg1, carg2, carg3, ccmnd, cscrp;
         exit(0);
     }
+    // Also set the group here, so that it exists even if the child has not run yet when the
+    // group is killed. This fails harmlessly if the child has already called exec.
+    setpgid(p, p);
     return p;
 }
 
@@ -126,13 +135,28 @@ inline bool is_pid_running(int pid)
 }
 
 /*!
- * After checking if the process is running using the is_pid_running function, terminate it.
+ * After checking if the process is running using the is_pid_running function, terminate it
+ * and reap it.
  * @param pid The PID of the process to terminate.
  */
 inline void terminate_process(int pid)
 {
     if (is_pid_running(pid)) {
         kill(pid, SIGKILL);
+        waitpid(pid, 0, 0);
+    }
+}
+
+/*!
+ * Terminate a child process created by fork_child, along with all the processes it has
+ * started (e.g. the simulator started by the script), and reap the child.
+ * @param pid The PID of the process to terminate. This is also the ID of its process group.
+ */
+inline void terminate_process_group(int pid)
+{
+    if (is_pid_running(pid)) {
+        kill(-pid, SIGKILL);
+        waitpid(pid, 0, 0);
     }
 }
 }
@@ -141,16 +165,24 @@ inline void terminate_process(int pid)
  * @brief ExecShellScriptTimeout execututes a shell script with the given set of parameters, and
  * terminates the process after a set time has passed if it has not returned by then.
  *
+ * If a cancellation check is given, it is called about once per second while the script runs.
+ * When it returns true, the script's process group is killed immediately. This is the only
+ * way to run a script that can be cancelled; ExecShellScript cannot be.
+ *
  * \todo In this function, in the else block, we can also, at a later stage, monitor the output files
  * of a simulation and use them to decide whether we should abort.
  *
  * @param script_path Absolute path to the shell script.
  * @param args Arguments to be passed to the script.
  * @param timeout Seconds before the execution will be terminated.
+ * @param cancel Optional function returning true if the execution should be cancelled.
+ * @param cancelled Optional output, set to true if the execution was cancelled.
  * @return True if the script returned _before_ the timeout, otherwise false.
  */
-inline bool ExecShellScriptTimeout(QString script_path, QStringList args, int timeout)
+inline bool ExecShellScriptTimeout(QString script_path, QStringList args, int timeout,
+                                   std::function<bool()> cancel=nullptr, bool *cancelled=nullptr)
 {
+    TRACE_SCOPE("ExecShellScript", "Simulation");
     if (!Utilities::FileHandling::FileExists(script_path))
         throw std::runtime_error("File not found: " + script_path.toStdString());
     assert(args.length() == 3);
@@ -176,19 +208,27 @@ inline bool ExecShellScriptTimeout(QString script_path, QStringList args, int ti
         return false;
     }
 
+    if (cancelled != nullptr) {
+        *cancelled = false;
+    }
     pid  = helpers::fork_child(script_path, args);
-    to.tv_sec = timeout;
-    to.tv_nsec = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+    long poll_ms = cancel ? 1000 : 1000L * timeout; // Only wake up before the timeout to check for cancellation
 
 
     if (VERB_SIM >= 2) {
         std::stringstream ss;
-        ss << "Monitoring child process with pid " << pid << ". Timeout set to " << to.tv_sec << std::endl;
+        ss << "Monitoring child process with pid " << pid << ". Timeout set to " << timeout << std::endl;
         Printer::info(ss.str());
     }
     do {
         if (!helpers::is_pid_running(pid)) // If the child no longer exists, return true
             return true;
+        long remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        long wait_ms = std::max(0L, std::min(poll_ms, remaining_ms));
+        to.tv_sec = wait_ms / 1000;
+        to.tv_nsec = (wait_ms % 1000) * 1000000L;
         int ret = sigtimedwait(&mask, NULL, &to);
         if (VERB_SIM >= 2) {
             std::stringstream ss;
@@ -201,10 +241,24 @@ inline bool ExecShellScriptTimeout(QString script_path, QStringList args, int ti
                 helpers::terminate_process(pid);
                 return false;
             }
+            else if (errno == EAGAIN && cancel && std::chrono::steady_clock::now() < deadline) { // Woke up to poll
+                if (cancel()) {
+                    Printer::ext_warn("Cancelled, killing child " + Printer::num2str(pid), "Utilities", "Execution");
+                    if (helpers::is_pid_running(pid)) {
+                        helpers::terminate_process_group(pid);
+                        if (cancelled != nullptr) {
+                            *cancelled = true;
+                        }
+                        return false;
+                    }
+                    return true;
+                }
+                continue;
+            }
             else if (errno == EAGAIN) {
                 Printer::ext_warn("Timeout, killing child " + Printer::num2str(pid), "Utilities", "Execution");
                 if (helpers::is_pid_running(pid)) { // Ensure that child still exists
-                    kill(pid, SIGKILL);
+                    helpers::terminate_process_group(pid);
                     return false;
                 }
                 else {
@@ -164,6 +164,25 @@ inline void WriteStringToFile(QString string, QString file_path)
     file.close();
 }
 
+/*!
+ * \brief WriteBufferToFile Write a buffer to a file as is, with a single unbuffered write.
+ * Removes existing file contents.
+ * \param buffer The bytes to be written.
+ * \param file_path Path to the file to write the buffer into.
+ */
+inline void WriteBufferToFile(const std::string &buffer, QString file_path)
+{
+    if (!ParentDirectoryExists(file_path))
+        throw std::runtime_error("File's parent directory not found: " + file_path.toStdString());
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+        throw std::runtime_error("Unable to open " + file_path.toStdString() + " for writing.");
+    if (file.write(buffer.data(), buffer.size()) != (qint64)buffer.size())
+        throw std::runtime_error("Unable to write to " + file_path.toStdString() + ".");
+    file.close();
+}
+
 /*!
  * \brief WriteLineToFile Append a string to a file.
  *
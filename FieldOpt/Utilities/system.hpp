@@ -21,7 +21,9 @@
 #define FIELDOPT_SYSTEM_H
 
 #include <string>
+#include <fstream>
 #include <stdlib.h>
+#include <unistd.h>
 
 /*!
  * @brief Check whether an environment variable has been set.
@@ -54,4 +56,17 @@ inline std::string get_env_var_value(std::string var_name) {
     }
 }
 
+/*!
+ * @brief Get the resident set size of the current process, read from /proc/self/statm.
+ * @return The resident memory in kilobytes, or -1 if it could not be determined.
+ */
+inline long resident_memory_kb() {
+    std::ifstream statm("/proc/self/statm");
+    long size, resident;
+    if (!(statm >> size >> resident)) {
+        return -1;
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
 #endif //FIELDOPT_SYSTEM_H
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "Utilities/async_writer.hpp"
+
+using namespace Utilities::FileHandling;
+
+namespace {
+
+class AsyncFileWriterTest : public testing::Test {
+ protected:
+  AsyncFileWriterTest() {
+      std::remove(path_.c_str());
+  }
+  virtual ~AsyncFileWriterTest() {
+      std::remove(path_.c_str());
+  }
+
+  std::string readFile(const std::string &path) {
+      std::ifstream in(path);
+      std::stringstream ss;
+      ss << in.rdbuf();
+      return ss.str();
+  }
+
+  const std::string path_ = "/tmp/fieldopt_test_async_writer.txt";
+};
+
+TEST_F(AsyncFileWriterTest, AppendKeepsOrder) {
+    AsyncFileWriter writer(10000);
+    writer.Append(path_, "first");
+    writer.Append(path_, "second\n");
+    writer.Append(path_, "third");
+    writer.Flush();
+    EXPECT_EQ("first\nsecond\nthird\n", readFile(path_));
+    EXPECT_EQ(3, writer.NumberWritten());
+}
+
+TEST_F(AsyncFileWriterTest, ReplaceWritesLastContents) {
+    AsyncFileWriter writer(10000);
+    writer.Replace(path_, "old");
+    writer.Replace(path_, "new");
+    writer.Flush();
+    EXPECT_EQ("new", readFile(path_));
+
+    writer.Append(path_, "appended");
+    writer.Flush();
+    EXPECT_EQ("newappended\n", readFile(path_));
+}
+
+TEST_F(AsyncFileWriterTest, InsertBeforeFooter) {
+    AsyncFileWriter writer(10000);
+    writer.Replace(path_, "{\"Cases\": [\n]}\n");
+    writer.InsertBeforeFooter(path_, "1\n", "]}\n");
+    writer.Flush();
+    EXPECT_EQ("{\"Cases\": [\n1\n]}\n", readFile(path_));
+
+    // Records in separate batches, and several in one batch
+    writer.InsertBeforeFooter(path_, ",2\n", "]}\n");
+    writer.Flush();
+    writer.InsertBeforeFooter(path_, ",3\n", "]}\n");
+    writer.InsertBeforeFooter(path_, ",4\n", "]}\n");
+    writer.Flush();
+    EXPECT_EQ("{\"Cases\": [\n1\n,2\n,3\n,4\n]}\n", readFile(path_));
+    EXPECT_EQ(5, writer.NumberWritten());
+}
+
+TEST_F(AsyncFileWriterTest, WrittenWithoutFlush) {
+    {
+        AsyncFileWriter writer(1);
+        writer.Append(path_, "line");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ("line\n", readFile(path_));
+    }
+    {
+        AsyncFileWriter writer(10000);
+        writer.Append(path_, "on destruction");
+    }
+    EXPECT_EQ("line\non destruction\n", readFile(path_));
+}
+
+TEST_F(AsyncFileWriterTest, ConcurrentProducers) {
+    const int n_threads = 4;
+    const int n_lines = 2000;
+    AsyncFileWriter writer(1);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&writer, t, this]() {
+          for (int i = 0; i < n_lines; ++i) {
+              writer.Append(path_, std::to_string(t) + " " + std::to_string(i));
+          }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    writer.Flush();
+    EXPECT_EQ(n_threads * n_lines, writer.NumberWritten());
+
+    // Every line is written once, and lines from one thread are in order
+    std::vector<int> next(n_threads, 0);
+    std::ifstream in(path_);
+    int t, i, n = 0;
+    while (in >> t >> i) {
+        EXPECT_EQ(next[t], i);
+        next[t] = i + 1;
+        n++;
+    }
+    EXPECT_EQ(n_threads * n_lines, n);
+}
+
+}
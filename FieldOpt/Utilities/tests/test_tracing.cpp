@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "Utilities/tracing.hpp"
+
+using namespace Tracing;
+
+namespace {
+
+class TracingTest : public testing::Test {
+ protected:
+  TracingTest() {
+      Tracer::Instance().Disable();
+      Tracer::Instance().Clear();
+  }
+  virtual ~TracingTest() {
+      Tracer::Instance().Disable();
+      Tracer::Instance().Clear();
+  }
+
+  std::string readFile(const std::string &path) {
+      std::ifstream in(path);
+      std::stringstream ss;
+      ss << in.rdbuf();
+      return ss.str();
+  }
+
+  const std::string path_ = "/tmp/fieldopt_test_trace.json";
+};
+
+TEST_F(TracingTest, DisabledRecordsNothing) {
+    {
+        TRACE_SCOPE("Outer", "Test");
+        TRACE_SCOPE("Inner", "Test");
+    }
+    EXPECT_EQ(0, Tracer::Instance().NumberOfEvents());
+}
+
+TEST_F(TracingTest, NestedScopes) {
+    Tracer::Instance().Enable(path_, 3);
+    {
+        TRACE_SCOPE("Outer", "Test");
+        {
+            TRACE_SCOPE("Inner", "Test");
+        }
+    }
+    EXPECT_EQ(2, Tracer::Instance().NumberOfEvents());
+    EXPECT_TRUE(Tracer::Instance().Flush());
+
+    std::string trace = readFile(path_);
+    EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Outer\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Inner\""));
+    EXPECT_NE(std::string::npos, trace.find("\"pid\":3"));
+    // The inner scope completes, and is recorded, first
+    EXPECT_LT(trace.find("\"name\":\"Inner\""), trace.find("\"name\":\"Outer\""));
+}
+
+TEST_F(TracingTest, Threads) {
+    Tracer::Instance().Enable(path_, 0);
+    {
+        TRACE_SCOPE("Main", "Test");
+    }
+    auto work = []() {
+      for (int i = 0; i < 100; ++i) {
+          TRACE_SCOPE("Work", "Test");
+      }
+    };
+    std::thread t1(work);
+    std::thread t2(work);
+    t1.join();
+    t2.join();
+    EXPECT_EQ(201, Tracer::Instance().NumberOfEvents());
+    EXPECT_TRUE(Tracer::Instance().Flush());
+
+    std::string trace = readFile(path_);
+    EXPECT_NE(trace.find("\"tid\":1}"), std::string::npos);
+    EXPECT_NE(trace.find("\"tid\":2}"), std::string::npos);
+}
+
+}
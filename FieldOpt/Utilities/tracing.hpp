@@ -0,0 +1,182 @@
+/// This file contains a light-weight hierarchical tracer, exporting to the Chrome trace format.
+#ifndef FIELDOPT_TRACING_HPP
+#define FIELDOPT_TRACING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief The Tracing namespace contains a tracer recording nested, timed scopes.
+ *
+ * Scopes are recorded with the TRACE_SCOPE macro. When tracing is disabled (the default),
+ * a scope costs a single relaxed atomic load. When enabled, each thread appends its events
+ * to its own buffer, so recording never takes a lock after a thread's first event.
+ *
+ * The recorded events are written by Flush() as a Chrome trace (complete "X" events), which
+ * can be opened in chrome://tracing or Perfetto. Nesting is implied by the timestamps. The
+ * process id is set to the MPI rank so that traces from several ranks can be concatenated.
+ */
+namespace Tracing {
+
+/*!
+ * @brief Nanoseconds on the monotonic clock.
+ */
+inline long long now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ * @brief A completed scope. The name and category must be string literals.
+ */
+struct Event {
+  const char *name;
+  const char *category;
+  long long start_ns;
+  long long duration_ns;
+};
+
+class Tracer {
+ public:
+  static Tracer &Instance() {
+      static Tracer tracer;
+      return tracer;
+  }
+
+  /*!
+   * @brief Start recording events.
+   * @param output_path Path to the file the trace is written to by Flush().
+   * @param pid Process id to write for the events (the MPI rank).
+   */
+  void Enable(const std::string &output_path, int pid=0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      output_path_ = output_path;
+      pid_ = pid;
+      origin_ns_ = now_ns();
+      enabled_.store(true, std::memory_order_relaxed);
+  }
+
+  void Disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Record(const char *name, const char *category, long long start_ns, long long end_ns) {
+      threadBuffer().events.push_back(Event{name, category, start_ns, end_ns - start_ns});
+  }
+
+  /*!
+   * @brief Number of events recorded so far, over all threads.
+   */
+  size_t NumberOfEvents() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t n = 0;
+      for (auto &buffer : buffers_) n += buffer->events.size();
+      return n;
+  }
+
+  /*!
+   * @brief Write all recorded events to the output file. Does nothing if tracing was never enabled.
+   *
+   * Must not be called while other threads are recording.
+   * @return True if the file was written.
+   */
+  bool Flush() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (output_path_.empty())
+          return false;
+      std::ofstream out(output_path_);
+      if (!out.is_open())
+          return false;
+      out << "{\"traceEvents\":[\n";
+      out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid_
+          << ",\"args\":{\"name\":\"rank " << pid_ << "\"}}";
+      out.setf(std::ios::fixed);
+      out.precision(3);
+      for (auto &buffer : buffers_) {
+          for (const Event &e : buffer->events) {
+              out << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+                  << ",\"ts\":" << (e.start_ns - origin_ns_) / 1000.0
+                  << ",\"dur\":" << e.duration_ns / 1000.0
+                  << ",\"pid\":" << pid_ << ",\"tid\":" << buffer->tid << "}";
+          }
+      }
+      out << "\n]}\n";
+      return out.good();
+  }
+
+  /*!
+   * @brief Discard all recorded events.
+   */
+  void Clear() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto &buffer : buffers_) buffer->events.clear();
+  }
+
+ private:
+  struct ThreadBuffer {
+    int tid;
+    std::vector<Event> events;
+  };
+
+  Tracer() {}
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  ThreadBuffer &threadBuffer() {
+      thread_local ThreadBuffer *buffer = nullptr;
+      if (buffer == nullptr) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          buffers_.emplace_back(new ThreadBuffer{(int)buffers_.size(), {}});
+          buffer = buffers_.back().get();
+          buffer->events.reserve(1024);
+      }
+      return *buffer;
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_; //!< One buffer per thread that has recorded an event.
+  std::string output_path_;
+  int pid_ = 0;
+  long long origin_ns_ = 0; //!< Time tracing was enabled; timestamps are written relative to this.
+};
+
+/*!
+ * @brief Records the lifetime of the object as an event, if tracing is enabled when it is created.
+ */
+class ScopedTrace {
+ public:
+  ScopedTrace(const char *name, const char *category)
+      : name_(name), category_(category),
+        start_ns_(Tracer::Instance().IsEnabled() ? now_ns() : -1) {}
+
+  ~ScopedTrace() {
+      if (start_ns_ >= 0)
+          Tracer::Instance().Record(name_, category_, start_ns_, now_ns());
+  }
+
+  ScopedTrace(const ScopedTrace &) = delete;
+  ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+ private:
+  const char *name_;
+  const char *category_;
+  long long start_ns_;
+};
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/*!
+ * @brief Trace the enclosing scope. The name and category must be string literals.
+ */
+#define TRACE_SCOPE(name, category) ::Tracing::ScopedTrace TRACE_CONCAT(trace_scope_, __LINE__)(name, category)
+
+#endif //FIELDOPT_TRACING_HPP
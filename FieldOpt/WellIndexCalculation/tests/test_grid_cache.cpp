@@ -0,0 +1,100 @@
+/******************************************************************************
+   Copyright (C) 2015-2017 Mathias C. Bellout <mathias.bellout@ntnu.no>
+
+   This file is part of the WellIndexCalculator, a part of FieldOpt.
+
+   WellIndexCalculator is free software: you can redistribute it
+   and/or modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation, either
+   version 3 of the License, or (at your option) any later version.
+
+   WellIndexCalculator is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with WellIndexCalculator.  If not, see
+   <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+#include "Reservoir/grid/grid.h"
+#include "Reservoir/grid/eclgrid.h"
+#include "WellIndexCalculation/wicalc_rixx.h"
+#include "Settings/tests/test_resource_example_file_paths.hpp"
+
+using namespace Reservoir::Grid;
+using namespace Reservoir::WellIndexCalculation;
+using namespace std;
+
+namespace {
+
+class GridCacheTest : public ::testing::Test {
+ protected:
+  GridCacheTest() {
+      wic_ = new wicalc_rixx(new ECLGrid(base_path_));
+      wic_->SetMaxCachedGrids(2);
+  }
+
+  // Switch to the grid of a realization, the way Model::set_grid_path does
+  Grid *activate(const string &path) {
+      Grid *grid;
+      if (!wic_->HasGrid(path)) {
+          grid = new ECLGrid(path);
+          wic_->AddGrid(grid);
+      }
+      else {
+          grid = wic_->GetGrid(path);
+      }
+      wic_->SetGridActive(grid);
+      return grid;
+  }
+
+  wicalc_rixx *wic_;
+  string base_path_ = TestResources::ExampleFilePaths::grid_5spot_;
+  vector<string> realization_paths_ = {TestResources::ExampleFilePaths::grid_horzwel_,
+                                       TestResources::ExampleFilePaths::cube_grid_,
+                                       TestResources::ExampleFilePaths::grid_flow_5spot_};
+};
+
+TEST_F(GridCacheTest, SwitchRealizations) {
+    // Cycle through the realizations twice; only the base grid and the active grid are kept
+    for (int round = 0; round < 2; ++round) {
+        for (int r = 0; r < realization_paths_.size(); ++r) {
+            Grid *grid = activate(realization_paths_[r]);
+            EXPECT_EQ(realization_paths_[r], grid->GetGridFilePath());
+            EXPECT_TRUE(wic_->HasGrid(realization_paths_[r]));
+            EXPECT_TRUE(wic_->HasGrid(base_path_));
+            for (int other = 0; other < realization_paths_.size(); ++other) {
+                if (other != r) {
+                    EXPECT_FALSE(wic_->HasGrid(realization_paths_[other]));
+                }
+            }
+        }
+    }
+}
+
+TEST_F(GridCacheTest, RecentlyUsedGridsAreKept) {
+    wic_->SetMaxCachedGrids(3);
+    activate(realization_paths_[0]);
+    activate(realization_paths_[1]);
+    activate(realization_paths_[0]); // realization 1 is now the least recently used
+    activate(realization_paths_[2]);
+    EXPECT_TRUE(wic_->HasGrid(base_path_));
+    EXPECT_TRUE(wic_->HasGrid(realization_paths_[0]));
+    EXPECT_FALSE(wic_->HasGrid(realization_paths_[1]));
+    EXPECT_TRUE(wic_->HasGrid(realization_paths_[2]));
+}
+
+TEST_F(GridCacheTest, Unbounded) {
+    wic_->SetMaxCachedGrids(0);
+    for (auto path : realization_paths_) {
+        activate(path);
+    }
+    for (auto path : realization_paths_) {
+        EXPECT_TRUE(wic_->HasGrid(path));
+    }
+}
+
+}
@@ -41,6 +41,7 @@ using std::stringstream;
 #include <Utilities/verbosity.h>
 #include <Utilities/printer.hpp>
 #include <Utilities/stringhelpers.hpp>
+#include <Utilities/tracing.hpp>
 
 // ---------------------------------------------------------
 enum CompletionType {
@@ -109,6 +110,10 @@ void wicalc_rixx::AddGrid(Grid::Grid *grid) {
     fill(intersections.begin(), intersections.end(), HUGE_VAL);
     dict_intersections_.insert(pair<string, vector<double>>(grid->GetGridFilePath(), intersections));
   }
+  if (base_grid_path_.empty()) {
+    base_grid_path_ = grid->GetGridFilePath();
+  }
+  touchGrid(grid->GetGridFilePath());
 }
 
 void wicalc_rixx::SetGridActive(Grid::Grid *grid) {
@@ -116,9 +121,38 @@ void wicalc_rixx::SetGridActive(Grid::Grid *grid) {
     Printer::ext_info("Setting grid active " + grid->GetGridFilePath(), "wicalc_rixx", "WellIndexCalculation");
   }
   assert(HasGrid(grid->GetGridFilePath()));
+  touchGrid(grid->GetGridFilePath());
   ricasedata_ = dict_casedata_[grid->GetGridFilePath()];
   grid_ = dict_grids_[grid->GetGridFilePath()];
   intersections_ = dict_intersections_[grid->GetGridFilePath()];
+  // Only evict once the new grid is active, so that it is never the one released
+  evictGrids();
+}
+
+void wicalc_rixx::touchGrid(const string &path) {
+  grid_lru_.remove(path);
+  grid_lru_.push_front(path);
+}
+
+void wicalc_rixx::evictGrids() {
+  if (max_cached_grids_ <= 0) {
+    return;
+  }
+  auto it = grid_lru_.end();
+  while (grid_lru_.size() > max_cached_grids_ && it != grid_lru_.begin()) {
+    --it;
+    if (*it == base_grid_path_ || (grid_ != nullptr && *it == grid_->GetGridFilePath())) {
+      continue;
+    }
+    if (VERB_WIC >= 2) {
+      Printer::ext_info("Releasing cached grid " + *it, "wicalc_rixx", "WellIndexCalculation");
+    }
+    delete dict_grids_[*it];
+    dict_grids_.erase(*it);
+    dict_casedata_.erase(*it);
+    dict_intersections_.erase(*it);
+    it = grid_lru_.erase(it);
+  }
 }
 
 // -----------------------------------------------------------------
@@ -239,6 +273,7 @@ void
 wicalc_rixx::ComputeWellBlocks(
     vector<IntersectedCell> &well_indices,
     WellDefinition &well) {
+  TRACE_SCOPE("ComputeWellBlocks", "WellIndexCalculation");
 
   // -------------------------------------------------------
   stringstream str;
@@ -31,6 +31,7 @@
 // FieldOpt::RESINXX
 #include "resinxx/well_path.h"
 #include "WellDefinition.h"
+#include <list>
 
 // ---------------------------------------------------------
 namespace Reservoir {
@@ -114,6 +115,15 @@ class wicalc_rixx
    */
   void SetGridActive(Grid::Grid *grid);
 
+  /*!
+   * @brief Bound the number of grids kept in memory. When a grid is set active and the
+   * bound is exceeded, the least recently activated grids are released. The first grid
+   * added (the base grid, which is referenced by the wells) and the active grid are
+   * never released.
+   * @param n Maximum number of cached grids. 0 means unbounded.
+   */
+  void SetMaxCachedGrids(int n) { max_cached_grids_ = n; }
+
  protected:
   // ---------------------------------------------------------------
   // size_t grid_count_;
@@ -125,6 +135,13 @@ class wicalc_rixx
   map<string, Grid::Grid*> dict_grids_;
   map<string, vector<double>> dict_intersections_;
 
+  int max_cached_grids_ = 0;
+  std::list<string> grid_lru_; //!< Cached grid paths, most recently activated first.
+  string base_grid_path_; //!< Path to the first grid added. This is never evicted.
+
+  void touchGrid(const string &path); //!< Mark a grid as the most recently used.
+  void evictGrids(); //!< Release the least recently used grids until the bound is satisfied.
+
 };
 
 }